@@ -3,6 +3,7 @@
 #include "../../dsp_fv/APFstructures.h"
 #include "../../dsp_fv/classicFilters.h"
 #include "../../dsp_fv/vibrato.h"
+#include "../../dsp_fv/silenceDetector.h"
 
 /// <summary>
 /// reverb Control parameters, linked to sliders
@@ -52,8 +53,32 @@ struct ReverbStructureParameters
 	vibratoParameters vibratoParam = { 0.5, 1.0, true }; // depth, rate and then enableVibrato
 };
 
+/// <summary>
+/// One output tap : reverberator delay line (0 to 3), delay in samples, gain (sign and output level), output channel (0 : left, 1 : right)
+/// </summary>
+struct AbyssalOutputTap
+{
+	int delayLine;
+	unsigned int delay_samples;
+	float gain;
+	int channel;
+};
+
+/// <summary>
+/// Output taps of the reverberator delay lines
+/// </summary>
+constexpr AbyssalOutputTap abyssalOutputTaps[] = {
+	{ 0, 825, 0.16f, 0 }, { 1, 2112, 0.16f, 0 }, { 2, 1630, -0.16f, 0 }, { 3, 3215, -0.16f, 0 },
+	{ 2, 825, 0.16f, 1 }, { 3, 2069, 0.16f, 1 }, { 1, 1679, -0.16f, 1 }, { 2, 2641, -0.16f, 1 }
+};
+
 
-class AbyssalPlateReverb : private Vibrato
+/// <summary>
+/// The Abyssal plate reverb : early reflexions, then a four branch reverberator. Processed in SampleType (float or double),
+/// see the AbyssalPlateReverb alias
+/// </summary>
+template <typename SampleType>
+class AbyssalPlateReverbT : private VibratoT<SampleType>
 {
 public:
 	/// <summary>
@@ -70,7 +95,9 @@ public:
 	/// <param name="pControlParameters"></param>
 	void updateParameters(ReverbControlParameters pControlParameters)
 	{
+		setParameters(pControlParameters);
 
+		// vibratos : from the new control parameters
 		structureParameters.vibratoParam = { controlParameters.modDepth,controlParameters.modRate,  true };
 		reverbVibratoV1.setParameters(structureParameters.vibratoParam);
 		reverbVibratoV2.setParameters(structureParameters.vibratoParam);
@@ -78,12 +105,13 @@ public:
 		//reverbVibratoV1.reset(sampleRate);
 		//reverbVibratoV2.reset(sampleRate);
 
-		setParameters(pControlParameters);
-		// update absorption and damping 
+		// update absorption and damping : table lookup, no trigonometry nor allocation
+		const double dampingACoeff[3] = { 1.0, 0.0, 0.0 };
+		const double dampingBCoeff[3] = { 1.0, (-1) * (float)controlParameters.damping, 0.0 };
 		for (auto i = 0; i < absorptionFilter.size(); ++i)
 		{
-			absorptionFilter[i].setCoefficients(controlParameters.absorption, 1.0, sampleRate);
-			reverbDampingFilter[i].updateParameters({ 1.0,0.0,0.0 }, { 1,(-1) * (float)controlParameters.damping,0.0 });
+			absorptionFilter[i].setCoefficients(absorptionTable, controlParameters.absorption, 1.0);
+			reverbDampingFilter[i].updateParameters(dampingACoeff, dampingBCoeff);
 		}
 	}
 
@@ -108,7 +136,10 @@ public:
 		earlyReflexFcomb2.createDelayBuffer(sampleRate);
 
 		// Set absorption low pass filter type and initial cutoff frequency
-		ClassicFilters filter;
+		if (!absorptionTable.isPreparedFor(ClassicFilterType::LPF1, sampleRate))
+			absorptionTable.prepare(ClassicFilterType::LPF1, sampleRate, 1.0, 1.0);
+		absorptionFilter.clear();
+		ClassicFiltersT<SampleType> filter;
 		for (auto i = 0; i < 4; ++i)
 		{
 			filter.setFilterType("LPF1");
@@ -116,13 +147,30 @@ public:
 			absorptionFilter.push_back(filter);
 		}
 
-		alternateAllPassFilter_modulated rModAPF;
-		alternateAllPassFilter rAPF;
-		delayLine rDelayLine;
-		Biquad rDampingFilter;
+		// output taps, grouped by delay line and channel. The delay lines hold the longest tap and a gathered block
+		vector<unsigned int> minBufferLength(4, 0);
+		for (auto& delayLineGroups : outputTapGroups)
+			for (auto& group : delayLineGroups)
+				group.clear();
+		for (auto& tap : abyssalOutputTaps)
+		{
+			outputTapGroups[(size_t)tap.delayLine][(size_t)tap.channel].push_back({ tap.delay_samples, (SampleType)tap.gain });
+			auto& length = minBufferLength[(size_t)tap.delayLine];
+			length = juce::jmax(length, tap.delay_samples + (unsigned int)maxGatherLength);
+		}
 
+		reverbModAPF.clear();
+		reverbAPF.clear();
+		reverbDelayLine.clear();
+		reverbDampingFilter.clear();
 		for (auto i = 0; i < 4; ++i)
 		{
+			// new instances every time, they are moved into the vectors
+			alternateAllPassFilter_modulatedT<SampleType> rModAPF;
+			alternateAllPassFilterT<SampleType> rAPF;
+			delayLineT<SampleType> rDelayLine;
+			BiquadT<SampleType> rDampingFilter;
+
 			rModAPF.setParameters(structureParameters.reverbModulatedAPF_Param[i], structureParameters.reverbModulatedAPF_lfoParam[i]);
 			rModAPF.createDelayBuffer(sampleRate);
 
@@ -130,7 +178,7 @@ public:
 			rAPF.createDelayBuffer(sampleRate);
 
 			rDelayLine.setParameters(structureParameters.reverbDelayLineParam[i]);
-			rDelayLine.createDelayBuffer(sampleRate);
+			rDelayLine.createDelayBuffer(sampleRate, minBufferLength[(size_t)i]);
 
 			rDampingFilter.setType("direct");
 			rDampingFilter.updateParameters({ 1.0,0.0,0.0 }, { 1,(-1) * (float)controlParameters.damping,0.0 });
@@ -152,26 +200,98 @@ public:
 		reverbVibratoV2.createDelayBuffer(sampleRate/*, 100.0*/);
 	}
 
-	vector<float> processAudioSample(vector<float> inputXn)
+	vector<SampleType> processAudioSample(vector<SampleType> inputXn)
 	{
-		auto temp = earlyReflexion_processAudioSample(inputXn);
-		temp = controlParameters.earlyReflexions * temp + (1.0f - controlParameters.earlyReflexions) *( 0.5f * (inputXn[0] + inputXn[1]));
-		auto out = reverberator_processAudioSample(temp);
-		return { (1.0f - controlParameters.mix) * inputXn[0] + (controlParameters.mix) * out[0], (1.0f - controlParameters.mix) * inputXn[1] + (controlParameters.mix) * out[1] };
+		processMono(SampleType(0.5) * (inputXn[0] + inputXn[1]));
+		auto out = readOutputTaps();
+		auto mix = (SampleType)controlParameters.mix;
+		return { (1 - mix) * inputXn[0] + (mix) * out[0], (1 - mix) * inputXn[1] + (mix) * out[1] };
+	}
+
+	/// <summary>
+	/// Processes a block : early reflexions and reverberator run sample by sample, then the output taps are gathered
+	/// for up to maxGatherLength samples at a time, one multi-tap read per delay line and channel. Same output as
+	/// processAudioSample(). The output buffers may be the input ones
+	/// </summary>
+	void processBlock(const float* inL, const float* inR, float* outL, float* outR, int numSamples)
+	{
+		auto mix = (SampleType)controlParameters.mix;
+		for (int start = 0; start < numSamples; start += maxGatherLength)
+		{
+			auto length = juce::jmin(maxGatherLength, numSamples - start);
+			for (int sample = 0; sample < length; ++sample)
+				processMono(SampleType(0.5) * ((SampleType)inL[start + sample] + (SampleType)inR[start + sample]));
+
+			gatherOutputTaps(length);
+			for (int sample = 0; sample < length; ++sample)
+			{
+				auto xL = (SampleType)inL[start + sample], xR = (SampleType)inR[start + sample];
+				outL[start + sample] = (float)((1 - mix) * xL + mix * gatheredOutput[0][(size_t)sample]);
+				outR[start + sample] = (float)((1 - mix) * xR + mix * gatheredOutput[1][(size_t)sample]);
+			}
+		}
+	}
+
+	/// <summary>
+	/// Tail length with the current parameters, in seconds (decay by tailDecay_dB) : the early reflexions loop
+	/// (4 branches, 0.25 each) and comb filters, then the reverberator, a loop through its 4 branches attenuated by decay
+	/// in each of them (the damping filters have a unity gain at DC), or the ringing of its APFs if longer
+	/// </summary>
+	double getTailLengthSeconds() const
+	{
+		auto& s = structureParameters;
+		const double decayER = 0.25;
+		double tail_s = 0.0;
+		if (controlParameters.earlyReflexions > 0.0f)
+		{
+			double erLoop_s = 0.0;
+			for (auto* apf : { &s.earlyReflexAPF1Param, &s.earlyReflexAPF2Param, &s.earlyReflexAPF3Param, &s.earlyReflexAPF4Param })
+			{
+				erLoop_s += apf->delayTime_ms * 0.001;
+				tail_s += getFeedbackDecayTime(apf->feedbackGain, apf->delayTime_ms * 0.001);
+			}
+			tail_s += erLoop_s + getFeedbackDecayTime(std::pow(decayER, 4.0), erLoop_s);
+			tail_s += juce::jmax(getFeedbackDecayTime(s.earlyReflexFcomb1Param.g, s.earlyReflexFcomb1Param.delayTime_ms * 0.001),
+				getFeedbackDecayTime(s.earlyReflexFcomb2Param.g, s.earlyReflexFcomb2Param.delayTime_ms * 0.001));
+		}
+
+		// the vibratos read up to 7 ms late
+		double loop_s = 2 * 0.007;
+		double apfDecay_s = 0.0;
+		for (auto i = 0; i < 4; ++i)
+		{
+			loop_s += 0.001 * (s.reverbModulatedAPF_Param[i].delayTime_ms + s.reverbAlternateAPFParam[i].delayTime_ms + s.reverbDelayLineParam[i].delayTime_ms);
+			apfDecay_s = juce::jmax(apfDecay_s,
+				getFeedbackDecayTime(s.reverbModulatedAPF_Param[i].feedbackGain, s.reverbModulatedAPF_Param[i].delayTime_ms * 0.001),
+				getFeedbackDecayTime(s.reverbAlternateAPFParam[i].feedbackGain, s.reverbAlternateAPFParam[i].delayTime_ms * 0.001));
+		}
+		auto loopDecay_s = getFeedbackDecayTime(std::pow((double)controlParameters.decay, 4.0), loop_s);
+		return limitTailLength(tail_s + loop_s + juce::jmax(loopDecay_s, apfDecay_s));
 	}
 
 private:
+	static constexpr int maxGatherLength = 64; // samples gathered per pass, the tapped delay lines are this much longer than their taps
+
 	/// <summary>
-	/// stereo IN to mono OUT
+	/// Early reflexions, blended with the dry input, then the reverberator, for one (mono) input sample
 	/// </summary>
-	/// <param name="inputXn"></param>
+	void processMono(SampleType input)
+	{
+		auto temp = earlyReflexion_processAudioSample(input);
+		auto earlyReflexions = (SampleType)controlParameters.earlyReflexions;
+		temp = earlyReflexions * temp + (1 - earlyReflexions) * input;
+		reverberator_processAudioSample(temp);
+	}
+
+	/// <summary>
+	/// mono IN to mono OUT
+	/// </summary>
+	/// <param name="input">the mid of the input channels</param>
 	/// <returns>mono output sample from the early reflexion </returns>
-	float earlyReflexion_processAudioSample(vector<float> inputXn)
+	SampleType earlyReflexion_processAudioSample(SampleType input)
 	{
-		float input = 0.5f * (float)(inputXn[0] + inputXn[1]);
-		static float branch1 = 0.0, branch2 = 0.0, branch3 = 0.0, branch4 = 0.0;
-		float decayER = 0.25;
-		float lateReflexAmount = 0.15;
+		SampleType decayER = SampleType(0.25);
+		SampleType lateReflexAmount = SampleType(0.15);
 
 		branch1 = absorptionFilter[0].processAudioSample(input + decayER * branch4);
 		branch1 = earlyReflexAPF1.processAudioSample(branch1);
@@ -185,34 +305,33 @@ private:
 		branch4 = absorptionFilter[3].processAudioSample(input + decayER * branch3);
 		branch4 = earlyReflexAPF4.processAudioSample(branch4);
 
-		float sumBranches = branch1 + branch2 + branch3 + branch4;
+		SampleType sumBranches = branch1 + branch2 + branch3 + branch4;
 
 		auto lateReflex = lateReflexAmount * (earlyReflexFcomb1.processAudioSample(sumBranches) + earlyReflexFcomb2.processAudioSample(sumBranches));
 
-		float output = lateReflex + sumBranches;
+		SampleType output = lateReflex + sumBranches;
 
 		return output;
 	}
 
 	/// <summary>
-	/// mono IN to stereo OUT
+	/// mono IN, the output is read from the delay lines (readOutputTaps(), gatherOutputTaps())
 	/// </summary>
 	/// <param name="inputXn"></param>
-	/// <returns> the outputs for each channel </returns>
-	vector<float> reverberator_processAudioSample(float inputXn)
+	void reverberator_processAudioSample(SampleType inputXn)
 	{
-		static vector<float> branches = { 0.0, 0.0, 0.0, 0.0 };
-
+		auto decay = (SampleType)controlParameters.decay;
+		auto damping = (SampleType)controlParameters.damping;
 		for (auto i = 0; i < branches.size(); ++i)
 		{
 			if (i == 0)
 			{
-				branches[i] = reverbModAPF[i].processAudioSample(inputXn + controlParameters.decay * branches[3]);
+				branches[i] = reverbModAPF[i].processAudioSample(inputXn + decay * branches[3]);
 				branches[i] = reverbVibratoV1.processAudioSample(branches[i]);
 			}
 			else
 			{
-				branches[i] = reverbModAPF[i].processAudioSample(inputXn + controlParameters.decay * branches[i - 1]);
+				branches[i] = reverbModAPF[i].processAudioSample(inputXn + decay * branches[i - 1]);
 
 			}
 
@@ -221,47 +340,63 @@ private:
 				branches[i] = reverbVibratoV2.processAudioSample(branches[i]);
 			}
 			branches[i] = reverbAPF[i].processAudioSample(branches[i]);
-			branches[i] = reverbDampingFilter[i].processAudioSample((1 - controlParameters.damping) * branches[i]);
+			branches[i] = reverbDampingFilter[i].processAudioSample((1 - damping) * branches[i]);
 			branches[i] = reverbDelayLine[i].processAudioSample(branches[i]);
 		}
-
-		vector<float> outputYn = readOutputTaps();
-
-		outputYn[0] = outputYn[0];
-		outputYn[1] = outputYn[1];
-		return outputYn;
-
 	}
 
-	vector<float> readOutputTaps()
+	/// <summary>
+	/// Reads the output taps of the last processed sample
+	/// </summary>
+	vector<SampleType> readOutputTaps()
 	{
-		float yL = reverbDelayLine[0].readDelayLine(825);
-		yL += reverbDelayLine[1].readDelayLine(2112);
-		yL -= reverbDelayLine[2].readDelayLine(1630);
-		yL -= reverbDelayLine[3].readDelayLine(3215);
-
-		float yR = reverbDelayLine[2].readDelayLine(825);
-		yR += reverbDelayLine[3].readDelayLine(2069);
-		yR -= reverbDelayLine[1].readDelayLine(1679);
-		yR -= reverbDelayLine[2].readDelayLine(2641);
+		gatherOutputTaps(1);
+		return { gatheredOutput[0][0], gatheredOutput[1][0] };
+	}
 
-		return { 0.16f * yL, 0.16f * yR };
+	/// <summary>
+	/// Gathers the output taps of the last numSamples processed samples into gatheredOutput, one multi-tap read
+	/// per delay line and channel
+	/// </summary>
+	void gatherOutputTaps(int numSamples)
+	{
+		for (int channel = 0; channel < 2; ++channel)
+		{
+			auto* output = gatheredOutput[(size_t)channel].data();
+			std::fill(output, output + numSamples, SampleType(0));
+			for (auto i = 0; i < reverbDelayLine.size(); ++i)
+			{
+				auto& group = outputTapGroups[(size_t)i][(size_t)channel];
+				if (!group.empty())
+					reverbDelayLine[i].gatherDelayLineTaps(group.data(), (int)group.size(), output, numSamples);
+			}
+		}
 	}
 
 	double sampleRate;
+	SampleType branch1 = SampleType(0), branch2 = SampleType(0), branch3 = SampleType(0), branch4 = SampleType(0); // early reflexions feedback branches
+	vector<SampleType> branches = { 0.0, 0.0, 0.0, 0.0 }; // reverberator feedback branches
 	ReverbControlParameters controlParameters;
 	ReverbStructureParameters structureParameters;
 
 	// Early Reflexions blocks
-	vector<ClassicFilters> absorptionFilter;
-	alternateAllPassFilter earlyReflexAPF1, earlyReflexAPF2, earlyReflexAPF3, earlyReflexAPF4;
-	FCombFilter earlyReflexFcomb1, earlyReflexFcomb2;
+	vector<ClassicFiltersT<SampleType>> absorptionFilter;
+	BiquadCoefficientTable absorptionTable; // LPF1 coefficients, computed at reset()
+	alternateAllPassFilterT<SampleType> earlyReflexAPF1, earlyReflexAPF2, earlyReflexAPF3, earlyReflexAPF4;
+	FCombFilterT<SampleType> earlyReflexFcomb1, earlyReflexFcomb2;
 
 	// Reverberator blocks
-	vector<alternateAllPassFilter_modulated> reverbModAPF;
-	vector<alternateAllPassFilter> reverbAPF;
-	vector<delayLine> reverbDelayLine;
-	vector<Biquad> reverbDampingFilter;
-	Vibrato reverbVibratoV1{ 100 };
-	Vibrato reverbVibratoV2{ 100 };
-};
\ No newline at end of file
+	vector<alternateAllPassFilter_modulatedT<SampleType>> reverbModAPF;
+	vector<alternateAllPassFilterT<SampleType>> reverbAPF;
+	vector<delayLineT<SampleType>> reverbDelayLine;
+	std::array<std::array<vector<CircularBufferTap<SampleType>>, 2>, 4> outputTapGroups; // output taps per delay line and channel, set at reset()
+	std::array<std::array<SampleType, maxGatherLength>, 2> gatheredOutput{};
+	vector<BiquadT<SampleType>> reverbDampingFilter;
+	VibratoT<SampleType> reverbVibratoV1{ 100 };
+	VibratoT<SampleType> reverbVibratoV2{ 100 };
+};
+
+/// <summary>
+/// Single precision reverb, the plugin's instantiation
+/// </summary>
+using AbyssalPlateReverb = AbyssalPlateReverbT<float>;
\ No newline at end of file
@@ -69,6 +69,8 @@ void AbyssalPlateReverbAudioProcessor::prepareToPlay(double sampleRate, int samp
 
     reverbAlgorithm.reset(sampleRate);
     reverbAlgorithm.setParameters(controlParameters);
+    silenceDetector.reset(sampleRate);
+    tailLength_s.store(reverbAlgorithm.getTailLengthSeconds());
 }
 
 void AbyssalPlateReverbAudioProcessor::releaseResources()
@@ -105,6 +107,7 @@ bool AbyssalPlateReverbAudioProcessor::isBusesLayoutSupported(const BusesLayout&
 
 void AbyssalPlateReverbAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
+    juce::ScopedNoDenormals noDenormals;
     auto mainInputOutput = getBusBuffer(buffer, true, 0);
     auto BufferIn_L = mainInputOutput.getReadPointer(0);
     auto BufferIn_R = mainInputOutput.getReadPointer(1);
@@ -123,16 +126,18 @@ void AbyssalPlateReverbAudioProcessor::processBlock(juce::AudioBuffer<float>& bu
     // update Reverb Algorithm parameters
     reverbAlgorithm.updateParameters(controlParameters);
 
-    vector<float> input = { 0.0, 0.0};
-
-    for (auto sample = 0;sample < buffer.getNumSamples(); ++sample)
+    // silent input and rung out tail : the reverb is skipped, its output is zero
+    tailLength_s.store(reverbAlgorithm.getTailLengthSeconds());
+    silenceDetector.setTailLength(tailLength_s.load());
+    if (!silenceDetector.processInput(BufferIn_L, BufferIn_R, buffer.getNumSamples()))
     {
-        input[0] = BufferIn_L[sample];
-        input[1] = BufferIn_R[sample];
-        auto yn = reverbAlgorithm.processAudioSample(input);
-        BufferOut_L[sample] = yn[0];
-        BufferOut_R[sample] = yn[1];
+        mainInputOutput.clear();
+        return;
     }
+
+    // processed in place, the output taps are gathered per block
+    reverbAlgorithm.processBlock(BufferIn_L, BufferIn_R, BufferOut_L, BufferOut_R, buffer.getNumSamples());
+    silenceDetector.processOutput(BufferOut_L, BufferOut_R, buffer.getNumSamples());
 }
 
 //==============================================================================
@@ -181,7 +186,7 @@ bool AbyssalPlateReverbAudioProcessor::isMidiEffect() const
 
 double AbyssalPlateReverbAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    return tailLength_s.load();
 }
 
 int AbyssalPlateReverbAudioProcessor::getNumPrograms()
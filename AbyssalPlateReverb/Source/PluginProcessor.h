@@ -70,5 +70,9 @@ private:
     // Reverb algorithm
     AbyssalPlateReverb reverbAlgorithm;
     ReverbControlParameters controlParameters;
+
+    // idle while the input is silent and the tail has rung out
+    SilenceDetector silenceDetector;
+    std::atomic<double> tailLength_s{ 0.0 };
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AbyssalPlateReverbAudioProcessor)
 };
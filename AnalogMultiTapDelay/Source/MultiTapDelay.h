@@ -2,11 +2,18 @@
 
 #include "dsp/combFilterWithFB.h"
 #include <vector>
+#include <array>
 #include "../../dsp_fv/classicFilters.h"
+#include "../../dsp_fv/stateVariableFilter.h"
+#include "../../dsp_fv/saturation.h"
 
 using std::vector;
 
-class FilteredNoise : private ClassicFilters
+/// <summary>
+/// Band limited noise (HPF1 at 6600 Hz then LPF1 at 890 Hz), filtered in SampleType
+/// </summary>
+template <typename SampleType>
+class FilteredNoiseT : private ClassicFiltersT<SampleType>
 {
 public:
     /// <summary>
@@ -32,94 +39,102 @@ public:
     /// <summary>
     /// Generates a filtered noise sample.
     /// </summary>
-    /// <returns>A float representing the filtered noise sample.</returns>
-    float sound()
+    /// <returns>The filtered noise sample.</returns>
+    SampleType sound()
     {
         // Generating a random noise sample and scaling it
-        auto noiseSample = random.nextFloat() * 0.125;
+        auto noiseSample = (SampleType)(random.nextFloat() * 0.125);
         // Processing the noise sample through the high-pass and then low-pass filter
         auto noiseSampleProcessed = level * lopFilter.processAudioSample(hipFilter.processAudioSample(noiseSample));
         return noiseSampleProcessed;
     }
 private:
 
-    ClassicFilters lopFilter;
-    ClassicFilters hipFilter;
-    float level = 0.25f; // The level of the noise
+    ClassicFiltersT<SampleType> lopFilter;
+    ClassicFiltersT<SampleType> hipFilter;
+    SampleType level = SampleType(0.25); // The level of the noise
     juce::Random random; // Random number generator for noise generation
 };
 /// <summary>
-/// The MultiTapDelay algorithm
+/// One tap of the MultiTapDelay : delay, level, pan and tone.
+/// The pan goes from -1 (left) to 1 (right), balanced : both channels are at unity gain in the center.
+/// The tone is the cutoff of a one-pole lowpass on the tap, no filtering at or above maxToneFrequency
 /// </summary>
-class MultiTapDelay : public CombFilterWithFB_stereo
+struct MultiTapParameters
+{
+    double delay_ms = 0.0;
+    float level = 0.0f;
+    float pan = 0.0f;
+    float tone_Hz = 20000.0f;
+};
+
+/// <summary>
+/// The MultiTapDelay algorithm : up to maxNumberOfTaps taps, each with its delay, level, pan and tone.
+/// The taps are set one by one (setTaps()), or as the plugin's geometric series (setTapsDelayTime(), setTapLevels()).
+/// The delay buffers, the filters and the per sample arithmetic are in SampleType, the tap parameters stay in float,
+/// see the MultiTapDelay alias
+/// </summary>
+template <typename SampleType>
+class MultiTapDelayT : public CombFilterWithFB_stereoT<SampleType>
 {
 public:
+    static constexpr int maxNumberOfTaps = 64;
+    static constexpr float maxToneFrequency = 20000.0f;
+
     void setParameters(double pCurrentSampleRate, double pDelayTimeMs, double pRatioBetweenTaps,
         unsigned int pNumberOfTaps, float pDry, float pWet, float pFeedbackGain, float pStereoWidth)
     {
-        currentSampleRate = pCurrentSampleRate;
+        this->currentSampleRate = pCurrentSampleRate;
         timeRatio = pRatioBetweenTaps;
         setNumberOfTaps(pNumberOfTaps);
-        setDelayTimeInMs(pDelayTimeMs);
-        setDryWetLevels(pDry, pWet);
-        setFeedbackGain(pFeedbackGain);
+        this->setDelayTimeInMs(pDelayTimeMs);
+        this->setDryWetLevels(pDry, pWet);
+        this->setFeedbackGain(pFeedbackGain);
         stereoWidth = pStereoWidth;
     }
 
     void createNoise(float pInitialLevel)
     {
-        noiseSource.createFilteredNoise(currentSampleRate);
+        noiseSource.createFilteredNoise(this->currentSampleRate);
         noiseLevel = pInitialLevel;
     }
 
     void setNumberOfTaps(unsigned int N)
      {
-         numberOfTaps = N;
+         numberOfTaps = juce::jmin(N, (unsigned int)maxNumberOfTaps);
      }
     //===============================================================
     // Methods to control the taps 
 
     /// <summary>
-    /// Instantitates the Taps, called at prepareToPlay()
+    /// Instantitates the Taps, called at prepareToPlay() : the first tap at full level, the others silent
     /// </summary>
     void instantiateTaps()
      {
-         for (int tap = 0; tap < numberOfTaps; ++tap)
+         for (int tap = 0; tap < maxNumberOfTaps; ++tap)
          {
-             if (tap == 0)
-             {
-                 tapDelayTimesInSamplesL.push_back(delayTimeInSamples);
-                 tapDelayTimesInSamplesR.push_back(delayTimeInSamples );
-                 tapLevels.push_back(1.0f);
-             }
-             else
-             {
-                 tapDelayTimesInSamplesL.push_back(tapDelayTimesInSamplesL[tap - 1] * timeRatio);
-                 tapDelayTimesInSamplesR.push_back(tapDelayTimesInSamplesR[tap - 1] * timeRatio);
-                 tapLevels.push_back(0.0f);
-             }
+             tapLevels[tap] = tap == 0 ? 1.0f : 0.0f;
+             tapPans[tap] = 0.0f;
+             tapTones_Hz[tap] = maxToneFrequency;
          }
+         toneStatesL.fill(0.0f);
+         toneStatesR.fill(0.0f);
+         setTapsDelayTime();
      }
 
     /// <summary>
-    /// Sets initial delay times
+    /// Sets the delay times as a geometric series : the first tap at the delay time, each next one timeRatio later
     /// </summary>
     void setTapsDelayTime()
     {
         for (unsigned int tap = 0; tap < numberOfTaps; ++tap)
         {
             if (tap == 0)
-            {
-                tapDelayTimesInSamplesL[tap] = delayTimeInSamples;
-                tapDelayTimesInSamplesR[tap] = delayTimeInSamples;
-            }
+                tapDelayTimesInSamples[tap] = this->delayTimeInSamples;
             else
-            {
-                tapDelayTimesInSamplesL[tap] = tapDelayTimesInSamplesL[tap - 1] * timeRatio;
-                tapDelayTimesInSamplesR[tap] = tapDelayTimesInSamplesR[tap - 1] * timeRatio;
-            }
-
+                tapDelayTimesInSamples[tap] = tapDelayTimesInSamples[tap - 1] * timeRatio;
         }
+        updateTapTable();
     }
     /// <summary>
     /// Sets initial tap Levels
@@ -127,10 +142,28 @@ public:
     /// <param name="pTapLevels"></param>
     void setTapLevels(vector<float> pTapLevels)
     {
-        for (auto tap = 0; tap < numberOfTaps; ++tap)
+        for (unsigned int tap = 0; tap < numberOfTaps && tap < pTapLevels.size(); ++tap)
         {
             tapLevels[tap] = pTapLevels[tap];
         }
+        updateTapTable();
+    }
+
+    /// <summary>
+    /// Sets every tap (delay, level, pan, tone), their number is the number of taps (maxNumberOfTaps at most).
+    /// Called after setParameters() : the delays are converted at its sample rate, and limited to the delay buffers
+    /// </summary>
+    void setTaps(const vector<MultiTapParameters>& pTaps)
+    {
+        setNumberOfTaps((unsigned int)pTaps.size());
+        for (unsigned int tap = 0; tap < numberOfTaps; ++tap)
+        {
+            tapDelayTimesInSamples[tap] = (float)(pTaps[tap].delay_ms * this->currentSampleRate / 1000.0);
+            tapLevels[tap] = pTaps[tap].level;
+            tapPans[tap] = pTaps[tap].pan;
+            tapTones_Hz[tap] = pTaps[tap].tone_Hz;
+        }
+        updateTapTable();
     }
 
     //===============================================================
@@ -140,32 +173,69 @@ public:
         noiseLevel = pNoiseLevel;
     }
 
+    // saturation of the feedback path, before the buffer writes : tanh with first order antiderivative antialiasing,
+    // compensated (ADAASaturatorT::setCompensation()) : its small signal response loses 0.5 dB at 10 kHz and 3.3 dB at
+    // 16 kHz per repeat at 48 kHz, 0.7 and 4.6 dB at 44.1 kHz, where the uncompensated second order lost 5.9 dB at 10 kHz
+    // and nulled fs / 3. The clean signal it is blended with goes through the same response, and while the saturation is
+    // on the taps are read the whole samples of its latency (1 of 1.5) earlier : the echoes are half a sample late.
+    // The amount (0 to 1) sets both the drive (up to maxSaturationDrive_dB) and the blend with the clean signal, 0 is a bypass
+
+    /// <summary>
+    /// Sets up the saturation, called at prepareToPlay() : no smoothing
+    /// </summary>
+    void setSaturationParameters(float pSaturation)
+    {
+        for (auto* saturator : { &saturatorL, &saturatorR })
+        {
+            saturator->setType(SaturationType::tanh);
+            saturator->setOrder(1);
+            saturator->setCompensation(true);
+        }
+        saturationAmount.reset(this->currentSampleRate, filterSmoothingTimeSeconds);
+        saturationAmount.setCurrentAndTargetValue(juce::jlimit(0.0f, 1.0f, pSaturation));
+        updateSaturationDrive();
+        saturationActive = saturationAmount.getCurrentValue() > 0.0f;
+        updateTapTable();
+    }
+
+    /// <summary>
+    /// Sets a new target amount, reached over filterSmoothingTimeSeconds by processAudioSample()
+    /// </summary>
+    void updateSaturationParameters(float pSaturation)
+    {
+        saturationAmount.setTargetValue(juce::jlimit(0.0f, 1.0f, pSaturation));
+    }
+
     //===============================================================
     // Methods to set the low pass and highpass filter 
+    // second order TPT state variable filters (Butterworth Q), the cutoff changes are smoothed sample by sample
+
+    /// <summary>
+    /// Sets up the filters, called at prepareToPlay() : no smoothing, the cutoffs jump to their values
+    /// </summary>
     void setFiltersParameters(float lowpassFrequency, float highpassFrequency)
     {
-        // setting Left Side filters 
-        lopFilterL.setFilterType("LPF1");
-        hipFilterL.setFilterType("HPF1");
-        lopFilterL.setCoefficients(lowpassFrequency , 1, currentSampleRate);
-        hipFilterL.setCoefficients(highpassFrequency, 1, currentSampleRate);
+        for (auto* filter : { &lopFilterL, &lopFilterR, &hipFilterL, &hipFilterR })
+            filter->reset(this->currentSampleRate);
 
-        // setting Right Side filters 
-        lopFilterR.setFilterType("LPF1");
-        hipFilterR.setFilterType("HPF1");
-        lopFilterR.setCoefficients(lowpassFrequency, 1, currentSampleRate);
-        hipFilterR.setCoefficients(highpassFrequency, 1, currentSampleRate);
+        lowpassCutoff.reset(this->currentSampleRate, filterSmoothingTimeSeconds);
+        highpassCutoff.reset(this->currentSampleRate, filterSmoothingTimeSeconds);
+        lowpassCutoff.setCurrentAndTargetValue(juce::jmax(minimumCutoff, lowpassFrequency));
+        highpassCutoff.setCurrentAndTargetValue(juce::jmax(minimumCutoff, highpassFrequency));
+
+        lopFilterL.setParameters(lowpassCutoff.getCurrentValue(), filterQualityFactor);
+        lopFilterR.setParameters(lowpassCutoff.getCurrentValue(), filterQualityFactor);
+        hipFilterL.setParameters(highpassCutoff.getCurrentValue(), filterQualityFactor);
+        hipFilterR.setParameters(highpassCutoff.getCurrentValue(), filterQualityFactor);
     }
 
+    /// <summary>
+    /// Sets new target cutoffs, reached over filterSmoothingTimeSeconds by processAudioSample()
+    /// </summary>
     void updateFiltersParameters(float lowpassFrequency, float highpassFrequency)
     {
-        //update Left Side Filter
-        lopFilterL.setCoefficients(lowpassFrequency,  1, currentSampleRate);
-        hipFilterL.setCoefficients(highpassFrequency, 1, currentSampleRate);
-
-        //update Right Side Filter
-        lopFilterR.setCoefficients(lowpassFrequency,  1, currentSampleRate);
-        hipFilterR.setCoefficients(highpassFrequency, 1, currentSampleRate);
+        lowpassCutoff.setTargetValue(juce::jmax(minimumCutoff, lowpassFrequency));
+        highpassCutoff.setTargetValue(juce::jmax(minimumCutoff, highpassFrequency));
     }
 
     /// <summary>
@@ -174,55 +244,316 @@ public:
     /// <param name="inputXnL"></param>
     /// <param name="inputXnR"></param>
     /// <returns> returns the output sample</returns>
-    vector<float> processAudioSample(float inputXnL, float inputXnR) override
+    vector<SampleType> processAudioSample(SampleType inputXnL, SampleType inputXnR) override
     {
-        auto ynDL = 0.0f, ynDR = 0.0f, sum = 0.0f;
-        auto noise = noiseLevel * noiseSource.sound();
-        for (auto tap = 0; tap < numberOfTaps; ++tap)
+        // reading taps
+        processTaps(1);
+
+        vector<SampleType> yn = { SampleType(0), SampleType(0) };
+        processSample(inputXnL, inputXnR, gatheredTapsL[0], gatheredTapsR[0], yn[0], yn[1]);
+        return yn;
+    }
+
+    /// <summary>
+    /// Processes a block of left and right input samples : the taps are read ahead for up to maxGatherLength samples
+    /// (no longer than the shortest tap, they only read samples written before), then filtered and summed.
+    /// Same output as processAudioSample(), the output buffers may be the input ones
+    /// </summary>
+    void processBlock(const float* inputL, const float* inputR, float* outputL, float* outputR, int numSamples)
+    {
+        auto gatherLength = (int)juce::jmin((unsigned int)maxGatherLength, shortestTap);
+        for (int start = 0; start < numSamples; start += gatherLength)
         {
-            // reading taps
-            ynDL += tapLevels[tap] * delayBufferL.readBuffer(tapDelayTimesInSamplesL[tap]);
-            ynDR += tapLevels[tap] * delayBufferR.readBuffer(tapDelayTimesInSamplesR[tap]);
+            auto length = juce::jmin(gatherLength, numSamples - start);
+            updateSaturationState();
+            processTaps(length);
 
-            sum += tapLevels[tap];
+            for (int sample = 0; sample < length; ++sample)
+            {
+                auto index = start + sample;
+                SampleType ynL, ynR;
+                processSample((SampleType)inputL[index], (SampleType)inputR[index], gatheredTapsL[(size_t)sample], gatheredTapsR[(size_t)sample],
+                    ynL, ynR);
+                outputL[index] = (float)ynL;
+                outputR[index] = (float)ynR;
+            }
         }
+    }
 
-        if (sum < 1.0f)
-            sum = 1.0f;
+private:
+    static constexpr int maxGatherLength = 64; // samples of tap outputs gathered per pass
+    static constexpr int laneWidth = 8; // taps filtered and summed together : one AVX register, two SSE ones
 
-        ynDL = ynDL / sum; // normalise level of taps to 1, to avoid excessive feedback
-        ynDR = ynDR / sum;
+    /// <summary>
+    /// Reads and sums the taps of both delay buffers for the next numSamples samples into gatheredTapsL and gatheredTapsR.
+    /// The unfiltered taps are summed by a single multi-tap read per channel, their pan gains in the tap gains ; the
+    /// filtered ones are read into their lanes of the tap frames (one multi-tap read per tap, its two interpolation points),
+    /// then filtered and summed
+    /// </summary>
+    void processTaps(int numSamples)
+    {
+        std::fill(gatheredTapsL.begin(), gatheredTapsL.begin() + numSamples, SampleType(0));
+        std::fill(gatheredTapsR.begin(), gatheredTapsR.begin() + numSamples, SampleType(0));
+        this->delayBufferL.gatherTapsAhead(unfilteredTapsL.data(), numberOfUnfilteredTaps, gatheredTapsL.data(), numSamples);
+        this->delayBufferR.gatherTapsAhead(unfilteredTapsR.data(), numberOfUnfilteredTaps, gatheredTapsR.data(), numSamples);
+        if (numberOfLanes == 0)
+            return;
+
+        for (int tap = 0; tap < numberOfLanes; ++tap)
+        {
+            if (!tapFiltered[tap])
+                continue;
+            readTap(this->delayBufferL, tap, tapFramesL, numSamples);
+            readTap(this->delayBufferR, tap, tapFramesR, numSamples);
+        }
+
+        for (int sample = 0; sample < numSamples; ++sample)
+        {
+            gatheredTapsL[(size_t)sample] += filterAndSumTaps(tapFramesL[(size_t)sample].data(), toneStatesL.data(), tapGainsL.data());
+            gatheredTapsR[(size_t)sample] += filterAndSumTaps(tapFramesR[(size_t)sample].data(), toneStatesR.data(), tapGainsR.data());
+        }
+    }
+
+    /// <summary>
+    /// Reads one tap for numSamples samples into its lane of the tap frames
+    /// </summary>
+    void readTap(CircularBuffer<SampleType>& delayBuffer, int tap, std::array<std::array<SampleType, maxNumberOfTaps>, maxGatherLength>& frames, int numSamples)
+    {
+        std::fill(tapRow.begin(), tapRow.begin() + numSamples, SampleType(0));
+        delayBuffer.gatherTapsAhead(&tapReads[(size_t)(2 * tap)], 2, tapRow.data(), numSamples);
+        for (int sample = 0; sample < numSamples; ++sample)
+            frames[(size_t)sample][(size_t)tap] = tapRow[(size_t)sample];
+    }
+
+    /// <summary>
+    /// Tone filters (TPT one-pole lowpasses) of the filtered taps for one sample (frame : one value per tap), summed
+    /// with their gains. The taps are structure of arrays, processed laneWidth at a time into partial sums : loops over
+    /// the lanes the compiler turns into SIMD instructions
+    /// </summary>
+    SampleType filterAndSumTaps(const SampleType* frame, SampleType* toneStates, const SampleType* gains)
+    {
+        SampleType partialSums[laneWidth] = {};
+        for (int lane = 0; lane < numberOfLanes; lane += laneWidth)
+        {
+            SampleType states[laneWidth];
+            SampleType lowpass[laneWidth];
+            for (int i = 0; i < laneWidth; ++i)
+            {
+                states[i] = toneStates[lane + i];
+                lowpass[i] = TPTOnePoleFilterT<SampleType>::processLowpass(frame[lane + i], toneGains[(size_t)(lane + i)], states[i]);
+            }
+
+            for (int i = 0; i < laneWidth; ++i)
+            {
+                toneStates[lane + i] = states[i];
+                partialSums[i] += gains[lane + i] * lowpass[i];
+            }
+        }
+
+        auto sum = SampleType(0);
+        for (int i = 0; i < laneWidth; ++i)
+            sum += partialSums[i];
+        return sum;
+    }
+
+    /// <summary>
+    /// Everything after the tap reads, for one sample : noise, filters, saturation, buffer writes and output mix.
+    /// ynDL and ynDR are the summed (normalised) taps
+    /// </summary>
+    void processSample(SampleType inputXnL, SampleType inputXnR, SampleType ynDL, SampleType ynDR, SampleType& outputL, SampleType& outputR)
+    {
+        auto noise = noiseLevel * noiseSource.sound();
         ynDL = ynDL + noise;
         ynDR = ynDR + noise;
 
+        // cutoff smoothing, fast coefficient updates while a ramp is running
+        if (lowpassCutoff.isSmoothing())
+        {
+            auto lowpassFrequency = lowpassCutoff.getNextValue();
+            lopFilterL.setCutoffFrequencyFast(lowpassFrequency);
+            lopFilterR.setCutoffFrequencyFast(lowpassFrequency);
+        }
+        if (highpassCutoff.isSmoothing())
+        {
+            auto highpassFrequency = highpassCutoff.getNextValue();
+            hipFilterL.setCutoffFrequencyFast(highpassFrequency);
+            hipFilterR.setCutoffFrequencyFast(highpassFrequency);
+        }
+
         // passes the audio through the filters 
-        auto ynFullWetL = hipFilterL.processAudioSample(lopFilterL.processAudioSample(inputXnL + feedbackGain * ynDL));
-        auto ynFullWetR = hipFilterL.processAudioSample(lopFilterR.processAudioSample(inputXnR + feedbackGain * ynDR));
+        auto ynFullWetL = hipFilterL.processAllOutputs(lopFilterL.processAllOutputs(inputXnL + this->feedbackGain * ynDL).lowpass).highpass;
+        auto ynFullWetR = hipFilterR.processAllOutputs(lopFilterR.processAllOutputs(inputXnR + this->feedbackGain * ynDR).lowpass).highpass;
+
+        // and through the saturation, skipped when off. The clean signal is its linear output, in line with the saturated one
+        if (saturationActive)
+        {
+            if (saturationAmount.isSmoothing())
+            {
+                saturationAmount.getNextValue();
+                updateSaturationDrive();
+            }
+            auto saturatedL = saturatorL.processAudioSample(saturationDrive * ynFullWetL) / saturationDrive;
+            auto saturatedR = saturatorR.processAudioSample(saturationDrive * ynFullWetR) / saturationDrive;
+            auto cleanL = saturatorL.getLinearOutput() / saturationDrive;
+            auto cleanR = saturatorR.getLinearOutput() / saturationDrive;
+            auto amount = (SampleType)saturationAmount.getCurrentValue();
+            ynFullWetL = cleanL + amount * (saturatedL - cleanL);
+            ynFullWetR = cleanR + amount * (saturatedR - cleanR);
+        }
 
         // writes samples to delay buffers
-        delayBufferL.writeBuffer(ynFullWetR);
-        delayBufferR.writeBuffer(ynFullWetL);
+        this->delayBufferL.writeBuffer(flushDenormal(ynFullWetR));
+        this->delayBufferR.writeBuffer(flushDenormal(ynFullWetL));
 
         // generates output samples
-        vector<float> yn = { stereoWidth * (dry * inputXnL + wet * ynDL) + (1 - stereoWidth) * (dry * inputXnR + wet * ynDR),
-                             stereoWidth * (dry * inputXnR + wet * ynDR) + (1 - stereoWidth) * (dry * inputXnL + wet * ynDL) };
-        return yn;
+        auto dry = this->dry, wet = this->wet;
+        outputL = stereoWidth * (dry * inputXnL + wet * ynDL) + (1 - stereoWidth) * (dry * inputXnR + wet * ynDR);
+        outputR = stereoWidth * (dry * inputXnR + wet * ynDR) + (1 - stereoWidth) * (dry * inputXnL + wet * ynDL);
     }
 
-private:
-    FilteredNoise noiseSource;
-    float stereoWidth;
-    float noiseLevel;
+    /// <summary>
+    /// Rebuilds the tap tables from the tap parameters : the levels are normalised by their sum (when above 1, to avoid
+    /// excessive feedback), the silent taps are left out, the unfiltered ones summed directly. The delays are limited
+    /// to the delay buffers, the tone filters are set at the current sample rate
+    /// </summary>
+    void updateTapTable()
+    {
+        auto sum = 0.0f;
+        for (unsigned int tap = 0; tap < numberOfTaps; ++tap)
+            sum += tapLevels[tap];
+        auto normalisation = 1.0f / juce::jmax(1.0f, sum);
+        auto toneBypassFrequency = juce::jmin(maxToneFrequency, 0.5f * (float)this->currentSampleRate);
+        // the interpolated reads reach one sample further than the delay
+        auto maxTapDelay = (float)(juce::jmax(3u, this->delayBufferL.getBufferLength()) - 2);
+        // whole samples only : a half sample fraction would add the interpolation's own lowpass to every repeat
+        auto saturationLatency = saturationActive ? std::floor((float)saturatorL.getLatency()) : 0.0f;
+
+        numberOfUnfilteredTaps = 0;
+        numberOfLanes = 0;
+        shortestTap = (unsigned int)maxGatherLength;
+        for (auto tap = 0; tap < maxNumberOfTaps; ++tap)
+        {
+            auto level = tap < (int)numberOfTaps ? normalisation * tapLevels[tap] : 0.0f;
+            auto tone = juce::jmax(1.0f, tapTones_Hz[tap]);
+            auto filtered = level != 0.0f && tone < toneBypassFrequency;
+            if (!filtered || !tapFiltered[tap])
+            {
+                // the tone filter starts from silence
+                toneStatesL[tap] = toneStatesR[tap] = SampleType(0);
+            }
+            tapFiltered[tap] = filtered;
+            if (!filtered)
+            {
+                // empty lane : no input, no output
+                tapGainsL[tap] = tapGainsR[tap] = SampleType(0);
+                toneGains[tap] = SampleType(0);
+                for (auto sample = 0; sample < maxGatherLength; ++sample)
+                    tapFramesL[sample][tap] = tapFramesR[sample][tap] = SampleType(0);
+            }
+            if (level == 0.0f)
+                continue;
+
+            // linear interpolation, as readBuffer(double) : two integer taps. The saturation delays the writes
+            auto delay = juce::jlimit(1.0f, maxTapDelay, tapDelayTimesInSamples[tap] - saturationLatency);
+            auto integerDelay = (unsigned int)delay;
+            auto fraction = delay - (float)integerDelay;
+            shortestTap = juce::jmin(shortestTap, integerDelay);
+
+            // balanced pan
+            auto pan = juce::jlimit(-1.0f, 1.0f, tapPans[tap]);
+            auto gainL = level * juce::jmin(1.0f, 1.0f - pan);
+            auto gainR = level * juce::jmin(1.0f, 1.0f + pan);
+
+            if (!filtered)
+            {
+                unfilteredTapsL[numberOfUnfilteredTaps] = { integerDelay, (SampleType)(gainL * (1.0f - fraction)) };
+                unfilteredTapsR[numberOfUnfilteredTaps++] = { integerDelay, (SampleType)(gainR * (1.0f - fraction)) };
+                unfilteredTapsL[numberOfUnfilteredTaps] = { integerDelay + 1, (SampleType)(gainL * fraction) };
+                unfilteredTapsR[numberOfUnfilteredTaps++] = { integerDelay + 1, (SampleType)(gainR * fraction) };
+                continue;
+            }
+
+            tapReads[2 * tap] = { integerDelay, (SampleType)(1.0f - fraction) };
+            tapReads[2 * tap + 1] = { integerDelay + 1, (SampleType)fraction };
+            tapGainsL[tap] = gainL;
+            tapGainsR[tap] = gainR;
+
+            toneGains[tap] = TPTOnePoleFilterT<SampleType>::computeGain(tone, this->currentSampleRate);
+            numberOfLanes = tap + 1;
+        }
+        numberOfLanes = (numberOfLanes + laneWidth - 1) / laneWidth * laneWidth;
+    }
+
+    /// <summary>
+    /// Once per gathered block, before the tap reads : the saturation is on while its amount is above 0 or moving.
+    /// Switching it on or off moves the taps by its latency, the saturators restart from silence
+    /// </summary>
+    void updateSaturationState()
+    {
+        auto active = saturationAmount.getCurrentValue() > 0.0f || saturationAmount.isSmoothing();
+        if (active == saturationActive)
+            return;
+        saturationActive = active;
+        saturatorL.reset();
+        saturatorR.reset();
+        updateTapTable();
+    }
+
+    void updateSaturationDrive()
+    {
+        saturationDrive = (SampleType)juce::Decibels::decibelsToGain(maxSaturationDrive_dB * saturationAmount.getCurrentValue());
+    }
+
+    FilteredNoiseT<SampleType> noiseSource;
+    SampleType stereoWidth;
+    SampleType noiseLevel;
 	double timeRatio;
-    vector<float> tapLevels;
-    vector<float> tapDelayTimesInSamplesL;
-    vector<float> tapDelayTimesInSamplesR;
     unsigned int numberOfTaps = 4;
 
+    // taps, structure of arrays : one value per tap in each
+    std::array<float, maxNumberOfTaps> tapDelayTimesInSamples{};
+    std::array<float, maxNumberOfTaps> tapLevels{};
+    std::array<float, maxNumberOfTaps> tapPans{};
+    std::array<float, maxNumberOfTaps> tapTones_Hz{};
+
+    // derived by updateTapTable() : two integer reads per (interpolated) tap.
+    // Unfiltered taps, with their level and pan gains
+    std::array<CircularBufferTap<SampleType>, 2 * maxNumberOfTaps> unfilteredTapsL{}, unfilteredTapsR{};
+    int numberOfUnfilteredTaps = 0;
+    // Filtered taps, one lane each : reads, pan gains, tone filters gains and states (TPT one-pole lowpasses)
+    std::array<CircularBufferTap<SampleType>, 2 * maxNumberOfTaps> tapReads{};
+    std::array<bool, maxNumberOfTaps> tapFiltered{};
+    std::array<SampleType, maxNumberOfTaps> tapGainsL{}, tapGainsR{};
+    std::array<SampleType, maxNumberOfTaps> toneGains{};
+    std::array<SampleType, maxNumberOfTaps> toneStatesL{}, toneStatesR{};
+    int numberOfLanes = 0; // the last filtered tap, rounded up to laneWidth
+    unsigned int shortestTap = 1;
+
+    // tap reads of a gathered block : one frame (a value per tap) per sample, and their sums
+    std::array<std::array<SampleType, maxNumberOfTaps>, maxGatherLength> tapFramesL{}, tapFramesR{};
+    std::array<SampleType, maxGatherLength> tapRow{};
+    std::array<SampleType, maxGatherLength> gatheredTapsL{}, gatheredTapsR{};
+
     // Each channel requires its own signal processing  chain, one filter / channel, one saturation / channel, etc..
     // except the noise which is just an added signal, input signal does not pass through it processing block
 
-    ClassicFilters lopFilterL, lopFilterR;
-    ClassicFilters hipFilterL, hipFilterR;
+    TPTStateVariableFilterT<SampleType> lopFilterL, lopFilterR;
+    TPTStateVariableFilterT<SampleType> hipFilterL, hipFilterR;
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> lowpassCutoff, highpassCutoff;
+    static constexpr double filterQualityFactor = 0.707;
+    static constexpr double filterSmoothingTimeSeconds = 0.05;
+    static constexpr float minimumCutoff = 1.0f; // multiplicative smoothing needs strictly positive values
+
+    ADAASaturatorT<SampleType> saturatorL, saturatorR;
+    bool saturationActive = false; // the saturators are in the loop, see updateSaturationState()
+    juce::SmoothedValue<float> saturationAmount;
+    SampleType saturationDrive = SampleType(1);
+    static constexpr float maxSaturationDrive_dB = 12.0f;
 };
 
+/// <summary>
+/// Single precision delay, the plugin's instantiation
+/// </summary>
+using FilteredNoise = FilteredNoiseT<float>;
+using MultiTapDelay = MultiTapDelayT<float>;
+
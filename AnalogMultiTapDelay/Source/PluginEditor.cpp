@@ -16,7 +16,7 @@ AnalogMultiTapDelayAudioProcessorEditor::AnalogMultiTapDelayAudioProcessorEditor
 {
 
 
-   setSize (800, 360);
+   setSize (800, 370);
    setLookAndFeel(new abschallLookAndFeel_Sliders(juce::Colours::limegreen,juce::Colours::green));
    //==============================================================================
    addAndMakeVisible( delayPot);
@@ -30,7 +30,7 @@ AnalogMultiTapDelayAudioProcessorEditor::AnalogMultiTapDelayAudioProcessorEditor
    //addAndMakeVisible( inputLevelPot);
    addAndMakeVisible( feedbackPot);
    addAndMakeVisible( noiseLevelPot);
-   //addAndMakeVisible( saturationPot);
+   addAndMakeVisible( saturationPot);
    addAndMakeVisible( lowPassPot);
    addAndMakeVisible( highPassPot);
    
@@ -54,7 +54,7 @@ AnalogMultiTapDelayAudioProcessorEditor::AnalogMultiTapDelayAudioProcessorEditor
    //inputLevelPot.createPot(100, 0, 100, "%", heightPot);
    feedbackPot.createPot(100, 0, 100, " %", heightPot);
    noiseLevelPot.createPot(0, 0, 1, "", smallPotsHeight);
-   //saturationPot.createPot(0, 0, 1, "", smallPotsHeight);
+   saturationPot.createPot(0, 0, 1, "", smallPotsHeight);
    lowPassPot.createPot(15000, 20, 15000, " Hz", smallPotsHeight);
    highPassPot.createPot(20, 20, 15000, " Hz", smallPotsHeight);
 
@@ -85,7 +85,7 @@ AnalogMultiTapDelayAudioProcessorEditor::AnalogMultiTapDelayAudioProcessorEditor
  // addAndMakeVisible( inputLevelLabel);
   addAndMakeVisible( feedbackLabel);
   addAndMakeVisible( noiseLevelLabel);
-  //addAndMakeVisible( saturationLabel);
+  addAndMakeVisible( saturationLabel);
   addAndMakeVisible( lowPassLabel);
   addAndMakeVisible( highPassLabel);
 
@@ -163,4 +163,5 @@ void AnalogMultiTapDelayAudioProcessorEditor::resized()
 
     lowPassPot.setBounds(4* widthBox + smallPotsWidth, heightLabel, smallPotsWidth, smallPotsHeight);;
     highPassPot.    setBounds(4 * widthBox + smallPotsWidth, heightBox, smallPotsWidth, smallPotsHeight);;
+    saturationPot.  setBounds(4 * widthBox + smallPotsWidth / 2, 2 * heightBox - heightLabel, smallPotsWidth, smallPotsHeight);
 }
@@ -77,6 +77,7 @@ void AnalogMultiTapDelayAudioProcessor::prepareToPlay(double sampleRate, int sam
     feedback=   parameters.getRawParameterValue("feedback");
     timeRatio = parameters.getRawParameterValue("timeRatio");
     noiseLevel= parameters.getRawParameterValue("noiseLevel");
+    saturation = parameters.getRawParameterValue("saturation");
     lowPass =   parameters.getRawParameterValue("lowPass");
     highPass =  parameters.getRawParameterValue("highPass");
     width = parameters.getRawParameterValue("width");
@@ -105,6 +106,7 @@ void AnalogMultiTapDelayAudioProcessor::prepareToPlay(double sampleRate, int sam
     delayAlgorithm.createDelayBuffer((float)currentSampleRate, maxDelayTime);
     delayAlgorithm.createNoise(0.0);
     delayAlgorithm.setFiltersParameters(lowPassCopy, highPassCopy);
+    delayAlgorithm.setSaturationParameters(saturation->load());
 
     // starting a timer which wills top when the delay buffer is filled for the first time 
     startTimer(maxDelayTime*1.2);
@@ -144,6 +146,7 @@ bool AnalogMultiTapDelayAudioProcessor::isBusesLayoutSupported(const BusesLayout
 
 void AnalogMultiTapDelayAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
+    juce::ScopedNoDenormals noDenormals;
     auto mainInputOutput = getBusBuffer(buffer, true, 0);
     auto BufferIn_L = mainInputOutput.getReadPointer(0);
     auto BufferIn_R = mainInputOutput.getReadPointer(1);
@@ -176,9 +179,7 @@ void AnalogMultiTapDelayAudioProcessor::processBlock(juce::AudioBuffer<float>& b
     delayAlgorithm.setTapsDelayTime();
     delayAlgorithm.setNoiseLevel(noiseLevelCopy);
     delayAlgorithm.updateFiltersParameters(lowPassCopy, highPassCopy);
-
-    float rightIn = 0.0;
-    float leftIn = 0.0;
+    delayAlgorithm.updateSaturationParameters(saturation->load());
 
     // Processing audio 
     //if (delayBufferFilled == false)
@@ -192,14 +193,8 @@ void AnalogMultiTapDelayAudioProcessor::processBlock(juce::AudioBuffer<float>& b
     //    }
     //else
         // once buffer has been filled, proceed to routine audio processing
-        for (auto sample = 0;sample < buffer.getNumSamples(); ++sample)
-        {
-            rightIn = BufferIn_L[sample];
-            leftIn = BufferIn_R[sample];
-            auto yn = delayAlgorithm.processAudioSample(leftIn,rightIn);
-            BufferOut_L[sample] = yn[0];
-            BufferOut_R[sample] = yn[1];
-        }
+        // (the input channels are swapped, the taps are gathered per block)
+        delayAlgorithm.processBlock(BufferIn_R, BufferIn_L, BufferOut_L, BufferOut_R, buffer.getNumSamples());
 }
 
 
@@ -1,12 +1,15 @@
 #pragma once
 
-#include "circularBuffer.h"
+#include "../../../dsp_fv/circularBuffer.h"
+#include "../../../dsp_fv/denormals.h"
 
 /// <summary>
 /// Comb Filter (one channel) with Feedback, inherits from the CircularBuffer class.
 /// Public members are: dry, wet (mix), and feedback (gain) ratio of output signal added to input in the feedback path.
+/// Samples and gains are in SampleType, see the CombFilterWithFB alias.
 /// </summary>
-class CombFilterWithFB : public CircularBuffer<float>
+template <typename SampleType>
+class CombFilterWithFBT : public CircularBuffer<SampleType>
 {
 public:
     /// <summary>
@@ -19,7 +22,7 @@ public:
     /// <param name="pWet"></param>
     /// <param name="pFeedbackGain"></param>
     virtual void setParameters(double pCurrentSampleRate, double pDelayTimeMs,
-        float pDry, float pWet, float pFeedbackGain)
+        SampleType pDry, SampleType pWet, SampleType pFeedbackGain)
     {
         currentSampleRate = pCurrentSampleRate;
         setDelayTimeInMs(pDelayTimeMs);
@@ -61,12 +64,12 @@ public:
     //    vector<float> yn = { dry * inputXnL + wet * ynD };
     //    return yn;
     //}
-    virtual float processAudioSample(float inputXn)
+    virtual SampleType processAudioSample(SampleType inputXn)
     {
         auto ynD = delayBuffer.readBuffer(delayTimeInSamples);
         auto ynFullWet = inputXn + feedbackGain * ynD;
-        delayBuffer.writeBuffer(ynFullWet);
-        float yn = dry * inputXn + wet * ynD;
+        delayBuffer.writeBuffer(flushDenormal(ynFullWet));
+        SampleType yn = dry * inputXn + wet * ynD;
         return yn;
     }
 
@@ -90,7 +93,7 @@ public:
     /// </summary>
     /// <param name="pDry"></param>
     /// <param name="pWet"></param>
-    void setDryWetLevels(float pDry, float pWet)
+    void setDryWetLevels(SampleType pDry, SampleType pWet)
     {
         dry = pDry;
         wet = pWet;
@@ -99,22 +102,22 @@ public:
     /// Set the feedback ratio (float number between 0 and 1).
     /// </summary>
     /// <param name="feedback"></param>
-    void setFeedbackGain(float feedback)
+    void setFeedbackGain(SampleType feedback)
     {
         feedbackGain = feedback;
     }
 
     // Public member variables
-    float dry;
-    float wet;
-    float feedbackGain;
+    SampleType dry;
+    SampleType wet;
+    SampleType feedbackGain;
 
 protected:
 
     double bufferLengthMsec;
     unsigned int bufferLength; // in samples
     unsigned int delayTimeInSamples;
-    CircularBuffer delayBuffer;
+    CircularBuffer<SampleType> delayBuffer;
     double currentSampleRate;
     double samplePerMsec;
 private:
@@ -124,8 +127,10 @@ private:
 /// <summary>
 /// Stereo Comb Filter (R and L channels) with Feedback, inherits from the CircularBuffer class.
 /// Public members are: dry, wet (mix), and feedback (gain) ratio of the output signal added to input.
+/// Samples and gains are in SampleType, see the CombFilterWithFB_stereo alias.
 /// </summary>
-class CombFilterWithFB_stereo : public CircularBuffer<float>
+template <typename SampleType>
+class CombFilterWithFB_stereoT : public CircularBuffer<SampleType>
 {
 public:
     /// <summary>
@@ -138,7 +143,7 @@ public:
     /// <param name="pWet"></param>
     /// <param name="pFeedbackGain"></param>
     virtual void setParameters(double pCurrentSampleRate, double pDelayTimeMs,
-        float pDry, float pWet, float pFeedbackGain)
+        SampleType pDry, SampleType pWet, SampleType pFeedbackGain)
     {
         currentSampleRate = pCurrentSampleRate;
         setDelayTimeInMs(pDelayTimeMs);
@@ -172,15 +177,15 @@ public:
     /// </summary>
     /// <param name="inputXn"></param>
     /// <returns></returns>
-    virtual vector<float> processAudioSample(float inputXnL, float inputXnR)
+    virtual vector<SampleType> processAudioSample(SampleType inputXnL, SampleType inputXnR)
     {
         auto ynDL = delayBufferL.readBuffer(delayTimeInSamples);
         auto ynDR = delayBufferR.readBuffer(delayTimeInSamples);
         auto ynFullWetL = inputXnL + feedbackGain * ynDL;
         auto ynFullWetR = inputXnR + feedbackGain * ynDR;
-        delayBufferL.writeBuffer(ynFullWetR);
-        delayBufferR.writeBuffer(ynFullWetL);
-        vector<float> yn = { dry * inputXnL + wet * ynDL,dry * inputXnR + wet * ynDR };
+        delayBufferL.writeBuffer(flushDenormal(ynFullWetR));
+        delayBufferR.writeBuffer(flushDenormal(ynFullWetL));
+        vector<SampleType> yn = { dry * inputXnL + wet * ynDL,dry * inputXnR + wet * ynDR };
         return yn;
     }
 
@@ -206,7 +211,7 @@ public:
     /// </summary>
     /// <param name="pDry"></param>
     /// <param name="pWet"></param>
-    void setDryWetLevels(float pDry, float pWet)
+    void setDryWetLevels(SampleType pDry, SampleType pWet)
     {
         dry = pDry;
         wet = pWet;
@@ -215,24 +220,30 @@ public:
     /// Set the feedback ratio (float number between 0 and 1).
     /// </summary>
     /// <param name="feedback"></param>
-    void setFeedbackGain(float feedback)
+    void setFeedbackGain(SampleType feedback)
     {
         feedbackGain = feedback;
     }
 
     // Public member variables
-    float dry;
-    float wet;
-    float feedbackGain;
+    SampleType dry;
+    SampleType wet;
+    SampleType feedbackGain;
 
 protected:
     double bufferLengthMsec;
     unsigned int bufferLength; // in samples
     unsigned int delayTimeInSamples;
-    CircularBuffer delayBufferR;
-    CircularBuffer delayBufferL;
+    CircularBuffer<SampleType> delayBufferR;
+    CircularBuffer<SampleType> delayBufferL;
     double currentSampleRate;
     double samplePerMsec;
 private:
 
 };
+
+/// <summary>
+/// Single precision comb filters, the plugin's instantiations
+/// </summary>
+using CombFilterWithFB = CombFilterWithFBT<float>;
+using CombFilterWithFB_stereo = CombFilterWithFB_stereoT<float>;
@@ -34,6 +34,7 @@
 
 #pragma once
 #include <JuceHeader.h>
+#include <array>
 
 class PinkNoise {
 private:
@@ -185,71 +186,150 @@ class NoiseFilter {
 private:
     // DC blocker variables
     float R;
-    float y = 0, xm1 = 0, ym1 = 0;
+    float xm1 = 0, ym1 = 0;
     
     // smoothing filter variables
-    // N - smooth length
-    // i - counter for initialization
-    int N, i = 0;
-    // opS - output of smoothing filter
-    // sub - subsitution : x[n] - x[n - N]
-    // acc - accumulator
-    float sub, acc;
-    // mem - memory for x[i - N] values
-    std::queue<float> mem;
-    
-    // use to clear memory queue on changes to N
-    void clear( std::queue<float> &q )
+    // maxN - capacity of the sample memory, a power of 2 so that the ring index can be masked
+    static constexpr int maxN = 256;
+    static constexpr int memMask = maxN - 1;
+    // N - smooth length, invN - 1/N
+    int N;
+    float invN;
+    // acc - accumulator, holds the sum of the last N input samples
+    float acc = 0.0f;
+    // mem - ring buffer memory for the x[n - N] values, memIndex - next write position
+    std::array<float, maxN> mem {};
+    int memIndex = 0;
+    // work - scratch used by the block versions, sized once in prepare()
+    std::vector<float> work;
+    
+    // use to clear the sample memory on changes to N
+    void clear()
+    {
+        mem.fill(0.0f);
+        memIndex = 0;
+        acc = 0.0f;
+    }
+    
+    // recomputes the accumulator from the memory, so that rounding errors
+    // of the running sum cannot build up over long runs
+    void refreshAccumulator()
     {
-       std::queue<float> empty;
-       std::swap( q, empty );
+        float sum = 0.0f;
+        for (int k = 1; k <= N; k++)
+            sum += mem[(memIndex - k) & memMask];
+        acc = sum;
     }
     
 public:
     // constructor
-    NoiseFilter(float R_in = 0.99, int N_in = 4) : R(R_in), N(N_in) {}
+    NoiseFilter(float R_in = 0.99, int N_in = 4) : R(R_in)
+    {
+        N = juce::jlimit(1, maxN, N_in);
+        invN = 1.0f / N;
+    }
+    
+    // allocates the scratch memory used by the block functions,
+    // call from prepareToPlay() so that no allocation happens on the audio thread
+    void prepare (int maxBlockSize)
+    {
+        work.assign((size_t) juce::jmax(1, maxBlockSize), 0.0f);
+        xm1 = 0; ym1 = 0;
+        clear();
+    }
     
     // DC blocking filter
     // https://www.dsprelated.com/freebooks/filters/DC_Blocker.html
     float dc_blocking_filter (float ip) {
-        y = ip - xm1 + R * ym1;
+        float y = ip - xm1 + R * ym1;
         xm1 = ip;
         ym1 = y;
         return y;
     }
     
+    // DC blocking filter, block version (in place)
+    void dc_blocking_filter (float* data, int numSamples) {
+        float x1 = xm1, y1 = ym1;
+        for (int n = 0; n < numSamples; n++) {
+            float x = data[n];
+            y1 = x - x1 + R * y1;
+            x1 = x;
+            data[n] = y1;
+        }
+        xm1 = x1;
+        ym1 = y1;
+    }
+    
     // moving average/smoothing filter
     // https://zipcpu.com/dsp/2017/10/16/boxcar.html
     float smoothing_filter (float ip) {
-        // init
-        if (i < N) {
-            mem.push(ip); // load memory buffer
-            //opS = ip;
-            i++;
-            return ip;
-        }
-        else {
-            // update sample memory buffer
-            mem.push(ip);
-            // filter
-            //sub = ip - mem;
-            sub = ip - mem.front();
-            acc += sub;
-            // trim sample memory buffer
-            mem.pop();
-        }
+        // x[n - N] is read before x[n] is written to the memory
+        float oldest = mem[(memIndex - N) & memMask];
+        mem[memIndex] = ip;
+        memIndex = (memIndex + 1) & memMask;
+        // filter
+        acc += ip - oldest;
+        if (memIndex == 0)
+            refreshAccumulator();
         // return avg/N
-        return acc/N;
+        return acc * invN;
+    }
+    
+    // moving average/smoothing filter, block version (in place)
+    // y[n] = (P[n] - P[n - N])/N with P the prefix sum of the input:
+    // the differences x[n] - x[n - N] are computed first in a loop without dependencies
+    // (vectorized by the compiler), only the prefix sum of those differences is serial
+    void smoothing_filter (float* data, int numSamples) {
+        const int capacity = (int) work.size();
+        jassert (capacity > 0); // prepare() must be called first
+        
+        while (numSamples > 0) {
+            const int n = juce::jmin(numSamples, capacity);
+            float* d = work.data();
+            
+            // differences against the samples still held in memory...
+            const int fromMem = juce::jmin(n, N);
+            for (int k = 0; k < fromMem; k++)
+                d[k] = data[k] - mem[(memIndex - N + k) & memMask];
+            // ... and against the current block
+            for (int k = N; k < n; k++)
+                d[k] = data[k] - data[k - N];
+            
+            // update the sample memory with the last input samples of the block
+            const int toMem = juce::jmin(n, maxN);
+            for (int k = n - toMem; k < n; k++)
+                mem[(memIndex + k) & memMask] = data[k];
+            memIndex = (memIndex + n) & memMask;
+            
+            // prefix sum
+            float a = acc;
+            for (int k = 0; k < n; k++) {
+                a += d[k];
+                data[k] = a * invN;
+            }
+            refreshAccumulator();
+            
+            data += n;
+            numSamples -= n;
+        }
+    }
+    
+    // DC blocker followed by the smoothing filter, block version (in place)
+    void process (float* data, int numSamples) {
+        dc_blocking_filter(data, numSamples);
+        smoothing_filter(data, numSamples);
     }
     
     // sets for UI control
     void setDCfiltConst (float sliderVal) { R = (sliderVal < 1.0) ? sliderVal : R; } // if ip < 1, pass to R, else leave it
     void setSmoothLength (int sliderVal) {
+        sliderVal = juce::jlimit(1, maxN, sliderVal);
+        if (sliderVal == N)
+            return;
         N = sliderVal;
-        // reset memory buffer counter
-        i = 0;
-        // clear the memory buffer
-        clear(mem);
+        invN = 1.0f / N;
+        // clear the sample memory and the accumulator
+        clear();
     }
     
 };
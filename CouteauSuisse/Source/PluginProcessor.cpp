@@ -23,17 +23,41 @@ CouteauSuisseAudioProcessor::CouteauSuisseAudioProcessor()
    parameters(*this, nullptr, juce::Identifier::Identifier("CouteauSuisseVTS"),createParameterLayout())
 #endif
 {
+    // test signal tables are rebuilt on the message thread
+    startTimerHz(10);
 }
 
 CouteauSuisseAudioProcessor::~CouteauSuisseAudioProcessor()
 {
+    stopTimer();
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout CouteauSuisseAudioProcessor::createParameterLayout()
 {
     juce::AudioProcessorValueTreeState::ParameterLayout layout;
     layout.add(std::make_unique<juce::AudioParameterFloat>("level", "Level", 0.0f, 1.0f, 0.0f));
-    layout.add(std::make_unique<juce::AudioParameterInt>("select", "Select", 0, 2, 0));
+    // 0 : white, 1 : pink, 2 : brown, 3 : sine, 4 : sweep, 5 : MLS, 6 : impulse, 7 : multitone
+    layout.add(std::make_unique<juce::AudioParameterInt>("select", "Select", 0, 7, 0));
+    layout.add(std::make_unique<juce::AudioParameterInt>("smoothing", "Smoothing", 1, 64, 1));
+    layout.add(std::make_unique<juce::AudioParameterBool>("dcBlock", "DC Block", false));
+
+    // test signals
+    layout.add(std::make_unique<juce::AudioParameterBool>("play", "Play", false));
+    layout.add(std::make_unique<juce::AudioParameterBool>("loop", "Loop", false));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("frequency", "Frequency",
+        juce::NormalisableRange<float>(20.0f, 20000.0f, 0.0f, 0.25f), 1000.0f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("sweepStart", "Sweep Start",
+        juce::NormalisableRange<float>(10.0f, 1000.0f, 0.0f, 0.3f), 20.0f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("sweepEnd", "Sweep End",
+        juce::NormalisableRange<float>(1000.0f, 24000.0f, 0.0f, 0.5f), 20000.0f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("sweepLength", "Sweep Length", 0.1f, 30.0f, 5.0f));
+    layout.add(std::make_unique<juce::AudioParameterInt>("mlsOrder", "MLS Order", 8, 20, 16));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("impulsePeriod", "Impulse Period", 0.0f, 10.0f, 0.0f));
+    layout.add(std::make_unique<juce::AudioParameterInt>("tones", "Tones", 1, 64, 16));
+
+    // impulse response
+    layout.add(std::make_unique<juce::AudioParameterFloat>("irMix", "IR Mix", 0.0f, 1.0f, 0.0f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("irGain", "IR Gain", -24.0f, 24.0f, 0.0f));
 
     return layout;
 
@@ -107,6 +131,15 @@ void CouteauSuisseAudioProcessor::prepareToPlay (double sampleRate, int samplesP
 {
     // Use this method as the place to do any pre-playback
     // initialisation that you need..
+    noiseFilter.prepare(samplesPerBlock);
+    generator.reset(sampleRate);
+    generator.setParameters(getGeneratorParameters());
+
+    // zero latency : 128 taps direct form head, the long partitions are computed by background threads
+    // (waited for when rendering offline)
+    convolutionReverb.setNonRealtime(isNonRealtime());
+    convolutionReverb.reset(sampleRate, 128, true);
+    setLatencySamples(convolutionReverb.getLatencySamples());
 }
 
 void CouteauSuisseAudioProcessor::releaseResources()
@@ -141,38 +174,133 @@ bool CouteauSuisseAudioProcessor::isBusesLayoutSupported (const BusesLayout& lay
 }
 #endif
 
+SignalGeneratorParameters CouteauSuisseAudioProcessor::getGeneratorParameters()
+{
+    SignalGeneratorParameters params;
+    auto select = (int) parameters.getRawParameterValue("select")->load();
+    switch (select)
+    {
+    case 4: params.signalType = testSignalType::kExponentialSweep; break;
+    case 5: params.signalType = testSignalType::kMLS; break;
+    case 6: params.signalType = testSignalType::kImpulse; break;
+    case 7: params.signalType = testSignalType::kMultitone; break;
+    default: params.signalType = testSignalType::kSine; break;
+    }
+    params.frequency_Hz = parameters.getRawParameterValue("frequency")->load();
+    params.sweepStart_Hz = parameters.getRawParameterValue("sweepStart")->load();
+    params.sweepEnd_Hz = parameters.getRawParameterValue("sweepEnd")->load();
+    params.sweepLength_s = parameters.getRawParameterValue("sweepLength")->load();
+    params.mlsOrder = (unsigned int) parameters.getRawParameterValue("mlsOrder")->load();
+    params.impulsePeriod_s = parameters.getRawParameterValue("impulsePeriod")->load();
+    params.numberOfTones = (unsigned int) parameters.getRawParameterValue("tones")->load();
+    params.loop = parameters.getRawParameterValue("loop")->load() > 0.5f;
+    return params;
+}
+
+void CouteauSuisseAudioProcessor::timerCallback()
+{
+    // table building allocates, it is kept away from the audio thread
+    generator.setParameters(getGeneratorParameters());
+}
+
 void CouteauSuisseAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
+    juce::ScopedNoDenormals noDenormals;
     auto mainInputOutput = getBusBuffer(buffer, true, 0);
-    auto BufferIn_L = mainInputOutput.getReadPointer(0);
-    auto BufferIn_R = mainInputOutput.getReadPointer(1);
     auto BufferOut_L = mainInputOutput.getWritePointer(0);
     auto BufferOut_R = mainInputOutput.getWritePointer(1);
-    
-    float noiseSelect = parameters.getRawParameterValue("select")->load();
+    auto numSamples = buffer.getNumSamples();
+
+    int select = (int) parameters.getRawParameterValue("select")->load();
     float levelSliderValue = parameters.getRawParameterValue("level")->load();
 
-    float noiseSample;
-    for (auto sample = 0;sample < buffer.getNumSamples(); ++sample)
+    if (select <= 2)
     {
-;
-        if (noiseSelect == 0)
+        int smoothLength = (int) parameters.getRawParameterValue("smoothing")->load();
+        bool dcBlock = parameters.getRawParameterValue("dcBlock")->load() > 0.5f;
+
+        // the noise type is selected once per block
+        switch (select)
         {
-            noiseSample = random.nextFloat();
+        case 0:
+            for (auto sample = 0; sample < numSamples; ++sample)
+                BufferOut_L[sample] = random.nextFloat();
+            break;
+        case 1:
+            for (auto sample = 0; sample < numSamples; ++sample)
+                BufferOut_L[sample] = nP.generate();
+            break;
+        default:
+            for (auto sample = 0; sample < numSamples; ++sample)
+                BufferOut_L[sample] = nB.generate();
+            break;
         }
-        if (noiseSelect == 1)
+
+        // noise shaping : DC blocker and smoothing filter, processed on the whole block.
+        // Both off by default (no DC block, smoothing length 1) : the noise is left untouched
+        noiseFilter.setSmoothLength(smoothLength);
+        if (dcBlock)
+            noiseFilter.process(BufferOut_L, numSamples);
+        else if (smoothLength > 1)
+            noiseFilter.smoothing_filter(BufferOut_L, numSamples);
+    }
+    else
+    {
+        // the play parameter starts / stops at the block start
+        bool play = parameters.getRawParameterValue("play")->load() > 0.5f;
+        if (play != wasPlaying)
         {
-            noiseSample = nP.generate();
+            if (play)
+                generator.start();
+            else
+                generator.stop();
+            wasPlaying = play;
         }
-        if (noiseSelect == 2)
+
+        // note on / note off start and stop the test signal on their exact sample : the block is split at each event
+        int position = 0;
+        for (const auto metadata : midiMessages)
         {
-            noiseSample = nB.generate();
+            auto message = metadata.getMessage();
+            if (!message.isNoteOn() && !message.isNoteOff())
+                continue;
+            auto eventPosition = juce::jlimit(position, numSamples, metadata.samplePosition);
+            generator.renderBlock(BufferOut_L + position, eventPosition - position);
+            position = eventPosition;
+            if (message.isNoteOn())
+                generator.start();
+            else
+                generator.stop();
         }
-        BufferOut_L[sample] = noiseSample * levelSliderValue;
-        BufferOut_R[sample] = noiseSample * levelSliderValue;
+        generator.renderBlock(BufferOut_L + position, numSamples - position);
+    }
+
+    std::copy(BufferOut_L, BufferOut_L + numSamples, BufferOut_R);
+
+    // impulse response, when one is loaded
+    float irMix = parameters.getRawParameterValue("irMix")->load();
+    if (irMix > 0.0f)
+    {
+        convolutionReverb.setParameters({ irMix, parameters.getRawParameterValue("irGain")->load() });
+        convolutionReverb.processBlock(BufferOut_L, BufferOut_R, numSamples);
+    }
+
+    for (auto sample = 0;sample < numSamples; ++sample)
+    {
+        BufferOut_L[sample] *= levelSliderValue;
+        BufferOut_R[sample] *= levelSliderValue;
     }
 }
 
+bool CouteauSuisseAudioProcessor::loadImpulseResponse(const juce::File& file)
+{
+    if (!convolutionReverb.loadImpulseResponse(file))
+        return false;
+    // the IR path is stored with the plugin state
+    parameters.state.setProperty("irFile", file.getFullPathName(), nullptr);
+    return true;
+}
+
 //==============================================================================
 bool CouteauSuisseAudioProcessor::hasEditor() const
 {
@@ -187,15 +315,22 @@ juce::AudioProcessorEditor* CouteauSuisseAudioProcessor::createEditor()
 //==============================================================================
 void CouteauSuisseAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
-    // You should use this method to store your parameters in the memory block.
-    // You could do that either as raw data, or use the XML or ValueTree classes
-    // as intermediaries to make it easy to save and load complex data.
+    // parameters and IR file path
+    auto state = parameters.copyState();
+    std::unique_ptr<juce::XmlElement> xml(state.createXml());
+    copyXmlToBinary(*xml, destData);
 }
 
 void CouteauSuisseAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
-    // You should use this method to restore your parameters from this memory block,
-    // whose contents will have been created by the getStateInformation() call.
+    std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
+    if (xmlState == nullptr || !xmlState->hasTagName(parameters.state.getType()))
+        return;
+
+    parameters.replaceState(juce::ValueTree::fromXml(*xmlState));
+    auto irPath = parameters.state.getProperty("irFile").toString();
+    if (irPath.isNotEmpty())
+        convolutionReverb.loadImpulseResponse(juce::File(irPath));
 }
 
 //==============================================================================
@@ -10,10 +10,13 @@
 
 #include <JuceHeader.h>
 #include "NoiseSource.h"
+#include "../../dsp_fv/signalGenerator.h"
+#include "../../dsp_fv/partitionedConvolution.h"
 //==============================================================================
 /**
 */
-class CouteauSuisseAudioProcessor  : public juce::AudioProcessor
+class CouteauSuisseAudioProcessor  : public juce::AudioProcessor,
+                                     private juce::Timer
 {
 public:
     //==============================================================================
@@ -54,12 +57,24 @@ public:
     void getStateInformation (juce::MemoryBlock& destData) override;
     void setStateInformation (const void* data, int sizeInBytes) override;
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
+
+    /// <summary>
+    /// Loads the impulse response applied to the generated signal, call from the message thread
+    /// </summary>
+    bool loadImpulseResponse(const juce::File& file);
 private:
+    void timerCallback() override;
+    SignalGeneratorParameters getGeneratorParameters();
+
     //==============================================================================
     juce::AudioProcessorValueTreeState parameters;
     juce::Random random;
     PinkNoise nP;
     BrownNoise nB;
+    NoiseFilter noiseFilter;
+    SignalGenerator generator;
+    ConvolutionReverb convolutionReverb;
+    bool wasPlaying = false;
 
     //std::atomic<bool>* whiteNoiseSelect = nullptr;
     //std::atomic<bool>*pinkNoiseSelect = nullptr;
@@ -1,6 +1,7 @@
 #pragma once
 #include "../../dsp_fv/APFstructures.h"
-#include "../../dsp_fv/classicFilters.h"
+#include "../../dsp_fv/stateVariableFilter.h"
+#include "../../dsp_fv/silenceDetector.h"
 
 
 /// <summary>
@@ -20,7 +21,7 @@ struct ReverbControlParameters
 	double damping;
 	double bandwidth;
 
-	
+	bool modulation = true; // tank APFs modulation, the reverb is linear time invariant without it
 };
 
 /// <summary>
@@ -56,9 +57,55 @@ struct ReverbStructureParameters
 };
 
 /// <summary>
-/// The Jon Dattorro Reverb algorithm
+/// Tank delays read by the output taps
+/// </summary>
+enum class DattorroTapSource { delayLine1, delayLine2, delayLine3, delayLine4, alternateAPF5, alternateAPF6 };
+
+/// <summary>
+/// One output tap : delay in samples at Dattorro's reference rate, sign of the tap, output channel (0 : left, 1 : right)
+/// </summary>
+struct DattorroOutputTap
+{
+	DattorroTapSource source;
+	double delay_samples;
+	double gain;
+	int channel;
+};
+
+/// <summary>
+/// Sample rate of the delay lengths and output taps given in Dattorro's paper (1997)
+/// </summary>
+constexpr double dattorroReferenceRate = 29761.0;
+
+/// <summary>
+/// The 14 output taps of the tank, in samples at dattorroReferenceRate, scaled to the sample rate at reset()
+/// </summary>
+constexpr DattorroOutputTap dattorroOutputTaps[] =
+{
+	// left channel
+	{ DattorroTapSource::delayLine1, 266.0, 1.0, 0 },
+	{ DattorroTapSource::delayLine1, 2974.0, 1.0, 0 },
+	{ DattorroTapSource::alternateAPF5, 1913.0, -1.0, 0 },
+	{ DattorroTapSource::delayLine2, 1996.0, 1.0, 0 },
+	{ DattorroTapSource::delayLine3, 1990.0, -1.0, 0 },
+	{ DattorroTapSource::alternateAPF6, 187.0, -1.0, 0 },
+	{ DattorroTapSource::delayLine4, 1066.0, -1.0, 0 },
+
+	// right channel
+	{ DattorroTapSource::delayLine3, 353.0, 1.0, 1 },
+	{ DattorroTapSource::delayLine3, 3627.0, 1.0, 1 },
+	{ DattorroTapSource::alternateAPF6, 1228.0, -1.0, 1 },
+	{ DattorroTapSource::delayLine4, 2673.0, 1.0, 1 },
+	{ DattorroTapSource::delayLine1, 2111.0, -1.0, 1 },
+	{ DattorroTapSource::alternateAPF5, 335.0, -1.0, 1 },
+	{ DattorroTapSource::delayLine2, 121.0, -1.0, 1 }
+};
+
+/// <summary>
+/// The Jon Dattorro Reverb algorithm, processed in SampleType (float or double), see the DattorroPlateReverb alias
 /// </summary>
-class DattorroPlateReverb
+template <typename SampleType>
+class DattorroPlateReverbT
 {
 public:
 	/// <summary>
@@ -78,6 +125,7 @@ public:
 
 		controlParameters.damping = pControlParameters.damping;
 		controlParameters.bandwidth = pControlParameters.bandwidth;
+		controlParameters.modulation = pControlParameters.modulation;
 
 		//... add additionnal control parameters here 
 	}
@@ -112,15 +160,17 @@ public:
 		structureParameters.modulatedAPF2Param.feedbackGain = controlParameters.decayDiffusion1;
 		structureParameters.alternateAPF5Param.feedbackGain = controlParameters.decayDiffusion2;
 		structureParameters.alternateAPF6Param.feedbackGain = controlParameters.decayDiffusion2;
+		structureParameters.modulatedAPF1_lfoParam.enableLFO = controlParameters.modulation;
+		structureParameters.modulatedAPF2_lfoParam.enableLFO = controlParameters.modulation;
 		
 		modulatedAPF1.setParameters(structureParameters.modulatedAPF1Param,structureParameters.modulatedAPF1_lfoParam);
 		modulatedAPF2.setParameters(structureParameters.modulatedAPF2Param,structureParameters.modulatedAPF2_lfoParam);
 		alternateAPF5.setParameters(structureParameters.alternateAPF5Param);
 		alternateAPF6.setParameters(structureParameters.alternateAPF6Param);
 		// update bandwidth and damping 
-		bandwidthLPF.setCoefficients(controlParameters.bandwidth, 1.0, sampleRate);
-		dampingLPF1.setCoefficients(controlParameters.damping, 1.0, sampleRate);
-		dampingLPF2.setCoefficients(controlParameters.damping, 1.0, sampleRate);
+		bandwidthLPF.setCutoffFrequency(controlParameters.bandwidth);
+		dampingLPF1.setCutoffFrequency(controlParameters.damping);
+		dampingLPF2.setCutoffFrequency(controlParameters.damping);
 	}
 
 	/// <summary>
@@ -152,13 +202,28 @@ public:
 		alternateAPF5.setParameters(structureParameters.alternateAPF5Param);
 		alternateAPF6.setParameters(structureParameters.alternateAPF6Param);
 
-		bandwidthLPF.setFilterType("LPF1");
-		dampingLPF1.setFilterType("LPF1");
-		dampingLPF2.setFilterType("LPF1");
-		bandwidthLPF.	setCoefficients(20000.0, 1.0, sampleRate);
-		dampingLPF1.	setCoefficients(0.0, 1.0, sampleRate);
-		dampingLPF2.	setCoefficients(0.0, 1.0, sampleRate);
-
+		bandwidthLPF.	reset(sampleRate);
+		dampingLPF1.	reset(sampleRate);
+		dampingLPF2.	reset(sampleRate);
+		bandwidthLPF.	setCutoffFrequency(20000.0);
+		dampingLPF1.	setCutoffFrequency(0.0);
+		dampingLPF2.	setCutoffFrequency(0.0);
+
+
+		// output taps at this sample rate, grouped by tapped buffer and channel. The tapped buffers hold the longest
+		// tap and a gathered block
+		vector<unsigned int> minBufferLength(numTapSources, 0);
+		for (auto& sourceGroups : outputTapGroups)
+			for (auto& group : sourceGroups)
+				group.clear();
+		for (int tap = 0; tap < numOutputTaps; ++tap)
+		{
+			auto& reference = dattorroOutputTaps[tap];
+			auto delay = (unsigned int)std::round(reference.delay_samples * sampleRate / dattorroReferenceRate);
+			outputTapGroups[(size_t)reference.source][(size_t)reference.channel].push_back({ delay, (SampleType)reference.gain });
+			auto& length = minBufferLength[(size_t)reference.source];
+			length = juce::jmax(length, delay + (unsigned int)maxGatherLength);
+		}
 
 		// create buffers
 		predelayLine.createDelayBuffer(sampleRate);
@@ -170,98 +235,175 @@ public:
 		inputDiffuser3.createDelayBuffer(sampleRate);
 		inputDiffuser4.createDelayBuffer(sampleRate);
 
-		delayLine1.createDelayBuffer(sampleRate);
-		delayLine2.createDelayBuffer(sampleRate);
-		delayLine3.createDelayBuffer(sampleRate);
-		delayLine4.createDelayBuffer(sampleRate);
+		delayLine1.createDelayBuffer(sampleRate, minBufferLength[(size_t)DattorroTapSource::delayLine1]);
+		delayLine2.createDelayBuffer(sampleRate, minBufferLength[(size_t)DattorroTapSource::delayLine2]);
+		delayLine3.createDelayBuffer(sampleRate, minBufferLength[(size_t)DattorroTapSource::delayLine3]);
+		delayLine4.createDelayBuffer(sampleRate, minBufferLength[(size_t)DattorroTapSource::delayLine4]);
 
-		alternateAPF5.createDelayBuffer(sampleRate);
-		alternateAPF6.createDelayBuffer(sampleRate);
+		alternateAPF5.createDelayBuffer(sampleRate, minBufferLength[(size_t)DattorroTapSource::alternateAPF5]);
+		alternateAPF6.createDelayBuffer(sampleRate, minBufferLength[(size_t)DattorroTapSource::alternateAPF6]);
 	}
 	/// <summary>
 	/// Process the incoming  L and R input signals
 	/// </summary>
 	/// <param name="inputXn"></param>
 	/// <returns> returns the processed audio samples </returns>
-	vector<float> processAudioSample(vector<float> inputXn)
+	vector<SampleType> processAudioSample(vector<SampleType> inputXn)
 	{
+		processTank(SampleType(0.5) * (inputXn[0] + inputXn[1]));
+
+		vector<SampleType> outputYn = readOutputTaps();
+
+		auto mix = (SampleType)controlParameters.mix;
+		outputYn[0] = (1 - mix) * inputXn[0] + (mix) * outputYn[0];
+		outputYn[1] = (1 - mix) * inputXn[1] + (mix) * outputYn[1];
+		return outputYn;
+	}
 
-		float input = 0.5f * (float)(inputXn[0] + inputXn[1]);
-		float output = 0.0f;
-		static float tank1_wet = 0.0f, tank2_wet = 0.0f;
+	/// <summary>
+	/// Processes a block : the tank runs sample by sample, then the output taps are gathered for up to
+	/// maxGatherLength samples at a time, one multi-tap read per tapped buffer and channel. Same output as processAudioSample().
+	/// The output buffers may be the input ones
+	/// </summary>
+	void processBlock(const float* inL, const float* inR, float* outL, float* outR, int numSamples)
+	{
+		auto mix = (SampleType)controlParameters.mix;
+		for (int start = 0; start < numSamples; start += maxGatherLength)
+		{
+			auto length = juce::jmin(maxGatherLength, numSamples - start);
+			for (int sample = 0; sample < length; ++sample)
+				processTank(SampleType(0.5) * ((SampleType)inL[start + sample] + (SampleType)inR[start + sample]));
+
+			gatherOutputTaps(length);
+			for (int sample = 0; sample < length; ++sample)
+			{
+				auto xL = (SampleType)inL[start + sample], xR = (SampleType)inR[start + sample];
+				outL[start + sample] = (float)((1 - mix) * xL + mix * gatheredOutput[0][sample]);
+				outR[start + sample] = (float)((1 - mix) * xR + mix * gatheredOutput[1][sample]);
+			}
+		}
+	}
+
+	/// <summary>
+	/// Tail length with the current parameters, in seconds (decay by tailDecay_dB) : predelay, input diffusers, then the tank,
+	/// a figure of eight through both halves, attenuated by decay twice per round trip (the damping lowpasses and the
+	/// APFs have a unity gain at DC), or the ringing of its APFs if longer. Infinite if decay reaches 1
+	/// </summary>
+	double getTailLengthSeconds() const
+	{
+		auto& s = structureParameters;
+		auto tail_s = controlParameters.predelay * 0.001;
+		for (auto* apf : { &s.inputDiffuser1Param, &s.inputDiffuser2Param, &s.inputDiffuser3Param, &s.inputDiffuser4Param })
+			tail_s += getFeedbackDecayTime(apf->feedbackGain, apf->delayTime_ms * 0.001) + apf->delayTime_ms * 0.001;
+
+		auto tankLoop_s = 0.001 * (s.modulatedAPF1Param.delayTime_ms + s.delayLine1Param.delayTime_ms + s.alternateAPF5Param.delayTime_ms + s.delayLine2Param.delayTime_ms
+			+ s.modulatedAPF2Param.delayTime_ms + s.delayLine3Param.delayTime_ms + s.alternateAPF6Param.delayTime_ms + s.delayLine4Param.delayTime_ms);
+		auto tankDecay_s = getFeedbackDecayTime(controlParameters.decay * controlParameters.decay, tankLoop_s);
+		for (auto* apf : { &s.modulatedAPF1Param, &s.modulatedAPF2Param, &s.alternateAPF5Param, &s.alternateAPF6Param })
+			tankDecay_s = juce::jmax(tankDecay_s, getFeedbackDecayTime(apf->feedbackGain, apf->delayTime_ms * 0.001));
+		return limitTailLength(tail_s + tankLoop_s + tankDecay_s);
+	}
+
+private:
+	static constexpr int numOutputTaps = (int)(sizeof(dattorroOutputTaps) / sizeof(dattorroOutputTaps[0]));
+	static constexpr int numTapSources = 6;
+	static constexpr int maxGatherLength = 64; // samples gathered per pass, the tapped buffers are this much longer than their taps
+
+	/// <summary>
+	/// Predelay, bandwidth, input diffusers and both halves of the tank, for one (mono) input sample
+	/// </summary>
+	void processTank(SampleType input)
+	{
+		SampleType output = SampleType(0);
 
 		output = predelayLine.processAudioSample(input);
 
-		output = bandwidthLPF.	processAudioSample(output);
+		output = bandwidthLPF.	processLowpass(output);
 
 		output = inputDiffuser1.processAudioSample(output);
 		output = inputDiffuser2.processAudioSample(output);
 		output = inputDiffuser3.processAudioSample(output);
 		output = inputDiffuser4.processAudioSample(output);
 
-		float tank1 = output + tank2_wet;
-		float tank2 = output + tank1_wet;
+		SampleType tank1 = output + tank2_wet;
+		SampleType tank2 = output + tank1_wet;
+		auto decay = (SampleType)controlParameters.decay;
 
 		// process tank 1
 		tank1 = modulatedAPF1.	processAudioSample(tank1);
 		tank1 = delayLine1.		processAudioSample(tank1);
-		tank1 = dampingLPF1.	processAudioSample(tank1);
+		tank1 = dampingLPF1.	processLowpass(tank1);
 		tank1 = alternateAPF5.	processAudioSample(tank1);
-		tank1_wet = delayLine2.	processAudioSample(tank1) * controlParameters.decay;
+		tank1_wet = delayLine2.	processAudioSample(tank1) * decay;
 
 		// process tank 2
 		tank2 = modulatedAPF2.	processAudioSample(tank2);
 		tank2 = delayLine3.		processAudioSample(tank2);
-		tank2 = dampingLPF2.	processAudioSample(tank2);
+		tank2 = dampingLPF2.	processLowpass(tank2);
 		tank2 = alternateAPF6.	processAudioSample(tank2);
-		tank2_wet = delayLine4.	processAudioSample(tank2) * controlParameters.decay;
-
-
-		vector<float> outputYn = readOutputTaps();
-
-		outputYn[0] = (1 - controlParameters.mix) * inputXn[0] + (controlParameters.mix) * outputYn[0];
-		outputYn[1] = (1 - controlParameters.mix) * inputXn[1] + (controlParameters.mix) * outputYn[1];
-		return outputYn;
+		tank2_wet = delayLine4.	processAudioSample(tank2) * decay;
 	}
 
-private:
 	/// <summary>
-	/// Reads from delayLines and creating the output signals 
+	/// Reads the output taps of the last processed sample
 	/// </summary>
 	/// <returns></returns>
-	vector<float> readOutputTaps()
+	vector<SampleType> readOutputTaps()
 	{
-		// left channel
-		float yL = delayLine1.readDelayLine(394);
-		yL += delayLine1.readDelayLine(4401);
-		yL -= alternateAPF5.readDelayLine(2831);
-		yL += delayLine2.readDelayLine(2954);
-		yL -= delayLine3.readDelayLine(2945);
-		yL -= alternateAPF6.readDelayLine(277);
-		yL -= delayLine4.readDelayLine(1578);
-
-		// right channel
-		float yR = delayLine3.readDelayLine(522);
-		yR += delayLine3.readDelayLine(5368);
-		yR -= alternateAPF6.readDelayLine(1817);
-		yR += delayLine4.readDelayLine(3956);
-		yR -= delayLine1.readDelayLine(3124);
-		yR -= alternateAPF5.readDelayLine(496);
-		yR -= delayLine2.readDelayLine(179);
-
-		vector<float> output = { yL, yR };
-
-		return output;
+		gatherOutputTaps(1);
+		return { gatheredOutput[0][0], gatheredOutput[1][0] };
+	}
+
+	/// <summary>
+	/// Gathers the output taps of the last numSamples processed samples into gatheredOutput, one multi-tap read
+	/// per tapped buffer and channel
+	/// </summary>
+	void gatherOutputTaps(int numSamples)
+	{
+		for (int channel = 0; channel < 2; ++channel)
+		{
+			auto* output = gatheredOutput[(size_t)channel].data();
+			std::fill(output, output + numSamples, SampleType(0));
+			for (int source = 0; source < numTapSources; ++source)
+			{
+				auto& group = outputTapGroups[(size_t)source][(size_t)channel];
+				if (!group.empty())
+					gatherTapSource((DattorroTapSource)source, group.data(), (int)group.size(), output, numSamples);
+			}
+		}
+	}
+
+	void gatherTapSource(DattorroTapSource source, const CircularBufferTap<SampleType>* taps, int numTaps, SampleType* output, int numSamples)
+	{
+		switch (source)
+		{
+		case DattorroTapSource::delayLine1: delayLine1.gatherDelayLineTaps(taps, numTaps, output, numSamples); break;
+		case DattorroTapSource::delayLine2: delayLine2.gatherDelayLineTaps(taps, numTaps, output, numSamples); break;
+		case DattorroTapSource::delayLine3: delayLine3.gatherDelayLineTaps(taps, numTaps, output, numSamples); break;
+		case DattorroTapSource::delayLine4: delayLine4.gatherDelayLineTaps(taps, numTaps, output, numSamples); break;
+		case DattorroTapSource::alternateAPF5: alternateAPF5.gatherDelayLineTaps(taps, numTaps, output, numSamples); break;
+		default: alternateAPF6.gatherDelayLineTaps(taps, numTaps, output, numSamples); break;
+		}
 	}
 
 	double sampleRate;
+	SampleType tank1_wet = SampleType(0), tank2_wet = SampleType(0); // tanks cross feedback, one sample delay
 	ReverbControlParameters controlParameters;
 	ReverbStructureParameters structureParameters;
 
-	alternateAllPassFilter inputDiffuser1, inputDiffuser2, inputDiffuser3, inputDiffuser4;
-	alternateAllPassFilter_modulated  modulatedAPF1, modulatedAPF2;
-	delayLine predelayLine;
-	delayLine delayLine1, delayLine2, delayLine3, delayLine4;
-	alternateAllPassFilter alternateAPF5, alternateAPF6;
-	ClassicFilters bandwidthLPF, dampingLPF1, dampingLPF2;
-};
\ No newline at end of file
+	// output taps per tapped buffer and channel, set at reset() for the sample rate
+	std::array<std::array<vector<CircularBufferTap<SampleType>>, 2>, numTapSources> outputTapGroups;
+	std::array<std::array<SampleType, maxGatherLength>, 2> gatheredOutput{};
+
+	alternateAllPassFilterT<SampleType> inputDiffuser1, inputDiffuser2, inputDiffuser3, inputDiffuser4;
+	alternateAllPassFilter_modulatedT<SampleType>  modulatedAPF1, modulatedAPF2;
+	delayLineT<SampleType> predelayLine;
+	delayLineT<SampleType> delayLine1, delayLine2, delayLine3, delayLine4;
+	alternateAllPassFilterT<SampleType> alternateAPF5, alternateAPF6;
+	TPTOnePoleFilterT<SampleType> bandwidthLPF, dampingLPF1, dampingLPF2; // first order TPT lowpass, same response as the LPF1 of ClassicFilters
+};
+
+/// <summary>
+/// Single precision reverb, the plugin's instantiation
+/// </summary>
+using DattorroPlateReverb = DattorroPlateReverbT<float>;
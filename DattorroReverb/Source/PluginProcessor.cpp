@@ -39,15 +39,20 @@ DattorroReverbAudioProcessor::DattorroReverbAudioProcessor()
             std::make_unique<juce::AudioParameterFloat>(
             "damping", "Damping", juce::NormalisableRange<float>(0.0f, 20000.0f),10.0f),
             std::make_unique<juce::AudioParameterFloat>(
-            "bandwidth", "Bandwidth", juce::NormalisableRange<float>(0.0f, 20000.0f),20000.0f)
+            "bandwidth", "Bandwidth", juce::NormalisableRange<float>(0.0f, 20000.0f),20000.0f),
+            std::make_unique<juce::AudioParameterBool>(
+            "baked", "Baked", false)
         }
     )
 #endif
 {
+    bakedReverb.setRenderFunction(&DattorroReverbAudioProcessor::renderImpulseResponse);
+    startTimerHz(10);
 }
 
 DattorroReverbAudioProcessor::~DattorroReverbAudioProcessor()
 {
+    stopTimer();
 }
 
 //==============================================================================
@@ -63,6 +68,7 @@ void DattorroReverbAudioProcessor::prepareToPlay (double sampleRate, int samples
     decay = parameters.getRawParameterValue("decay");
     damping = parameters.getRawParameterValue("damping");
     bandwidth = parameters.getRawParameterValue("bandwidth");
+    baked = parameters.getRawParameterValue("baked");
 
 
     controlParameters.mix = mix->load();
@@ -78,6 +84,10 @@ void DattorroReverbAudioProcessor::prepareToPlay (double sampleRate, int samples
     
     reverbAlgorithm.reset(sampleRate);
     reverbAlgorithm.setParameters(controlParameters);
+    bakedReverb.setNonRealtime(isNonRealtime());
+    bakedReverb.reset(sampleRate, samplesPerBlock);
+    silenceDetector.reset(sampleRate);
+    tailLength_s.store(reverbAlgorithm.getTailLengthSeconds());
 }
 
 void DattorroReverbAudioProcessor::releaseResources()
@@ -114,9 +124,9 @@ bool DattorroReverbAudioProcessor::isBusesLayoutSupported (const BusesLayout& la
 
 void DattorroReverbAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
+    juce::ScopedNoDenormals noDenormals;
+    // processed in place
     auto mainInputOutput = getBusBuffer(buffer, true, 0);
-    auto BufferIn_L = mainInputOutput.getReadPointer(0);
-    auto BufferIn_R = mainInputOutput.getReadPointer(1);
     auto BufferOut_L = mainInputOutput.getWritePointer(0);
     auto BufferOut_R = mainInputOutput.getWritePointer(1);
 
@@ -131,19 +141,67 @@ void DattorroReverbAudioProcessor::processBlock (juce::AudioBuffer<float>& buffe
     controlParameters.bandwidth = bandwidth->load();
     controlParameters.decay = decay->load();
 
-    // update Reverb Algorithm parameters
+    // baked : no tank modulation, the reverb is LTI and may be replaced by the convolution with its IR
+    auto isBaked = baked->load() >= 0.5f;
+    controlParameters.modulation = !isBaked;
+
+    // update Reverb Algorithm parameters, fully wet : the mix is applied by bakedReverb
+    auto mixValue = controlParameters.mix;
+    controlParameters.mix = 1.0;
     reverbAlgorithm.updateParameters(controlParameters);
+    tailLength_s.store(reverbAlgorithm.getTailLengthSeconds());
+    silenceDetector.setTailLength(tailLength_s.load());
+
+    double settings[] = { controlParameters.predelay, controlParameters.inputDiffusion1, controlParameters.inputDiffusion2,
+        controlParameters.decayDiffusion1, controlParameters.decayDiffusion2, controlParameters.decay,
+        controlParameters.damping, controlParameters.bandwidth };
+
+    bakedReverb.processBlock(BufferOut_L, BufferOut_R, buffer.getNumSamples(), mixValue, settings, 8, isBaked,
+        [this](const float* inL, const float* inR, float* wetL, float* wetR, int numSamples)
+        {
+            // silent input and rung out tail : the live engine is skipped, its output is zero
+            if (!silenceDetector.processInput(inL, inR, numSamples))
+            {
+                std::fill(wetL, wetL + numSamples, 0.0f);
+                std::fill(wetR, wetR + numSamples, 0.0f);
+                return;
+            }
+
+            // the output taps are gathered block by block
+            reverbAlgorithm.processBlock(inL, inR, wetL, wetR, numSamples);
+            silenceDetector.processOutput(wetL, wetR, numSamples);
+        });
+}
 
+void DattorroReverbAudioProcessor::timerCallback()
+{
+    bakedReverb.update(getBakedSettings(), baked != nullptr && baked->load() >= 0.5f);
+}
 
-    vector<float> input = { 0.0,0.0 };
+vector<double> DattorroReverbAudioProcessor::getBakedSettings() const
+{
+    // same order as the settings given to bakedReverb.processBlock()
+    vector<double> settings;
+    for (auto id : { "predelay", "inputDiffusion1", "inputDiffusion2", "decayDiffusion1", "decayDiffusion2", "decay", "damping", "bandwidth" })
+        settings.push_back(parameters.getRawParameterValue(id)->load());
+    return settings;
+}
 
-    for (auto sample = 0;sample < buffer.getNumSamples(); ++sample)
+void DattorroReverbAudioProcessor::renderImpulseResponse(const vector<double>& settings, double sampleRate, juce::AudioBuffer<float>& ir)
+{
+    // a new engine, without modulation, fed with a unit impulse
+    DattorroPlateReverb engine;
+    ReverbControlParameters control = { 1.0, settings[0], settings[1], settings[2], settings[3], settings[4], settings[5], settings[6], settings[7], false };
+    engine.reset(sampleRate);
+    engine.updateParameters(control);
+
+    vector<float> input = { 1.0f, 1.0f };
+    for (auto sample = 0; sample < ir.getNumSamples(); ++sample)
     {
-        input[0] = BufferIn_L[sample];
-        input[1] = BufferIn_R[sample];
-        auto yn = reverbAlgorithm.processAudioSample(input);
-        BufferOut_L[sample] = yn[0];
-        BufferOut_R[sample] = yn[1];
+        auto yn = engine.processAudioSample(input);
+        ir.setSample(0, sample, yn[0]);
+        ir.setSample(1, sample, yn[1]);
+        input = { 0.0f, 0.0f };
     }
 }
 
@@ -193,7 +251,7 @@ bool DattorroReverbAudioProcessor::isMidiEffect() const
 
 double DattorroReverbAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    return tailLength_s.load();
 }
 
 int DattorroReverbAudioProcessor::getNumPrograms()
@@ -11,11 +11,13 @@
 #include <JuceHeader.h>
 #include "SimpleModulatedDelay.h"
 #include "DattorroPlateReverb.h"
+#include "../../dsp_fv/bakedReverb.h"
 
 //==============================================================================
 /**
 */
-class DattorroReverbAudioProcessor  : public juce::AudioProcessor
+class DattorroReverbAudioProcessor  : public juce::AudioProcessor,
+                                      private juce::Timer
 {
 public:
     //==============================================================================
@@ -57,6 +59,10 @@ public:
 
 private:
     //==============================================================================
+    void timerCallback() override;
+    vector<double> getBakedSettings() const;
+    static void renderImpulseResponse(const vector<double>& settings, double sampleRate, juce::AudioBuffer<float>& ir);
+
     juce::AudioProcessorValueTreeState parameters;
     double currentSampleRate;
 
@@ -73,11 +79,19 @@ private:
 
     std::atomic<float>* damping = nullptr;
     std::atomic<float>* bandwidth = nullptr;
+    std::atomic<float>* baked = nullptr;
     // The reverb algorithm
     SimpleModulatedDelay delayAlgorithm;
     DelayControlParameters delayControl;
     
     DattorroPlateReverb reverbAlgorithm;
     ReverbControlParameters controlParameters;
+
+    // static settings : convolution with the rendered impulse response
+    BakedReverb bakedReverb;
+
+    // the live engine is idle while its input is silent and its tail has rung out
+    SilenceDetector silenceDetector;
+    std::atomic<double> tailLength_s{ 0.0 };
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DattorroReverbAudioProcessor)
 };
@@ -83,6 +83,7 @@ bool Delay101AudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts)
 
 void Delay101AudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
+    juce::ScopedNoDenormals noDenormals;
     auto mainInputOutput = getBusBuffer(buffer, true, 0);
     auto delayTimeMsecCopy = delayTime->get();
     auto wetDryCopy = wetDry->get();
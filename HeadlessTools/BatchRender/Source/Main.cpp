@@ -0,0 +1,339 @@
+/*
+  ==============================================================================
+
+    BatchRender : renders many tracks through chains of the plugins' engines.
+
+    Every input file is a track : it is read by a source node, processed by its
+    own instances of the engine chain, and written by a sink node. All the tracks
+    are nodes of a single processing graph, run block by block on a work stealing
+    thread pool : the tracks render in parallel, each chain in order.
+
+    When every engine of the chain has a batched variant (schroeder, filter), the
+    tracks are grouped by BatchedEngineAdapter::numLanes and every group is a
+    single node : the instances of a group are processed together, one track
+    per SIMD lane. --no-batch renders these chains track by track.
+
+    Usage :
+    BatchRender --input file_or_directory [--input ...] --engine name[:param=value,...] [--engine ...]
+                [--output Rendered] [--tail 5] [--threads N] [--block 512] [--no-batch]
+
+    Engines : dattorro, abyssal, spring, schroeder, fdn, multitap, filter, and the
+    compiled topologies dattorro-topology, abyssal-topology, schroeder-topology. The chain is
+    applied in the order of the --engine options. Outputs are 32 bit float WAV files.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <iostream>
+#include "../../Shared/EngineAdapters.h"
+#include "../../Shared/WorkStealingThreadPool.h"
+#include "../../Shared/ProcessingGraph.h"
+
+/// <summary>
+/// One engine of the chain and its parameters
+/// </summary>
+struct ChainEngine
+{
+	juce::String name;
+	vector<std::pair<juce::String, double>> parameters;
+};
+
+/// <summary>
+/// One track : its reader, its writer and its render length
+/// </summary>
+struct Track
+{
+	juce::File inputFile;
+	std::unique_ptr<juce::AudioFormatReader> reader;
+	std::unique_ptr<juce::AudioFormatWriter> writer;
+	juce::AudioBuffer<float> readBuffer;
+	juce::int64 length = 0;		// input length plus tail
+	juce::int64 position = 0;
+	bool failed = false;
+};
+
+/// <summary>
+/// Parses "name:param=value,param=value"
+/// </summary>
+static ChainEngine parseEngine(const juce::String& text)
+{
+	ChainEngine engine;
+	engine.name = text.upToFirstOccurrenceOf(":", false, false);
+	auto parameters = juce::StringArray::fromTokens(text.fromFirstOccurrenceOf(":", false, false), ",", "");
+	for (auto& p : parameters)
+		if (p.contains("="))
+			engine.parameters.push_back({ p.upToFirstOccurrenceOf("=", false, false), p.fromFirstOccurrenceOf("=", false, false).getDoubleValue() });
+	return engine;
+}
+
+static juce::Array<juce::File> findInputFiles(const juce::StringArray& inputs, juce::AudioFormatManager& formatManager)
+{
+	juce::Array<juce::File> files;
+	for (auto& input : inputs)
+	{
+		auto file = juce::File::getCurrentWorkingDirectory().getChildFile(input);
+		if (file.isDirectory())
+		{
+			auto children = file.findChildFiles(juce::File::findFiles, false, formatManager.getWildcardForAllFormats());
+			children.sort();
+			files.addArray(children);
+		}
+		else if (file.existsAsFile())
+			files.add(file);
+	}
+	return files;
+}
+
+static std::unique_ptr<juce::AudioFormatWriter> createWavWriter(const juce::File& file, double sampleRate)
+{
+	file.deleteFile();
+	std::unique_ptr<juce::FileOutputStream> stream(file.createOutputStream());
+	if (stream == nullptr)
+		return nullptr;
+
+	juce::WavAudioFormat wavFormat;
+	std::unique_ptr<juce::AudioFormatWriter> writer(wavFormat.createWriterFor(stream.get(), sampleRate, 2, 32, {}, 0));
+	if (writer != nullptr)
+		stream.release(); // the writer owns the stream
+	return writer;
+}
+
+/// <summary>
+/// Reads the next block of a track, past the end of the file the reader returns silence : the tail
+/// </summary>
+static void readTrack(Track& track, float* outL, float* outR, int numSamples)
+{
+	auto& buffer = track.readBuffer;
+	track.reader->read(&buffer, 0, numSamples, track.position, true, true);
+	if (track.reader->numChannels == 1)
+		buffer.copyFrom(1, 0, buffer, 0, 0, numSamples);
+	std::copy(buffer.getReadPointer(0), buffer.getReadPointer(0) + numSamples, outL);
+	std::copy(buffer.getReadPointer(1), buffer.getReadPointer(1) + numSamples, outR);
+}
+
+/// <summary>
+/// Writes the next block of a track, up to its render length
+/// </summary>
+static void writeTrack(Track& track, const float* inL, const float* inR, int numSamples)
+{
+	auto count = (int)juce::jmin((juce::int64)numSamples, track.length - track.position);
+	if (count <= 0)
+		return;
+	const float* channels[] = { inL, inR };
+	if (!track.writer->writeFromFloatArrays(channels, 2, count))
+		track.failed = true;
+	track.position += count;
+}
+
+/// <summary>
+/// numLanes tracks rendered together by the batched variants of the chain's engines
+/// </summary>
+struct TrackGroup
+{
+	vector<Track*> tracks; // up to numLanes, the remaining lanes process silence
+	vector<std::unique_ptr<BatchedEngineAdapter>> chain;
+	juce::AudioBuffer<float> left, right; // one channel per lane
+
+	void process(int numSamples)
+	{
+		left.clear();
+		right.clear();
+		for (size_t lane = 0; lane < tracks.size(); ++lane)
+			readTrack(*tracks[lane], left.getWritePointer((int)lane), right.getWritePointer((int)lane), numSamples);
+
+		for (auto& engine : chain)
+			engine->process(left.getArrayOfWritePointers(), right.getArrayOfWritePointers(), numSamples);
+
+		for (size_t lane = 0; lane < tracks.size(); ++lane)
+			writeTrack(*tracks[lane], left.getReadPointer((int)lane), right.getReadPointer((int)lane), numSamples);
+	}
+};
+
+static void printUsage()
+{
+	std::cout << "BatchRender --input file_or_directory [--input ...] --engine name[:param=value,...] [--engine ...]" << std::endl
+		<< "            [--output Rendered] [--tail 5] [--threads N] [--block 512] [--no-batch]" << std::endl
+		<< "engines : " << getEngineNames().joinIntoString(", ") << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+	juce::StringArray inputs;
+	vector<ChainEngine> chain;
+	auto outputDirectory = juce::File::getCurrentWorkingDirectory().getChildFile("Rendered");
+	double tail_s = 5.0;
+	int numThreads = juce::SystemStats::getNumCpus();
+	int blockSize = 512;
+	bool batch = true;
+
+	// command line
+	for (int i = 1; i < argc; ++i)
+	{
+		juce::String option(argv[i]);
+		juce::String value = i + 1 < argc ? juce::String(argv[i + 1]) : juce::String();
+		if (option == "--no-batch")
+		{
+			batch = false;
+			continue;
+		}
+		if (option == "--input") inputs.add(value);
+		else if (option == "--engine") chain.push_back(parseEngine(value));
+		else if (option == "--output") outputDirectory = juce::File::getCurrentWorkingDirectory().getChildFile(value);
+		else if (option == "--tail") tail_s = juce::jmax(0.0, value.getDoubleValue());
+		else if (option == "--threads") numThreads = juce::jmax(1, value.getIntValue());
+		else if (option == "--block") blockSize = juce::jmax(1, value.getIntValue());
+		else
+		{
+			printUsage();
+			return 1;
+		}
+		++i;
+	}
+
+	// the chain is checked once, on a probe instance of each engine
+	for (auto& engine : chain)
+	{
+		auto probe = createEngineAdapter(engine.name);
+		if (probe == nullptr)
+		{
+			std::cout << "Unknown engine " << engine.name << std::endl;
+			printUsage();
+			return 1;
+		}
+		for (auto& p : engine.parameters)
+			if (!probe->setParameter(p.first, p.second))
+			{
+				std::cout << "Unknown parameter " << p.first << ", " << engine.name << " parameters are : "
+					<< probe->getParameterNames().joinIntoString(", ") << std::endl;
+				return 1;
+			}
+		batch = batch && createBatchedEngineAdapter(engine.name) != nullptr;
+	}
+
+	juce::AudioFormatManager formatManager;
+	formatManager.registerBasicFormats();
+	auto files = findInputFiles(inputs, formatManager);
+	if (files.isEmpty() || chain.empty())
+	{
+		printUsage();
+		return 1;
+	}
+	outputDirectory.createDirectory();
+
+	// tracks, all at the sample rate of the first one
+	vector<std::unique_ptr<Track>> tracks;
+	double sampleRate = 0.0;
+	for (auto& file : files)
+	{
+		auto track = std::make_unique<Track>();
+		track->inputFile = file;
+		track->reader.reset(formatManager.createReaderFor(file));
+		if (track->reader == nullptr)
+		{
+			std::cout << "  SKIPPED (unreadable) " << file.getFileName() << std::endl;
+			continue;
+		}
+		if (sampleRate == 0.0)
+			sampleRate = track->reader->sampleRate;
+		if (track->reader->sampleRate != sampleRate)
+		{
+			std::cout << "  SKIPPED (sample rate " << track->reader->sampleRate << " Hz) " << file.getFileName() << std::endl;
+			continue;
+		}
+		track->writer = createWavWriter(outputDirectory.getChildFile(file.getFileNameWithoutExtension() + ".wav"), sampleRate);
+		if (track->writer == nullptr)
+		{
+			std::cout << "  SKIPPED (cannot write) " << file.getFileName() << std::endl;
+			continue;
+		}
+		track->length = track->reader->lengthInSamples + (juce::int64)(tail_s * sampleRate);
+		track->readBuffer.setSize(2, blockSize);
+		tracks.push_back(std::move(track));
+	}
+	if (tracks.empty())
+		return 1;
+
+	// graph : source -> engine chain -> sink, for every track, or a single node for every group of batched tracks
+	ProcessingGraph graph;
+	vector<std::unique_ptr<TrackGroup>> groups;
+	if (batch)
+	{
+		constexpr auto numLanes = BatchedEngineAdapter::numLanes;
+		for (size_t first = 0; first < tracks.size(); first += numLanes)
+		{
+			auto group = std::make_unique<TrackGroup>();
+			for (auto t = first; t < juce::jmin(first + numLanes, tracks.size()); ++t)
+				group->tracks.push_back(tracks[t].get());
+			for (auto& engine : chain)
+			{
+				auto adapter = createBatchedEngineAdapter(engine.name);
+				adapter->reset(sampleRate, blockSize);
+				for (auto& p : engine.parameters)
+					adapter->setParameter(p.first, p.second);
+				group->chain.push_back(std::move(adapter));
+			}
+			group->left.setSize(numLanes, blockSize);
+			group->right.setSize(numLanes, blockSize);
+
+			auto* g = group.get();
+			graph.addNode([g](const float*, const float*, float*, float*, int numSamples) { g->process(numSamples); });
+			groups.push_back(std::move(group));
+		}
+	}
+	else
+	{
+		for (auto& t : tracks)
+		{
+			auto* track = t.get();
+			auto node = graph.addNode([track](const float*, const float*, float* outL, float* outR, int numSamples)
+				{
+					readTrack(*track, outL, outR, numSamples);
+				});
+
+			for (auto& engine : chain)
+			{
+				auto adapter = createEngineAdapter(engine.name);
+				for (auto& p : engine.parameters)
+					adapter->setParameter(p.first, p.second);
+				node = graph.addEngine(std::move(adapter), { node });
+			}
+
+			graph.addNode([track](const float* inL, const float* inR, float*, float*, int numSamples)
+				{
+					writeTrack(*track, inL, inR, numSamples);
+				}, { node });
+		}
+	}
+	graph.prepare(sampleRate, blockSize);
+
+	juce::int64 longest = 0, totalLength = 0;
+	for (auto& track : tracks)
+	{
+		longest = juce::jmax(longest, track->length);
+		totalLength += track->length;
+	}
+
+	std::cout << "Rendering " << tracks.size() << " tracks through " << chain.size() << " engines ("
+		<< graph.getNumNodes() << " nodes" << (batch ? ", batched by " + juce::String(BatchedEngineAdapter::numLanes) : juce::String())
+		<< ") on " << numThreads << " threads" << std::endl;
+
+	WorkStealingThreadPool pool(numThreads - 1); // the main thread works too
+	auto startTime = juce::Time::getMillisecondCounterHiRes();
+	for (juce::int64 position = 0; position < longest; position += blockSize)
+		graph.process(pool, (int)juce::jmin((juce::int64)blockSize, longest - position));
+
+	int numFailed = 0;
+	for (auto& track : tracks)
+	{
+		track->writer.reset(); // flushes the file
+		numFailed += track->failed ? 1 : 0;
+		std::cout << (track->failed ? "  FAILED " : "  ") << track->inputFile.getFileNameWithoutExtension() << ".wav" << std::endl;
+	}
+
+	auto elapsed_s = (juce::Time::getMillisecondCounterHiRes() - startTime) / 1000.0;
+	std::cout << "Done in " << juce::String(elapsed_s, 2) << " s, "
+		<< juce::String((double)totalLength / sampleRate / juce::jmax(0.001, elapsed_s), 1)
+		<< "x real time (all tracks)" << std::endl;
+	return numFailed > 0 ? 1 : 0;
+}
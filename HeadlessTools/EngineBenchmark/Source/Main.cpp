@@ -0,0 +1,633 @@
+/*
+  ==============================================================================
+
+    EngineBenchmark : compares the float and double instantiations of the engines.
+
+    Every engine of the EngineAdapters (and the batched schroeder and filter) is
+    instantiated twice, SampleType = float and SampleType = double, with the
+    adapter's settings, and processes the same stereo noise bursts. For each
+    instantiation the best of --repeats runs is reported in ns per sample and as
+    a real time factor, and the float output is compared to the double one (peak
+    difference, dB relative to the peak of the double output).
+
+    With --silence, the denormal check runs instead : a noise burst followed by
+    that many seconds of silence, the time per block is measured while the tails
+    decay through the subnormal range. Flush to zero stays off unless --ftz is
+    given, the primitives' own flushDenormal() has to keep the time flat.
+
+    Usage :
+    EngineBenchmark [--engine name] [--engine ...] [--seconds 10] [--samplerate 48000] [--repeats 5]
+                    [--silence 30] [--ftz]
+
+    Engines : dattorro, abyssal, spring, schroeder, fdn, multitap, filter,
+    dattorro-topology, abyssal-topology, schroeder-topology, batched-schroeder,
+    batched-filter. All of them by default. The batched engines process 8 lanes
+    (copies of the mid of the input), their time is per frame of 8 samples.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <iostream>
+#include <chrono>
+#include "../../Shared/EngineAdapters.h"
+
+/// <summary>
+/// Dattorro plate, the DattorroAdapter settings, fully wet
+/// </summary>
+template <typename SampleType>
+class DattorroBenchmark
+{
+public:
+	void reset(double sampleRate)
+	{
+		dattorro::ReverbControlParameters controlParameters = { 1.0, 0.0, 0.75, 0.625, 0.7, 0.5, 0.5, 10.0, 20000.0 };
+		engine.reset(sampleRate);
+		engine.updateParameters(controlParameters);
+	}
+
+	void process(const float* inL, const float* inR, float* outL, float* outR, int numSamples)
+	{
+		engine.processBlock(inL, inR, outL, outR, numSamples);
+	}
+
+private:
+	dattorro::DattorroPlateReverbT<SampleType> engine;
+};
+
+/// <summary>
+/// Abyssal plate, the AbyssalAdapter settings, fully wet
+/// </summary>
+template <typename SampleType>
+class AbyssalBenchmark
+{
+public:
+	void reset(double sampleRate)
+	{
+		abyssal::ReverbControlParameters controlParameters;
+		controlParameters.mix = 1.0f;
+		controlParameters.absorption = 20000.0f;
+		controlParameters.earlyReflexions = 0.0f;
+		controlParameters.decay = 0.0f;
+		controlParameters.damping = 0.5f;
+		controlParameters.modRate = 1.0f;
+		controlParameters.modDepth = 0.0f;
+		engine.reset(sampleRate);
+		engine.updateParameters(controlParameters);
+	}
+
+	void process(const float* inL, const float* inR, float* outL, float* outR, int numSamples)
+	{
+		engine.processBlock(inL, inR, outL, outR, numSamples);
+	}
+
+private:
+	abyssal::AbyssalPlateReverbT<SampleType> engine;
+};
+
+/// <summary>
+/// Spring reverb (downsampled Clf), the SpringAdapter settings, fully wet
+/// </summary>
+template <typename SampleType>
+class SpringBenchmark
+{
+public:
+	void reset(double sampleRate)
+	{
+		engine.reset(sampleRate);
+		engine.updateParameters({ 1.0, 1.0 });
+	}
+
+	void process(const float* inL, const float* inR, float* outL, float* outR, int numSamples)
+	{
+		vector<SampleType> input = { SampleType(0), SampleType(0) };
+		for (auto sample = 0; sample < numSamples; ++sample)
+		{
+			input[0] = (SampleType)inL[sample];
+			input[1] = (SampleType)inR[sample];
+			auto yn = engine.processAudioSample(input);
+			outL[sample] = (float)yn[0];
+			outR[sample] = (float)yn[1];
+		}
+	}
+
+private:
+	spring::ParametricSpringReverbT<SampleType> engine;
+};
+
+/// <summary>
+/// Schroeder series allpasses, as the SchroederAdapter : mono sum, fully wet
+/// </summary>
+template <typename SampleType>
+class SchroederBenchmark
+{
+public:
+	void reset(double sampleRate)
+	{
+		engine.reset(sampleRate);
+		engine.setParameters({ 1.0 });
+	}
+
+	void process(const float* inL, const float* inR, float* outL, float* outR, int numSamples)
+	{
+		for (auto sample = 0; sample < numSamples; ++sample)
+		{
+			auto yn = engine.processAudioSample(SampleType(0.5) * ((SampleType)inL[sample] + (SampleType)inR[sample]));
+			outL[sample] = (float)yn;
+			outR[sample] = (float)yn;
+		}
+	}
+
+private:
+	schroeder::SchroederReverbSeriesT<SampleType> engine;
+};
+
+/// <summary>
+/// ClassicFilters LPF2 at 1 kHz, Q 0.707, one filter per channel, as the FilterAdapter defaults
+/// </summary>
+template <typename SampleType>
+class FilterBenchmark
+{
+public:
+	void reset(double sampleRate)
+	{
+		for (auto& filter : filters)
+		{
+			filter = ClassicFiltersT<SampleType>();
+			filter.setFilterType(ClassicFilterType::LPF2);
+			filter.setCoefficients(1000.0, 0.707, sampleRate);
+		}
+	}
+
+	void process(const float* inL, const float* inR, float* outL, float* outR, int numSamples)
+	{
+		for (auto sample = 0; sample < numSamples; ++sample)
+		{
+			outL[sample] = (float)filters[0].processAudioSample((SampleType)inL[sample]);
+			outR[sample] = (float)filters[1].processAudioSample((SampleType)inR[sample]);
+		}
+	}
+
+private:
+	ClassicFiltersT<SampleType> filters[2];
+};
+
+/// <summary>
+/// Feedback delay network, 16 lines, the FDNAdapter settings (FDNParameters defaults), fully wet
+/// </summary>
+template <typename SampleType>
+class FDNBenchmark
+{
+public:
+	void reset(double sampleRate)
+	{
+		engine.setParameters(FDNParameters());
+		engine.reset(sampleRate);
+	}
+
+	void process(const float* inL, const float* inR, float* outL, float* outR, int numSamples)
+	{
+		SampleType frame[2];
+		for (auto sample = 0; sample < numSamples; ++sample)
+		{
+			frame[0] = (SampleType)inL[sample];
+			frame[1] = (SampleType)inR[sample];
+			engine.processAudioFrame(frame);
+			outL[sample] = (float)frame[0];
+			outR[sample] = (float)frame[1];
+		}
+	}
+
+private:
+	FeedbackDelayNetworkT<16, SampleType> engine;
+};
+
+/// <summary>
+/// Compiled reverb topology, as the TopologyAdapter : the topology defaults, fully wet
+/// </summary>
+template <typename SampleType>
+class TopologyBenchmark
+{
+public:
+	TopologyBenchmark(const ReverbTopology& topology)
+	{
+		engine.setTopology(topology);
+		engine.setControl("mix", 1.0);
+	}
+
+	void reset(double sampleRate)
+	{
+		engine.reset(sampleRate);
+		engine.updateParameters();
+	}
+
+	void process(const float* inL, const float* inR, float* outL, float* outR, int numSamples)
+	{
+		SampleType frame[2];
+		for (auto sample = 0; sample < numSamples; ++sample)
+		{
+			frame[0] = (SampleType)inL[sample];
+			frame[1] = (SampleType)inR[sample];
+			engine.processAudioFrame(frame);
+			outL[sample] = (float)frame[0];
+			outR[sample] = (float)frame[1];
+		}
+	}
+
+private:
+	CompiledReverbT<SampleType> engine;
+};
+
+template <typename SampleType>
+class DattorroTopologyBenchmark : public TopologyBenchmark<SampleType>
+{
+public:
+	DattorroTopologyBenchmark() : TopologyBenchmark<SampleType>(ReverbTopologies::dattorroPlate()) {}
+};
+
+template <typename SampleType>
+class AbyssalTopologyBenchmark : public TopologyBenchmark<SampleType>
+{
+public:
+	AbyssalTopologyBenchmark() : TopologyBenchmark<SampleType>(ReverbTopologies::abyssalPlate()) {}
+};
+
+template <typename SampleType>
+class SchroederTopologyBenchmark : public TopologyBenchmark<SampleType>
+{
+public:
+	SchroederTopologyBenchmark() : TopologyBenchmark<SampleType>(ReverbTopologies::schroederSeries()) {}
+};
+
+/// <summary>
+/// Multi-tap delay, the MultiTapDelayAdapter defaults (4 geometric taps, 50 % mix) with 8 taps, the last 4 through
+/// their tone filters, and the saturation on
+/// </summary>
+template <typename SampleType>
+class MultiTapBenchmark
+{
+public:
+	void reset(double sampleRate)
+	{
+		vector<multitap::MultiTapParameters> taps(8);
+		for (auto tap = 0; tap < (int)taps.size(); ++tap)
+		{
+			taps[(size_t)tap].delay_ms = juce::jmin(5000.0, 1000.0 * std::pow(1.618, (double)tap) / 8.0);
+			taps[(size_t)tap].level = 1.0f;
+			taps[(size_t)tap].pan = tap % 2 == 0 ? -0.5f : 0.5f;
+			taps[(size_t)tap].tone_Hz = tap < 4 ? 20000.0f : 2000.0f;
+		}
+
+		engine.setParameters(sampleRate, 1000.0, 1.618, 8, 0.5f, 0.5f, 0.003f, 0.0f);
+		engine.instantiateTaps();
+		engine.createDelayBuffer((float)sampleRate, 5001.0f);
+		engine.createNoise(0.0f);
+		engine.setFiltersParameters(15000.0f, 20.0f);
+		engine.setSaturationParameters(0.5f);
+		engine.setTaps(taps);
+	}
+
+	void process(const float* inL, const float* inR, float* outL, float* outR, int numSamples)
+	{
+		engine.processBlock(inL, inR, outL, outR, numSamples);
+	}
+
+private:
+	multitap::MultiTapDelayT<SampleType> engine;
+};
+
+/// <summary>
+/// Base of the batched benchmarks : the mid of the input (as the SchroederAdapter) is copied to every lane, lane 0 goes
+/// to both outputs
+/// </summary>
+template <typename SampleType>
+class BatchedBenchmark
+{
+public:
+	static constexpr int numLanes = 8;
+
+protected:
+	void interleave(const float* inL, const float* inR, int numSamples)
+	{
+		frames.resize((size_t)numSamples * numLanes);
+		for (int sample = 0; sample < numSamples; ++sample)
+			for (int lane = 0; lane < numLanes; ++lane)
+				frames[(size_t)sample * numLanes + lane] = SampleType(0.5) * ((SampleType)inL[sample] + (SampleType)inR[sample]);
+	}
+
+	void copyLane0(float* outL, float* outR, int numSamples)
+	{
+		for (int sample = 0; sample < numSamples; ++sample)
+			outL[sample] = outR[sample] = (float)frames[(size_t)sample * numLanes];
+	}
+
+	vector<SampleType> frames;
+};
+
+/// <summary>
+/// Schroeder series allpasses on 8 lanes, as the BatchedSchroederAdapter, fully wet
+/// </summary>
+template <typename SampleType>
+class BatchedSchroederBenchmark : public BatchedBenchmark<SampleType>
+{
+public:
+	void reset(double sampleRate)
+	{
+		engine.reset(sampleRate);
+		engine.setParameters({ 1.0 });
+	}
+
+	void process(const float* inL, const float* inR, float* outL, float* outR, int numSamples)
+	{
+		this->interleave(inL, inR, numSamples);
+		for (int sample = 0; sample < numSamples; ++sample)
+			engine.processAudioFrame(this->frames.data() + (size_t)sample * this->numLanes);
+		this->copyLane0(outL, outR, numSamples);
+	}
+
+private:
+	schroeder::BatchedSchroederReverbSeriesT<BatchedBenchmark<SampleType>::numLanes, SampleType> engine;
+};
+
+/// <summary>
+/// ClassicFilters LPF2 at 1 kHz, Q 0.707 on 8 lanes, as the BatchedFilterAdapter defaults
+/// </summary>
+template <typename SampleType>
+class BatchedFilterBenchmark : public BatchedBenchmark<SampleType>
+{
+public:
+	void reset(double sampleRate)
+	{
+		filter.reset();
+		filter.setFilterType(ClassicFilterType::LPF2);
+		filter.setCoefficients(1000.0, 0.707, sampleRate);
+	}
+
+	void process(const float* inL, const float* inR, float* outL, float* outR, int numSamples)
+	{
+		this->interleave(inL, inR, numSamples);
+		for (int sample = 0; sample < numSamples; ++sample)
+			filter.processAudioFrame(this->frames.data() + (size_t)sample * this->numLanes);
+		this->copyLane0(outL, outR, numSamples);
+	}
+
+private:
+	BatchedClassicFiltersT<BatchedBenchmark<SampleType>::numLanes, SampleType> filter;
+};
+
+struct BenchmarkSettings
+{
+	juce::StringArray engines;
+	double sampleRate = 48000.0;
+	double seconds = 10.0;
+	int repeats = 5;
+	int blockSize = 512;
+	double silence_s = 0.0;		// > 0 : denormal check instead of the float / double comparison
+	bool flushToZero = false;	// denormal check with the processor flags set, as in the plugins
+};
+
+/// <summary>
+/// Timing and output of one instantiation
+/// </summary>
+struct BenchmarkResult
+{
+	double nsPerSample = 0.0;
+	vector<float> outputL, outputR;
+};
+
+/// <summary>
+/// Processes the input block by block --repeats times, a fresh reset() every run, keeps the fastest run.
+/// Denormals are flushed as in the plugins, float tails would otherwise reach them long before double ones
+/// </summary>
+template <typename Engine>
+static BenchmarkResult runBenchmark(const BenchmarkSettings& settings, const vector<float>& inputL, const vector<float>& inputR)
+{
+	BenchmarkResult result;
+	auto numSamples = (int)inputL.size();
+	result.outputL.assign(inputL.size(), 0.0f);
+	result.outputR.assign(inputR.size(), 0.0f);
+
+	// as in the plugins' processBlock()
+	juce::ScopedNoDenormals noDenormals;
+	auto engine = std::make_unique<Engine>();
+	double best_ns = 0.0;
+	for (int run = 0; run < settings.repeats; ++run)
+	{
+		engine->reset(settings.sampleRate);
+		auto start = std::chrono::steady_clock::now();
+		for (int position = 0; position < numSamples; position += settings.blockSize)
+		{
+			auto length = juce::jmin(settings.blockSize, numSamples - position);
+			engine->process(inputL.data() + position, inputR.data() + position,
+				result.outputL.data() + position, result.outputR.data() + position, length);
+		}
+		auto elapsed_ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+		if (run == 0 || elapsed_ns < best_ns)
+			best_ns = elapsed_ns;
+	}
+	result.nsPerSample = best_ns / numSamples;
+	return result;
+}
+
+/// <summary>
+/// Peak difference between the float and double outputs, dB relative to the double output peak
+/// </summary>
+static double getDifference_dB(const BenchmarkResult& single, const BenchmarkResult& reference)
+{
+	float peak = 0.0f, difference = 0.0f;
+	for (size_t i = 0; i < reference.outputL.size(); ++i)
+	{
+		peak = juce::jmax(peak, std::abs(reference.outputL[i]), std::abs(reference.outputR[i]));
+		difference = juce::jmax(difference, std::abs(single.outputL[i] - reference.outputL[i]), std::abs(single.outputR[i] - reference.outputR[i]));
+	}
+	if (peak == 0.0f)
+		return -200.0;
+	return juce::Decibels::gainToDecibels(difference / peak, -200.0f);
+}
+
+template <template <typename> class Engine>
+static void compareInstantiations(const juce::String& name, const BenchmarkSettings& settings, const vector<float>& inputL, const vector<float>& inputR)
+{
+	auto single = runBenchmark<Engine<float>>(settings, inputL, inputR);
+	auto reference = runBenchmark<Engine<double>>(settings, inputL, inputR);
+	auto samplePeriod_ns = 1.0e9 / settings.sampleRate;
+
+	std::cout << name.paddedRight(' ', 20)
+		<< juce::String(single.nsPerSample, 2).paddedLeft(' ', 10) << " ns" << juce::String(samplePeriod_ns / single.nsPerSample, 0).paddedLeft(' ', 9) << "x"
+		<< juce::String(reference.nsPerSample, 2).paddedLeft(' ', 10) << " ns" << juce::String(samplePeriod_ns / reference.nsPerSample, 0).paddedLeft(' ', 9) << "x"
+		<< juce::String(reference.nsPerSample / single.nsPerSample, 2).paddedLeft(' ', 10)
+		<< juce::String(getDifference_dB(single, reference), 1).paddedLeft(' ', 10) << " dB" << std::endl;
+}
+
+/// <summary>
+/// Denormal check : 0.5 s of noise then settings.silence_s of silence, processed block by block.
+/// Reports the time per sample over the first and the last second of silence : a tail reaching subnormal
+/// numbers shows up as a last second many times slower than the first one
+/// </summary>
+template <typename Engine>
+static void measureSilence(const juce::String& name, const juce::String& type, const BenchmarkSettings& settings)
+{
+	auto burstLength = (int)(0.5 * settings.sampleRate);
+	auto numSamples = burstLength + (int)(settings.silence_s * settings.sampleRate);
+	auto secondLength = (int)settings.sampleRate;
+	vector<float> inputL((size_t)numSamples, 0.0f), inputR((size_t)numSamples, 0.0f);
+	vector<float> outputL((size_t)settings.blockSize), outputR((size_t)settings.blockSize);
+	juce::Random random(1234);
+	for (int i = 0; i < burstLength; ++i)
+	{
+		inputL[(size_t)i] = 0.5f * (2.0f * random.nextFloat() - 1.0f);
+		inputR[(size_t)i] = 0.5f * (2.0f * random.nextFloat() - 1.0f);
+	}
+
+	std::unique_ptr<juce::ScopedNoDenormals> noDenormals;
+	if (settings.flushToZero)
+		noDenormals = std::make_unique<juce::ScopedNoDenormals>();
+	auto engine = std::make_unique<Engine>();
+	engine->reset(settings.sampleRate);
+
+	double first_ns = 0.0, last_ns = 0.0, slowestBlock_ns = 0.0;
+	for (int position = 0; position < numSamples; position += settings.blockSize)
+	{
+		auto length = juce::jmin(settings.blockSize, numSamples - position);
+		auto start = std::chrono::steady_clock::now();
+		engine->process(inputL.data() + position, inputR.data() + position, outputL.data(), outputR.data(), length);
+		auto elapsed_ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+		if (position >= burstLength && position < burstLength + secondLength)
+			first_ns += elapsed_ns;
+		if (position >= numSamples - secondLength)
+			last_ns += elapsed_ns;
+		if (position >= burstLength)
+			slowestBlock_ns = juce::jmax(slowestBlock_ns, elapsed_ns / length);
+	}
+	first_ns /= secondLength;
+	last_ns /= secondLength;
+
+	std::cout << name.paddedRight(' ', 20) << type.paddedRight(' ', 8)
+		<< juce::String(first_ns, 2).paddedLeft(' ', 10) << " ns"
+		<< juce::String(last_ns, 2).paddedLeft(' ', 10) << " ns"
+		<< juce::String(last_ns / first_ns, 2).paddedLeft(' ', 10)
+		<< juce::String(slowestBlock_ns, 2).paddedLeft(' ', 10) << " ns" << std::endl;
+}
+
+template <template <typename> class Engine>
+static void checkDenormals(const juce::String& name, const BenchmarkSettings& settings)
+{
+	measureSilence<Engine<float>>(name, "float", settings);
+	measureSilence<Engine<double>>(name, "double", settings);
+}
+
+static juce::StringArray getBenchmarkNames()
+{
+	return { "dattorro", "abyssal", "spring", "schroeder", "fdn", "multitap", "filter",
+		"dattorro-topology", "abyssal-topology", "schroeder-topology", "batched-schroeder", "batched-filter" };
+}
+
+static void printUsage()
+{
+	std::cout << "EngineBenchmark [--engine name] [--engine ...] [--seconds 10] [--samplerate 48000] [--repeats 5] [--silence 30] [--ftz]" << std::endl
+		<< "Engines : " << getBenchmarkNames().joinIntoString(", ") << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+	BenchmarkSettings settings;
+	const auto engineNames = getBenchmarkNames();
+
+	// command line
+	for (int i = 1; i < argc; ++i)
+	{
+		juce::String option(argv[i]);
+		juce::String value = i + 1 < argc ? juce::String(argv[i + 1]) : juce::String();
+		if (option == "--engine") settings.engines.add(value);
+		else if (option == "--seconds") settings.seconds = juce::jmax(0.1, value.getDoubleValue());
+		else if (option == "--samplerate") settings.sampleRate = value.getDoubleValue();
+		else if (option == "--repeats") settings.repeats = juce::jmax(1, value.getIntValue());
+		else if (option == "--silence") settings.silence_s = juce::jmax(1.0, value.getDoubleValue());
+		else if (option == "--ftz")
+		{
+			settings.flushToZero = true;
+			continue;
+		}
+		else
+		{
+			printUsage();
+			return 1;
+		}
+		++i;
+	}
+	if (settings.engines.isEmpty())
+		settings.engines = engineNames;
+	for (auto& name : settings.engines)
+	{
+		if (!engineNames.contains(name))
+		{
+			std::cout << "Unknown engine " << name << std::endl;
+			printUsage();
+			return 1;
+		}
+	}
+
+	if (settings.silence_s > 0.0)
+	{
+		std::cout << "Denormal check : 0.5 s of noise, " << juce::String(settings.silence_s, 1) << " s of silence at " << settings.sampleRate << " Hz, "
+			<< (settings.flushToZero ? "flush to zero on" : "flush to zero off") << std::endl;
+		std::cout << juce::String("engine").paddedRight(' ', 20) << juce::String("type").paddedRight(' ', 8)
+			<< juce::String("first s").paddedLeft(' ', 13) << juce::String("last s").paddedLeft(' ', 13)
+			<< juce::String("ratio").paddedLeft(' ', 10) << juce::String("slowest").paddedLeft(' ', 13) << std::endl;
+		for (auto& name : settings.engines)
+		{
+			if (name == "dattorro") checkDenormals<DattorroBenchmark>(name, settings);
+			else if (name == "abyssal") checkDenormals<AbyssalBenchmark>(name, settings);
+			else if (name == "spring") checkDenormals<SpringBenchmark>(name, settings);
+			else if (name == "schroeder") checkDenormals<SchroederBenchmark>(name, settings);
+			else if (name == "fdn") checkDenormals<FDNBenchmark>(name, settings);
+			else if (name == "multitap") checkDenormals<MultiTapBenchmark>(name, settings);
+			else if (name == "filter") checkDenormals<FilterBenchmark>(name, settings);
+			else if (name == "dattorro-topology") checkDenormals<DattorroTopologyBenchmark>(name, settings);
+			else if (name == "abyssal-topology") checkDenormals<AbyssalTopologyBenchmark>(name, settings);
+			else if (name == "schroeder-topology") checkDenormals<SchroederTopologyBenchmark>(name, settings);
+			else if (name == "batched-schroeder") checkDenormals<BatchedSchroederBenchmark>(name, settings);
+			else if (name == "batched-filter") checkDenormals<BatchedFilterBenchmark>(name, settings);
+		}
+		return 0;
+	}
+
+	// noise bursts : 100 ms of noise, 400 ms of silence, the tails are part of the measure
+	auto numSamples = (size_t)(settings.seconds * settings.sampleRate);
+	auto burstPeriod = (size_t)(0.5 * settings.sampleRate);
+	auto burstLength = burstPeriod / 5;
+	vector<float> inputL(numSamples, 0.0f), inputR(numSamples, 0.0f);
+	juce::Random random(1234);
+	for (size_t i = 0; i < numSamples; ++i)
+	{
+		if (i % burstPeriod < burstLength)
+		{
+			inputL[i] = 0.5f * (2.0f * random.nextFloat() - 1.0f);
+			inputR[i] = 0.5f * (2.0f * random.nextFloat() - 1.0f);
+		}
+	}
+
+	std::cout << juce::String(settings.seconds, 1) << " s at " << settings.sampleRate << " Hz, best of " << settings.repeats << " runs" << std::endl;
+	std::cout << juce::String("engine").paddedRight(' ', 20)
+		<< juce::String("float").paddedLeft(' ', 13) << juce::String("realtime").paddedLeft(' ', 10)
+		<< juce::String("double").paddedLeft(' ', 13) << juce::String("realtime").paddedLeft(' ', 10)
+		<< juce::String("speedup").paddedLeft(' ', 10) << juce::String("difference").paddedLeft(' ', 13) << std::endl;
+
+	for (auto& name : settings.engines)
+	{
+		if (name == "dattorro") compareInstantiations<DattorroBenchmark>(name, settings, inputL, inputR);
+		else if (name == "abyssal") compareInstantiations<AbyssalBenchmark>(name, settings, inputL, inputR);
+		else if (name == "spring") compareInstantiations<SpringBenchmark>(name, settings, inputL, inputR);
+		else if (name == "schroeder") compareInstantiations<SchroederBenchmark>(name, settings, inputL, inputR);
+		else if (name == "fdn") compareInstantiations<FDNBenchmark>(name, settings, inputL, inputR);
+		else if (name == "multitap") compareInstantiations<MultiTapBenchmark>(name, settings, inputL, inputR);
+		else if (name == "filter") compareInstantiations<FilterBenchmark>(name, settings, inputL, inputR);
+		else if (name == "dattorro-topology") compareInstantiations<DattorroTopologyBenchmark>(name, settings, inputL, inputR);
+		else if (name == "abyssal-topology") compareInstantiations<AbyssalTopologyBenchmark>(name, settings, inputL, inputR);
+		else if (name == "schroeder-topology") compareInstantiations<SchroederTopologyBenchmark>(name, settings, inputL, inputR);
+		else if (name == "batched-schroeder") compareInstantiations<BatchedSchroederBenchmark>(name, settings, inputL, inputR);
+		else if (name == "batched-filter") compareInstantiations<BatchedFilterBenchmark>(name, settings, inputL, inputR);
+	}
+	return 0;
+}
@@ -0,0 +1,268 @@
+/*
+  ==============================================================================
+
+    IRCapture : offline impulse response capture of the reverb engines.
+
+    Drives an engine with an exponential sweep or a maximum length sequence,
+    deconvolves the output into a stereo impulse response and writes it as a
+    32 bit float WAV file. Every point of the parameter grid is rendered by a
+    job of a thread pool.
+
+    Usage :
+    IRCapture --engine dattorro|abyssal|spring|fdn|dattorro-topology|abyssal-topology [--signal sweep|mls]
+              [--param name=v1,v2,...]... [--samplerate 48000] [--ir-length 4]
+              [--sweep-length 5] [--f1 20] [--f2 20000] [--mls-order 18]
+              [--threads N] [--block 512] [--output IRs]
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <iostream>
+#include "../../Shared/EngineAdapters.h"
+#include "../../../dsp_fv/signalGenerator.h"
+#include "../../../dsp_fv/deconvolution.h"
+
+/// <summary>
+/// Capture settings, read from the command line
+/// </summary>
+struct CaptureSettings
+{
+	juce::String engineName;
+	bool useMLS = false;
+	double sampleRate = 48000.0;
+	double irLength_s = 4.0;
+	double sweepLength_s = 5.0;
+	double f1 = 20.0;
+	double f2 = 20000.0;
+	unsigned int mlsOrder = 18;
+	int blockSize = 512;
+	int numThreads = juce::SystemStats::getNumCpus();
+	juce::File outputDirectory = juce::File::getCurrentWorkingDirectory().getChildFile("IRs");
+};
+
+/// <summary>
+/// A swept parameter and its values
+/// </summary>
+struct ParameterAxis
+{
+	juce::String name;
+	vector<double> values;
+};
+
+/// <summary>
+/// One point of the parameter grid
+/// </summary>
+using ParameterPoint = vector<std::pair<juce::String, double>>;
+
+/// <summary>
+/// Cartesian product of the parameter axes
+/// </summary>
+static vector<ParameterPoint> createParameterGrid(const vector<ParameterAxis>& axes)
+{
+	vector<ParameterPoint> grid = { {} };
+	for (auto& axis : axes)
+	{
+		vector<ParameterPoint> next;
+		for (auto& point : grid)
+			for (auto value : axis.values)
+			{
+				auto p = point;
+				p.push_back({ axis.name, value });
+				next.push_back(p);
+			}
+		grid = next;
+	}
+	return grid;
+}
+
+/// <summary>
+/// Builds the output file name from the engine name and the parameter point
+/// </summary>
+static juce::String createFileName(const juce::String& engineName, const ParameterPoint& point)
+{
+	auto name = engineName;
+	for (auto& p : point)
+		name << "_" << p.first << "=" << juce::String(p.second, 4);
+	return name + ".wav";
+}
+
+/// <summary>
+/// Writes a stereo 32 bit float WAV file
+/// </summary>
+static bool writeWavFile(const juce::File& file, const vector<float>& left, const vector<float>& right, double sampleRate)
+{
+	file.deleteFile();
+	std::unique_ptr<juce::FileOutputStream> stream(file.createOutputStream());
+	if (stream == nullptr)
+		return false;
+
+	juce::WavAudioFormat wavFormat;
+	std::unique_ptr<juce::AudioFormatWriter> writer(wavFormat.createWriterFor(stream.get(), sampleRate, 2, 32, {}, 0));
+	if (writer == nullptr)
+		return false;
+	stream.release(); // the writer owns the stream
+
+	const float* channels[] = { left.data(), right.data() };
+	return writer->writeFromFloatArrays(channels, 2, (int)left.size());
+}
+
+/// <summary>
+/// Renders the excitation through a new engine instance, by blocks
+/// </summary>
+static void renderEngine(EngineAdapter& engine, const vector<float>& excitation, vector<float>& outL, vector<float>& outR, int blockSize)
+{
+	auto length = (int)excitation.size();
+	outL.assign(length, 0.0f);
+	outR.assign(length, 0.0f);
+	for (int start = 0; start < length; start += blockSize)
+	{
+		auto numSamples = juce::jmin(blockSize, length - start);
+		// mono excitation on both inputs
+		engine.process(excitation.data() + start, excitation.data() + start, outL.data() + start, outR.data() + start, numSamples);
+	}
+}
+
+static void printUsage()
+{
+	std::cout << "IRCapture --engine dattorro|abyssal|spring|fdn|dattorro-topology|abyssal-topology [--signal sweep|mls] [--param name=v1,v2,...]..." << std::endl
+		<< "          [--samplerate 48000] [--ir-length 4] [--sweep-length 5] [--f1 20] [--f2 20000]" << std::endl
+		<< "          [--mls-order 18] [--threads N] [--block 512] [--output IRs]" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+	CaptureSettings settings;
+	vector<ParameterAxis> axes;
+
+	// command line
+	for (int i = 1; i < argc; ++i)
+	{
+		juce::String option(argv[i]);
+		juce::String value = i + 1 < argc ? juce::String(argv[i + 1]) : juce::String();
+		if (option == "--engine") settings.engineName = value;
+		else if (option == "--signal") settings.useMLS = value == "mls";
+		else if (option == "--samplerate") settings.sampleRate = value.getDoubleValue();
+		else if (option == "--ir-length") settings.irLength_s = value.getDoubleValue();
+		else if (option == "--sweep-length") settings.sweepLength_s = value.getDoubleValue();
+		else if (option == "--f1") settings.f1 = value.getDoubleValue();
+		else if (option == "--f2") settings.f2 = value.getDoubleValue();
+		else if (option == "--mls-order") settings.mlsOrder = (unsigned int)value.getIntValue();
+		else if (option == "--threads") settings.numThreads = juce::jmax(1, value.getIntValue());
+		else if (option == "--block") settings.blockSize = juce::jmax(1, value.getIntValue());
+		else if (option == "--output") settings.outputDirectory = juce::File::getCurrentWorkingDirectory().getChildFile(value);
+		else if (option == "--param")
+		{
+			ParameterAxis axis;
+			axis.name = value.upToFirstOccurrenceOf("=", false, false);
+			auto values = juce::StringArray::fromTokens(value.fromFirstOccurrenceOf("=", false, false), ",", "");
+			for (auto& v : values)
+				axis.values.push_back(v.getDoubleValue());
+			axes.push_back(axis);
+		}
+		else
+		{
+			printUsage();
+			return 1;
+		}
+		++i;
+	}
+
+	auto probe = createEngineAdapter(settings.engineName);
+	if (probe == nullptr)
+	{
+		printUsage();
+		return 1;
+	}
+	for (auto& axis : axes)
+	{
+		if (!probe->getParameterNames().contains(axis.name))
+		{
+			std::cout << "Unknown parameter " << axis.name << ", " << settings.engineName << " parameters are : "
+				<< probe->getParameterNames().joinIntoString(", ") << std::endl;
+			return 1;
+		}
+	}
+	settings.outputDirectory.createDirectory();
+
+	// excitation and deconvolution, shared by all the jobs
+	auto fs = settings.sampleRate;
+	auto irLength = (size_t)(settings.irLength_s * fs);
+	vector<float> excitation;
+	ExponentialSweepDeconvolver sweepDeconvolver;
+	MLSDeconvolver mlsDeconvolver;
+
+	if (settings.useMLS)
+	{
+		// two periods : the first one fills the engine, the second one is the steady state response
+		auto sequence = createMaximumLengthSequence(settings.mlsOrder);
+		if (irLength > sequence.size())
+		{
+			std::cout << "The MLS period is shorter than the impulse response, increase --mls-order" << std::endl;
+			return 1;
+		}
+		mlsDeconvolver.prepare(sequence);
+		excitation = sequence;
+		excitation.insert(excitation.end(), sequence.begin(), sequence.end());
+	}
+	else
+	{
+		auto sweep = createExponentialSweep(fs, settings.f1, settings.f2, settings.sweepLength_s);
+		excitation = sweep;
+		excitation.resize(sweep.size() + irLength, 0.0f);
+		sweepDeconvolver.prepare(sweep, fs, settings.f1, settings.f2, excitation.size());
+	}
+
+	auto grid = createParameterGrid(axes);
+	std::cout << "Capturing " << grid.size() << " impulse responses of " << settings.engineName
+		<< " on " << settings.numThreads << " threads" << std::endl;
+
+	juce::ThreadPool pool(settings.numThreads);
+	juce::CriticalSection logLock;
+	std::atomic<int> numFailed{ 0 };
+	auto startTime = juce::Time::getMillisecondCounterHiRes();
+
+	for (auto& point : grid)
+	{
+		pool.addJob([&, point]
+			{
+				juce::ScopedNoDenormals noDenormals;
+				auto engine = createEngineAdapter(settings.engineName);
+				engine->reset(fs);
+				for (auto& p : point)
+					engine->setParameter(p.first, p.second);
+
+				vector<float> outL, outR;
+				renderEngine(*engine, excitation, outL, outR, settings.blockSize);
+
+				vector<float> irL, irR;
+				if (settings.useMLS)
+				{
+					auto period = mlsDeconvolver.getLength();
+					irL = mlsDeconvolver.deconvolve(outL.data() + period);
+					irR = mlsDeconvolver.deconvolve(outR.data() + period);
+					irL.resize(irLength);
+					irR.resize(irLength);
+				}
+				else
+				{
+					irL = sweepDeconvolver.deconvolve(outL.data(), irLength);
+					irR = sweepDeconvolver.deconvolve(outR.data(), irLength);
+				}
+
+				auto file = settings.outputDirectory.getChildFile(createFileName(settings.engineName, point));
+				auto written = writeWavFile(file, irL, irR, fs);
+				if (!written)
+					++numFailed;
+
+				const juce::ScopedLock lock(logLock);
+				std::cout << (written ? "  " : "  FAILED ") << file.getFileName() << std::endl;
+			});
+	}
+
+	while (pool.getNumJobs() > 0)
+		juce::Thread::sleep(20);
+
+	std::cout << "Done in " << juce::String((juce::Time::getMillisecondCounterHiRes() - startTime) / 1000.0, 2) << " s" << std::endl;
+	return numFailed > 0 ? 1 : 0;
+}
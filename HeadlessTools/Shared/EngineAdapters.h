@@ -0,0 +1,755 @@
+#pragma once
+#include <JuceHeader.h>
+#include <memory>
+#include <iostream>
+#include <vector>
+
+/*
+* Engine adapters, used by the headless tools to drive the plugins' reverb engines outside of a host.
+* Each engine header declares its own ReverbControlParameters and ReverbStructureParameters, so every engine
+* is included inside its own namespace. The dsp_fv headers are included first, at global scope :
+* thanks to #pragma once the engines then share a single copy of the library.
+*/
+#include "../../dsp_fv/APFstructures.h"
+#include "../../dsp_fv/classicFilters.h"
+#include "../../dsp_fv/biquad.h"
+#include "../../dsp_fv/vibrato.h"
+#include "../../dsp_fv/batchedFilters.h"
+#include "../../dsp_fv/stateVariableFilter.h"
+#include "../../dsp_fv/iirDesigner.h"
+#include "../../dsp_fv/saturation.h"
+#include "../../dsp_fv/silenceDetector.h"
+#include "../../dsp_fv/feedbackDelayNetwork.h"
+#include "../../dsp_fv/reverbTopologies.h"
+
+namespace dattorro
+{
+#include "../../DattorroReverb/Source/DattorroPlateReverb.h"
+}
+
+namespace abyssal
+{
+#include "../../AbyssalPlateReverb/Source/AbyssalPlateReverb.h"
+}
+
+namespace spring
+{
+#include "../../ParametricSpringReverb/Source/ParametricSpringReverb_downsampled.h"
+}
+
+namespace schroeder
+{
+#include "../../SchroederReverb/Source/SchroederReverb.h"
+}
+
+// the delay has its own copy of combFilterWithFB.h, it stays in its namespace (its circular buffer is the dsp_fv one)
+namespace multitap
+{
+#include "../../AnalogMultiTapDelay/Source/MultiTapDelay.h"
+}
+
+/// <summary>
+/// Common interface to the reverb engines : parameters are set by name, audio is processed by blocks
+/// </summary>
+class EngineAdapter
+{
+public:
+	virtual ~EngineAdapter() = default;
+
+	/// <summary>
+	/// Resets the engine, allocates its delay lines
+	/// </summary>
+	virtual void reset(double sampleRate) = 0;
+
+	/// <summary>
+	/// Sets a control parameter, using the plugin parameter IDs
+	/// </summary>
+	/// <returns> false if the parameter is unknown </returns>
+	virtual bool setParameter(const juce::String& name, double value) = 0;
+
+	/// <summary>
+	/// Processes a stereo block, parameters set since the previous call are applied first
+	/// </summary>
+	virtual void process(const float* inL, const float* inR, float* outL, float* outR, int numSamples) = 0;
+
+	/// <summary>
+	/// Names of the control parameters
+	/// </summary>
+	virtual juce::StringArray getParameterNames() const = 0;
+};
+
+/// <summary>
+/// Engine adapter template : the engine is processed sample by sample, as in the plugins' processBlock()
+/// </summary>
+template <typename Engine, typename ControlParameters>
+class SampleEngineAdapter : public EngineAdapter
+{
+public:
+	void reset(double sampleRate) override
+	{
+		engine.reset(sampleRate);
+		parametersChanged = true;
+	}
+
+	void process(const float* inL, const float* inR, float* outL, float* outR, int numSamples) override
+	{
+		if (parametersChanged)
+		{
+			engine.updateParameters(controlParameters);
+			parametersChanged = false;
+		}
+
+		vector<float> input = { 0.0f, 0.0f };
+		for (auto sample = 0; sample < numSamples; ++sample)
+		{
+			input[0] = inL[sample];
+			input[1] = inR[sample];
+			auto yn = engine.processAudioSample(input);
+			outL[sample] = (float)yn[0];
+			outR[sample] = (float)yn[1];
+		}
+	}
+
+protected:
+	Engine engine;
+	ControlParameters controlParameters;
+	bool parametersChanged = true;
+};
+
+/// <summary>
+/// DattorroPlateReverb, defaults are the plugin's defaults, fully wet
+/// </summary>
+class DattorroAdapter : public SampleEngineAdapter<dattorro::DattorroPlateReverb, dattorro::ReverbControlParameters>
+{
+public:
+	DattorroAdapter()
+	{
+		controlParameters = { 1.0, 0.0, 0.75, 0.625, 0.7, 0.5, 0.5, 10.0, 20000.0 };
+	}
+
+	bool setParameter(const juce::String& name, double value) override
+	{
+		auto& p = controlParameters;
+		if (name == "mix") p.mix = value;
+		else if (name == "predelay") p.predelay = value;
+		else if (name == "inputDiffusion1") p.inputDiffusion1 = value;
+		else if (name == "inputDiffusion2") p.inputDiffusion2 = value;
+		else if (name == "decayDiffusion1") p.decayDiffusion1 = value;
+		else if (name == "decayDiffusion2") p.decayDiffusion2 = value;
+		else if (name == "decay") p.decay = value;
+		else if (name == "damping") p.damping = value;
+		else if (name == "bandwidth") p.bandwidth = value;
+		else if (name == "modulation") p.modulation = value != 0.0;
+		else return false;
+		parametersChanged = true;
+		return true;
+	}
+
+	juce::StringArray getParameterNames() const override
+	{
+		return { "mix", "predelay", "inputDiffusion1", "inputDiffusion2", "decayDiffusion1", "decayDiffusion2", "decay", "damping", "bandwidth", "modulation" };
+	}
+
+	/// <summary>
+	/// Block processing, gathered output taps, as in the plugin
+	/// </summary>
+	void process(const float* inL, const float* inR, float* outL, float* outR, int numSamples) override
+	{
+		if (parametersChanged)
+		{
+			engine.updateParameters(controlParameters);
+			parametersChanged = false;
+		}
+		engine.processBlock(inL, inR, outL, outR, numSamples);
+	}
+};
+
+/// <summary>
+/// AbyssalPlateReverb, defaults are the plugin's defaults, fully wet
+/// </summary>
+class AbyssalAdapter : public SampleEngineAdapter<abyssal::AbyssalPlateReverb, abyssal::ReverbControlParameters>
+{
+public:
+	AbyssalAdapter()
+	{
+		controlParameters.mix = 1.0f;
+		controlParameters.absorption = 20000.0f;
+		controlParameters.earlyReflexions = 0.0f;
+		controlParameters.decay = 0.0f;
+		controlParameters.damping = 0.5f;
+		controlParameters.modRate = 1.0f;
+		controlParameters.modDepth = 0.0f;
+	}
+
+	bool setParameter(const juce::String& name, double value) override
+	{
+		auto& p = controlParameters;
+		if (name == "mix") p.mix = (float)value;
+		else if (name == "absorption") p.absorption = (float)value;
+		else if (name == "earlyReflexions") p.earlyReflexions = (float)value;
+		else if (name == "decay") p.decay = (float)value;
+		else if (name == "damping") p.damping = (float)value;
+		else if (name == "modRate") p.modRate = (float)value;
+		else if (name == "modDepth") p.modDepth = (float)value;
+		else return false;
+		parametersChanged = true;
+		return true;
+	}
+
+	juce::StringArray getParameterNames() const override
+	{
+		return { "mix", "absorption", "earlyReflexions", "decay", "damping", "modRate", "modDepth" };
+	}
+
+	/// <summary>
+	/// Block processing, gathered output taps, as in the plugin
+	/// </summary>
+	void process(const float* inL, const float* inR, float* outL, float* outR, int numSamples) override
+	{
+		if (parametersChanged)
+		{
+			engine.updateParameters(controlParameters);
+			parametersChanged = false;
+		}
+		engine.processBlock(inL, inR, outL, outR, numSamples);
+	}
+};
+
+/// <summary>
+/// ParametricSpringReverb (downsampled Clf version, as used by the plugin), fully wet
+/// </summary>
+class SpringAdapter : public SampleEngineAdapter<spring::ParametricSpringReverb, spring::ReverbControlParameters>
+{
+public:
+	SpringAdapter()
+	{
+		controlParameters = { 1.0, 1.0 };
+	}
+
+	bool setParameter(const juce::String& name, double value) override
+	{
+		if (name == "mix") controlParameters.mix = value;
+		else if (name == "impulse_level") controlParameters.IR_level = value;
+		else return false;
+		parametersChanged = true;
+		return true;
+	}
+
+	juce::StringArray getParameterNames() const override
+	{
+		return { "mix", "impulse_level" };
+	}
+};
+
+/// <summary>
+/// SchroederReverbSeries, as used by the plugin : mono (mid of L and R) to both outputs, fully wet
+/// </summary>
+class SchroederAdapter : public EngineAdapter
+{
+public:
+	void reset(double sampleRate) override
+	{
+		engine.reset(sampleRate);
+		engine.setParameters(controlParameters);
+	}
+
+	bool setParameter(const juce::String& name, double value) override
+	{
+		if (name != "mix")
+			return false;
+		controlParameters.mix = value;
+		engine.setParameters(controlParameters);
+		return true;
+	}
+
+	void process(const float* inL, const float* inR, float* outL, float* outR, int numSamples) override
+	{
+		for (auto sample = 0; sample < numSamples; ++sample)
+		{
+			auto yn = engine.processAudioSample(0.5f * (inL[sample] + inR[sample]));
+			outL[sample] = yn;
+			outR[sample] = yn;
+		}
+	}
+
+	juce::StringArray getParameterNames() const override
+	{
+		return { "mix" };
+	}
+
+private:
+	schroeder::SchroederReverbSeries engine;
+	schroeder::ReverbControlParameters controlParameters = { 1.0 };
+};
+
+/// <summary>
+/// FeedbackDelayNetwork, 16 lines, fully wet. matrix : 0 Hadamard, 1 Householder.
+/// A size change reallocates the delay lines before the next block
+/// </summary>
+class FDNAdapter : public EngineAdapter
+{
+public:
+	void reset(double pSampleRate) override
+	{
+		sampleRate = pSampleRate;
+		engine.setParameters(parameters);
+		engine.reset(sampleRate);
+		sizeChanged = false;
+	}
+
+	bool setParameter(const juce::String& name, double value) override
+	{
+		if (name == "mix") parameters.mix = value;
+		else if (name == "decay") parameters.decay_s = value;
+		else if (name == "damping") parameters.damping = value;
+		else if (name == "size") { sizeChanged = sizeChanged || value != parameters.size; parameters.size = value; }
+		else if (name == "modulationRate") parameters.modulationRate_Hz = value;
+		else if (name == "modulationDepth") parameters.modulationDepth_ms = value;
+		else if (name == "matrix") parameters.matrix = value >= 0.5 ? FDNMatrixType::householder : FDNMatrixType::hadamard;
+		else return false;
+		engine.setParameters(parameters);
+		return true;
+	}
+
+	void process(const float* inL, const float* inR, float* outL, float* outR, int numSamples) override
+	{
+		if (sizeChanged)
+			reset(sampleRate);
+
+		float frame[2];
+		for (auto sample = 0; sample < numSamples; ++sample)
+		{
+			frame[0] = inL[sample];
+			frame[1] = inR[sample];
+			engine.processAudioFrame(frame);
+			outL[sample] = frame[0];
+			outR[sample] = frame[1];
+		}
+	}
+
+	juce::StringArray getParameterNames() const override
+	{
+		return { "mix", "decay", "damping", "size", "modulationRate", "modulationDepth", "matrix" };
+	}
+
+private:
+	FeedbackDelayNetwork<16> engine;
+	FDNParameters parameters;
+	double sampleRate = 44100.0;
+	bool sizeChanged = false;
+};
+
+/// <summary>
+/// Reverb topology compiled by CompiledReverb (dattorro-topology, abyssal-topology, schroeder-topology),
+/// parameters are the topology controls. Defaults are the plugins' defaults, fully wet
+/// </summary>
+class TopologyAdapter : public EngineAdapter
+{
+public:
+	TopologyAdapter(const ReverbTopology& topology)
+	{
+		engine.setTopology(topology);
+		engine.setControl("mix", 1.0);
+	}
+
+	void reset(double sampleRate) override
+	{
+		if (!engine.reset(sampleRate))
+			std::cout << engine.getTopology().name << " : " << engine.getError() << std::endl;
+		parametersChanged = true;
+	}
+
+	bool setParameter(const juce::String& name, double value) override
+	{
+		if (!getParameterNames().contains(name))
+			return false;
+		engine.setControl(name, value);
+		parametersChanged = true;
+		return true;
+	}
+
+	void process(const float* inL, const float* inR, float* outL, float* outR, int numSamples) override
+	{
+		if (parametersChanged)
+		{
+			engine.updateParameters();
+			parametersChanged = false;
+		}
+
+		float frame[2];
+		for (auto sample = 0; sample < numSamples; ++sample)
+		{
+			frame[0] = inL[sample];
+			frame[1] = inR[sample];
+			engine.processAudioFrame(frame);
+			outL[sample] = frame[0];
+			outR[sample] = frame[1];
+		}
+	}
+
+	juce::StringArray getParameterNames() const override
+	{
+		juce::StringArray names;
+		for (auto& control : engine.getTopology().controls)
+			names.add(control.name);
+		return names;
+	}
+
+private:
+	CompiledReverb engine;
+	bool parametersChanged = true;
+};
+
+/// <summary>
+/// AnalogMultiTapDelay engine, 4 taps by default and up to 64 ("taps"). Defaults are the plugin's defaults, with a 50 % mix.
+/// Units are the plugin's : mix and feedback in %, delay in ms. Each tap N has a level (tapLevel_N), a pan (tapPan_N, -1 to 1)
+/// and a tone (tapTone_N, lowpass cutoff in Hz) ; its delay is tapDelay_N in ms, or when 0 the plugin's geometric series
+/// (delay * timeRatio^(N - 1))
+/// </summary>
+class MultiTapDelayAdapter : public EngineAdapter
+{
+public:
+	MultiTapDelayAdapter()
+	{
+		taps[0].level = 1.0f;
+	}
+
+	void reset(double pSampleRate) override
+	{
+		sampleRate = pSampleRate;
+		engine.setParameters(sampleRate, delay, timeRatio, numberOfTaps, 1.0f - mix / 100, mix / 100, feedback / 100, width);
+		engine.instantiateTaps();
+		engine.createDelayBuffer((float)sampleRate, maxDelayTime);
+		engine.createNoise(0.0f);
+		engine.setFiltersParameters(lowPass, highPass);
+		engine.setSaturationParameters(saturation);
+		parametersChanged = true;
+	}
+
+	bool setParameter(const juce::String& name, double value) override
+	{
+		auto tap = name.getTrailingIntValue() - 1;
+		auto isTapParameter = tap >= 0 && tap < multitap::MultiTapDelay::maxNumberOfTaps;
+
+		if (name == "mix") mix = (float)value;
+		else if (name == "delay") delay = juce::jlimit(10.0, 5000.0, value);
+		else if (name == "feedback") feedback = (float)value;
+		else if (name == "timeRatio") timeRatio = value;
+		else if (name == "width") width = (float)value;
+		else if (name == "noiseLevel") noiseLevel = (float)value;
+		else if (name == "saturation") saturation = (float)value;
+		else if (name == "lowPass") lowPass = (float)value;
+		else if (name == "highPass") highPass = (float)value;
+		else if (name == "taps") numberOfTaps = (unsigned int)juce::jlimit(1, multitap::MultiTapDelay::maxNumberOfTaps, (int)value);
+		else if (isTapParameter && name.startsWith("tapLevel_")) taps[tap].level = (float)value;
+		else if (isTapParameter && name.startsWith("tapDelay_")) taps[tap].delay_ms = juce::jlimit(0.0, maxTapDelayTime, value);
+		else if (isTapParameter && name.startsWith("tapPan_")) taps[tap].pan = (float)value;
+		else if (isTapParameter && name.startsWith("tapTone_")) taps[tap].tone_Hz = (float)value;
+		else return false;
+		parametersChanged = true;
+		return true;
+	}
+
+	void process(const float* inL, const float* inR, float* outL, float* outR, int numSamples) override
+	{
+		if (parametersChanged)
+		{
+			// the plugin's update sequence, the taps set one by one
+			engine.setParameters(sampleRate, delay, timeRatio, numberOfTaps, 1.0f - mix / 100, mix / 100, feedback / 100, width);
+			engine.setTaps(getTapPattern());
+			engine.setNoiseLevel(noiseLevel);
+			engine.updateFiltersParameters(lowPass, highPass);
+			engine.updateSaturationParameters(saturation);
+			parametersChanged = false;
+		}
+
+		engine.processBlock(inL, inR, outL, outR, numSamples);
+	}
+
+	juce::StringArray getParameterNames() const override
+	{
+		juce::StringArray names = { "mix", "delay", "feedback", "timeRatio", "width", "noiseLevel", "saturation", "lowPass", "highPass", "taps" };
+		for (auto tap = 1; tap <= multitap::MultiTapDelay::maxNumberOfTaps; ++tap)
+			for (auto* parameter : { "tapLevel_", "tapDelay_", "tapPan_", "tapTone_" })
+				names.add(parameter + juce::String(tap));
+		return names;
+	}
+
+private:
+	/// <summary>
+	/// The numberOfTaps first taps, geometric delays where none is set, capped to the longest delay
+	/// </summary>
+	vector<multitap::MultiTapParameters> getTapPattern() const
+	{
+		vector<multitap::MultiTapParameters> pattern(taps.begin(), taps.begin() + numberOfTaps);
+		for (auto tap = 0; tap < (int)numberOfTaps; ++tap)
+			if (pattern[tap].delay_ms <= 0.0)
+				pattern[tap].delay_ms = juce::jmin(maxTapDelayTime, delay * std::pow(timeRatio, (double)tap));
+		return pattern;
+	}
+
+	multitap::MultiTapDelay engine;
+	double sampleRate = 44100.0;
+	unsigned int numberOfTaps = 4;
+	const float maxDelayTime = 5001.0f;
+	const double maxTapDelayTime = 5000.0;
+
+	float mix = 50.0f;
+	double delay = 1000.0;
+	float feedback = 0.3f;
+	double timeRatio = 1.618;
+	float width = 0.0f;
+	float noiseLevel = 0.0f;
+	float saturation = 0.0f;
+	float lowPass = 15000.0f;
+	float highPass = 20.0f;
+	vector<multitap::MultiTapParameters> taps = vector<multitap::MultiTapParameters>(multitap::MultiTapDelay::maxNumberOfTaps);
+	bool parametersChanged = true;
+};
+
+/// <summary>
+/// ClassicFilters on both channels. type : ClassicFilterType index (0 LPF1, 1 HPF1, 2 LPF2, 3 HPF2, 4 BPF2, 5 BSF2,
+/// 6 APF2, 7 PEAK, 8 LSF, 9 HSF, 10 TILT), gain : boost / cut in dB of PEAK, LSF, HSF and TILT
+/// </summary>
+class FilterAdapter : public EngineAdapter
+{
+public:
+	void reset(double pSampleRate) override
+	{
+		sampleRate = pSampleRate;
+		for (auto& filter : filters)
+			filter = ClassicFilters();
+		updateFilters();
+	}
+
+	bool setParameter(const juce::String& name, double value) override
+	{
+		if (name == "type") type = juce::jlimit(0, (int)ClassicFilterType::TILT, (int)value);
+		else if (name == "frequency") frequency = value;
+		else if (name == "q") q = value;
+		else if (name == "gain") gain_dB = value;
+		else return false;
+		updateFilters();
+		return true;
+	}
+
+	void process(const float* inL, const float* inR, float* outL, float* outR, int numSamples) override
+	{
+		for (auto sample = 0; sample < numSamples; ++sample)
+		{
+			outL[sample] = (float)filters[0].processAudioSample(inL[sample]);
+			outR[sample] = (float)filters[1].processAudioSample(inR[sample]);
+		}
+	}
+
+	juce::StringArray getParameterNames() const override
+	{
+		return { "type", "frequency", "q", "gain" };
+	}
+
+private:
+	void updateFilters()
+	{
+		for (auto& filter : filters)
+		{
+			filter.setFilterType((ClassicFilterType)type);
+			filter.setBoostCut(gain_dB);
+			filter.setCoefficients(juce::jlimit(10.0, 0.49 * sampleRate, frequency), q, sampleRate);
+		}
+	}
+
+	ClassicFilters filters[2];
+	double sampleRate = 44100.0;
+	int type = 2;
+	double frequency = 1000.0;
+	double q = 0.707;
+	double gain_dB = 0.0;
+};
+
+/// <summary>
+/// Batched engine : numLanes instances of one engine, one track per lane, processed together
+/// (structure of arrays over the instances, see batchedFilters.h)
+/// </summary>
+class BatchedEngineAdapter
+{
+public:
+	static constexpr int numLanes = 8;
+
+	virtual ~BatchedEngineAdapter() = default;
+
+	/// <summary>
+	/// Resets the engines, allocates the delay lines and the frame buffer
+	/// </summary>
+	virtual void reset(double sampleRate, int maxBlockSize) = 0;
+
+	/// <summary>
+	/// Sets a control parameter of every lane, same names as the EngineAdapter
+	/// </summary>
+	virtual bool setParameter(const juce::String& name, double value) = 0;
+
+	/// <summary>
+	/// Processes numLanes stereo tracks in place, one left and one right buffer per lane
+	/// </summary>
+	virtual void process(float* const* left, float* const* right, int numSamples) = 0;
+
+protected:
+	/// <summary>
+	/// Tracks to frames : frames[sample * numLanes + lane]
+	/// </summary>
+	void interleave(float* const* tracks, int numSamples)
+	{
+		for (int lane = 0; lane < numLanes; ++lane)
+			for (int sample = 0; sample < numSamples; ++sample)
+				frames[(size_t)sample * numLanes + lane] = tracks[lane][sample];
+	}
+
+	/// <summary>
+	/// Frames back to tracks
+	/// </summary>
+	void deinterleave(float* const* tracks, int numSamples)
+	{
+		for (int lane = 0; lane < numLanes; ++lane)
+			for (int sample = 0; sample < numSamples; ++sample)
+				tracks[lane][sample] = frames[(size_t)sample * numLanes + lane];
+	}
+
+	vector<float> frames;
+};
+
+/// <summary>
+/// SchroederReverbSeries on numLanes tracks : mono (mid of L and R) to both outputs, as the SchroederAdapter
+/// </summary>
+class BatchedSchroederAdapter : public BatchedEngineAdapter
+{
+public:
+	void reset(double sampleRate, int maxBlockSize) override
+	{
+		frames.assign((size_t)maxBlockSize * numLanes, 0.0f);
+		engine.reset(sampleRate);
+		engine.setParameters(controlParameters);
+	}
+
+	bool setParameter(const juce::String& name, double value) override
+	{
+		if (name != "mix")
+			return false;
+		controlParameters.mix = value;
+		engine.setParameters(controlParameters);
+		return true;
+	}
+
+	void process(float* const* left, float* const* right, int numSamples) override
+	{
+		for (int lane = 0; lane < numLanes; ++lane)
+			for (int sample = 0; sample < numSamples; ++sample)
+				left[lane][sample] = 0.5f * (left[lane][sample] + right[lane][sample]);
+
+		interleave(left, numSamples);
+		for (int sample = 0; sample < numSamples; ++sample)
+			engine.processAudioFrame(frames.data() + (size_t)sample * numLanes);
+		deinterleave(left, numSamples);
+
+		for (int lane = 0; lane < numLanes; ++lane)
+			std::copy(left[lane], left[lane] + numSamples, right[lane]);
+	}
+
+private:
+	schroeder::BatchedSchroederReverbSeries<numLanes> engine;
+	schroeder::ReverbControlParameters controlParameters = { 1.0 };
+};
+
+/// <summary>
+/// ClassicFilters on numLanes tracks, one batched filter per channel, as the FilterAdapter
+/// </summary>
+class BatchedFilterAdapter : public BatchedEngineAdapter
+{
+public:
+	void reset(double pSampleRate, int maxBlockSize) override
+	{
+		sampleRate = pSampleRate;
+		frames.assign((size_t)maxBlockSize * numLanes, 0.0f);
+		for (auto& filter : filters)
+			filter.reset();
+		updateFilters();
+	}
+
+	bool setParameter(const juce::String& name, double value) override
+	{
+		if (name == "type") type = juce::jlimit(0, (int)ClassicFilterType::TILT, (int)value);
+		else if (name == "frequency") frequency = value;
+		else if (name == "q") q = value;
+		else if (name == "gain") gain_dB = value;
+		else return false;
+		updateFilters();
+		return true;
+	}
+
+	void process(float* const* left, float* const* right, int numSamples) override
+	{
+		float* const* channels[] = { left, right };
+		for (int ch = 0; ch < 2; ++ch)
+		{
+			interleave(channels[ch], numSamples);
+			for (int sample = 0; sample < numSamples; ++sample)
+				filters[ch].processAudioFrame(frames.data() + (size_t)sample * numLanes);
+			deinterleave(channels[ch], numSamples);
+		}
+	}
+
+private:
+	void updateFilters()
+	{
+		for (auto& filter : filters)
+		{
+			filter.setFilterType((ClassicFilterType)type);
+			filter.setBoostCut(gain_dB);
+			filter.setCoefficients(juce::jlimit(10.0, 0.49 * sampleRate, frequency), q, sampleRate);
+		}
+	}
+
+	BatchedClassicFilters<numLanes> filters[2];
+	double sampleRate = 44100.0;
+	int type = 2;
+	double frequency = 1000.0;
+	double q = 0.707;
+	double gain_dB = 0.0;
+};
+
+/// <summary>
+/// Names accepted by createEngineAdapter()
+/// </summary>
+inline juce::StringArray getEngineNames()
+{
+	return { "dattorro", "abyssal", "spring", "schroeder", "fdn", "multitap", "filter",
+		"dattorro-topology", "abyssal-topology", "schroeder-topology" };
+}
+
+/// <summary>
+/// Creates an engine adapter from its name, see getEngineNames()
+/// </summary>
+/// <returns> nullptr if the name is unknown </returns>
+inline std::unique_ptr<EngineAdapter> createEngineAdapter(const juce::String& name)
+{
+	if (name == "dattorro") return std::make_unique<DattorroAdapter>();
+	if (name == "abyssal") return std::make_unique<AbyssalAdapter>();
+	if (name == "spring") return std::make_unique<SpringAdapter>();
+	if (name == "schroeder") return std::make_unique<SchroederAdapter>();
+	if (name == "fdn") return std::make_unique<FDNAdapter>();
+	if (name == "multitap") return std::make_unique<MultiTapDelayAdapter>();
+	if (name == "filter") return std::make_unique<FilterAdapter>();
+	if (name == "dattorro-topology") return std::make_unique<TopologyAdapter>(ReverbTopologies::dattorroPlate());
+	if (name == "abyssal-topology") return std::make_unique<TopologyAdapter>(ReverbTopologies::abyssalPlate());
+	if (name == "schroeder-topology") return std::make_unique<TopologyAdapter>(ReverbTopologies::schroederSeries());
+	return nullptr;
+}
+
+/// <summary>
+/// Creates the batched variant of an engine
+/// </summary>
+/// <returns> nullptr if the engine has no batched variant </returns>
+inline std::unique_ptr<BatchedEngineAdapter> createBatchedEngineAdapter(const juce::String& name)
+{
+	if (name == "schroeder") return std::make_unique<BatchedSchroederAdapter>();
+	if (name == "filter") return std::make_unique<BatchedFilterAdapter>();
+	return nullptr;
+}
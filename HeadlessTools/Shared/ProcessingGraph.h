@@ -0,0 +1,154 @@
+#pragma once
+#include <JuceHeader.h>
+#include <vector>
+#include <functional>
+#include <atomic>
+#include <memory>
+#include "EngineAdapters.h"
+#include "WorkStealingThreadPool.h"
+
+using std::vector;
+
+/*
+* Processing graph of the headless tools : stereo nodes (sources, engine instances, sinks) connected into a DAG.
+* Each block, the nodes without inputs are submitted to a work stealing thread pool, and every node submits the
+* nodes depending on it once their last input is ready : independent chains run in parallel, a serial chain runs
+* in order. Inputs refer to nodes added before, so the graph has no cycle by construction.
+*/
+class ProcessingGraph
+{
+public:
+	/// <summary>
+	/// Node processing : the sum of the node inputs (silence without inputs) to the node output
+	/// </summary>
+	using NodeFunction = std::function<void(const float* inL, const float* inR, float* outL, float* outR, int numSamples)>;
+
+	/// <summary>
+	/// Adds a node, its inputs are summed
+	/// </summary>
+	/// <returns> node index </returns>
+	int addNode(NodeFunction function, vector<int> inputs = {})
+	{
+		auto node = std::make_unique<Node>();
+		node->function = std::move(function);
+		node->inputs = std::move(inputs);
+		auto index = (int)nodes.size();
+		for (auto input : node->inputs)
+		{
+			jassert(input >= 0 && input < index);
+			nodes[input]->dependents.push_back(index);
+		}
+		nodes.push_back(std::move(node));
+		return index;
+	}
+
+	/// <summary>
+	/// Adds an engine instance, owned by the graph
+	/// </summary>
+	/// <returns> node index </returns>
+	int addEngine(std::unique_ptr<EngineAdapter> engine, vector<int> inputs)
+	{
+		auto* adapter = engine.get();
+		engines.push_back(std::move(engine));
+		return addNode([adapter](const float* inL, const float* inR, float* outL, float* outR, int numSamples)
+			{
+				// nodes run on any worker of the pool, as in the plugins' processBlock()
+				juce::ScopedNoDenormals noDenormals;
+				adapter->process(inL, inR, outL, outR, numSamples);
+			}, std::move(inputs));
+	}
+
+	/// <summary>
+	/// Resets the engines and allocates the node buffers
+	/// </summary>
+	void prepare(double sampleRate, int pMaxBlockSize)
+	{
+		maxBlockSize = pMaxBlockSize;
+		for (auto& engine : engines)
+			engine->reset(sampleRate);
+		for (auto& node : nodes)
+		{
+			node->output.setSize(2, maxBlockSize);
+			node->input.setSize(2, maxBlockSize);
+			node->input.clear();
+		}
+	}
+
+	/// <summary>
+	/// Processes one block through the whole graph, returns when every node has run
+	/// </summary>
+	void process(WorkStealingThreadPool& pool, int numSamples)
+	{
+		jassert(numSamples <= maxBlockSize);
+		blockSize = numSamples;
+		remainingNodes.store((int)nodes.size(), std::memory_order_relaxed);
+		for (auto& node : nodes)
+			node->remainingInputs.store((int)node->inputs.size(), std::memory_order_relaxed);
+
+		for (int i = 0; i < (int)nodes.size(); ++i)
+			if (nodes[i]->inputs.empty())
+				pool.submit([this, &pool, i] { runNode(pool, i); });
+
+		pool.waitUntil([this] { return remainingNodes.load(std::memory_order_acquire) == 0; });
+	}
+
+	const float* getOutput(int node, int channel) const
+	{
+		return nodes[node]->output.getReadPointer(channel);
+	}
+
+	int getNumNodes() const
+	{
+		return (int)nodes.size();
+	}
+
+private:
+	struct Node
+	{
+		NodeFunction function;
+		vector<int> inputs;
+		vector<int> dependents;
+		juce::AudioBuffer<float> input, output;
+		std::atomic<int> remainingInputs{ 0 };
+	};
+
+	void runNode(WorkStealingThreadPool& pool, int index)
+	{
+		auto& node = *nodes[index];
+
+		// a single input is read in place, several are summed
+		const float* inL = node.input.getReadPointer(0);
+		const float* inR = node.input.getReadPointer(1);
+		if (node.inputs.size() == 1)
+		{
+			inL = getOutput(node.inputs[0], 0);
+			inR = getOutput(node.inputs[0], 1);
+		}
+		else if (node.inputs.size() > 1)
+		{
+			node.input.clear();
+			for (auto input : node.inputs)
+				for (int ch = 0; ch < 2; ++ch)
+				{
+					auto source = getOutput(input, ch);
+					auto destination = node.input.getWritePointer(ch);
+					for (int i = 0; i < blockSize; ++i)
+						destination[i] += source[i];
+				}
+		}
+
+		node.function(inL, inR, node.output.getWritePointer(0), node.output.getWritePointer(1), blockSize);
+
+		for (auto dependent : node.dependents)
+			if (nodes[dependent]->remainingInputs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+				pool.submit([this, &pool, dependent] { runNode(pool, dependent); });
+
+		remainingNodes.fetch_sub(1, std::memory_order_acq_rel);
+	}
+
+	vector<std::unique_ptr<Node>> nodes;
+	vector<std::unique_ptr<EngineAdapter>> engines;
+	int maxBlockSize = 512;
+	int blockSize = 0;
+	std::atomic<int> remainingNodes{ 0 };
+};
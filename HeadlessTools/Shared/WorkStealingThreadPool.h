@@ -0,0 +1,182 @@
+#pragma once
+#include <JuceHeader.h>
+#include <vector>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+
+using std::vector;
+
+/*
+* Work stealing thread pool, used by the headless tools to run many engine instances in parallel.
+* Every worker owns a task queue : its own tasks are taken from the back (the most recent one, still in cache),
+* idle workers steal from the front of the other queues. Tasks submitted from outside the pool are spread
+* over the queues in turn. A thread waiting for the pool (waitUntil) runs tasks too.
+*/
+class WorkStealingThreadPool
+{
+public:
+	using Task = std::function<void()>;
+
+	/// <param name="numThreads">worker threads, the waiting thread comes on top</param>
+	explicit WorkStealingThreadPool(int numThreads)
+	{
+		numThreads = juce::jmax(1, numThreads);
+		// one queue per worker, plus one for the threads outside of the pool
+		for (int i = 0; i <= numThreads; ++i)
+			queues.push_back(std::make_unique<WorkQueue>());
+		for (int i = 0; i < numThreads; ++i)
+			threads.emplace_back([this, i] { run(i); });
+	}
+
+	~WorkStealingThreadPool()
+	{
+		{
+			const std::lock_guard<std::mutex> lock(sleepMutex);
+			shouldExit = true;
+		}
+		wakeUp.notify_all();
+		for (auto& thread : threads)
+			thread.join();
+	}
+
+	/// <summary>
+	/// Queues a task : on the calling worker's own queue, or in turn on the workers' queues
+	/// </summary>
+	void submit(Task task)
+	{
+		auto index = getCurrentQueueIndex();
+		if (index == getExternalQueueIndex())
+			index = (int)(nextQueue++ % (unsigned int)threads.size());
+
+		{
+			const std::lock_guard<std::mutex> lock(queues[index]->mutex);
+			queues[index]->tasks.push_back(std::move(task));
+		}
+		pendingTasks.fetch_add(1, std::memory_order_release);
+		{
+			// an empty critical section : a worker about to sleep has either seen the task or gets the notification
+			const std::lock_guard<std::mutex> lock(sleepMutex);
+		}
+		wakeUp.notify_one();
+	}
+
+	/// <summary>
+	/// Runs tasks on the calling thread until isDone() returns true
+	/// </summary>
+	void waitUntil(const std::function<bool()>& isDone)
+	{
+		auto index = getCurrentQueueIndex();
+		while (!isDone())
+			if (!runOneTask(index))
+				std::this_thread::yield();
+	}
+
+	int getNumThreads() const
+	{
+		return (int)threads.size();
+	}
+
+private:
+	struct WorkQueue
+	{
+		std::mutex mutex;
+		std::deque<Task> tasks;
+	};
+
+	/// <summary>
+	/// Index of the calling worker's queue, the external queue for the other threads
+	/// </summary>
+	int getCurrentQueueIndex() const
+	{
+		auto& current = getCurrentWorker();
+		return current.pool == this ? current.index : getExternalQueueIndex();
+	}
+
+	int getExternalQueueIndex() const
+	{
+		return (int)threads.size();
+	}
+
+	struct CurrentWorker
+	{
+		const WorkStealingThreadPool* pool = nullptr;
+		int index = 0;
+	};
+
+	static CurrentWorker& getCurrentWorker()
+	{
+		thread_local CurrentWorker current;
+		return current;
+	}
+
+	/// <summary>
+	/// Own queue first (LIFO), then steals from the others (FIFO)
+	/// </summary>
+	bool runOneTask(int index)
+	{
+		Task task;
+		if (!popBack(index, task))
+		{
+			auto numQueues = (int)queues.size();
+			for (int i = 1; i < numQueues && !task; ++i)
+				popFront((index + i) % numQueues, task);
+		}
+		if (!task)
+			return false;
+
+		pendingTasks.fetch_sub(1, std::memory_order_acq_rel);
+		task();
+		return true;
+	}
+
+	bool popBack(int index, Task& task)
+	{
+		auto& queue = *queues[index];
+		const std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.tasks.empty())
+			return false;
+		task = std::move(queue.tasks.back());
+		queue.tasks.pop_back();
+		return true;
+	}
+
+	bool popFront(int index, Task& task)
+	{
+		auto& queue = *queues[index];
+		const std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.tasks.empty())
+			return false;
+		task = std::move(queue.tasks.front());
+		queue.tasks.pop_front();
+		return true;
+	}
+
+	void run(int index)
+	{
+		getCurrentWorker() = { this, index };
+		for (;;)
+		{
+			if (runOneTask(index))
+				continue;
+
+			std::unique_lock<std::mutex> lock(sleepMutex);
+			wakeUp.wait(lock, [this] { return shouldExit || pendingTasks.load(std::memory_order_acquire) > 0; });
+			if (shouldExit)
+				return;
+		}
+	}
+
+	vector<std::unique_ptr<WorkQueue>> queues;
+	std::vector<std::thread> threads;
+	std::atomic<unsigned int> nextQueue{ 0 };
+	std::atomic<int> pendingTasks{ 0 };
+
+	std::mutex sleepMutex;
+	std::condition_variable wakeUp;
+	bool shouldExit = false;
+};
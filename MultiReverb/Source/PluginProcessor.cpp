@@ -0,0 +1,247 @@
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin processor.
+
+  ==============================================================================
+*/
+
+#include "PluginProcessor.h"
+#include "PluginEditor.h"
+
+//==============================================================================
+MultiReverbAudioProcessor::MultiReverbAudioProcessor()
+#ifndef JucePlugin_PreferredChannelConfigurations
+     : AudioProcessor (BusesProperties()
+                     #if ! JucePlugin_IsMidiEffect
+                      #if ! JucePlugin_IsSynth
+                       .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
+                      #endif
+                       .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
+                     #endif
+                       ),
+    parameters(*this, nullptr, juce::Identifier::Identifier("MultiReverbVTS"),
+        {
+            std::make_unique<juce::AudioParameterChoice>(
+            "algorithm", "Algorithm", getReverbAlgorithmNames(), (int)ReverbAlgorithm::dattorro),
+            std::make_unique<juce::AudioParameterFloat>(
+            "mix", "Mix", juce::NormalisableRange<float>(0.0f, 1.0f),0.0f),
+
+            // Dattorro, the ranges and defaults of the DattorroReverb plugin
+            std::make_unique<juce::AudioParameterFloat>(
+            "dattorro_predelay", "Dattorro Predelay", juce::NormalisableRange<float>(0.0f, 500.0f),0.0f),
+            std::make_unique<juce::AudioParameterFloat>(
+            "dattorro_inputDiffusion1", "Dattorro Input Diffusion 1", juce::NormalisableRange<float>(0.0f, 0.9999999f),0.75f),
+            std::make_unique<juce::AudioParameterFloat>(
+            "dattorro_inputDiffusion2", "Dattorro Input Diffusion 2", juce::NormalisableRange<float>(0.0f, 0.9999999f),0.625f),
+            std::make_unique<juce::AudioParameterFloat>(
+            "dattorro_decayDiffusion1", "Dattorro Decay Diffusion 1", juce::NormalisableRange<float>(0.0f, 0.9999999f),0.7f),
+            std::make_unique<juce::AudioParameterFloat>(
+            "dattorro_decayDiffusion2", "Dattorro Decay Diffusion 2", juce::NormalisableRange<float>(0.25f, 0.5f),0.5f),
+            std::make_unique<juce::AudioParameterFloat>(
+            "dattorro_decay", "Dattorro Decay", juce::NormalisableRange<float>(0.0f,  0.9999999f),0.5f),
+            std::make_unique<juce::AudioParameterFloat>(
+            "dattorro_damping", "Dattorro Damping", juce::NormalisableRange<float>(0.0f, 20000.0f),10.0f),
+            std::make_unique<juce::AudioParameterFloat>(
+            "dattorro_bandwidth", "Dattorro Bandwidth", juce::NormalisableRange<float>(0.0f, 20000.0f),20000.0f),
+
+            // Abyssal, the ranges and defaults of the AbyssalPlateReverb plugin
+            std::make_unique<juce::AudioParameterFloat>(
+            "abyssal_absorption", "Abyssal Absorption", juce::NormalisableRange<float>(0.0f, 20000.0f),20000.0f),
+            std::make_unique<juce::AudioParameterFloat>(
+            "abyssal_earlyReflexions", "Abyssal Early Reflexions Amount", juce::NormalisableRange<float>(0.0f, 1.0f),0.0f),
+            std::make_unique<juce::AudioParameterFloat>(
+            "abyssal_decay", "Abyssal Decay", juce::NormalisableRange<float>(0.0f, 1.0f),0.0f),
+            std::make_unique<juce::AudioParameterFloat>(
+            "abyssal_damping", "Abyssal Damping", juce::NormalisableRange<float>(0.0f, 0.9999f),0.5f),
+            std::make_unique<juce::AudioParameterFloat>(
+            "abyssal_modRate", "Abyssal Modulation Rate", juce::NormalisableRange<float>(0.01f, 10.0f),1.0f),
+            std::make_unique<juce::AudioParameterFloat>(
+            "abyssal_modDepth", "Abyssal Modulation Depth", juce::NormalisableRange<float>(0.0f, 1.0),0.0f),
+
+            // FDN, the FDNParameters defaults
+            std::make_unique<juce::AudioParameterFloat>(
+            "fdn_decay", "FDN Decay", juce::NormalisableRange<float>(0.1f, 20.0f, 0.0f, 0.5f),2.0f),
+            std::make_unique<juce::AudioParameterFloat>(
+            "fdn_damping", "FDN Damping", juce::NormalisableRange<float>(0.05f, 1.0f),0.5f),
+            std::make_unique<juce::AudioParameterFloat>(
+            "fdn_size", "FDN Size", juce::NormalisableRange<float>(0.25f, 2.0f),1.0f),
+            std::make_unique<juce::AudioParameterFloat>(
+            "fdn_modulationRate", "FDN Modulation Rate", juce::NormalisableRange<float>(0.0f, 5.0f),0.5f),
+            std::make_unique<juce::AudioParameterFloat>(
+            "fdn_modulationDepth", "FDN Modulation Depth", juce::NormalisableRange<float>(0.0f, 2.0f),0.3f),
+            std::make_unique<juce::AudioParameterBool>(
+            "fdn_matrix", "FDN Householder Matrix", false)
+        }
+    )
+#endif
+{
+    algorithm = parameters.getRawParameterValue("algorithm");
+    mix = parameters.getRawParameterValue("mix");
+    fdnSize = parameters.getRawParameterValue("fdn_size");
+    reverbHost.setFactories(getReverbAlgorithmFactories(parameters));
+    startTimerHz(10);
+}
+
+MultiReverbAudioProcessor::~MultiReverbAudioProcessor()
+{
+    stopTimer();
+}
+
+//==============================================================================
+void MultiReverbAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
+{
+    // only the selected algorithm is created and allocated, the others on selection
+    reverbHost.reset(sampleRate, samplesPerBlock, getSelectedAlgorithm(), getAllocationSetting());
+}
+
+void MultiReverbAudioProcessor::releaseResources()
+{
+    // When playback stops, you can use this as an opportunity to free up any
+    // spare memory, etc.
+}
+
+#ifndef JucePlugin_PreferredChannelConfigurations
+bool MultiReverbAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
+{
+  #if JucePlugin_IsMidiEffect
+    juce::ignoreUnused (layouts);
+    return true;
+  #else
+    // The algorithms are stereo in, stereo out
+    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+        return false;
+
+    // This checks if the input layout matches the output layout
+   #if ! JucePlugin_IsSynth
+    if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
+        return false;
+   #endif
+
+    return true;
+  #endif
+}
+#endif
+
+void MultiReverbAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    juce::ScopedNoDenormals noDenormals;
+    // processed in place
+    auto mainInputOutput = getBusBuffer(buffer, true, 0);
+    auto BufferOut_L = mainInputOutput.getWritePointer(0);
+    auto BufferOut_R = mainInputOutput.getWritePointer(1);
+
+    // the active algorithm(s) read their parameters, the mix is applied by the host
+    reverbHost.processBlock(BufferOut_L, BufferOut_R, buffer.getNumSamples(), mix->load());
+}
+
+void MultiReverbAudioProcessor::timerCallback()
+{
+    // a new selection is prepared in the background, then crossfaded in
+    reverbHost.update(getSelectedAlgorithm(), getAllocationSetting());
+}
+
+int MultiReverbAudioProcessor::getSelectedAlgorithm() const
+{
+    return (int)algorithm->load();
+}
+
+double MultiReverbAudioProcessor::getAllocationSetting() const
+{
+    // the FDN delay lengths are set when it is allocated : a size change prepares a new network
+    return getSelectedAlgorithm() == (int)ReverbAlgorithm::fdn ? fdnSize->load() : 0.0;
+}
+
+//==============================================================================
+bool MultiReverbAudioProcessor::hasEditor() const
+{
+    return false; // (change this to false if you choose to not supply an editor)
+}
+
+juce::AudioProcessorEditor* MultiReverbAudioProcessor::createEditor()
+{
+    return new MultiReverbAudioProcessorEditor (*this);
+}
+
+//==============================================================================
+const juce::String MultiReverbAudioProcessor::getName() const
+{
+    return JucePlugin_Name;
+}
+
+bool MultiReverbAudioProcessor::acceptsMidi() const
+{
+#if JucePlugin_WantsMidiInput
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool MultiReverbAudioProcessor::producesMidi() const
+{
+#if JucePlugin_ProducesMidiOutput
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool MultiReverbAudioProcessor::isMidiEffect() const
+{
+#if JucePlugin_IsMidiEffect
+    return true;
+#else
+    return false;
+#endif
+}
+
+double MultiReverbAudioProcessor::getTailLengthSeconds() const
+{
+    return reverbHost.getTailLengthSeconds();
+}
+
+int MultiReverbAudioProcessor::getNumPrograms()
+{
+    return 1;   // NB: some hosts don't cope very well if you tell them there are 0 programs,
+    // so this should be at least 1, even if you're not really implementing programs.
+}
+
+int MultiReverbAudioProcessor::getCurrentProgram()
+{
+    return 0;
+}
+
+void MultiReverbAudioProcessor::setCurrentProgram(int index)
+{
+}
+
+const juce::String MultiReverbAudioProcessor::getProgramName(int index)
+{
+    return {};
+}
+
+void MultiReverbAudioProcessor::changeProgramName(int index, const juce::String& newName)
+{
+}
+
+//==============================================================================
+void MultiReverbAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
+{
+    // You should use this method to store your parameters in the memory block.
+    // You could do that either as raw data, or use the XML or ValueTree classes
+    // as intermediaries to make it easy to save and load complex data.
+}
+
+void MultiReverbAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
+{
+    // You should use this method to restore your parameters from this memory block,
+    // whose contents will have been created by the getStateInformation() call.
+}
+
+//==============================================================================
+// This creates new instances of the plugin..
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
+{
+    return new MultiReverbAudioProcessor();
+}
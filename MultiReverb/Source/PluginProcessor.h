@@ -0,0 +1,74 @@
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin processor.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ReverbAlgorithms.h"
+
+//==============================================================================
+/**
+*/
+class MultiReverbAudioProcessor  : public juce::AudioProcessor,
+                                   private juce::Timer
+{
+public:
+    //==============================================================================
+    MultiReverbAudioProcessor();
+    ~MultiReverbAudioProcessor() override;
+
+    //==============================================================================
+    void prepareToPlay (double sampleRate, int samplesPerBlock) override;
+    void releaseResources() override;
+
+   #ifndef JucePlugin_PreferredChannelConfigurations
+    bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
+   #endif
+
+    void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+
+    //==============================================================================
+    juce::AudioProcessorEditor* createEditor() override;
+    bool hasEditor() const override;
+
+    //==============================================================================
+    const juce::String getName() const override;
+
+    bool acceptsMidi() const override;
+    bool producesMidi() const override;
+    bool isMidiEffect() const override;
+    double getTailLengthSeconds() const override;
+
+    //==============================================================================
+    int getNumPrograms() override;
+    int getCurrentProgram() override;
+    void setCurrentProgram (int index) override;
+    const juce::String getProgramName (int index) override;
+    void changeProgramName (int index, const juce::String& newName) override;
+
+    //==============================================================================
+    void getStateInformation (juce::MemoryBlock& destData) override;
+    void setStateInformation (const void* data, int sizeInBytes) override;
+
+private:
+    //==============================================================================
+    void timerCallback() override;
+    int getSelectedAlgorithm() const;
+    double getAllocationSetting() const;
+
+    juce::AudioProcessorValueTreeState parameters;
+
+    // Effect control parameters, the algorithms read their own
+    std::atomic<float>* algorithm = nullptr;
+    std::atomic<float>* mix = nullptr;
+    std::atomic<float>* fdnSize = nullptr;
+
+    // The reverb algorithms, only the selected one is allocated
+    ReverbHost reverbHost;
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MultiReverbAudioProcessor)
+};
@@ -0,0 +1,312 @@
+#pragma once
+#include <JuceHeader.h>
+#include <memory>
+
+/*
+* The reverb algorithms of the other plugins, run by the ReverbHost.
+* Each engine header declares its own ReverbControlParameters and ReverbStructureParameters, so every engine
+* is included inside its own namespace (as in HeadlessTools/Shared/EngineAdapters.h). The dsp_fv headers are
+* included first, at global scope : thanks to #pragma once the engines then share a single copy of the library.
+*/
+#include "../../dsp_fv/APFstructures.h"
+#include "../../dsp_fv/classicFilters.h"
+#include "../../dsp_fv/biquad.h"
+#include "../../dsp_fv/vibrato.h"
+#include "../../dsp_fv/batchedFilters.h"
+#include "../../dsp_fv/stateVariableFilter.h"
+#include "../../dsp_fv/silenceDetector.h"
+#include "../../dsp_fv/iirDesigner.h"
+#include "../../dsp_fv/feedbackDelayNetwork.h"
+#include "../../dsp_fv/reverbHost.h"
+
+namespace dattorro
+{
+#include "../../DattorroReverb/Source/DattorroPlateReverb.h"
+}
+
+namespace abyssal
+{
+#include "../../AbyssalPlateReverb/Source/AbyssalPlateReverb.h"
+}
+
+namespace spring
+{
+#include "../../ParametricSpringReverb/Source/ParametricSpringReverb_downsampled.h"
+}
+
+namespace schroeder
+{
+#include "../../SchroederReverb/Source/SchroederReverb.h"
+}
+
+/// <summary>
+/// Algorithm numbers, the order of the "algorithm" choice parameter
+/// </summary>
+enum class ReverbAlgorithm { schroeder, schroederSeries, dattorro, abyssal, spring, fdn };
+
+/// <summary>
+/// Names of the algorithms, in ReverbAlgorithm order
+/// </summary>
+inline juce::StringArray getReverbAlgorithmNames()
+{
+	return { "Schroeder", "Schroeder Series", "Dattorro", "Abyssal", "Spring", "FDN" };
+}
+
+/// <summary>
+/// Schroeder 1962 (parallel combs) or 1961 (series allpasses) : mono (mid of L and R) to both outputs
+/// </summary>
+template <typename Engine>
+class HostedSchroeder : public HostedReverb
+{
+public:
+	void reset(double sampleRate) override
+	{
+		engine.reset(sampleRate);
+		engine.setParameters({ 1.0 });
+	}
+
+	void updateParameters() override
+	{
+	}
+
+	void processBlock(const float* inL, const float* inR, float* wetL, float* wetR, int numSamples) override
+	{
+		for (auto sample = 0; sample < numSamples; ++sample)
+		{
+			auto yn = engine.processAudioSample(0.5f * (inL[sample] + inR[sample]));
+			wetL[sample] = yn;
+			wetR[sample] = yn;
+		}
+	}
+
+	double getTailLengthSeconds() const override
+	{
+		return engine.getTailLengthSeconds();
+	}
+
+private:
+	Engine engine;
+};
+
+/// <summary>
+/// Engines processing a stereo frame (vector of 2 samples), as in the plugins' processBlock()
+/// </summary>
+template <typename Engine, typename ControlParameters>
+class HostedFrameReverb : public HostedReverb
+{
+public:
+	void reset(double sampleRate) override
+	{
+		engine.reset(sampleRate);
+		updateParameters();
+	}
+
+	void processBlock(const float* inL, const float* inR, float* wetL, float* wetR, int numSamples) override
+	{
+		for (auto sample = 0; sample < numSamples; ++sample)
+		{
+			input[0] = inL[sample];
+			input[1] = inR[sample];
+			auto yn = engine.processAudioSample(input);
+			wetL[sample] = (float)yn[0];
+			wetR[sample] = (float)yn[1];
+		}
+	}
+
+	double getTailLengthSeconds() const override
+	{
+		return engine.getTailLengthSeconds();
+	}
+
+protected:
+	Engine engine;
+	ControlParameters controlParameters;
+	vector<float> input = { 0.0f, 0.0f };
+};
+
+/// <summary>
+/// Dattorro plate, with its tank modulation
+/// </summary>
+class HostedDattorro : public HostedFrameReverb<dattorro::DattorroPlateReverb, dattorro::ReverbControlParameters>
+{
+public:
+	HostedDattorro(juce::AudioProcessorValueTreeState& parameters)
+	{
+		predelay = parameters.getRawParameterValue("dattorro_predelay");
+		inputDiffusion1 = parameters.getRawParameterValue("dattorro_inputDiffusion1");
+		inputDiffusion2 = parameters.getRawParameterValue("dattorro_inputDiffusion2");
+		decayDiffusion1 = parameters.getRawParameterValue("dattorro_decayDiffusion1");
+		decayDiffusion2 = parameters.getRawParameterValue("dattorro_decayDiffusion2");
+		decay = parameters.getRawParameterValue("dattorro_decay");
+		damping = parameters.getRawParameterValue("dattorro_damping");
+		bandwidth = parameters.getRawParameterValue("dattorro_bandwidth");
+		controlParameters.mix = 1.0;
+	}
+
+	void updateParameters() override
+	{
+		controlParameters.predelay = predelay->load();
+		controlParameters.inputDiffusion1 = inputDiffusion1->load();
+		controlParameters.inputDiffusion2 = inputDiffusion2->load();
+		controlParameters.decayDiffusion1 = decayDiffusion1->load();
+		controlParameters.decayDiffusion2 = decayDiffusion2->load();
+		controlParameters.decay = decay->load();
+		controlParameters.damping = damping->load();
+		controlParameters.bandwidth = bandwidth->load();
+		engine.updateParameters(controlParameters);
+	}
+
+	void processBlock(const float* inL, const float* inR, float* wetL, float* wetR, int numSamples) override
+	{
+		engine.processBlock(inL, inR, wetL, wetR, numSamples);
+	}
+
+private:
+	std::atomic<float>* predelay = nullptr;
+	std::atomic<float>* inputDiffusion1 = nullptr;
+	std::atomic<float>* inputDiffusion2 = nullptr;
+	std::atomic<float>* decayDiffusion1 = nullptr;
+	std::atomic<float>* decayDiffusion2 = nullptr;
+	std::atomic<float>* decay = nullptr;
+	std::atomic<float>* damping = nullptr;
+	std::atomic<float>* bandwidth = nullptr;
+};
+
+/// <summary>
+/// Abyssal plate
+/// </summary>
+class HostedAbyssal : public HostedFrameReverb<abyssal::AbyssalPlateReverb, abyssal::ReverbControlParameters>
+{
+public:
+	HostedAbyssal(juce::AudioProcessorValueTreeState& parameters)
+	{
+		absorption = parameters.getRawParameterValue("abyssal_absorption");
+		earlyReflexions = parameters.getRawParameterValue("abyssal_earlyReflexions");
+		decay = parameters.getRawParameterValue("abyssal_decay");
+		damping = parameters.getRawParameterValue("abyssal_damping");
+		modRate = parameters.getRawParameterValue("abyssal_modRate");
+		modDepth = parameters.getRawParameterValue("abyssal_modDepth");
+		controlParameters.mix = 1.0f;
+	}
+
+	void updateParameters() override
+	{
+		controlParameters.absorption = absorption->load();
+		controlParameters.earlyReflexions = earlyReflexions->load();
+		controlParameters.decay = decay->load();
+		controlParameters.damping = damping->load();
+		controlParameters.modRate = modRate->load();
+		controlParameters.modDepth = modDepth->load();
+		engine.updateParameters(controlParameters);
+	}
+
+	void processBlock(const float* inL, const float* inR, float* wetL, float* wetR, int numSamples) override
+	{
+		engine.processBlock(inL, inR, wetL, wetR, numSamples);
+	}
+
+private:
+	std::atomic<float>* absorption = nullptr;
+	std::atomic<float>* earlyReflexions = nullptr;
+	std::atomic<float>* decay = nullptr;
+	std::atomic<float>* damping = nullptr;
+	std::atomic<float>* modRate = nullptr;
+	std::atomic<float>* modDepth = nullptr;
+};
+
+/// <summary>
+/// Parametric spring reverb, downsampled Clf version as in its plugin. No control besides the mix
+/// </summary>
+class HostedSpring : public HostedFrameReverb<spring::ParametricSpringReverb, spring::ReverbControlParameters>
+{
+public:
+	HostedSpring()
+	{
+		controlParameters = { 1.0, 1.0 };
+	}
+
+	void updateParameters() override
+	{
+		engine.updateParameters(controlParameters);
+	}
+};
+
+/// <summary>
+/// Feedback delay network, 16 lines. The size is read when the network is reset : a size change is
+/// prepared as a new instance by the host (see ReverbHost::update())
+/// </summary>
+class HostedFDN : public HostedReverb
+{
+public:
+	HostedFDN(juce::AudioProcessorValueTreeState& parameters)
+	{
+		decay = parameters.getRawParameterValue("fdn_decay");
+		damping = parameters.getRawParameterValue("fdn_damping");
+		size = parameters.getRawParameterValue("fdn_size");
+		modulationRate = parameters.getRawParameterValue("fdn_modulationRate");
+		modulationDepth = parameters.getRawParameterValue("fdn_modulationDepth");
+		matrix = parameters.getRawParameterValue("fdn_matrix");
+		fdnParameters.mix = 1.0;
+	}
+
+	void reset(double sampleRate) override
+	{
+		fdnParameters.size = size->load();
+		updateParameters();
+		engine.reset(sampleRate);
+	}
+
+	void updateParameters() override
+	{
+		fdnParameters.decay_s = decay->load();
+		fdnParameters.damping = damping->load();
+		fdnParameters.modulationRate_Hz = modulationRate->load();
+		fdnParameters.modulationDepth_ms = modulationDepth->load();
+		fdnParameters.matrix = matrix->load() >= 0.5f ? FDNMatrixType::householder : FDNMatrixType::hadamard;
+		engine.setParameters(fdnParameters);
+	}
+
+	void processBlock(const float* inL, const float* inR, float* wetL, float* wetR, int numSamples) override
+	{
+		float frame[2];
+		for (auto sample = 0; sample < numSamples; ++sample)
+		{
+			frame[0] = inL[sample];
+			frame[1] = inR[sample];
+			engine.processAudioFrame(frame);
+			wetL[sample] = frame[0];
+			wetR[sample] = frame[1];
+		}
+	}
+
+	double getTailLengthSeconds() const override
+	{
+		return engine.getTailLengthSeconds();
+	}
+
+private:
+	FeedbackDelayNetwork<16> engine;
+	FDNParameters fdnParameters;
+	std::atomic<float>* decay = nullptr;
+	std::atomic<float>* damping = nullptr;
+	std::atomic<float>* size = nullptr;
+	std::atomic<float>* modulationRate = nullptr;
+	std::atomic<float>* modulationDepth = nullptr;
+	std::atomic<float>* matrix = nullptr;
+};
+
+/// <summary>
+/// Factories of the hosted algorithms, in ReverbAlgorithm order
+/// </summary>
+inline vector<ReverbHost::Factory> getReverbAlgorithmFactories(juce::AudioProcessorValueTreeState& parameters)
+{
+	auto* state = &parameters;
+	return {
+		[] { return std::make_unique<HostedSchroeder<schroeder::SchroederReverb>>(); },
+		[] { return std::make_unique<HostedSchroeder<schroeder::SchroederReverbSeries>>(); },
+		[state] { return std::make_unique<HostedDattorro>(*state); },
+		[state] { return std::make_unique<HostedAbyssal>(*state); },
+		[] { return std::make_unique<HostedSpring>(); },
+		[state] { return std::make_unique<HostedFDN>(*state); }
+	};
+}
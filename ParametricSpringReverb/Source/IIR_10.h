@@ -1,10 +1,12 @@
 #pragma once
+#include "../../dsp_fv/iirDesigner.h"
+#include "../../dsp_fv/denormals.h"
 /*
 * Infinite Impulse Response filter class
 * 
 * Filters an input signal, sample by sample
 * As for now this is only a test version, which in unoptimized 
-* Calculation of a and b coefficients is performed externally using the "scipy.signal" library 
+* IIRfilter coefficients are computed by the dsp_fv IIRDesigner (iirDesigner.h), for the current sample rate
 */
 
 /// <summary>
@@ -108,7 +110,7 @@ public:
 				if (i == 0)
 				{
 					xStateVector[0] = xn;
-					yStateVector[0] = yn;
+					yStateVector[0] = flushDenormal(yn);
 				}
 				else
 				{
@@ -147,55 +149,20 @@ private:
 };
 
 /// <summary>
-/// 10th-order low pass Elliptic Filter
-/// N : 10
-/// type : low pass
-/// fc : 4 kHz and 5 kHz
-/// rp : 1 dB
-/// rs : attenuation in the stop band 60 dB
+/// IIR filter based on 2nd order biquad filter structures (and a 1st order one for odd orders).
+/// Coefficients are computed by the dsp_fv IIRDesigner, for the current sample rate, the sections process
+/// in SampleType, see the IIRfilter alias
 /// </summary>
-/// 
-struct IIRFilterCoeff
-{
-	//filter order
-	unsigned int N = 10;
-
-	//calculated using Python's scipy signal library
-	// 2nd order cascaded filter structures coefficients
-	//4KHz
-	//vector<vector<double>> acoeff = { { 2.08707020e-03, 4.32795775e-04, 2.08707020e-03 },
-	//	{1.00000000e+00, -1.35295140e+00, 1.00000000e+00},
-	//	{1.00000000e+00, -1.58866341e+00, 1.00000000e+00},
-	//	{1.00000000e+00, -1.64689418e+00, 1.00000000e+00},
-	//	{1.00000000e+00, -1.66280686e+00, 1.00000000e+00}};
-
-	//vector<vector<double>> bcoeff = { {1.00000000e+00, -1.71423801e+00, 7.56257719e-01},
-	//	{1.00000000e+00, -1.69763544e+00, 8.58196421e-01},
-	//	{1.00000000e+00, -1.68441929e+00, 9.41018508e-01},
-	//	{1.00000000e+00, -1.67922030e+00, 9.79415607e-01},
-	//	{1.00000000e+00, -1.67993383e+00, 9.95127711e-01} };
-	//5 kHz
-	vector<vector<double>> acoeff = { {  0.00289504, 0.00191265, 0.00289504 },
-		{1., -1.05033069, 1.},
-		{1., -1.37575949, 1.},
-		{1., -1.45959129, 1.},
-		{1., -1.48274757, 1.} };
-
-	vector<vector<double>> bcoeff = { {1., -1.63691194,		0.7021348},
-		{1., -1.57927007,		0.8274404},
-		{1., -1.53319663,		0.92846835},
-		{1., -1.51330346,		0.97507128},
-		{1., -1.50934335,		0.99410041} };
-};
-
-/// <summary>
-/// IIR filter based on 2nd order biquad filter structures, expects an even numbered filter order 
-/// </summary>
-class IIRfilter
+template <typename SampleType>
+class IIRfilterT
 {
 public:
-	IIRfilter() {
-		initializeFilter();
+	/// <summary>
+	/// Designs the filter for the given sample rate, called at reset()
+	/// </summary>
+	void design(const IIRDesignParameters& parameters, double sampleRate)
+	{
+		updateCoeff(IIRDesigner::design(parameters, sampleRate));
 	}
 
 	/// <summary>
@@ -205,16 +172,23 @@ public:
 	/// <param name="pbcoeff"></param>
 	void updateCoeff(vector<vector<double>> pacoeff, vector<vector<double>> pbcoeff, unsigned int pN, string form ="canonical")
 	{
-		coeff.N = pN;
-		coeff.acoeff = pacoeff;
-		coeff.bcoeff = pbcoeff;
-		Biquad ellipticFilterBlock{ form };
-		for (auto i = 0; i < int(coeff.N / 2); ++i)
+		SOSCoefficients sos;
+		sos.N = pN;
+		sos.acoeff = pacoeff;
+		sos.bcoeff = pbcoeff;
+		updateCoeff(sos, form);
+	}
+
+	void updateCoeff(const SOSCoefficients& sos, string form = "canonical")
+	{
+		coeff = sos;
+		filter.clear();
+		for (auto i = 0; i < (int)coeff.acoeff.size(); ++i)
 		{
-			ellipticFilterBlock.updateParameters(coeff.acoeff[i], coeff.bcoeff[i]);
-			ellipticFilterBlock.setDryWetGain(0, 1.0);
-			// Update the current filter's biquad structures
-			filter[i] = ellipticFilterBlock;
+			BiquadT<SampleType> filterBlock{ form };
+			filterBlock.updateParameters(coeff.acoeff[i], coeff.bcoeff[i]);
+			filterBlock.setDryWetGain(0, 1.0);
+			filter.push_back(filterBlock);
 		}
 	}
 
@@ -223,31 +197,22 @@ public:
 	/// </summary>
 	/// <param name="x"></param>
 	/// <returns> The processed audio sample</returns>
-	double processAudio(double x)
+	SampleType processAudio(SampleType x)
 	{
-		double output = x;
-		for (auto i = 0; i < int(coeff.N / 2); ++i)
+		SampleType output = x;
+		for (auto i = 0; i < (int)filter.size(); ++i)
 		{
 			output = filter[i].processAudioSample(output);
 		}
 		return output;
 	}
 private:
-	/// <summary>
-	/// sets 
-	/// </summary>
-	void initializeFilter()
-	{
-		Biquad ellipticFilterBlock{ "canonical" };
-		for (auto i = 0; i < int(coeff.N / 2); ++i)
-		{
-
-			ellipticFilterBlock.updateParameters(coeff.acoeff[i], coeff.bcoeff[i]);
-			ellipticFilterBlock.setDryWetGain(0, 1.0);
-			filter.push_back(ellipticFilterBlock);
-		}
-	}
 	// Member variables 
-	IIRFilterCoeff coeff; 
-	vector<Biquad> filter;
-};
\ No newline at end of file
+	SOSCoefficients coeff; 
+	vector<BiquadT<SampleType>> filter;
+};
+
+/// <summary>
+/// Single precision sections, as the dsp_fv Biquad alias
+/// </summary>
+using IIRfilter = IIRfilterT<float>;
\ No newline at end of file
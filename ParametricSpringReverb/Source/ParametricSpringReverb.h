@@ -86,6 +86,9 @@ struct ReverbStructureParameters
 	//Chf block
 	alternateAPF_1Parameters ChfCascadedAPFParam = { ahigh, true };
 	delayLineParameters ChfDelayLineParam = { Lhigh * 1.3 , true }; // times in ms
+
+	// Elliptic low pass filtering the Clf output above fC, designed at reset() for the current sample rate
+	IIRDesignParameters ellipticFilterParam = { IIRDesignType::elliptic, IIRResponseType::lowpass, 10, 5000.0, 1.0, 60.0 };
 };
 
 /// <summary>
@@ -116,11 +119,13 @@ public:
 	{
 		sampleRate = pSampleRate;
 
-		nestedAPF rNestedAPF;
+		Clf_cascadedAPF.clear();
 
 		// Mlow-order stretched APF initialization
 		for (auto i = 0; i < structureParameters.Mlow; ++i)
 		{
+			// a new instance every time : a moved-from filter loses its internal APF form
+			nestedAPF rNestedAPF;
 			rNestedAPF.reset(sampleRate);
 			rNestedAPF.setParameters(structureParameters.ClfCascadedAPFParam);
 			rNestedAPF.createDelayBuffer(sampleRate);
@@ -142,6 +147,8 @@ public:
 
 		// Leaky-Integrator which filters the modulation noise
 		leakyIntegrator.updateParameters({ (1 - structureParameters.aint),0,0 }, { 1, -structureParameters.aint ,0 });
+
+		ellipticFilter.design(structureParameters.ellipticFilterParam, sampleRate);
 	}
 
 	/// <summary>
@@ -152,7 +159,6 @@ public:
 	float processAudioSample(float input)
 	{
 		float output = 0.0f;
-		static float ynD = 0.0f;
 
 		auto temp = input - ynD;
 		//temp = structureParameters.DC_scalingFactor *  DCFilter.processAudioSample(temp);
@@ -171,15 +177,14 @@ public:
 	float processAudioSample_bis(float input)
 	{
 		float output = 0.0f;
-		static float ynD = 0.0f;
 
-		ynD = rippleFilterDelayLine.readDelayLine(structureParameters.Lripple * 44.1);
-		auto temp = input - structureParameters.springModelParam.glf * ynD;
+		ynD_bis = rippleFilterDelayLine.readDelayLine(structureParameters.Lripple * 44.1);
+		auto temp = input - structureParameters.springModelParam.glf * ynD_bis;
 		temp = structureParameters.DC_scalingFactor * DCFilter.processAudioSample(temp);
 		temp = cascadedAPF_procesAudio(temp);
 		output = temp;
 
-		ynD = multitapDelay_processAudio(output);
+		ynD_bis = multitapDelay_processAudio(output);
 
 		return output;
 	}
@@ -240,12 +245,12 @@ private:
 	double sampleRate;
 	ReverbControlParameters controlParameters;
 	ReverbStructureParameters structureParameters;
+	float ynD = 0.0f, ynD_bis = 0.0f; // feedback samples of processAudioSample() and processAudioSample_bis()
 	vector<nestedAPF> Clf_cascadedAPF;
 	Biquad DCFilter{ "canonical" };
 	Biquad leakyIntegrator{ "canonical" };
 	IIRfilter ellipticFilter;
 	delayLine preechoDelayLine, rippleFilterDelayLine, ClfDelayLine;
-	IIRFilterCoeff newCoeff;
 };
 
 /// <summary>
@@ -261,6 +266,7 @@ public:
 		structureParameters.fN = sampleRate / 2;
 
 		// Mhigh-order stretched APF initialization
+		Chf_cascadedAPF.clear();
 		for (auto i = 0; i < structureParameters.Mhigh; ++i)
 		{
 			Chf_cascadedAPF.push_back(rAPF_1);
@@ -283,7 +289,6 @@ public:
 	float processAudioSample(float input)
 	{
 		float output = 0.0f;
-		static float ynD = 0.0f;
 		juce::Random rnd;
 		auto noiseMod = leakyIntegrator.processAudioSample(rnd.nextFloat()) * structureParameters.springModelParam.gmod_high;
 
@@ -317,6 +322,7 @@ private:
 
 	double sampleRate;
 	ReverbStructureParameters structureParameters;
+	float ynD = 0.0f; // feedback sample
 	vector<stretchedAPF_2> Chf_cascadedAPF;
 	delayLine  ChfDelayLine;
 	Biquad leakyIntegrator{ "direct" };
@@ -361,7 +367,6 @@ public:
 	vector<double> processAudioSample(vector<float> inputXn)
 	{
 		auto input = 0.5f * (inputXn[0] + inputXn[1]);
-		static auto clf_out = 0.0f, chf_out = 0.0f;
 
 		clf_out = clf_structure.processAudioSample(input + structureParameters.C1 * chf_out);
 		chf_out = chf_structure.processAudioSample(input + structureParameters.C2 * clf_out);
@@ -375,9 +380,9 @@ public:
 
 private:
 	double sampleRate;
-	IIRfilter ellipticFilter;
 	ReverbControlParameters controlParameters;
 	ReverbStructureParameters structureParameters;
+	float clf_out = 0.0f, chf_out = 0.0f; // Clf and Chf outputs, cross coupled
 	Clf_structure clf_structure;
 	Chf_structure chf_structure;
 };
@@ -5,6 +5,7 @@
 */
 #include "../../dsp_fv/APFstructures.h"
 #include "../../dsp_fv/classicFilters.h"
+#include "../../dsp_fv/silenceDetector.h"
 #include "IIR_10.h"
 /// <summary>
 /// reverb Control parameters, linked to sliders
@@ -90,12 +91,16 @@ struct ReverbStructureParameters
 	//Chf block
 	alternateAPF_1Parameters ChfCascadedAPFParam = { ahigh, true };
 	delayLineParameters ChfDelayLineParam = { Lhigh * 1.3 , true }; // times in ms
+
+	// Elliptic low pass filtering the Clf output above fC, designed at reset() for the current sample rate
+	IIRDesignParameters ellipticFilterParam = { IIRDesignType::elliptic, IIRResponseType::lowpass, 10, 5000.0, 1.0, 60.0 };
 };
 
 /// <summary>
-/// Low-Frequency Feedback Delay Structure
+/// Low-Frequency Feedback Delay Structure, processed in SampleType
 /// </summary>
-class Clf_structure
+template <typename SampleType>
+class Clf_structureT
 {
 public:
 	/// <summary>
@@ -120,11 +125,13 @@ public:
 	{
 		sampleRate = pSampleRaten;
 		downSampleRate = pDownSampleRate;
-		nestedAPF rNestedAPF;
+		Clf_cascadedAPF.clear();
 
 		// Mlow-order stretched APF initialization
 		for (auto i = 0; i < structureParameters.Mlow; ++i)
 		{
+			// a new instance every time : a moved-from filter loses its internal APF form
+			nestedAPFT<SampleType> rNestedAPF;
 			rNestedAPF.reset(downSampleRate);
 			rNestedAPF.setParameters(structureParameters.ClfCascadedAPFParam);
 			rNestedAPF.createDelayBuffer(downSampleRate);
@@ -153,17 +160,16 @@ public:
 	/// </summary>
 	/// <param name="input"></param>
 	/// <returns> Processed audio sample </returns>
-	float processAudioSample(float input)
+	SampleType processAudioSample(SampleType input)
 	{
 
-		float output = 0.0f;
-		static float ynD = 0.0f;
+		SampleType output = SampleType(0);
 
 		auto temp = input - ynD;
 		//temp = structureParameters.DC_scalingFactor *  DCFilter.processAudioSample(temp);
 		temp = cascadedAPF_procesAudio(temp);
 		output = temp;
-		ynD = structureParameters.springModelParam.glf * multitapDelay_processAudio(temp);
+		ynD = flushDenormal((SampleType)structureParameters.springModelParam.glf * multitapDelay_processAudio(temp));
 
 		return output;
 	}
@@ -173,18 +179,17 @@ public:
 	/// </summary>
 	/// <param name="input"></param>
 	/// <returns> Processed audio sample </returns>
-	float processAudioSample_bis(float input)
+	SampleType processAudioSample_bis(SampleType input)
 	{
-		float output = 0.0f;
-		static float ynD = 0.0f;
+		SampleType output = SampleType(0);
 
-		ynD = rippleFilterDelayLine.readDelayLine(structureParameters.Lripple * 44.1);
-		auto temp = input - structureParameters.springModelParam.glf * ynD;
+		ynD_bis = rippleFilterDelayLine.readDelayLine(structureParameters.Lripple * 44.1);
+		auto temp = input - (SampleType)structureParameters.springModelParam.glf * ynD_bis;
 		//temp = structureParameters.DC_scalingFactor * DCFilter.processAudioSample(temp);
 		temp = cascadedAPF_procesAudio(temp);
 		output = temp;
 
-		ynD = multitapDelay_processAudio(output);
+		ynD_bis = multitapDelay_processAudio(output);
 
 		return output;
 	}
@@ -194,9 +199,9 @@ private:
 	/// </summary>
 	/// <param name="x"></param>
 	/// <returns> Processed audio sample</returns>
-	float cascadedAPF_procesAudio(float x)
+	SampleType cascadedAPF_procesAudio(SampleType x)
 	{
-		float output = 0.0f;
+		SampleType output = SampleType(0);
 		for (auto i = 0; i < structureParameters.Mlow; ++i)
 		{
 			if (i == 0)
@@ -209,33 +214,34 @@ private:
 		return output;
 	}
 
-	float multitapDelay_processAudio(float x)
+	SampleType multitapDelay_processAudio(SampleType x)
 	{
 		juce::Random rnd;
-		auto noiseMod = leakyIntegrator.processAudioSample(rnd.nextFloat()) * structureParameters.springModelParam.gmod_low;
+		auto noiseMod = leakyIntegrator.processAudioSample((SampleType)rnd.nextFloat()) * structureParameters.springModelParam.gmod_low;
 		ClfDelayLine.writeDelayLine(x);
 		auto temp = ClfDelayLine.readDelayLine(structureParameters.L0 * structureParameters.defaultSamplesPerMs + noiseMod);
 
+		auto gecho = (SampleType)structureParameters.springModelParam.gecho;
 		bool combStyle = true;
 		if (combStyle)
 		{
 			// Process using Preecho filter, comb filter style
 			auto tempwet = preechoDelayLine.readDelayLine(structureParameters.Lecho);
-			auto fullwet = temp + structureParameters.springModelParam.gecho * tempwet;
-			preechoDelayLine.writeDelayLine(fullwet);
+			auto fullwet = temp + gecho * tempwet;
+			preechoDelayLine.writeDelayLine(flushDenormal(fullwet));
 			temp = fullwet;
 
 			// Process by Ripple Filter, comb filter style
 			tempwet = rippleFilterDelayLine.readDelayLine(structureParameters.Lecho);
-			fullwet = temp + structureParameters.springModelParam.gecho * tempwet;
-			rippleFilterDelayLine.writeDelayLine(fullwet);
+			fullwet = temp + gecho * tempwet;
+			rippleFilterDelayLine.writeDelayLine(flushDenormal(fullwet));
 			temp = fullwet;
 
 		}
 		else
 		{
-			temp = preechoDelayLine.processAudioSample(temp) + structureParameters.springModelParam.gecho * temp;
-			temp = rippleFilterDelayLine.processAudioSample(temp) + structureParameters.springModelParam.gripple * temp;
+			temp = preechoDelayLine.processAudioSample(temp) + gecho * temp;
+			temp = rippleFilterDelayLine.processAudioSample(temp) + (SampleType)structureParameters.springModelParam.gripple * temp;
 		}
 
 		return temp;
@@ -245,27 +251,29 @@ private:
 	double downSampleRate;
 	ReverbControlParameters controlParameters;
 	ReverbStructureParameters structureParameters;
-	vector<nestedAPF> Clf_cascadedAPF;
-	Biquad DCFilter{ "canonical" };
-	Biquad leakyIntegrator{ "canonical" };
-	IIRfilter ellipticFilter;
-	delayLine preechoDelayLine, rippleFilterDelayLine, ClfDelayLine;
-	IIRFilterCoeff newCoeff;
+	SampleType ynD = SampleType(0), ynD_bis = SampleType(0); // feedback samples of processAudioSample() and processAudioSample_bis()
+	vector<nestedAPFT<SampleType>> Clf_cascadedAPF;
+	BiquadT<SampleType> DCFilter{ "canonical" };
+	BiquadT<SampleType> leakyIntegrator{ "canonical" };
+	IIRfilterT<SampleType> ellipticFilter;
+	delayLineT<SampleType> preechoDelayLine, rippleFilterDelayLine, ClfDelayLine;
 };
 
 /// <summary>
-/// High-Frequency Feedback Delay Structure 
+/// High-Frequency Feedback Delay Structure, processed in SampleType
 /// </summary>
-class Chf_structure
+template <typename SampleType>
+class Chf_structureT
 {
 public:
 	void reset(double pSampleRate)
 	{
 		sampleRate = pSampleRate;
-		stretchedAPF_2 rAPF_1(structureParameters.ChfCascadedAPFParam);
+		stretchedAPF_2T<SampleType> rAPF_1(structureParameters.ChfCascadedAPFParam);
 		structureParameters.fN = sampleRate / 2;
 
 		// Mhigh-order stretched APF initialization
+		Chf_cascadedAPF.clear();
 		for (auto i = 0; i < structureParameters.Mhigh; ++i)
 		{
 			Chf_cascadedAPF.push_back(rAPF_1);
@@ -285,17 +293,16 @@ public:
 	/// </summary>
 	/// <param name="input"></param>
 	/// <returns> Processed audio sample</returns>
-	float processAudioSample(float input)
+	SampleType processAudioSample(SampleType input)
 	{
-		float output = 0.0f;
-		static float ynD = 0.0f;
+		SampleType output = SampleType(0);
 		juce::Random rnd;
-		auto noiseMod = leakyIntegrator.processAudioSample(rnd.nextFloat()) * structureParameters.springModelParam.gmod_high;
+		auto noiseMod = leakyIntegrator.processAudioSample((SampleType)rnd.nextFloat()) * structureParameters.springModelParam.gmod_high;
 
 		ynD = ChfDelayLine.readDelayLine(structureParameters.Lhigh * structureParameters.defaultSamplesPerMs + noiseMod);
-		output = input - structureParameters.springModelParam.ghf * ynD;
+		output = input - (SampleType)structureParameters.springModelParam.ghf * ynD;
 		output = cascadedAPF_procesAudio(output);
-		ChfDelayLine.writeDelayLine(output);
+		ChfDelayLine.writeDelayLine(flushDenormal(output));
 
 		return output;
 	}
@@ -306,9 +313,9 @@ private:
 	/// </summary>
 	/// <param name="x"></param>
 	/// <returns> Processed audio sample</returns>
-	float cascadedAPF_procesAudio(float x)
+	SampleType cascadedAPF_procesAudio(SampleType x)
 	{
-		float output = 0.0f;
+		SampleType output = SampleType(0);
 		for (auto i = 0; i < structureParameters.Mhigh; ++i)
 		{
 			if (i == 0)
@@ -322,15 +329,18 @@ private:
 
 	double sampleRate;
 	ReverbStructureParameters structureParameters;
-	vector<stretchedAPF_2> Chf_cascadedAPF;
-	delayLine  ChfDelayLine;
-	Biquad leakyIntegrator{ "canonical" };
+	SampleType ynD = SampleType(0); // feedback sample
+	vector<stretchedAPF_2T<SampleType>> Chf_cascadedAPF;
+	delayLineT<SampleType>  ChfDelayLine;
+	BiquadT<SampleType> leakyIntegrator{ "canonical" };
 };
 
 /// <summary>
-/// Parametric Spring Reverberation Effect (2010) by V. Välimäki and J. D . Parker 
+/// Parametric Spring Reverberation Effect (2010) by V. Välimäki and J. D . Parker.
+/// Processed in SampleType (float or double), see the ParametricSpringReverb alias
 /// </summary>
-class ParametricSpringReverb
+template <typename SampleType>
+class ParametricSpringReverbT
 {
 public:
 	/// <summary>
@@ -362,30 +372,42 @@ public:
 		downsampleRate = sampleRate / decimationFactor;
 		clf_structure.reset(sampleRate, downsampleRate);
 		chf_structure.reset(sampleRate);
+		ellipticFilter.design(structureParameters.ellipticFilterParam, sampleRate);
 	}
 
-	vector<double> processAudioSample(vector<float> inputXn)
+	vector<SampleType> processAudioSample(vector<SampleType> inputXn)
 	{
-		auto input = 0.5f * (inputXn[0] + inputXn[1]);
-		static auto clf_out = 0.0f, chf_out = 0.0f;
+		auto input = SampleType(0.5) * (inputXn[0] + inputXn[1]);
 
 		// decimate input audio for the Clf block 
 		if (decimationCounter % decimationFactor == 0) {
 			decimationCounter = 1; // Reset the counter
-			clf_out = clf_structure.processAudioSample(input + structureParameters.C1 * chf_out); // process input audio by Clf structure 
+			clf_out = clf_structure.processAudioSample(input + (SampleType)structureParameters.C1 * chf_out); // process input audio by Clf structure 
 		}
 		else {
 			++decimationCounter;
-			clf_out = 0.0; // Return zero for samples not taken
+			clf_out = SampleType(0); // Return zero for samples not taken
 		}
 		clf_out = ellipticFilter.processAudio(clf_out);
 
-		chf_out = chf_structure.processAudioSample(input + structureParameters.C2 * clf_out);
+		chf_out = chf_structure.processAudioSample(input + (SampleType)structureParameters.C2 * clf_out);
 
-		double mixedSignal = structureParameters.springModelParam.ghigh * chf_out +
-			structureParameters.springModelParam.glow * clf_out +
-			structureParameters.springModelParam.gdry * input;
-		return { controlParameters.mix * mixedSignal + (1 - controlParameters.mix) * input,controlParameters.mix * mixedSignal + (1 - controlParameters.mix) * input };
+		auto& model = structureParameters.springModelParam;
+		SampleType mixedSignal = (SampleType)model.ghigh * chf_out + (SampleType)model.glow * clf_out + (SampleType)model.gdry * input;
+		auto mix = (SampleType)controlParameters.mix;
+		return { mix * mixedSignal + (1 - mix) * input, mix * mixedSignal + (1 - mix) * input };
+	}
+
+	/// <summary>
+	/// Tail length in seconds (decay by tailDecay_dB). The structure is fixed : the Clf and Chf loops, at most timeDelay_ms
+	/// long (delay lines and the group delay of the APF cascades), attenuated by glf and ghf per round trip
+	/// </summary>
+	double getTailLengthSeconds() const
+	{
+		auto& model = structureParameters.springModelParam;
+		auto loop_s = model.timeDelay_ms * 0.001;
+		auto loopGain = juce::jmax(std::abs(model.glf), std::abs(model.ghf));
+		return limitTailLength(loop_s + getFeedbackDecayTime(loopGain, loop_s));
 	}
 
 
@@ -394,9 +416,17 @@ private:
 	double downsampleRate;
 	int decimationFactor = 2;
 	int decimationCounter = 1;
-	IIRfilter ellipticFilter;
+	IIRfilterT<SampleType> ellipticFilter;
 	ReverbControlParameters controlParameters;
 	ReverbStructureParameters structureParameters;
-	Clf_structure clf_structure;
-	Chf_structure chf_structure;
+	SampleType clf_out = SampleType(0), chf_out = SampleType(0); // Clf and Chf outputs, cross coupled
+	Clf_structureT<SampleType> clf_structure;
+	Chf_structureT<SampleType> chf_structure;
 };
+
+/// <summary>
+/// Single precision reverb, the plugin's instantiation
+/// </summary>
+using Clf_structure = Clf_structureT<float>;
+using Chf_structure = Chf_structureT<float>;
+using ParametricSpringReverb = ParametricSpringReverbT<float>;
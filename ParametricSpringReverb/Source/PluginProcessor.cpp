@@ -50,6 +50,8 @@ void ParametricSpringReverbAudioProcessor::prepareToPlay(double sampleRate, int
     controlParameters.IR_level = ir_level->load();
     reverbAlgorithm.reset(sampleRate);
     reverbAlgorithm.setParameters(controlParameters);
+    silenceDetector.reset(sampleRate);
+    tailLength_s.store(reverbAlgorithm.getTailLengthSeconds());
 }
 
 void ParametricSpringReverbAudioProcessor::releaseResources()
@@ -86,6 +88,7 @@ bool ParametricSpringReverbAudioProcessor::isBusesLayoutSupported(const BusesLay
 
 void ParametricSpringReverbAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
+    juce::ScopedNoDenormals noDenormals;
     auto mainInputOutput = getBusBuffer(buffer, true, 0);
     auto BufferIn_L = mainInputOutput.getReadPointer(0);
     auto BufferIn_R = mainInputOutput.getReadPointer(1);
@@ -98,6 +101,15 @@ void ParametricSpringReverbAudioProcessor::processBlock(juce::AudioBuffer<float>
     // update Reverb Algorithm parameters
     reverbAlgorithm.updateParameters(controlParameters);
 
+    // silent input and rung out tail : the reverb is skipped, its output is zero
+    tailLength_s.store(reverbAlgorithm.getTailLengthSeconds());
+    silenceDetector.setTailLength(tailLength_s.load());
+    if (!silenceDetector.processInput(BufferIn_L, BufferIn_R, buffer.getNumSamples()))
+    {
+        mainInputOutput.clear();
+        return;
+    }
+
     vector<float> input = { 0.0, 0.0 };
     //if (impulseBool->load())
     //{
@@ -119,6 +131,7 @@ void ParametricSpringReverbAudioProcessor::processBlock(juce::AudioBuffer<float>
         BufferOut_L[sample] = yn[0];
         BufferOut_R[sample] = yn[1];
     }
+    silenceDetector.processOutput(BufferOut_L, BufferOut_R, buffer.getNumSamples());
 }
 
 //==============================================================================
@@ -166,7 +179,7 @@ bool ParametricSpringReverbAudioProcessor::isMidiEffect() const
 
 double ParametricSpringReverbAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    return tailLength_s.load();
 }
 
 int ParametricSpringReverbAudioProcessor::getNumPrograms()
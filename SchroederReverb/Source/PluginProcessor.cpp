@@ -40,6 +40,8 @@ void SchroederReverbAudioProcessor::prepareToPlay(double sampleRate, int samples
     reverbControl.mix = mix->load();
     reverbAlgorithm.reset(sampleRate);
     reverbAlgorithm.setParameters(reverbControl);
+    silenceDetector.reset(sampleRate);
+    tailLength_s.store(reverbAlgorithm.getTailLengthSeconds());
 
 }
 
@@ -77,6 +79,7 @@ bool SchroederReverbAudioProcessor::isBusesLayoutSupported(const BusesLayout& la
 
 void SchroederReverbAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
+    juce::ScopedNoDenormals noDenormals;
     auto mainInputOutput = getBusBuffer(buffer, true, 0);
     auto BufferIn_L = mainInputOutput.getReadPointer(0);
     auto BufferIn_R = mainInputOutput.getReadPointer(1);
@@ -88,6 +91,15 @@ void SchroederReverbAudioProcessor::processBlock(juce::AudioBuffer<float>& buffe
     // update Reverb Algorithm parameters
     reverbAlgorithm.setParameters(reverbControl);
 
+    // silent input and rung out tail : the reverb is skipped, its output is zero
+    tailLength_s.store(reverbAlgorithm.getTailLengthSeconds());
+    silenceDetector.setTailLength(tailLength_s.load());
+    if (!silenceDetector.processInput(BufferIn_L, BufferIn_R, buffer.getNumSamples()))
+    {
+        mainInputOutput.clear();
+        return;
+    }
+
     double rightIn = 0.0;
     double leftIn = 0.0;
 
@@ -99,6 +111,7 @@ void SchroederReverbAudioProcessor::processBlock(juce::AudioBuffer<float>& buffe
         BufferOut_L[sample] = yn;
         BufferOut_R[sample] = yn;
     }
+    silenceDetector.processOutput(BufferOut_L, BufferOut_R, buffer.getNumSamples());
 }
 
 //==============================================================================
@@ -146,7 +159,7 @@ bool SchroederReverbAudioProcessor::isMidiEffect() const
 
 double SchroederReverbAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    return tailLength_s.load();
 }
 
 int SchroederReverbAudioProcessor::getNumPrograms()
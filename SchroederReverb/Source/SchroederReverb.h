@@ -1,5 +1,7 @@
 #pragma once
 #include "../../dsp_fv/APFstructures.h"
+#include "../../dsp_fv/batchedFilters.h"
+#include "../../dsp_fv/silenceDetector.h"
 
 /// <summary>
 /// Outsidecontrol parameters (linked to Plugin parameters)
@@ -37,8 +39,10 @@ struct SchroederReverbStructureParameters
 /// composed of 4 parallel comb filters, which feed into 2 short comb APF.
 /// 
 /// My note: I do not like the sound.
+/// Processed in SampleType (float or double), see the SchroederReverb alias.
 /// </summary>
-class SchroederReverb
+template <typename SampleType>
+class SchroederReverbT
 {
 public:
 	/// <summary>
@@ -74,9 +78,9 @@ public:
 	/// </summary>
 	/// <param name="inputXn"></param>
 	/// <returns></returns>
-	virtual float processAudioSample(float inputXn)
+	virtual SampleType processAudioSample(SampleType inputXn)
 	{
-		float yn = 0.0f;
+		SampleType yn = SampleType(0);
 
 		for (auto numComb = 0; numComb < structureParameters.numberOfCombFilters; ++numComb)
 		{
@@ -87,19 +91,39 @@ public:
 		{
 			yn = APF[numbAPF].processAudioSample(yn);
 		}
-		auto output = (1 - controlParameters.mix) * inputXn + (controlParameters.mix) * yn;
+		auto mix = (SampleType)controlParameters.mix;
+		auto output = (1 - mix) * inputXn + (mix) * yn;
 		return output;
 
 
 	}
 
+	/// <summary>
+	/// Tail length in seconds (decay by tailDecay_dB) : the longest ringing comb, then the APFs in series
+	/// </summary>
+	virtual double getTailLengthSeconds() const
+	{
+		double tail_s = 0.0;
+		for (auto numComb = 0; numComb < structureParameters.numberOfCombFilters; ++numComb)
+		{
+			auto& comb = structureParameters.combFilterParameters[numComb];
+			tail_s = juce::jmax(tail_s, getFeedbackDecayTime(comb.feedbackGain, comb.delayTime_ms * 0.001));
+		}
+		for (auto numbAPF = 0; numbAPF < structureParameters.numberOfAPF; ++numbAPF)
+		{
+			auto& apf = structureParameters.apfParameters[numbAPF];
+			tail_s += getFeedbackDecayTime(apf.feedbackGain, apf.delayTime_ms * 0.001);
+		}
+		return limitTailLength(tail_s);
+	}
+
 protected:
 	double sampleRate;
 	ReverbControlParameters controlParameters;
 private:
 	SchroederReverbStructureParameters structureParameters;
-	CombFilter combFilters[4];
-	allPassFilter APF[2];
+	CombFilterT<SampleType> combFilters[4];
+	allPassFilterT<SampleType> APF[2];
 
 };
 
@@ -127,7 +151,8 @@ struct SchroederSeriesStructureParameters
 /// 
 /// My note: I like the sound of this simple reverb.
 /// </summary>
-class SchroederReverbSeries : public SchroederReverb
+template <typename SampleType>
+class SchroederReverbSeriesT : public SchroederReverbT<SampleType>
 {
 public:
 	/// <summary>
@@ -136,12 +161,12 @@ public:
 	/// <param name="pSampleRate"></param>
 	void reset(double pSampleRate) override
 	{
-		sampleRate = pSampleRate;
+		this->sampleRate = pSampleRate;
 
 		for (auto numbAPF = 0; numbAPF < seriesStructureParameters.numberOfAPF; ++numbAPF)
 		{
 			APF[numbAPF].setParameters(seriesStructureParameters.apfParameters[numbAPF]);
-			APF[numbAPF].createDelayBuffer(sampleRate);
+			APF[numbAPF].createDelayBuffer(this->sampleRate);
 		}
 	}
 	/// <summary>
@@ -149,7 +174,7 @@ public:
 	/// </summary>
 	/// <param name="inputXn"></param>
 	/// <returns></returns>
-	float processAudioSample(float inputXn) override
+	SampleType processAudioSample(SampleType inputXn) override
 	{
 		auto yn = APF[0].processAudioSample(inputXn);
 		for (auto numbAPF = 1; numbAPF < seriesStructureParameters.numberOfAPF; ++numbAPF)
@@ -157,12 +182,84 @@ public:
 			yn = APF[numbAPF].processAudioSample(yn);
 		}
 
-		auto output = (1 - controlParameters.mix) * inputXn + (controlParameters.mix) * yn;
+		auto mix = (SampleType)this->controlParameters.mix;
+		auto output = (1 - mix) * inputXn + (mix) * yn;
 		return output;
 	}
+
+	/// <summary>
+	/// Tail length in seconds (decay by tailDecay_dB) : the APFs ring one after the other
+	/// </summary>
+	double getTailLengthSeconds() const override
+	{
+		double tail_s = 0.0;
+		for (auto numbAPF = 0; numbAPF < seriesStructureParameters.numberOfAPF; ++numbAPF)
+		{
+			auto& apf = seriesStructureParameters.apfParameters[numbAPF];
+			tail_s += apf.delayTime_ms * 0.001 + getFeedbackDecayTime(apf.feedbackGain, apf.delayTime_ms * 0.001);
+		}
+		return limitTailLength(tail_s);
+	}
 protected:
 
 private:
 	SchroederSeriesStructureParameters seriesStructureParameters;
-	allPassFilter APF[5];
-};
\ No newline at end of file
+	allPassFilterT<SampleType> APF[5];
+};
+
+/// <summary>
+/// Single precision reverbs, the plugin's instantiations
+/// </summary>
+using SchroederReverb = SchroederReverbT<float>;
+using SchroederReverbSeries = SchroederReverbSeriesT<float>;
+
+/// <summary>
+/// numLanes SchroederReverbSeries instances processed together, one mono track per lane (batch rendering).
+/// All the lanes share the structure and the mix. Processed in SampleType, see the BatchedSchroederReverbSeries alias
+/// </summary>
+template <int numLanes, typename SampleType>
+class BatchedSchroederReverbSeriesT
+{
+public:
+	void setParameters(ReverbControlParameters pControlParameters)
+	{
+		controlParameters.mix = pControlParameters.mix;
+	}
+
+	void reset(double pSampleRate)
+	{
+		for (auto numbAPF = 0; numbAPF < seriesStructureParameters.numberOfAPF; ++numbAPF)
+		{
+			APF[numbAPF].setParameters(seriesStructureParameters.apfParameters[numbAPF]);
+			APF[numbAPF].createDelayBuffer(pSampleRate);
+		}
+	}
+
+	/// <summary>
+	/// processes one frame (one sample of every lane) in place
+	/// </summary>
+	void processAudioFrame(SampleType* frame)
+	{
+		alignas(32) SampleType yn[numLanes];
+		for (int lane = 0; lane < numLanes; ++lane)
+			yn[lane] = frame[lane];
+
+		for (auto numbAPF = 0; numbAPF < seriesStructureParameters.numberOfAPF; ++numbAPF)
+			APF[numbAPF].processAudioFrame(yn);
+
+		auto mix = (SampleType)controlParameters.mix;
+		for (int lane = 0; lane < numLanes; ++lane)
+			frame[lane] = (1 - mix) * frame[lane] + mix * yn[lane];
+	}
+
+private:
+	ReverbControlParameters controlParameters = { 1.0 };
+	SchroederSeriesStructureParameters seriesStructureParameters;
+	BatchedAllPassFilterT<numLanes, SampleType> APF[5];
+};
+
+/// <summary>
+/// Single precision lanes, the batch renderer's instantiation
+/// </summary>
+template <int numLanes>
+using BatchedSchroederReverbSeries = BatchedSchroederReverbSeriesT<numLanes, float>;
@@ -12,30 +12,17 @@
 void ClassicBiquadFilters_2AudioProcessorEditor::filterStyleSelection()
 {
     juce::AudioProcessorParameterWithID* param = valueTreeState.getParameter("filtertype");
-    switch (filterTypeChoice.getSelectedId()) {
-    case 1:
-        param->setValueNotifyingHost(0.0);
-        break;
-    case 2:
-        param->setValueNotifyingHost(0.25);
-        break;
-    case 3:
-        param->setValueNotifyingHost(0.5);
-        break;
-    case 4:
-        param->setValueNotifyingHost(0.75);
-        break;
-    default:
-        param->setValueNotifyingHost(0.0);
-        break;
-    }
+    // one step per filter type, item ids start at 1
+    auto numTypes = filterTypeChoice.getNumItems();
+    auto index = juce::jlimit(0, numTypes - 1, filterTypeChoice.getSelectedId() - 1);
+    param->setValueNotifyingHost(numTypes > 1 ? (float)index / (float)(numTypes - 1) : 0.0f);
 }
 //==============================================================================
 ClassicBiquadFilters_2AudioProcessorEditor::ClassicBiquadFilters_2AudioProcessorEditor (ClassicBiquadFilters_2AudioProcessor& p, juce::AudioProcessorValueTreeState& vts)
     : AudioProcessorEditor (&p), audioProcessor (p), valueTreeState(vts)
 {
 
-    setSize (480, 170);
+    setSize (600, 170);
     
     // set custom LookAndFeel, which applies to Pots and Sliders Only 
     setLookAndFeel(new abschallLookAndFeel_Sliders(juce::Colours::navy.darker(20.0f), juce::Colours::dodgerblue.darker(1.0f)));
@@ -43,6 +30,7 @@ ClassicBiquadFilters_2AudioProcessorEditor::ClassicBiquadFilters_2AudioProcessor
     cutOffAttachment.reset(new SliderAttachment(valueTreeState, "fc", cutOffPot));
     qAttachment.reset(new SliderAttachment(valueTreeState, "qfactor", qPot));
     dryWetAttachment.reset(new SliderAttachment(valueTreeState, "dryWet", dryWetPot));
+    gainAttachment.reset(new SliderAttachment(valueTreeState, "gain", gainPot));
 
     // addAndMakeVisible and attachToComponent
     for (auto i = 0; i < pots.size(); ++i)
@@ -63,16 +51,32 @@ ClassicBiquadFilters_2AudioProcessorEditor::ClassicBiquadFilters_2AudioProcessor
     dryWetLabel.setText("AMOUNT", juce::dontSendNotification);
     dryWetLabel.setJustificationType(juce::Justification::centred);
 
+    gainLabel.setText("GAIN", juce::dontSendNotification);
+    gainLabel.setJustificationType(juce::Justification::centred);
+
     // set pot value suffixes
     cutOffPot.setSuffix(" Hz");
     cutOffPot.setSkewFactorFromMidPoint(2000.0);
+    gainPot.setSuffix(" dB");
     // filter choiceComboBox
     addAndMakeVisible(filterTypeChoice);
     filterTypeChoice.addItem("LPF1", 1);
     filterTypeChoice.addItem("LPF2", 2);
     filterTypeChoice.addItem("HPF1", 3);
     filterTypeChoice.addItem("HPF2", 4);
+    filterTypeChoice.addItem("BPF2", 5);
+    filterTypeChoice.addItem("NOTCH", 6);
+    filterTypeChoice.addItem("APF2", 7);
+    filterTypeChoice.addItem("PEAK", 8);
+    filterTypeChoice.addItem("LOW SHELF", 9);
+    filterTypeChoice.addItem("HIGH SHELF", 10);
+    filterTypeChoice.addItem("TILT", 11);
     filterTypeChoiceAttachment.reset(new ComboBoxAttachment(valueTreeState, "filtertype", filterTypeChoice));
+
+    // linear phase mode, adds latency
+    addAndMakeVisible(linearPhaseButton);
+    linearPhaseButton.setButtonText("LINEAR PHASE");
+    linearPhaseAttachment.reset(new ButtonAttachment(valueTreeState, "linearPhase", linearPhaseButton));
 }
 
 
@@ -98,5 +102,7 @@ void ClassicBiquadFilters_2AudioProcessorEditor::resized()
     cutOffPot.setBounds(0, heightLabel, wPot, heightPot);
     qPot.setBounds(widthBox, heightLabel, wPot, heightPot);
     dryWetPot.setBounds(2*widthBox, heightLabel, wPot, heightPot);
-    filterTypeChoice.setBounds(3 * widthBox + 10, heightLabel, 80, heightBox/3);
+    gainPot.setBounds(3 * widthBox, heightLabel, wPot, heightPot);
+    filterTypeChoice.setBounds(4 * widthBox + 10, heightLabel, 100, heightBox/3);
+    linearPhaseButton.setBounds(4 * widthBox + 10, heightLabel + heightBox / 3 + 10, 100, heightBox / 3);
 }
@@ -36,20 +36,26 @@ private:
     rotaryPot cutOffPot;
     rotaryPot qPot;
     rotaryPot dryWetPot;
-    vector<rotaryPot*> pots = { &cutOffPot, &qPot, &dryWetPot };
+    rotaryPot gainPot;
+    vector<rotaryPot*> pots = { &cutOffPot, &qPot, &dryWetPot, &gainPot };
 
     titleLabel cutOffLabel;
     titleLabel qLabel;
     titleLabel dryWetLabel;
-    vector<juce::Label*> titleLabels = { &cutOffLabel ,&qLabel, &dryWetLabel };
+    titleLabel gainLabel;
+    vector<juce::Label*> titleLabels = { &cutOffLabel ,&qLabel, &dryWetLabel, &gainLabel };
 
     std::unique_ptr<SliderAttachment> cutOffAttachment;
     std::unique_ptr<SliderAttachment> qAttachment;
     std::unique_ptr<SliderAttachment> dryWetAttachment;
+    std::unique_ptr<SliderAttachment> gainAttachment;
 
     juce::ComboBox filterTypeChoice;
     std::unique_ptr<ComboBoxAttachment> filterTypeChoiceAttachment;
 
+    juce::ToggleButton linearPhaseButton;
+    std::unique_ptr<ButtonAttachment> linearPhaseAttachment;
+
     // components sizes
     int wPot = 120, heightPot = 90;
     int wLabel = 120, heightLabel = 30;
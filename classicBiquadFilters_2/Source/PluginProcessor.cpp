@@ -38,8 +38,17 @@ ClassicBiquadFilters_2AudioProcessor::ClassicBiquadFilters_2AudioProcessor():Aud
         std::make_unique<juce::AudioParameterFloat>(
             "filtertype",
             "Filter Type",
-            juce::NormalisableRange<float>(0.0f, 0.75f),
-            0.0f)
+            juce::NormalisableRange<float>(0.0f, 10.0f, 1.0f), // one step per filter type, see setFilterType()
+            0.0f),
+        std::make_unique<juce::AudioParameterFloat>(
+            "gain",
+            "Gain",
+            juce::NormalisableRange<float>(-24.0f, 24.0f, 0.1f), // boost / cut of the PEAK, LSF, HSF and TILT filters
+            0.0f),
+        std::make_unique<juce::AudioParameterBool>(
+            "linearPhase",
+            "Linear Phase",
+            false)
         }
     )
 {   
@@ -47,6 +56,8 @@ ClassicBiquadFilters_2AudioProcessor::ClassicBiquadFilters_2AudioProcessor():Aud
     QParameter = parameters.getRawParameterValue("qfactor");
     dryWetParameter = parameters.getRawParameterValue("dryWet");
     filterTypeParameter = parameters.getRawParameterValue("filtertype");
+    gainParameter = parameters.getRawParameterValue("gain");
+    linearPhaseParameter = parameters.getRawParameterValue("linearPhase");
 
     //filterTypeParameter = parameters.getParameter("filterChoice");
     //filterTypeNum = (int)filterTypeParameter->getValue();
@@ -69,10 +80,16 @@ void ClassicBiquadFilters_2AudioProcessor::prepareToPlay (double sampleRate, int
     auto filterTypeCopy = filterTypeParameter->load();
 
     currentSampleRate = sampleRate;
-    setFilterType((int) 4* filterTypeCopy);
+    filter.prepare(getTotalNumOutputChannels(), samplesPerBlock);
+    setFilterType((int)filterTypeCopy);
+    filter.setBoostCut(gainParameter->load());
     filter.setFilterGain(KCopy);
     filter.setCoefficients(fcCopy, QCopy, currentSampleRate);
 
+    // linear phase mode : FIR designed from the same settings, its latency is reported while it is on
+    linearPhaseFilter.prepare(getTotalNumOutputChannels(), currentSampleRate, getLinearPhaseParameters());
+    linearPhaseActive = linearPhaseParameter->load() > 0.5f;
+    setLatencySamples(linearPhaseActive ? linearPhaseFilter.getLatency() : 0);
 }
 
 void ClassicBiquadFilters_2AudioProcessor::releaseResources()
@@ -94,16 +111,32 @@ void ClassicBiquadFilters_2AudioProcessor::processBlock(juce::AudioBuffer<float>
     auto KCopy = dryWetParameter->load();
     auto filterTypeCopy = filterTypeParameter->load();
 
-    setFilterType((int) 4 * filterTypeCopy);
+    // coefficients are only recomputed when a parameter changed
+    setFilterType((int)filterTypeCopy);
+    filter.setBoostCut(gainParameter->load());
     filter.setFilterGain(KCopy);
     filter.setCoefficients(fcCopy, QCopy, currentSampleRate);
 
-    for (auto sample = 0;sample < buffer.getNumSamples(); ++sample)
+    auto linearPhase = linearPhaseParameter->load() > 0.5f;
+    if (linearPhase != linearPhaseActive)
     {
-        for (auto i = 0; i < mainInputOutput.getNumChannels(); ++i)
-        {
-            *mainInputOutput.getWritePointer(i, sample) = filter.processAudioSample(*mainInputOutput.getReadPointer(i, sample));
-        }
+        // the mode that is switched to starts from a cleared state
+        linearPhaseActive = linearPhase;
+        setLatencySamples(linearPhaseActive ? linearPhaseFilter.getLatency() : 0);
+        filter.reset();
+        linearPhaseFilter.reset();
+    }
+
+    if (linearPhaseActive)
+    {
+        // new settings are designed on a background thread and faded in
+        linearPhaseFilter.setParameters(getLinearPhaseParameters());
+        linearPhaseFilter.processBlock(mainInputOutput);
+    }
+    else
+    {
+        // every channel has its own filter state, channels are processed together by groups of 4
+        filter.processBlock(mainInputOutput);
     }
 }
 
@@ -114,12 +147,9 @@ bool ClassicBiquadFilters_2AudioProcessor::isBusesLayoutSupported (const BusesLa
     juce::ignoreUnused (layouts);
     return true;
   #else
-    // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
-    // Some plugin hosts, such as certain GarageBand versions, will only
-    // load plugins that support stereo bus layouts.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // mono, stereo and multichannel layouts (5.1, 7.1, 7.1.4 ...), up to the filter bank's channel count
+    auto numChannels = layouts.getMainOutputChannelSet().size();
+    if (numChannels < 1 || numChannels > BiquadFilterBank::maxChannels)
         return false;
 
     // This checks if the input layout matches the output layout
@@ -236,11 +266,44 @@ void ClassicBiquadFilters_2AudioProcessor::setFilterType(int filterNum)
         case 3:
             filter.setFilterType("HPF2");
             break;
+        case 4:
+            filter.setFilterType("BPF2");
+            break;
+        case 5:
+            filter.setFilterType("BSF2");
+            break;
+        case 6:
+            filter.setFilterType("APF2");
+            break;
+        case 7:
+            filter.setFilterType("PEAK");
+            break;
+        case 8:
+            filter.setFilterType("LSF");
+            break;
+        case 9:
+            filter.setFilterType("HSF");
+            break;
+        case 10:
+            filter.setFilterType("TILT");
+            break;
         default :
             filter.setFilterType("LPF1");
     }
 }
 
+LinearPhaseFilterParameters ClassicBiquadFilters_2AudioProcessor::getLinearPhaseParameters()
+{
+    // filter type as set by setFilterType()
+    LinearPhaseFilterParameters linearPhaseParameters;
+    linearPhaseParameters.filterType = filter.getFilterType();
+    linearPhaseParameters.cornerFreq = fcParameter->load();
+    linearPhaseParameters.qualityFactor = QParameter->load();
+    linearPhaseParameters.boostCut_dB = gainParameter->load();
+    linearPhaseParameters.wetGain = dryWetParameter->load();
+    return linearPhaseParameters;
+}
+
 //==============================================================================
 // This creates new instances of the plugin..
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
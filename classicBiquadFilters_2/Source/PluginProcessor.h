@@ -9,7 +9,8 @@
 #pragma once
 
 #include <JuceHeader.h>
-#include "dsp_fv/biquad.h"
+#include "../../dsp_fv/biquadFilterBank.h"
+#include "../../dsp_fv/linearPhaseFilter.h"
 using std::vector;
 //==============================================================================
 /**
@@ -64,18 +65,23 @@ public:
     //==============================================================================
     // Helper functions
     void ClassicBiquadFilters_2AudioProcessor::setFilterType(int filterNum);
+    LinearPhaseFilterParameters getLinearPhaseParameters();
 private:
     //==============================================================================
     float level = 0.0f;
     Biquad biquadFilter;
     float currentSampleRate;
 
-    ClassicFilters filter;
+    BiquadFilterBank filter; // one biquad state per channel
+    LinearPhaseFilter linearPhaseFilter; // FIR with the magnitude of the biquad, reported latency
+    bool linearPhaseActive = false;
     //juce::AudioParameterFloat* fc, * Q, * K;
     std::atomic<float>* fcParameter = nullptr;
     std::atomic<float>* QParameter = nullptr;
     std::atomic<float>* dryWetParameter = nullptr;
     std::atomic<float>* filterTypeParameter = nullptr;
+    std::atomic<float>* gainParameter = nullptr;
+    std::atomic<float>* linearPhaseParameter = nullptr;
 
     juce::AudioProcessorValueTreeState parameters;
 
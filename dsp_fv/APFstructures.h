@@ -24,7 +24,8 @@ struct DelayLine_modulationParameters
 /// <summary>
 /// Simple delay Line, Z^(-D) 
 /// </summary>
-class delayLine : private CircularBuffer<float>
+template <typename SampleType>
+class delayLineT : private CircularBuffer<SampleType>
 {
 public:
 	/// <summary>
@@ -43,10 +44,19 @@ public:
 	/// </summary>
 	/// <param name="pSampleRate"></param>
 	void createDelayBuffer(double pSampleRate) 
+	{
+		createDelayBuffer(pSampleRate, 0);
+	}
+	/// <summary>
+	/// Creates the Delay Line's Delay Buffer, at least pMinBufferLength samples long : for the taps
+	/// reading further than the delay time (see gatherDelayLineTaps())
+	/// </summary>
+	void createDelayBuffer(double pSampleRate, unsigned int pMinBufferLength)
 	{
 		currentSampleRate = pSampleRate;
 		samplesPerMsec = currentSampleRate / 1000.0;
-		auto bufferLength = (unsigned int)(parameters.delayTime_ms * samplesPerMsec) + 1;
+		parameters.delayTime_samples = parameters.delayTime_ms * samplesPerMsec;
+		auto bufferLength = juce::jmax((unsigned int)(parameters.delayTime_ms * samplesPerMsec) + 1, pMinBufferLength);
 		delayBuffer.createBuffer(bufferLength);
 
 		// flushes the delayBuffer before any read or write.
@@ -57,7 +67,7 @@ public:
 	/// </summary>
 	/// <param name="inputXn"></param>
 	/// <returns></returns>
-	virtual double processAudioSample(double inputXn)
+	virtual SampleType processAudioSample(SampleType inputXn)
 	{
 		// full wet signal processing 
 
@@ -75,7 +85,7 @@ public:
 	/// Writes to delayLine and increments writePointer by 1
 	/// </summary>
 	/// <param name="x"></param>
-	void writeDelayLine(double x)
+	void writeDelayLine(SampleType x)
 	{
 		delayBuffer.writeBuffer(x);
 	}
@@ -85,15 +95,33 @@ public:
 	/// </summary>
 	/// <param name="pDelayTime_samples"></param>
 	/// <returns></returns>
-	float readDelayLine(float pDelayTime_samples)
+	SampleType readDelayLine(double pDelayTime_samples)
 	{
 		return delayBuffer.readBuffer(pDelayTime_samples);
 	}
+	/// <summary>
+	/// Reads the delay Line at a fractional delay with cubic interpolation (see CircularBuffer::readBufferCubic()),
+	/// for modulated reads inside feedback loops. The buffer must hold pDelayTime_samples + 2
+	/// </summary>
+	/// <param name="pDelayTime_samples"></param>
+	/// <returns></returns>
+	SampleType readDelayLineCubic(double pDelayTime_samples)
+	{
+		return delayBuffer.readBufferCubic(pDelayTime_samples);
+	}
+	/// <summary>
+	/// Sums a set of fixed taps over the block just written into output (see CircularBuffer::gatherTaps()).
+	/// The longest tap + numSamples - 1 must fit in the buffer (createDelayBuffer())
+	/// </summary>
+	void gatherDelayLineTaps(const CircularBufferTap<SampleType>* taps, int numTaps, SampleType* output, int numSamples)
+	{
+		delayBuffer.gatherTaps(taps, numTaps, output, numSamples);
+	}
 
 private:
 	delayLineParameters parameters;
 	double currentSampleRate;
-	CircularBuffer delayBuffer;
+	CircularBuffer<SampleType> delayBuffer;
 	double samplesPerMsec;
 };
 
@@ -101,7 +129,8 @@ private:
 /// UNTESTED !!
 /// A sinewave modulated delay Line
 /// </summary>
-class DelayLine_modulated : private CircularBuffer<float>
+template <typename SampleType>
+class DelayLine_modulatedT : private CircularBuffer<SampleType>
 {
 public:
 	/// <summary>
@@ -149,7 +178,7 @@ public:
 	/// </summary>
 	/// <param name="inputXn">The input audio sample to process.</param>
 	/// <returns>The processed audio sample.</returns>
-	float processAudioSample(float inputXn)
+	SampleType processAudioSample(SampleType inputXn)
 	{
 		if (parameters.enableDelay == true)
 		{
@@ -174,7 +203,7 @@ private:
 	LFO lfo;
 	double currentSampleRate;
 	double samplesPerMsec;
-	CircularBuffer delayBuffer;
+	CircularBuffer<SampleType> delayBuffer;
 };
 
 struct CombFilterParameters
@@ -190,7 +219,8 @@ struct CombFilterParameters
 /// !!! This should be modified to a common max buffer length ! The class as is (3/08/2024) does not 
 /// lend itself to delay time modulation 
 /// </summary>
-class CombFilter : private CircularBuffer<float>
+template <typename SampleType>
+class CombFilterT : private CircularBuffer<SampleType>
 {
 public:
 	/// <summary>
@@ -226,7 +256,7 @@ public:
 	/// </summary>
 	/// <param name="pDelayTime_samples"></param>
 	/// <returns></returns>
-	float readDelayLine(unsigned int pDelayTime_samples)
+	SampleType readDelayLine(unsigned int pDelayTime_samples)
 	{
 		return delayBuffer.readBuffer((unsigned int) pDelayTime_samples);
 	}
@@ -235,15 +265,15 @@ public:
 	/// </summary>
 	/// <param name="inputXn"></param>
 	/// <returns></returns>
-	virtual float processAudioSample(float inputXn)
+	virtual SampleType processAudioSample(SampleType inputXn)
 	{
 		// full wet signal processing 
 
 		if (parameters.enableComb == true)
 		{
 			auto ynD = delayBuffer.readBuffer(parameters.delayTime_samples, true);
-			auto ynFullWet = inputXn + parameters.feedbackGain * ynD;
-			delayBuffer.writeBuffer(ynFullWet);
+			auto ynFullWet = inputXn + (SampleType)parameters.feedbackGain * ynD;
+			delayBuffer.writeBuffer(flushDenormal(ynFullWet));
 
 			return ynD;
 		}
@@ -255,7 +285,7 @@ protected:
 	CombFilterParameters parameters;
 	double currentSampleRate;
 	double samplesPerMsec;
-	CircularBuffer delayBuffer;
+	CircularBuffer<SampleType> delayBuffer;
 };
 
 struct FCombFilterParameters
@@ -268,7 +298,8 @@ struct FCombFilterParameters
 	double g1 = 0.0;
 };
 
-class FCombFilter : private CircularBuffer<float>
+template <typename SampleType>
+class FCombFilterT : private CircularBuffer<SampleType>
 {
 public:
 	/// <summary>
@@ -284,7 +315,7 @@ public:
 		parameters.delayTime_samples = (unsigned int)parameters.delayTime_ms * samplesPerMsec;
 		rpole.setType("direct");
 
-		rpole.updateParameters({ 1.0, 0, 0 }, {0, (-1) * (float) parameters.g1, 0}); // LowPass 1-pole filter 
+		rpole.updateParameters({ 1.0, 0, 0 }, {0, (-1) * parameters.g1, 0}); // LowPass 1-pole filter 
 	}
 
 	/// <summary>
@@ -308,7 +339,7 @@ public:
 	/// </summary>
 	/// <param name="pDelayTime_samples"></param>
 	/// <returns></returns>
-	float readDelayLine(unsigned int pDelayTime_samples)
+	SampleType readDelayLine(unsigned int pDelayTime_samples)
 	{
 		return delayBuffer.readBuffer((unsigned int)pDelayTime_samples);
 	}
@@ -317,7 +348,7 @@ public:
 	/// </summary>
 	/// <param name="inputXn"></param>
 	/// <returns></returns>
-	virtual float processAudioSample(float inputXn)
+	virtual SampleType processAudioSample(SampleType inputXn)
 	{
 		// full wet signal processing 
 
@@ -325,9 +356,9 @@ public:
 		{
 			auto ynD = delayBuffer.readBuffer(parameters.delayTime_samples, true);
 			ynD = rpole.processAudioSample(ynD);
-			auto g2 = (1 - parameters.g1) * parameters.g ;// (1 - g1) * g // eventually to be updated quickliy somewhere
+			auto g2 = (SampleType)((1 - parameters.g1) * parameters.g) ;// (1 - g1) * g // eventually to be updated quickliy somewhere
 			auto ynFullWet = inputXn + g2 * ynD;
-			delayBuffer.writeBuffer(ynFullWet);
+			delayBuffer.writeBuffer(flushDenormal(ynFullWet));
 
 			return ynD;
 		}
@@ -339,8 +370,8 @@ protected:
 	FCombFilterParameters parameters;
 	double currentSampleRate;
 	double samplesPerMsec;
-	CircularBuffer delayBuffer;
-	Biquad rpole;
+	CircularBuffer<SampleType> delayBuffer;
+	BiquadT<SampleType> rpole;
 };
 
 struct APFParameters
@@ -354,7 +385,8 @@ struct APFParameters
 /// <summary>
 /// APF class,as described in the MR Schroeder 1961 and 1962 reverberation papers
 /// </summary>
-class allPassFilter : private CircularBuffer<float>
+template <typename SampleType>
+class allPassFilterT : private CircularBuffer<SampleType>
 {
 public:
 	/// <summary>
@@ -374,11 +406,20 @@ public:
 	/// </summary>
 	/// <param name="pSampleRate"></param>
 	virtual void createDelayBuffer(double pSampleRate)
+	{
+		createDelayBuffer(pSampleRate, 0);
+	}
+
+	/// <summary>
+	/// Creates the delay buffer, at least pMinBufferLength samples long : for the taps reading further
+	/// than the delay time (see gatherDelayLineTaps())
+	/// </summary>
+	void createDelayBuffer(double pSampleRate, unsigned int pMinBufferLength)
 	{
 		currentSampleRate = pSampleRate;
 		samplesPerMsec = currentSampleRate / 1000.0;
 		parameters.delayTime_samples = (unsigned int)parameters.delayTime_ms * samplesPerMsec;
-		auto bufferLength = (unsigned int)(parameters.delayTime_ms * samplesPerMsec) + 1;
+		auto bufferLength = juce::jmax((unsigned int)(parameters.delayTime_ms * samplesPerMsec) + 1, pMinBufferLength);
 		delayBuffer.createBuffer(bufferLength);
 	}
 
@@ -388,24 +429,34 @@ public:
 	/// </summary>
 	/// <param name="pDelayTime_samples"></param>
 	/// <returns></returns>
-	float readDelayLine(unsigned int pDelayTime_samples)
+	SampleType readDelayLine(unsigned int pDelayTime_samples)
 	{
 		return delayBuffer.readBuffer((unsigned int)pDelayTime_samples);
 	}
 
+	/// <summary>
+	/// Sums a set of fixed taps over the block just written into output (see CircularBuffer::gatherTaps()).
+	/// The longest tap + numSamples - 1 must fit in the buffer (createDelayBuffer())
+	/// </summary>
+	void gatherDelayLineTaps(const CircularBufferTap<SampleType>* taps, int numTaps, SampleType* output, int numSamples)
+	{
+		delayBuffer.gatherTaps(taps, numTaps, output, numSamples);
+	}
+
 	/// <summary>
 	/// Processes the incoming audio sample, output is full wet 
 	/// </summary>
 	/// <param name="inputXn"></param>
 	/// <returns></returns>
-	virtual float processAudioSample(float inputXn)
+	virtual SampleType processAudioSample(SampleType inputXn)
 	{
-		auto ynD = 0.0;
+		auto ynD = SampleType(0);
 		if (parameters.enableAPF == true)
 		{
+			auto g = (SampleType)parameters.feedbackGain;
 			ynD = delayBuffer.readBuffer(parameters.delayTime_samples);
-			delayBuffer.writeBuffer(inputXn + ynD * parameters.feedbackGain);
-			auto yn = (1 - parameters.feedbackGain * parameters.feedbackGain) * ynD + inputXn * (-parameters.feedbackGain);
+			delayBuffer.writeBuffer(flushDenormal(inputXn + ynD * g));
+			auto yn = (1 - g * g) * ynD + inputXn * (-g);
 
 			return yn;
 		}
@@ -418,13 +469,14 @@ protected:
 	APFParameters parameters; //change parameters by apfParameters 
 	double currentSampleRate;
 	double samplesPerMsec;
-	CircularBuffer delayBuffer;
+	CircularBuffer<SampleType> delayBuffer;
 };
 
 /// <summary>
 /// Lattice APF structure / alternate APF as described by Jon Dattorro and Will Pirkle 
 /// </summary>
-class alternateAllPassFilter : public allPassFilter
+template <typename SampleType>
+class alternateAllPassFilterT : public allPassFilterT<SampleType>
 {
 public:
 	/// <summary>
@@ -432,14 +484,15 @@ public:
 	/// </summary>
 	/// <param name="inputXn"></param>
 	/// <returns> The processed Audio sample</returns>
-	float processAudioSample(float inputXn) override
+	SampleType processAudioSample(SampleType inputXn) override
 	{
-		if (parameters.enableAPF == true)
+		if (this->parameters.enableAPF == true)
 		{
-			auto ynD = delayBuffer.readBuffer(parameters.delayTime_samples, true);
-			auto temp = inputXn + ynD * parameters.feedbackGain;
-			delayBuffer.writeBuffer(temp);
-			auto yn = -parameters.feedbackGain * temp + ynD;
+			auto g = (SampleType)this->parameters.feedbackGain;
+			auto ynD = this->delayBuffer.readBuffer(this->parameters.delayTime_samples, true);
+			auto temp = inputXn + ynD * g;
+			this->delayBuffer.writeBuffer(flushDenormal(temp));
+			auto yn = -g * temp + ynD;
 
 			return yn;
 		}
@@ -464,7 +517,8 @@ struct APF_modulationParameters
 /// <summary>
 /// Class for an alternate all-pass filter with modulation.
 /// </summary>
-class alternateAllPassFilter_modulated : public allPassFilter
+template <typename SampleType>
+class alternateAllPassFilter_modulatedT : public allPassFilterT<SampleType>
 {
 public:
 	/// <summary>
@@ -473,8 +527,8 @@ public:
 	/// <param name="pSampleRate">The new sample rate.</param>
 	void reset(double pSampleRate)
 	{
-		currentSampleRate = pSampleRate;
-		lfo.reset(currentSampleRate);
+		this->currentSampleRate = pSampleRate;
+		lfo.reset(this->currentSampleRate);
 	}
 
 	/// <summary>
@@ -484,7 +538,7 @@ public:
 	/// <param name="pApfModParameters">Modulation parameters for the filter.</param>
 	void setParameters(APFParameters pAPFparameters, APF_modulationParameters pApfModParameters)
 	{
-		allPassFilter::setParameters(pAPFparameters);
+		allPassFilterT<SampleType>::setParameters(pAPFparameters);
 		setModulationParameters(pApfModParameters);
 
 		OscillatorParameters lfoParams = { generatorWaveform::kSin, apfModParameters.LFORate_Hz };
@@ -497,16 +551,16 @@ public:
 	/// <param name="pSampleRate">The sample rate.</param>
 	void createDelayBuffer(double pSampleRate) override
 	{
-		currentSampleRate = pSampleRate;
-		samplesPerMsec = currentSampleRate / 1000.0;
+		this->currentSampleRate = pSampleRate;
+		this->samplesPerMsec = this->currentSampleRate / 1000.0;
 		
 		// Buffer length needs to take the excursion time (in samples) into account.
-		auto bufferLength = (unsigned int)((parameters.delayTime_ms + apfModParameters.excursion_ms) * samplesPerMsec + 1);
-		parameters.delayTime_samples = parameters.delayTime_ms * samplesPerMsec;
-		apfModParameters.excursion_samples = apfModParameters.excursion_ms * samplesPerMsec;
-		delayBuffer.createBuffer(bufferLength);
+		auto bufferLength = (unsigned int)((this->parameters.delayTime_ms + apfModParameters.excursion_ms) * this->samplesPerMsec + 1);
+		this->parameters.delayTime_samples = this->parameters.delayTime_ms * this->samplesPerMsec;
+		apfModParameters.excursion_samples = apfModParameters.excursion_ms * this->samplesPerMsec;
+		this->delayBuffer.createBuffer(bufferLength);
 		//flush the delay line
-		delayBuffer.flush();
+		this->delayBuffer.flush();
 	}
 
 	/// <summary>
@@ -514,9 +568,9 @@ public:
 	/// </summary>
 	/// <param name="inputXn">The input audio sample to process.</param>
 	/// <returns>The processed audio sample.</returns>
-	float processAudioSample(float inputXn) override
+	SampleType processAudioSample(SampleType inputXn) override
 	{
-		if (parameters.enableAPF == true)
+		if (this->parameters.enableAPF == true)
 		{
 			double modValue = 0.0;
 			if (apfModParameters.enableLFO == true)
@@ -525,10 +579,11 @@ public:
 				auto modValue = outLfo.normalOutput * apfModParameters.excursion_samples;
 			}
 
-			auto ynD = delayBuffer.readBuffer(parameters.delayTime_samples + modValue, true);
-			auto temp = inputXn + parameters.feedbackGain * ynD;
-			delayBuffer.writeBuffer(temp);
-			auto yn = -parameters.feedbackGain * temp + ynD;
+			auto g = (SampleType)this->parameters.feedbackGain;
+			auto ynD = this->delayBuffer.readBuffer(this->parameters.delayTime_samples + modValue, true);
+			auto temp = inputXn + g * ynD;
+			this->delayBuffer.writeBuffer(flushDenormal(temp));
+			auto yn = -g * temp + ynD;
 			return yn;
 		}
 		else
@@ -566,16 +621,17 @@ struct  alternateAPF_1Parameters
 /// <summary>
 /// First-Order IIR Allpass
 /// </summary>
-class alternateAPF_1
+template <typename SampleType>
+class alternateAPF_1T
 {
 public:
-	alternateAPF_1() {
+	alternateAPF_1T() {
 		aCoeffVector = { 1,0,0 };
 		bCoeffVector = { 1,0,0 };
-		form = "direct";
+		form = BiquadForm::direct;
 	}
 
-	alternateAPF_1(const string f) :form(f)
+	alternateAPF_1T(const string f) :form(getBiquadForm(f))
 	{
 		aCoeffVector = { 1,0,0 };
 		bCoeffVector = { 1,0,0 };
@@ -584,29 +640,38 @@ public:
 	/// Constructs a Biquad filter with a specified form but with default coefficients.
 	/// </summary>
 	/// <param name="f">The form of the biquad filter (e.g., "direct", "canonical").</param>
-	alternateAPF_1(vector<double> aCoeff, vector<double> bCoeff, string f = "direct") :
-		aCoeffVector(aCoeff), bCoeffVector(bCoeff), form(f) { }
+	alternateAPF_1T(vector<double> aCoeff, vector<double> bCoeff, string f = "direct") :
+		form(getBiquadForm(f))
+	{
+		for (int i = 0; i < 3; ++i)
+		{
+			aCoeffVector[i] = (SampleType)aCoeff[i];
+			bCoeffVector[i] = (SampleType)bCoeff[i];
+		}
+	}
 
-	alternateAPF_1(double feedback, string f = "direct") 
+	alternateAPF_1T(double feedback, string f = "direct") 
 	{
-		aCoeffVector = { feedback,1,0 };
-		bCoeffVector = { 1,feedback,0 };
-		form = "direct";
+		updateCoefficient(feedback);
+		form = BiquadForm::direct;
 	}
-	alternateAPF_1(alternateAPF_1Parameters pParameters) : parameters(pParameters)
+	alternateAPF_1T(alternateAPF_1Parameters pParameters) : parameters(pParameters)
 	{
 		updateCoefficient(parameters.feedbackGain);
-		form = "direct";
+		form = BiquadForm::direct;
 	}
 
+	virtual ~alternateAPF_1T() = default;
+
 	/// <summary>
 	/// Updates the alternate allpass filter's feedback coefficient
 	/// </summary>
 	/// <param name="pFeedback"></param>
 	virtual void updateCoefficient(double pFeedback)
 	{
-		aCoeffVector = { pFeedback,1,0 };
-		bCoeffVector = { 1,pFeedback,0 };
+		auto feedback = (SampleType)pFeedback;
+		aCoeffVector = { feedback,1,0 };
+		bCoeffVector = { 1,feedback,0 };
 
 		parameters.feedbackGain = pFeedback;
 	}
@@ -624,60 +689,61 @@ public:
 	/// </summary>
 	/// <param name="inputXn"></param>
 	/// <returns> The processed Audio sample</returns>
-	double processAudioSample(float xn) 
+	SampleType processAudioSample(SampleType xn) 
 	{
-		if (form == "direct")
-		{
-			float yn = aCoeffVector[0] * xn +
-				aCoeffVector[1] * xStateVector[0] +
-				aCoeffVector[2] * xStateVector[1] -
-				bCoeffVector[1] * yStateVector[0] -
-				bCoeffVector[2] * yStateVector[1];
-
-			xStateVector[1] = xStateVector[0];
-			xStateVector[0] = xn;
-
-			yStateVector[1] = yStateVector[0];
-			yStateVector[0] = yn;
-
-			return yn;
-		}
 		// Processes the input sample using the Direct Form 2 ("Canonical") flow 
-		else if (form == "canonical")
+		if (form == BiquadForm::canonical)
 		{
-			double wn = (xn - bCoeffVector[1] * wStateVector[0] -
+			SampleType wn = (xn - bCoeffVector[1] * wStateVector[0] -
 				bCoeffVector[2] * wStateVector[1]);
-			double yn = aCoeffVector[0] * wn +
+			SampleType yn = aCoeffVector[0] * wn +
 				aCoeffVector[1] * wStateVector[0] +
 				aCoeffVector[2] * wStateVector[1];
 
 
 			wStateVector[1] = wStateVector[0];
-			wStateVector[0] = wn;
+			wStateVector[0] = flushDenormal(wn);
 			return  yn;
 		}
+
+		SampleType yn = aCoeffVector[0] * xn +
+			aCoeffVector[1] * xStateVector[0] +
+			aCoeffVector[2] * xStateVector[1] -
+			bCoeffVector[1] * yStateVector[0] -
+			bCoeffVector[2] * yStateVector[1];
+
+		xStateVector[1] = xStateVector[0];
+		xStateVector[0] = xn;
+
+		yStateVector[1] = yStateVector[0];
+		yStateVector[0] = flushDenormal(yn);
+
+		return yn;
 	}
 
 private:
 	alternateAPF_1Parameters parameters;
-	vector<double> aCoeffVector;
-	vector<double> bCoeffVector;
-	vector<double> xStateVector{ 0.0f, 0.0f };
-	vector<double> yStateVector{ 0.0f, 0.0f };
-	vector<double> wStateVector{ 0.0f, 0.0f };
-	string form = "canonical";
+	std::array<SampleType, 3> aCoeffVector{};
+	std::array<SampleType, 3> bCoeffVector{};
+	std::array<SampleType, 2> xStateVector{};
+	std::array<SampleType, 2> yStateVector{};
+	std::array<SampleType, 2> wStateVector{};
+	BiquadForm form = BiquadForm::canonical;
 };
 
-class stretchedAPF_2
+/// <summary>
+/// Second-Order IIR Allpass, z^-2 stretched version of alternateAPF_1 (direct form only)
+/// </summary>
+template <typename SampleType>
+class stretchedAPF_2T
 {
 public:
-	stretchedAPF_2() {
+	stretchedAPF_2T() {
 		aCoeffVector = { 1,0,0 };
 		bCoeffVector = { 1,0,0 };
-		form = "direct";
 	}
 
-	stretchedAPF_2(const string f) :form(f)
+	stretchedAPF_2T(const string f)
 	{
 		aCoeffVector = { 1,0,0 };
 		bCoeffVector = { 1,0,0 };
@@ -686,20 +752,22 @@ public:
 	/// Constructs a Biquad filter with a specified form but with default coefficients.
 	/// </summary>
 	/// <param name="f">The form of the biquad filter (e.g., "direct", "canonical").</param>
-	stretchedAPF_2(vector<double> aCoeff, vector<double> bCoeff, string f = "direct") :
-
-		aCoeffVector(aCoeff), bCoeffVector(bCoeff), form(f) { }
+	stretchedAPF_2T(vector<double> aCoeff, vector<double> bCoeff, string f = "direct")
+	{
+		for (int i = 0; i < 3; ++i)
+		{
+			aCoeffVector[i] = (SampleType)aCoeff[i];
+			bCoeffVector[i] = (SampleType)bCoeff[i];
+		}
+	}
 
-	stretchedAPF_2(double feedback, string f = "direct")
+	stretchedAPF_2T(double feedback, string f = "direct")
 	{
-		aCoeffVector = { feedback,0,1 };
-		bCoeffVector = { 1,0 ,feedback };
-		form = "direct";
+		updateCoefficient(feedback);
 	}
-	stretchedAPF_2(alternateAPF_1Parameters pParameters) : parameters(pParameters)
+	stretchedAPF_2T(alternateAPF_1Parameters pParameters) : parameters(pParameters)
 	{
 		updateCoefficient(parameters.feedbackGain);
-		form = "direct";
 	}
 
 	/// <summary>
@@ -708,8 +776,9 @@ public:
 	/// <param name="pFeedback"></param>
 	void updateCoefficient(double pFeedback)
 	{
-		aCoeffVector = { pFeedback,0,1 };
-		bCoeffVector = { 1,0,pFeedback };
+		auto feedback = (SampleType)pFeedback;
+		aCoeffVector = { feedback,0,1 };
+		bCoeffVector = { 1,0,feedback };
 
 		parameters.feedbackGain = pFeedback;
 	}
@@ -719,33 +788,28 @@ public:
 	/// </summary>
 	/// <param name="inputXn"></param>
 	/// <returns> The processed Audio sample</returns>
-	double processAudioSample(float xn)
+	SampleType processAudioSample(SampleType xn)
 	{
-		if (form == "direct")
-		{
-			float yn = aCoeffVector[0] * xn +
-				aCoeffVector[1] * xStateVector[0] +
-				aCoeffVector[2] * xStateVector[1] -
-				bCoeffVector[1] * yStateVector[0] -
-				bCoeffVector[2] * yStateVector[1];
+		SampleType yn = aCoeffVector[0] * xn +
+			aCoeffVector[1] * xStateVector[0] +
+			aCoeffVector[2] * xStateVector[1] -
+			bCoeffVector[1] * yStateVector[0] -
+			bCoeffVector[2] * yStateVector[1];
 
-			xStateVector[1] = xStateVector[0];
-			xStateVector[0] = xn;
+		xStateVector[1] = xStateVector[0];
+		xStateVector[0] = xn;
 
-			yStateVector[1] = yStateVector[0];
-			yStateVector[0] = yn;
+		yStateVector[1] = yStateVector[0];
+		yStateVector[0] = flushDenormal(yn);
 
-			return yn;
-		}
+		return yn;
 	}
 private:
 	alternateAPF_1Parameters parameters;
-	vector<double> aCoeffVector;
-	vector<double> bCoeffVector;
-	vector<double> xStateVector{ 0.0f, 0.0f };
-	vector<double> yStateVector{ 0.0f, 0.0f };
-	vector<double> wStateVector{ 0.0f, 0.0f };
-	string form = "direct";
+	std::array<SampleType, 3> aCoeffVector{};
+	std::array<SampleType, 3> bCoeffVector{};
+	std::array<SampleType, 2> xStateVector{};
+	std::array<SampleType, 2> yStateVector{};
 };
 struct nestedAPFParameters
 {
@@ -756,7 +820,8 @@ struct nestedAPFParameters
 	double delayTime_samples;
 };
 
-class nestedAPF : public allPassFilter
+template <typename SampleType>
+class nestedAPFT : public allPassFilterT<SampleType>
 {
 public:
 	/// <summary>
@@ -765,8 +830,8 @@ public:
 	/// <param name="pSampleRate">The new sample rate.</param>
 	void reset(double pSampleRate)
 	{
-		currentSampleRate = pSampleRate;
-		samplesPerMsec = currentSampleRate / 1000;
+		this->currentSampleRate = pSampleRate;
+		this->samplesPerMsec = this->currentSampleRate / 1000;
 		internalAPF.updateCoefficient(parameters.feedbackGain_nested);
 	}
 
@@ -778,9 +843,9 @@ public:
 	void setParameters(nestedAPFParameters pNestedAPFParameters)
 	{
 		parameters = pNestedAPFParameters;
-		parameters.delayTime_samples = (parameters.delayTime_ms * samplesPerMsec);
+		parameters.delayTime_samples = (parameters.delayTime_ms * this->samplesPerMsec);
 		APFParameters pAPFparameters = { parameters.delayTime_ms,parameters.feedbackGain_external, parameters.enableAPF, parameters.delayTime_samples };
-		allPassFilter::setParameters(pAPFparameters);
+		allPassFilterT<SampleType>::setParameters(pAPFparameters);
 		internalAPF.updateCoefficient(parameters.feedbackGain_nested);
 	}
 
@@ -789,17 +854,18 @@ public:
 	/// </summary>
 	/// <param name="inputXn">The input audio sample to process.</param>
 	/// <returns>The processed audio sample.</returns>
-	float processAudioSample(float inputXn) override
+	SampleType processAudioSample(SampleType inputXn) override
 	{
 		if (parameters.enableAPF == true)
 		{
-			auto ynD = delayBuffer.readBuffer(parameters.delayTime_samples, true);
-			auto wn = -parameters.feedbackGain_external * ynD + inputXn;
+			auto g = (SampleType)parameters.feedbackGain_external;
+			auto ynD = this->delayBuffer.readBuffer(parameters.delayTime_samples, true);
+			auto wn = -g * ynD + inputXn;
 			auto wnD = internalAPF.processAudioSample(wn);
 
-			delayBuffer.writeBuffer(wnD);
+			this->delayBuffer.writeBuffer(flushDenormal(wnD));
 
-			return parameters.feedbackGain_external * wn + ynD;
+			return g * wn + ynD;
 		}
 		else
 		{
@@ -808,6 +874,26 @@ public:
 	}
 private:
 	nestedAPFParameters parameters;
-	//alternateAPF_1 internalAPF;
-	stretchedAPF_2 internalAPF;
-};
\ No newline at end of file
+	//alternateAPF_1T<SampleType> internalAPF;
+	stretchedAPF_2T<SampleType> internalAPF;
+};
+
+// =============================================================================
+// Sample type instantiations
+// The structures are templated on the sample type : every sample is stored and
+// computed in SampleType, the parameters stay in double and are converted once
+// per sample. The aliases are the single precision instantiations, as every
+// default alias of dsp_fv (biquads, TPT filters, vibrato, saturation) : the
+// engines built from them are float only, their T<double> versions double only.
+// =============================================================================
+
+using delayLine = delayLineT<float>;
+using DelayLine_modulated = DelayLine_modulatedT<float>;
+using CombFilter = CombFilterT<float>;
+using FCombFilter = FCombFilterT<float>;
+using allPassFilter = allPassFilterT<float>;
+using alternateAllPassFilter = alternateAllPassFilterT<float>;
+using alternateAllPassFilter_modulated = alternateAllPassFilter_modulatedT<float>;
+using alternateAPF_1 = alternateAPF_1T<float>;
+using stretchedAPF_2 = stretchedAPF_2T<float>;
+using nestedAPF = nestedAPFT<float>;
@@ -0,0 +1,403 @@
+#pragma once
+#include <JuceHeader.h>
+#include <vector>
+#include <map>
+#include <functional>
+#include <atomic>
+#include <cstring>
+#include <cmath>
+#include <memory>
+#include "partitionedConvolution.h"
+
+using std::vector;
+
+// =============================================================================
+// Baked reverb
+// An algorithmic reverb with static (LTI) settings is replaced by the convolution with its own impulse response
+// =============================================================================
+
+/// <summary>
+/// Baked reverb settings
+/// </summary>
+struct BakedReverbParameters
+{
+	double settleTime_s = 0.5;				// settings must not change for this long before a render starts
+	double maxLength_s = 10.0;				// longest impulse response rendered
+	double tailThreshold_dB = -90.0;		// the IR is cut where it falls below this level, relative to its peak
+	size_t maxCacheEntries = 8;
+};
+
+/// <summary>
+/// Replaces a linear time invariant algorithmic reverb by the convolution with its impulse response, once its settings settle.
+/// - message thread : update() is called periodically with the current settings. When they have settled, the IR is
+///   rendered by a background thread through the render function, cached (key : settings quantized to 4 significant
+///   digits), then installed in the zero latency convolution engine
+/// - audio thread : processBlock() routes the input to the live engine or to the convolution, whichever matches the
+///   current settings. At a handover the path losing the input keeps running on silence until its tail has rung out,
+///   and both outputs are summed : for an LTI engine the sum is exactly the live output, no crossfade artefact.
+/// The live engine is only run while it has input or a tail, the convolution costs a fraction of a recursive network.
+/// The engine is driven in mono (mid of L and R) to stereo, fully wet : the mix is applied here.
+/// </summary>
+class BakedReverb
+{
+public:
+	/// <summary>
+	/// Renders the fully wet stereo impulse response of a new engine with the given settings, for a unit impulse
+	/// on both inputs. The buffer is allocated, the function fills it. Called on a background thread
+	/// </summary>
+	using RenderFunction = std::function<void(const vector<double>& settings, double sampleRate, juce::AudioBuffer<float>& ir)>;
+
+	void setRenderFunction(RenderFunction pRenderFunction)
+	{
+		renderFunction = pRenderFunction;
+	}
+
+	void setParameters(BakedReverbParameters pParameters)
+	{
+		parameters = pParameters;
+	}
+
+	/// <summary>
+	/// Offline rendering, see ConvolutionReverb::setNonRealtime(). Applied to the convolutions prepared from then on
+	/// </summary>
+	void setNonRealtime(bool pNonRealtime)
+	{
+		nonRealtime = pNonRealtime;
+	}
+
+	/// <summary>
+	/// Allocates the buffers, drops the cache if the sample rate changed. Not to be called while processing
+	/// </summary>
+	void reset(double pSampleRate, int pMaxBlockSize)
+	{
+		if (pSampleRate != sampleRate)
+		{
+			const juce::ScopedLock lock(renderLock);
+			cache.clear();
+			finishedRenders.clear();
+		}
+		sampleRate = pSampleRate;
+		maxBlockSize = juce::jmax(1, pMaxBlockSize);
+
+		convolution = createConvolution(juce::AudioBuffer<float>());
+		installedKey = 0;
+		installedLength = 0;
+		routeToBaked = false;
+		liveRingOut = 0;
+		bakedRingOut = 0;
+		convolutionActive.store(false);
+
+		for (auto* buffer : { &dryL, &dryR, &wetL, &wetR, &tempL, &tempR, &silence })
+			buffer->assign(maxBlockSize, 0.0f);
+	}
+
+	/// <summary>
+	/// Message thread, periodically : settle detection, renders, cache and IR installation
+	/// </summary>
+	/// <param name="settings">engine settings, mix excluded</param>
+	/// <param name="bakingEnabled">baking requested and engine LTI</param>
+	void update(const vector<double>& settings, bool bakingEnabled)
+	{
+		collectFinishedRenders();
+
+		auto key = getKey(settings.data(), (int)settings.size());
+		auto now = juce::Time::getMillisecondCounterHiRes() * 0.001;
+		if (key != lastKey)
+		{
+			lastKey = key;
+			settleStart_s = now;
+			return;
+		}
+		if (!bakingEnabled || now - settleStart_s < parameters.settleTime_s || key == installedKey)
+			return;
+
+		auto entry = cache.find(key);
+		if (entry != cache.end())
+		{
+			entry->second.lastUse = ++useCounter;
+			if (entry->second.bakeable)
+				install(key, entry->second.ir);
+		}
+		else if (!renderPending && renderFunction != nullptr)
+			startRender(key, quantize(settings));
+	}
+
+	/// <summary>
+	/// Audio thread : processes a stereo block in place
+	/// </summary>
+	/// <param name="mix">dry / wet</param>
+	/// <param name="settings">same settings as given to update()</param>
+	/// <param name="live">live engine, fully wet : live(const float* inL, const float* inR, float* wetL, float* wetR, int numSamples)</param>
+	template <typename LiveProcess>
+	void processBlock(float* left, float* right, int numSamples, double mix, const double* settings, int numSettings,
+		bool bakingEnabled, LiveProcess&& live)
+	{
+		updateRouting(bakingEnabled ? getKey(settings, numSettings) : 0);
+
+		auto wet = (float)mix;
+		auto dry = 1.0f - wet;
+		int n = 0;
+		while (n < numSamples)
+		{
+			auto count = juce::jmin(numSamples - n, maxBlockSize);
+			std::copy(left + n, left + n + count, dryL.begin());
+			std::copy(right + n, right + n + count, dryR.begin());
+			std::fill(wetL.begin(), wetL.begin() + count, 0.0f);
+			std::fill(wetR.begin(), wetR.begin() + count, 0.0f);
+
+			// live path : input, or silence while its tail rings out
+			if (!routeToBaked || liveRingOut > 0)
+			{
+				if (routeToBaked)
+				{
+					live(silence.data(), silence.data(), tempL.data(), tempR.data(), count);
+					liveRingOut = juce::jmax(0, liveRingOut - count);
+				}
+				else
+					live(dryL.data(), dryR.data(), tempL.data(), tempR.data(), count);
+				accumulate(count);
+			}
+
+			// convolution path, mono input on both channels
+			if (routeToBaked || bakedRingOut > 0)
+			{
+				for (int i = 0; i < count; ++i)
+					tempL[i] = routeToBaked ? 0.5f * (dryL[i] + dryR[i]) : 0.0f;
+				std::copy(tempL.begin(), tempL.begin() + count, tempR.begin());
+				convolution->processBlock(tempL.data(), tempR.data(), count);
+				accumulate(count);
+
+				if (!routeToBaked)
+				{
+					bakedRingOut = juce::jmax(0, bakedRingOut - count);
+					if (bakedRingOut == 0)
+						convolutionActive.store(false, std::memory_order_release);
+				}
+			}
+
+			for (int i = 0; i < count; ++i)
+			{
+				left[n + i] = dry * dryL[i] + wet * wetL[i];
+				right[n + i] = dry * dryR[i] + wet * wetR[i];
+			}
+			n += count;
+		}
+	}
+
+	/// <summary>
+	/// true when the input goes to the convolution
+	/// </summary>
+	bool isBaked() const
+	{
+		return routeToBaked;
+	}
+
+	/// <summary>
+	/// Cache key : FNV-1a hash of the settings quantized to 4 significant digits. 0 means no key
+	/// </summary>
+	static uint64_t getKey(const double* settings, int numSettings)
+	{
+		uint64_t hash = 14695981039346656037ull;
+		for (int i = 0; i < numSettings; ++i)
+		{
+			auto value = quantize(settings[i]);
+			unsigned char bytes[sizeof(double)];
+			std::memcpy(bytes, &value, sizeof(double));
+			for (auto byte : bytes)
+				hash = (hash ^ byte) * 1099511628211ull;
+		}
+		return hash == 0 ? 1 : hash;
+	}
+
+private:
+	struct CacheEntry
+	{
+		juce::AudioBuffer<float> ir;
+		bool bakeable = false;		// false if the response did not decay within maxLength_s
+		uint64_t lastUse = 0;
+	};
+
+	static double quantize(double value)
+	{
+		if (value == 0.0 || !std::isfinite(value))
+			return value;
+		auto scale = std::pow(10.0, 3.0 - std::floor(std::log10(std::abs(value))));
+		return std::round(value * scale) / scale;
+	}
+
+	static vector<double> quantize(const vector<double>& settings)
+	{
+		vector<double> quantized;
+		for (auto value : settings)
+			quantized.push_back(quantize(value));
+		return quantized;
+	}
+
+	/// <summary>
+	/// Audio thread : hands the input over when the installed IR starts or stops matching the settings.
+	/// Under the state lock, so that no IR is installed while the convolution is in use
+	/// </summary>
+	void updateRouting(uint64_t key)
+	{
+		const juce::SpinLock::ScopedTryLockType lock(stateLock);
+		if (!lock.isLocked())
+			return;
+
+		auto toBaked = key != 0 && key == installedKey;
+		if (toBaked == routeToBaked)
+			return;
+
+		routeToBaked = toBaked;
+		if (routeToBaked)
+		{
+			liveRingOut = installedLength;
+			convolutionActive.store(true, std::memory_order_release);
+		}
+		else
+			bakedRingOut = installedLength;
+	}
+
+	/// <summary>
+	/// Zero latency convolution of an impulse response, fully wet
+	/// </summary>
+	std::unique_ptr<ConvolutionReverb> createConvolution(const juce::AudioBuffer<float>& ir) const
+	{
+		auto newConvolution = std::make_unique<ConvolutionReverb>();
+		newConvolution->reset(sampleRate, 128, true);
+		newConvolution->setParameters({ 1.0, 0.0 });
+		newConvolution->setNonRealtime(nonRealtime);
+		newConvolution->setImpulseResponse(ir, sampleRate);
+		return newConvolution;
+	}
+
+	/// <summary>
+	/// Message thread : installs an IR once the convolution has no input and no tail left.
+	/// The convolution is prepared outside of the state lock, which only covers the swap
+	/// </summary>
+	void install(uint64_t key, const juce::AudioBuffer<float>& ir)
+	{
+		if (convolutionActive.load(std::memory_order_acquire))
+			return;
+		auto newConvolution = createConvolution(ir);
+		{
+			const juce::SpinLock::ScopedLockType lock(stateLock);
+			// the audio thread may have gone back to the installed IR meanwhile
+			if (convolutionActive.load(std::memory_order_acquire))
+				return;
+			std::swap(convolution, newConvolution);
+			installedLength = ir.getNumSamples();
+			installedKey = key;
+		}
+		// the previous convolution is released here, outside of the lock
+	}
+
+	void startRender(uint64_t key, const vector<double>& settings)
+	{
+		renderPending = true;
+		auto render = renderFunction;
+		auto fs = sampleRate;
+		auto length = (int)(parameters.maxLength_s * fs);
+		auto threshold = juce::Decibels::decibelsToGain(parameters.tailThreshold_dB, -200.0);
+
+		renderThread.addJob([this, key, settings, render, fs, length, threshold]
+			{
+				// the render runs the engine on this thread, the flags of the audio thread do not apply
+				juce::ScopedNoDenormals noDenormals;
+				CacheEntry entry;
+				entry.ir.setSize(2, length);
+				entry.ir.clear();
+				render(settings, fs, entry.ir);
+
+				// cut the tail below the threshold, not bakeable if it is still above in the last 100 ms
+				float peak = 0.0f;
+				for (int ch = 0; ch < entry.ir.getNumChannels(); ++ch)
+					for (int i = 0; i < length; ++i)
+						peak = juce::jmax(peak, std::abs(entry.ir.getSample(ch, i)));
+				int end = 0;
+				for (int ch = 0; ch < entry.ir.getNumChannels(); ++ch)
+					for (int i = length - 1; i >= end; --i)
+						if (std::abs(entry.ir.getSample(ch, i)) > peak * (float)threshold)
+						{
+							end = i + 1;
+							break;
+						}
+				entry.bakeable = peak > 0.0f && end < length - (int)(0.1 * fs);
+				entry.ir.setSize(2, juce::jmax(1, end), true);
+
+				const juce::ScopedLock lock(renderLock);
+				finishedRenders.push_back({ key, fs, std::move(entry) });
+			});
+	}
+
+	struct FinishedRender
+	{
+		uint64_t key;
+		double sampleRate;
+		CacheEntry entry;
+	};
+
+	/// <summary>
+	/// Message thread : moves the finished renders to the cache, evicts the least recently used entries
+	/// </summary>
+	void collectFinishedRenders()
+	{
+		const juce::ScopedLock lock(renderLock);
+		for (auto& render : finishedRenders)
+		{
+			renderPending = false;
+			if (render.sampleRate != sampleRate)
+				continue;
+			render.entry.lastUse = ++useCounter;
+			cache[render.key] = std::move(render.entry);
+		}
+		finishedRenders.clear();
+
+		while (cache.size() > parameters.maxCacheEntries)
+		{
+			auto oldest = cache.begin();
+			for (auto it = cache.begin(); it != cache.end(); ++it)
+				if (it->second.lastUse < oldest->second.lastUse)
+					oldest = it;
+			cache.erase(oldest);
+		}
+	}
+
+	void accumulate(int count)
+	{
+		for (int i = 0; i < count; ++i)
+		{
+			wetL[i] += tempL[i];
+			wetR[i] += tempR[i];
+		}
+	}
+
+	double sampleRate = 0.0;
+	int maxBlockSize = 512;
+	BakedReverbParameters parameters;
+	bool nonRealtime = false;
+	RenderFunction renderFunction;
+	std::unique_ptr<ConvolutionReverb> convolution;	// swapped by install() under the state lock
+
+	// message thread
+	std::map<uint64_t, CacheEntry> cache;
+	uint64_t useCounter = 0;
+	uint64_t lastKey = 0;
+	double settleStart_s = 0.0;
+	bool renderPending = false;
+
+	// shared with the audio thread, written under the state lock
+	juce::SpinLock stateLock;
+	uint64_t installedKey = 0;
+	int installedLength = 0;
+	std::atomic<bool> convolutionActive{ false };
+
+	// audio thread
+	bool routeToBaked = false;
+	int liveRingOut = 0, bakedRingOut = 0;
+	vector<float> dryL, dryR, wetL, wetR, tempL, tempR, silence;
+
+	// render thread
+	juce::CriticalSection renderLock;
+	vector<FinishedRender> finishedRenders;
+	juce::ThreadPool renderThread{ 1 };		// last member : destroyed first, waits for a render in progress
+};
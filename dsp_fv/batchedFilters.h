@@ -0,0 +1,217 @@
+#pragma once
+#include <JuceHeader.h>
+#include <vector>
+#include <cmath>
+#include "APFstructures.h"
+#include "classicFilters.h"
+
+using std::vector;
+
+// =============================================================================
+// Batched filters
+// numLanes instances of the same filter, sharing their parameters, processed together.
+// The state is stored as structure of arrays : one frame holds one sample of every
+// instance (lane), so every operation is a loop over the lanes of a frame, which the
+// compiler turns into SIMD instructions (8 lanes = one AVX register, two SSE ones).
+// Frames and states are in SampleType (float lanes are twice as many per register),
+// see the aliases at the end of the file.
+// =============================================================================
+
+/// <summary>
+/// Circular buffer of frames, with wire-AND-ing wrapping mechanism (as CircularBuffer)
+/// </summary>
+template <int numLanes, typename SampleType>
+class BatchedCircularBufferT
+{
+public:
+	/// <summary>
+	/// Creates a zeroed buffer of at least length frames
+	/// </summary>
+	void createBuffer(unsigned int length)
+	{
+		auto bufferLength = (unsigned int)(pow(2, ceil(log(length) / log(2))));
+		buffer.assign((size_t)bufferLength * numLanes, SampleType(0));
+		writeIndex = 0;
+		wrapMask = bufferLength - 1;
+	}
+
+	/// <summary>
+	/// Writes a frame and increments the write index by 1
+	/// </summary>
+	void writeBuffer(const SampleType* frame)
+	{
+		auto* destination = buffer.data() + (size_t)writeIndex * numLanes;
+		for (int lane = 0; lane < numLanes; ++lane)
+			destination[lane] = frame[lane];
+		++writeIndex;
+		writeIndex &= wrapMask;
+	}
+
+	/// <summary>
+	/// Frame written pDelay frames ago
+	/// </summary>
+	const SampleType* readBuffer(unsigned int pDelay) const
+	{
+		return buffer.data() + (size_t)((writeIndex - pDelay) & wrapMask) * numLanes;
+	}
+
+	/// <summary>
+	/// Reads a frame at a fractional delay, with linear interpolation (as CircularBuffer::readBuffer)
+	/// </summary>
+	void readBuffer(double delayInFractionalSamples, SampleType* frame) const
+	{
+		auto* y1 = readBuffer((unsigned int)delayInFractionalSamples);
+		auto* y2 = readBuffer((unsigned int)delayInFractionalSamples + 1);
+		auto fraction = (SampleType)(delayInFractionalSamples - (int)delayInFractionalSamples);
+		for (int lane = 0; lane < numLanes; ++lane)
+			frame[lane] = fraction * y2[lane] + (SampleType(1) - fraction) * y1[lane];
+	}
+
+private:
+	unsigned int writeIndex = 0;
+	unsigned int wrapMask = 0;
+	vector<SampleType> buffer;
+};
+
+/// <summary>
+/// numLanes allPassFilter instances (Schroeder APF) sharing their parameters
+/// </summary>
+template <int numLanes, typename SampleType>
+class BatchedAllPassFilterT
+{
+public:
+	void setParameters(APFParameters pParameters)
+	{
+		parameters = pParameters;
+	}
+
+	/// <summary>
+	/// Creates the delay buffer, the delay time in samples is computed as by allPassFilter
+	/// </summary>
+	void createDelayBuffer(double pSampleRate)
+	{
+		auto samplesPerMsec = pSampleRate / 1000.0;
+		parameters.delayTime_samples = (unsigned int)parameters.delayTime_ms * samplesPerMsec;
+		delayBuffer.createBuffer((unsigned int)(parameters.delayTime_ms * samplesPerMsec) + 1);
+	}
+
+	/// <summary>
+	/// Processes one frame in place, output is full wet
+	/// </summary>
+	void processAudioFrame(SampleType* frame)
+	{
+		if (parameters.enableAPF == false)
+			return;
+
+		alignas(32) SampleType ynD[numLanes];
+		alignas(32) SampleType toWrite[numLanes];
+		delayBuffer.readBuffer(parameters.delayTime_samples, ynD);
+
+		auto g = (SampleType)parameters.feedbackGain;
+		auto oneMinusG2 = SampleType(1) - g * g;
+		for (int lane = 0; lane < numLanes; ++lane)
+		{
+			toWrite[lane] = flushDenormal(frame[lane] + ynD[lane] * g);
+			frame[lane] = oneMinusG2 * ynD[lane] - g * frame[lane];
+		}
+		delayBuffer.writeBuffer(toWrite);
+	}
+
+private:
+	APFParameters parameters;
+	BatchedCircularBufferT<numLanes, SampleType> delayBuffer;
+};
+
+/// <summary>
+/// numLanes ClassicFilters instances sharing their coefficients, canonical biquad form
+/// </summary>
+template <int numLanes, typename SampleType>
+class BatchedClassicFiltersT
+{
+public:
+	/// <summary>
+	/// Sets the filter type, see ClassicFilterType
+	/// </summary>
+	void setFilterType(juce::String type)
+	{
+		filterType = BiquadCoefficients::getFilterType(type);
+	}
+
+	void setFilterType(ClassicFilterType type)
+	{
+		filterType = type;
+	}
+
+	/// <summary>
+	/// Sets the boost / cut of the PEAK, LSF, HSF and TILT filters, applied by the next setCoefficients() call
+	/// </summary>
+	void setBoostCut(double pBoostCut_dB)
+	{
+		boostCut_dB = pBoostCut_dB;
+	}
+
+	/// <summary>
+	/// Sets the coefficients, as ClassicFilters::setCoefficients()
+	/// </summary>
+	void setCoefficients(double cornerFreq, double qualityFactor, double sampleFreq, double gain = 1.0)
+	{
+		if (coefficients.update(filterType, cornerFreq, qualityFactor, sampleFreq, boostCut_dB))
+			copyCoefficients();
+		processedCoeff = (SampleType)gain;
+		dryCoeff = (SampleType)(1.0 - gain);
+		bypass = filterType == ClassicFilterType::None;
+	}
+
+	/// <summary>
+	/// Clears the filter states
+	/// </summary>
+	void reset()
+	{
+		for (int lane = 0; lane < numLanes; ++lane)
+			w1[lane] = w2[lane] = SampleType(0);
+	}
+
+	/// <summary>
+	/// Processes one frame in place
+	/// </summary>
+	void processAudioFrame(SampleType* frame)
+	{
+		if (bypass)
+			return;
+
+		for (int lane = 0; lane < numLanes; ++lane)
+		{
+			auto wn = frame[lane] - b1 * w1[lane] - b2 * w2[lane];
+			auto yn = a0 * wn + a1 * w1[lane] + a2 * w2[lane];
+			w2[lane] = w1[lane];
+			w1[lane] = flushDenormal(wn);
+			frame[lane] = processedCoeff * yn + dryCoeff * frame[lane];
+		}
+	}
+
+private:
+	void copyCoefficients()
+	{
+		a0 = (SampleType)coefficients.aCoeff[0]; a1 = (SampleType)coefficients.aCoeff[1]; a2 = (SampleType)coefficients.aCoeff[2];
+		b1 = (SampleType)coefficients.bCoeff[1]; b2 = (SampleType)coefficients.bCoeff[2];
+	}
+
+	ClassicFilterType filterType = ClassicFilterType::None;
+	double boostCut_dB = 0.0;
+	BiquadCoefficients coefficients;
+	SampleType a0 = SampleType(1), a1 = SampleType(0), a2 = SampleType(0), b1 = SampleType(0), b2 = SampleType(0);
+	SampleType processedCoeff = SampleType(1), dryCoeff = SampleType(0);
+	bool bypass = false;
+	alignas(32) SampleType w1[numLanes] = {};
+	alignas(32) SampleType w2[numLanes] = {};
+};
+
+/// <summary>
+/// Single precision lanes, as every default alias of dsp_fv
+/// </summary>
+template <int numLanes>
+using BatchedCircularBuffer = BatchedCircularBufferT<numLanes, float>;
+template <int numLanes>
+using BatchedAllPassFilter = BatchedAllPassFilterT<numLanes, float>;
+template <int numLanes>
+using BatchedClassicFilters = BatchedClassicFiltersT<numLanes, float>;
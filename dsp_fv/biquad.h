@@ -1,6 +1,8 @@
-#pragma once 
+#pragma once
 #include <JuceHeader.h>
 #include <vector>
+#include <array>
+#include "denormals.h"
 using std::vector;
 
 // =============================================================================
@@ -8,32 +10,51 @@ using std::vector;
 // used to implement every kinf of second order filter, sample by sample reading
 // =============================================================================
 
+/// <summary>
+/// Biquad topologies : Direct Form 1 ("direct"), Direct Form 2 ("canonical"), bypass ("None")
+/// </summary>
+enum class BiquadForm { direct, canonical, None };
+
+/// <summary>
+/// Converts the "direct", "canonical", "None" form names, unknown names are bypassed
+/// </summary>
+inline BiquadForm getBiquadForm(const juce::String& f)
+{
+    if (f == "direct")
+        return BiquadForm::direct;
+    if (f == "canonical")
+        return BiquadForm::canonical;
+    return BiquadForm::None;
+}
+
 /// <summary>
 /// Represents a biquad filter, which is a fundamental element in digital signal processing for audio.
 /// This class allows for the creation and manipulation of various filter types through the adjustment
 /// of coefficients and provides methods for processing audio samples.
+/// Coefficients, states and arithmetic are in SampleType (float or double), see the Biquad alias.
 /// </summary>
-class Biquad
+template <typename SampleType>
+class BiquadT
 {
 public:
-    
-    Biquad() {
-        aCoeffVector = { 0,0,0 };
-        bCoeffVector = { 0,0,0 };
-        form = "canonical";
 
+    BiquadT() {
+        form = BiquadForm::canonical;
     }
-    Biquad(const juce::String f):form(f)
+    BiquadT(const juce::String f):form(getBiquadForm(f))
     {
-        aCoeffVector = { 0,0,0 };
-        bCoeffVector = { 0,0,0 };
     }
     /// <summary>
     /// Constructs a Biquad filter with a specified form but with default coefficients.
     /// </summary>
     /// <param name="f">The form of the biquad filter (e.g., "direct", "canonical").</param>
-    Biquad(vector<double> aCoeff, vector<double> bCoeff, int numCoeff, juce::String f = "direct") :
-        aCoeffVector(aCoeff), bCoeffVector(bCoeff), form(f) { }
+    BiquadT(vector<double> aCoeff, vector<double> bCoeff, int numCoeff, juce::String f = "direct") :
+        form(getBiquadForm(f))
+    {
+        updateParameters(aCoeff, bCoeff);
+    }
+
+    virtual ~BiquadT() = default;
 
     /// <summary>
     /// Updates the filter coefficients.
@@ -42,31 +63,31 @@ public:
     /// <param name="bCoeff">New set of feedforward coefficients.</param>
     void updateParameters(vector<double> aCoeff, vector<double> bCoeff)
     {
-        // updates the biquad class a and b  parameters 
+        updateParameters(aCoeff.data(), bCoeff.data());
+    }
+
+    /// <summary>
+    /// Updates the filter coefficients from arrays of 3 values, without allocation.
+    /// </summary>
+    void updateParameters(const double* aCoeff, const double* bCoeff)
+    {
         for (int i = 0; i < 3; ++i)
         {
-            aCoeffVector[i] = aCoeff[i];
-            bCoeffVector[i] = bCoeff[i];
+            aCoeffVector[i] = (SampleType)aCoeff[i];
+            bCoeffVector[i] = (SampleType)bCoeff[i];
         }
     }
 
     /// <summary>
     /// Resets all coefficients and internal state vectors to zero.
-    /// </summary>    
+    /// </summary>
     virtual void resetCoeff()
     {
         // flushes all the vectors values, resets to 0
-        for (int i = 0; i <aCoeffVector.size(); ++i)
-        {
-            aCoeffVector[i] = 0.0f;
-            bCoeffVector[i] = 0.0f;
-        }
-
-        for (int i = 0; i < aCoeffVector.size(); ++i)
-        {
-            xStateVector[i] = 0.0f;
-            yStateVector[i] = 0.0f;
-        }
+        aCoeffVector.fill(SampleType(0));
+        bCoeffVector.fill(SampleType(0));
+        xStateVector.fill(SampleType(0));
+        yStateVector.fill(SampleType(0));
     }
 
     /// <summary>
@@ -74,10 +95,10 @@ public:
     /// </summary>
     /// <param name="dry">Gain for the dry (unprocessed) signal.</param>
     /// <param name="processed">Gain for the wet (processed) signal.</param>
-    void setDryWetGain(double dry, double processed) 
+    void setDryWetGain(double dry, double processed)
     {
-        dryCoeff = dry;
-        processedCoeff = processed;
+        dryCoeff = (SampleType)dry;
+        processedCoeff = (SampleType)processed;
     }
 
     /// <summary>
@@ -85,16 +106,16 @@ public:
     /// </summary>
     /// <param name="xn">The input audio sample.</param>
     /// <returns>The filtered audio sample.</returns>
-    virtual double processAudioSample(double xn)
+    virtual SampleType processAudioSample(SampleType xn)
     {
-        // Processes the input sample using the Direct Form 1 flow 
-        if (form == juce::String("direct"))
+        // Processes the input sample using the Direct Form 1 flow
+        if (form == BiquadForm::direct)
         {
-            double yn = processedCoeff * (aCoeffVector[0] * xn +
+            SampleType yn = processedCoeff * (aCoeffVector[0] * xn +
                 aCoeffVector[1] * xStateVector[0] +
                 aCoeffVector[2] * xStateVector[1] -
                 bCoeffVector[1] * yStateVector[0] -
-                bCoeffVector[2] * yStateVector[1]) + 
+                bCoeffVector[2] * yStateVector[1]) +
                 dryCoeff * xn;
 
 
@@ -102,31 +123,28 @@ public:
             xStateVector[0] = xn;
 
             yStateVector[1] = yStateVector[0];
-            yStateVector[0] = yn;
+            yStateVector[0] = flushDenormal(yn);
 
             return yn;
         }
-        // Processes the input sample using the Direct Form 2 ("Canonical") flow 
-        else if (form == juce::String("canonical"))
+        // Processes the input sample using the Direct Form 2 ("Canonical") flow
+        else if (form == BiquadForm::canonical)
         {
-            double wn = ( xn - bCoeffVector[1] * wStateVector[0] - 
+            SampleType wn = ( xn - bCoeffVector[1] * wStateVector[0] -
                                 bCoeffVector[2] * wStateVector[1]);
-            double ynUnprocessed =aCoeffVector[0] * wn     + 
-                                aCoeffVector[1] * wStateVector[0]   + 
+            SampleType ynUnprocessed =aCoeffVector[0] * wn     +
+                                aCoeffVector[1] * wStateVector[0]   +
                                 aCoeffVector[2] * wStateVector[1];
 
-            
+
             wStateVector[1] = wStateVector[0];
-            wStateVector[0] = wn;
+            wStateVector[0] = flushDenormal(wn);
             return processedCoeff * ynUnprocessed +dryCoeff * xn; //yn
 
         }
 
-        else if (form == juce::String("None"))
-        {
-            double yn = xn;
-            return yn;
-        }
+        // "None" : bypass
+        return xn;
     }
 
    /// <summary>
@@ -134,16 +152,26 @@ public:
    /// </summary>
    /// <param name="type">The form/type of the biquad filter  topology (e.g., "direct", "canonical").</param>
     void setType(juce::String type) {
+        form = getBiquadForm(type);
+    }
+
+    void setType(BiquadForm type) {
         form = type;
     }
 
 private:
-    vector<double> aCoeffVector;
-    vector<double> bCoeffVector;
-    vector<double> xStateVector{ 0.0f, 0.0f };
-    vector<double> yStateVector{ 0.0f, 0.0f };
-    vector<double> wStateVector{ 0.0f, 0.0f };
-    double dryCoeff = 0.0;
-    double processedCoeff = 1.0;
-    juce::String form;
-};
\ No newline at end of file
+    std::array<SampleType, 3> aCoeffVector{};
+    std::array<SampleType, 3> bCoeffVector{};
+    std::array<SampleType, 2> xStateVector{};
+    std::array<SampleType, 2> yStateVector{};
+    std::array<SampleType, 2> wStateVector{};
+    SampleType dryCoeff = SampleType(0);
+    SampleType processedCoeff = SampleType(1);
+    BiquadForm form;
+};
+
+/// <summary>
+/// Single precision biquad, as every default alias of dsp_fv. BiquadT<double> for low corner frequencies
+/// in the direct form, where float coefficients lose the poles' precision
+/// </summary>
+using Biquad = BiquadT<float>;
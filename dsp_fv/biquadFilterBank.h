@@ -0,0 +1,181 @@
+#pragma once
+#include <JuceHeader.h>
+#include <vector>
+#include "classicFilters.h"
+
+using std::vector;
+
+// =============================================================================
+// BiquadFilterBank
+// one biquad per channel, all channels sharing the same coefficients
+// =============================================================================
+
+/// <summary>
+/// Per channel filter bank for multichannel buses (up to 16 channels, e.g. 7.1 or 9.1.6).
+/// Every channel has its own state, the states are stored contiguously by groups of laneWidth channels :
+/// a block is interleaved group by group, and the direct form 1 recursion runs on the channels of a group
+/// together, one channel per SIMD lane. Coefficients are the ClassicFilters ones (BiquadCoefficients).
+/// </summary>
+class BiquadFilterBank
+{
+public:
+	static constexpr int laneWidth = 4;
+	static constexpr int maxChannels = 16;
+
+	/// <summary>
+	/// Allocates the channel states and the interleaving buffer, clears the states
+	/// </summary>
+	void prepare(int pNumChannels, int maxBlockSize)
+	{
+		numChannels = juce::jlimit(1, maxChannels, pNumChannels);
+		numGroups = (numChannels + laneWidth - 1) / laneWidth;
+		states.assign((size_t)numGroups * stateSize, 0.0f);
+		frames.assign((size_t)juce::jmax(1, maxBlockSize) * laneWidth, 0.0f);
+	}
+
+	/// <summary>
+	/// Clears the channel states
+	/// </summary>
+	void reset()
+	{
+		std::fill(states.begin(), states.end(), 0.0f);
+	}
+
+	/// <summary>
+	/// Sets the filter type, see ClassicFilterType
+	/// </summary>
+	void setFilterType(juce::String type)
+	{
+		filterType = BiquadCoefficients::getFilterType(type);
+	}
+
+	ClassicFilterType getFilterType() const
+	{
+		return filterType;
+	}
+
+	/// <summary>
+	/// Sets the boost / cut of the PEAK, LSF, HSF and TILT filters, applied by the next setCoefficients() call
+	/// </summary>
+	void setBoostCut(double pBoostCut_dB)
+	{
+		boostCut_dB = pBoostCut_dB;
+	}
+
+	/// <summary>
+	/// Sets the coefficients of every channel, from the corner frequency, quality factor and sample rate
+	/// </summary>
+	void setCoefficients(double cornerFreq, double qualityFactor, double sampleFreq)
+	{
+		if (coefficients.update(filterType, cornerFreq, qualityFactor, sampleFreq, boostCut_dB))
+			copyCoefficients();
+		bypass = filterType == ClassicFilterType::None;
+	}
+
+	/// <summary>
+	/// Wet (processed) = gain, Dry = 1 - gain
+	/// </summary>
+	void setFilterGain(float gain)
+	{
+		processedCoeff = gain;
+		dryCoeff = 1.0f - gain;
+	}
+
+	/// <summary>
+	/// Filters the first channels of the buffer (at most the prepared number of channels) in place.
+	/// Blocks longer than the prepared size are filtered in chunks of the prepared size
+	/// </summary>
+	void processBlock(juce::AudioBuffer<float>& buffer)
+	{
+		if (bypass)
+			return;
+
+		auto channels = juce::jmin(numChannels, buffer.getNumChannels());
+		auto chunkSize = (int)(frames.size() / laneWidth);
+		for (int start = 0; start < buffer.getNumSamples(); start += chunkSize)
+		{
+			auto numSamples = juce::jmin(chunkSize, buffer.getNumSamples() - start);
+			for (int group = 0; group * laneWidth < channels; ++group)
+				processGroup(buffer, group, channels, start, numSamples);
+		}
+	}
+
+	int getNumChannels() const
+	{
+		return numChannels;
+	}
+
+private:
+	/// <summary>
+	/// Filters the channels of one group, from sample start to start + numSamples (at most the prepared size)
+	/// </summary>
+	void processGroup(juce::AudioBuffer<float>& buffer, int group, int channels, int start, int numSamples)
+	{
+		auto firstChannel = group * laneWidth;
+		auto groupChannels = juce::jmin(laneWidth, channels - firstChannel);
+
+		// channels to frames, the unused lanes of the last group process silence
+		std::fill(frames.begin(), frames.begin() + (size_t)numSamples * laneWidth, 0.0f);
+		for (int lane = 0; lane < groupChannels; ++lane)
+		{
+			auto* input = buffer.getReadPointer(firstChannel + lane, start);
+			for (int sample = 0; sample < numSamples; ++sample)
+				frames[(size_t)sample * laneWidth + lane] = input[sample];
+		}
+
+		processFrames(states.data() + (size_t)group * stateSize, numSamples);
+
+		for (int lane = 0; lane < groupChannels; ++lane)
+		{
+			auto* output = buffer.getWritePointer(firstChannel + lane, start);
+			for (int sample = 0; sample < numSamples; ++sample)
+				output[sample] = frames[(size_t)sample * laneWidth + lane];
+		}
+	}
+
+	void copyCoefficients()
+	{
+		a0 = (float)coefficients.aCoeff[0]; a1 = (float)coefficients.aCoeff[1]; a2 = (float)coefficients.aCoeff[2];
+		b1 = (float)coefficients.bCoeff[1]; b2 = (float)coefficients.bCoeff[2];
+	}
+
+	/// <summary>
+	/// Direct form 1 on the interleaved frames of one group, state : x(n-1), x(n-2), y(n-1), y(n-2) of every lane
+	/// </summary>
+	void processFrames(float* state, int numSamples)
+	{
+		float* x1 = state;
+		float* x2 = state + laneWidth;
+		float* y1 = state + 2 * laneWidth;
+		float* y2 = state + 3 * laneWidth;
+
+		for (int sample = 0; sample < numSamples; ++sample)
+		{
+			auto* frame = frames.data() + (size_t)sample * laneWidth;
+			for (int lane = 0; lane < laneWidth; ++lane)
+			{
+				auto xn = frame[lane];
+				auto yn = a0 * xn + a1 * x1[lane] + a2 * x2[lane] - b1 * y1[lane] - b2 * y2[lane];
+				x2[lane] = x1[lane];
+				x1[lane] = xn;
+				y2[lane] = y1[lane];
+				y1[lane] = yn;
+				frame[lane] = processedCoeff * yn + dryCoeff * xn;
+			}
+		}
+	}
+
+	static constexpr int stateSize = 4 * laneWidth;
+
+	ClassicFilterType filterType = ClassicFilterType::LPF1;
+	double boostCut_dB = 0.0;
+	BiquadCoefficients coefficients;
+	float a0 = 1.0f, a1 = 0.0f, a2 = 0.0f, b1 = 0.0f, b2 = 0.0f;
+	float processedCoeff = 1.0f, dryCoeff = 0.0f;
+	bool bypass = false;
+
+	int numChannels = 0;
+	int numGroups = 0;
+	vector<float> states;
+	vector<float> frames;
+};
@@ -2,6 +2,8 @@
 #include <iostream>
 #include <memory>
 #include <vector>
+#include <algorithm>
+#include "denormals.h"
 
 using std::vector;
 using namespace std;
@@ -11,6 +13,17 @@ using namespace std;
 // with wire-AND-ing wrapping mechanism
 // ========================================================================
 
+/// <summary>
+/// A fixed tap of a multi-tap read (see CircularBuffer::gatherTaps()) : the delay in samples, as given
+/// to readBuffer(), and the gain the tap is summed with
+/// </summary>
+template <typename T>
+struct CircularBufferTap
+{
+    unsigned int delay;
+    T gain;
+};
+
 /// <summary>
 /// Represents a circular buffer template class.
 /// </summary>
@@ -19,19 +32,19 @@ class CircularBuffer
 {
 public:
     /// <summary>
-    /// Performs linear interpolation between two values.
+    /// Performs linear interpolation between two values, computed in the sample type T.
     /// </summary>
     /// <param name="y1">The first value.</param>
     /// <param name="y2">The second value.</param>
     /// <param name="fractional_X">The fractional position between y1 and y2.</param>
     /// <returns>The interpolated value.</returns>
-    double doLinearInterpolation(double y1, double y2, double fractional_X)
+    T doLinearInterpolation(T y1, T y2, T fractional_X)
     {
-        if (fractional_X >= 1.0) // If fractional_X is greater than or equal to 1.0, return y2
+        if (fractional_X >= T(1)) // If fractional_X is greater than or equal to 1.0, return y2
             return y2;
 
         // Weighted sum method of interpolation 
-        return fractional_X * y2 + (1.0 - fractional_X) * y1;
+        return y1 + fractional_X * (y2 - y1);
     }
 
     CircularBuffer()
@@ -52,9 +65,8 @@ public:
     {
         auto bufferLength = (unsigned int)(pow(2, ceil(log(length) / log(2)))); // Power of 2 : efficient modulo 2 mask operation  
 
-        // initally fills the buffer with T(0) values 
-        for (auto i = 0; i < bufferLength; ++i)
-            buffer.push_back(T(0));
+        // fills the buffer with T(0) values, replacing the previous one : createBuffer() is called at every reset
+        buffer.assign(bufferLength, T(0));
 
         writeIndex = 0;
         offset = 1;
@@ -104,6 +116,60 @@ public:
         return buffer[readIndex];
     }
 
+    /// <summary>
+    /// Reads the numSamples values a fixed delay tap returned over the last numSamples writes :
+    /// output[i] = readBuffer(pDelay) as read just after the write of sample i of the block.
+    /// Copied in at most two contiguous segments (the buffer wraps once at most), pDelay + numSamples - 1
+    /// must not exceed the buffer length
+    /// </summary>
+    /// <param name="pDelay">The delay in samples, as given to readBuffer().</param>
+    /// <param name="output">numSamples values.</param>
+    void readBlock(unsigned int pDelay, T* output, int numSamples)
+    {
+        auto bufferLength = wrapMask + 1;
+        auto readIndex = (writeIndex - pDelay - (unsigned int)(numSamples - 1)) & wrapMask;
+        auto firstSegment = std::min((unsigned int)numSamples, bufferLength - readIndex);
+        std::copy(buffer.begin() + readIndex, buffer.begin() + readIndex + firstSegment, output);
+        std::copy(buffer.begin(), buffer.begin() + (numSamples - firstSegment), output + firstSegment);
+    }
+
+    /// <summary>
+    /// Multi-tap read of the block just written : output[i] += the sum of taps[t].gain * readBuffer(taps[t].delay),
+    /// as read just after the write of sample i. Each tap is read in at most two contiguous segments, summed with
+    /// a multiply-add loop the compiler vectorises. delay + numSamples - 1 must not exceed the buffer length
+    /// </summary>
+    /// <param name="taps">numTaps taps, read from the same buffer.</param>
+    /// <param name="output">numSamples values, accumulated : cleared by the caller.</param>
+    void gatherTaps(const CircularBufferTap<T>* taps, int numTaps, T* output, int numSamples)
+    {
+        for (int tap = 0; tap < numTaps; ++tap)
+        {
+            auto readIndex = (writeIndex - taps[tap].delay - (unsigned int)(numSamples - 1)) & wrapMask;
+            accumulateSegments(readIndex, taps[tap].gain, output, numSamples);
+        }
+    }
+
+    /// <summary>
+    /// Multi-tap read of the block about to be written : output[i] += the sum of taps[t].gain * readBuffer(taps[t].delay),
+    /// as read just before the write of sample i. The taps only reach samples written before the block, every delay must
+    /// be at least numSamples : the feedback structures (tap reads before the writes) can gather a block ahead
+    /// </summary>
+    /// <param name="taps">numTaps taps, read from the same buffer.</param>
+    /// <param name="output">numSamples values, accumulated : cleared by the caller.</param>
+    void gatherTapsAhead(const CircularBufferTap<T>* taps, int numTaps, T* output, int numSamples)
+    {
+        for (int tap = 0; tap < numTaps; ++tap)
+            accumulateSegments((writeIndex - taps[tap].delay) & wrapMask, taps[tap].gain, output, numSamples);
+    }
+
+    /// <summary>
+    /// Length of the buffer in samples (a power of 2), the longest delay that can be read
+    /// </summary>
+    unsigned int getBufferLength() const
+    {
+        return wrapMask + 1;
+    }
+
     /// <summary>
     /// Flushes the circular buffer by writing zeros to all elements.
     /// This is necessary to avoid crackling at plugin startup. 
@@ -119,6 +185,7 @@ public:
 
     /// <summary>
     /// Reads data from the circular buffer with fractional delay and optional interpolation.
+    /// The delay stays in double (long delays keep their fractional resolution), the interpolation is done in T.
     /// </summary>
     /// <param name="delayInFractionalSamples">The delay in fractional samples.</param>
     /// <param name="interpolate">Flag indicating whether to perform interpolation.</param>
@@ -131,12 +198,46 @@ public:
             return y1;
         T y2 = readBuffer((unsigned int)delayInFractionalSamples + 1);
 
-        double fraction = delayInFractionalSamples - (int)delayInFractionalSamples;
+        auto fraction = (T)(delayInFractionalSamples - (int)delayInFractionalSamples);
 
         return doLinearInterpolation(y1, y2, fraction);
     }
 
+    /// <summary>
+    /// Reads data from the circular buffer with fractional delay and cubic (third order Lagrange) interpolation,
+    /// over the four samples around the delay. Much flatter than the linear interpolation, whose lowpass moves
+    /// with the fraction : for modulated reads inside feedback loops. The delay must be at least 1, and
+    /// delayInFractionalSamples + 2 must not exceed the buffer length
+    /// </summary>
+    /// <param name="delayInFractionalSamples">The delay in fractional samples.</param>
+    /// <returns>The interpolated value.</returns>
+    T readBufferCubic(double delayInFractionalSamples)
+    {
+        auto delay = (unsigned int)delayInFractionalSamples;
+        auto f = (T)(delayInFractionalSamples - (double)delay);
+        T ym1 = readBuffer(delay - 1), y0 = readBuffer(delay), y1 = readBuffer(delay + 1), y2 = readBuffer(delay + 2);
+
+        auto fp1 = f + T(1), fm1 = f - T(1), fm2 = f - T(2);
+        return fm1 * fm2 * (T(3) * fp1 * y0 - f * ym1) / T(6) + fp1 * f * (fm1 * y2 - T(3) * fm2 * y1) / T(6);
+    }
+
 private:
+    /// <summary>
+    /// output[i] += gain * the numSamples values from readIndex on, in two contiguous segments if the buffer wraps
+    /// </summary>
+    void accumulateSegments(unsigned int readIndex, T gain, T* output, int numSamples)
+    {
+        auto firstSegment = (int)std::min((unsigned int)numSamples, wrapMask + 1 - readIndex);
+        const T* segment = buffer.data() + readIndex;
+        for (int i = 0; i < firstSegment; ++i)
+            output[i] += gain * segment[i];
+
+        segment = buffer.data();
+        output += firstSegment;
+        for (int i = 0; i < numSamples - firstSegment; ++i)
+            output[i] += gain * segment[i];
+    }
+
     unsigned int writeIndex;
     unsigned int offset;
     unsigned int wrapMask;
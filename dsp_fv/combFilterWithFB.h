@@ -62,7 +62,7 @@ public:
         delayBuffer.setsDelay(delayTimeInSamples);
         auto ynD = delayBuffer.readBuffer();
         auto ynFullWet = inputXn + feedbackGain * ynD;
-        delayBuffer.writeBuffer(ynFullWet);
+        delayBuffer.writeBuffer(flushDenormal(ynFullWet));
         vector<float> yn = { dry * inputXn + wet * ynD, dry * inputXn + wet * ynD };
         return yn;
     }
@@ -174,8 +174,8 @@ public:
         auto ynDR = delayBufferR.readBuffer(delayTimeInSamples);
         auto ynFullWetL = inputXnL + feedbackGain * ynDL;
         auto ynFullWetR = inputXnR + feedbackGain * ynDR;
-        delayBufferL.writeBuffer(ynFullWetR);
-        delayBufferR.writeBuffer(ynFullWetL);
+        delayBufferL.writeBuffer(flushDenormal(ynFullWetR));
+        delayBufferR.writeBuffer(flushDenormal(ynFullWetL));
         vector<float> yn = { dry * inputXnL + wet * ynDL,dry * inputXnR + wet * ynDR };
         return yn;
     }
@@ -0,0 +1,223 @@
+#pragma once
+#include <vector>
+#include <cmath>
+#include "fft.h"
+
+using std::vector;
+
+// ========================================================================
+// Impulse response deconvolution
+// Exponential sweeps : Farina inverse filter, applied by FFT
+// Maximum length sequences : fast Hadamard transform (Borish and Angell)
+// ========================================================================
+
+/// <summary>
+/// Returns the smallest order such that 2^order >= length
+/// </summary>
+inline unsigned int getFFTOrder(size_t length)
+{
+	unsigned int order = 1;
+	while (((size_t)1 << order) < length)
+		++order;
+	return order;
+}
+
+/// <summary>
+/// Recovers impulse responses from the recorded response to an exponential sweep.
+/// The inverse filter is the time reversed sweep with a -6 dB / octave envelope, so the sweep convolved
+/// with it is a band limited impulse, delayed by the sweep length minus one sample.
+/// The harmonic distortion products land before that delay and are discarded.
+/// prepare() allocates, deconvolve() is const and can be called from several threads.
+/// </summary>
+class ExponentialSweepDeconvolver
+{
+public:
+	/// <summary>
+	/// Prepares the inverse filter spectrum
+	/// </summary>
+	/// <param name="sweep">the excitation sweep, as created by createExponentialSweep()</param>
+	/// <param name="pSampleRate"></param>
+	/// <param name="f1">sweep start frequency</param>
+	/// <param name="f2">sweep end frequency</param>
+	/// <param name="pResponseLength">number of recorded samples, sweep and tail</param>
+	void prepare(const vector<float>& sweep, double pSampleRate, double f1, double f2, size_t pResponseLength)
+	{
+		sweepLength = sweep.size();
+		responseLength = pResponseLength;
+		f2 = std::fmin(f2, 0.5 * pSampleRate);
+
+		fft.prepare(getFFTOrder(responseLength + sweepLength - 1));
+		auto size = fft.getSize();
+		auto numBins = fft.getNumBins();
+
+		// time reversed sweep, the envelope decays from 0 dB (f2) to f1 / f2 (f1)
+		auto L = (sweepLength / pSampleRate) / std::log(f2 / f1);
+		vector<float> inverse(size, 0.0f);
+		for (size_t n = 0; n < sweepLength; ++n)
+			inverse[n] = sweep[sweepLength - 1 - n] * (float)std::exp(-(n / pSampleRate) / L);
+
+		inverseRe.assign(numBins, 0.0f);
+		inverseIm.assign(numBins, 0.0f);
+		fft.performForward(inverse.data(), inverseRe.data(), inverseIm.data());
+
+		// normalisation : the sweep convolved with the inverse filter has a unit gain in the swept band
+		vector<float> sweepRe(numBins), sweepIm(numBins), padded(size, 0.0f);
+		std::copy(sweep.begin(), sweep.end(), padded.begin());
+		fft.performForward(padded.data(), sweepRe.data(), sweepIm.data());
+
+		auto binLow = (size_t)(2.0 * f1 / pSampleRate * size);
+		auto binHigh = (size_t)(0.5 * f2 / pSampleRate * size);
+		double sum = 0.0;
+		size_t count = 0;
+		for (auto k = binLow; k <= binHigh && k < numBins; ++k, ++count)
+		{
+			auto re = sweepRe[k] * inverseRe[k] - sweepIm[k] * inverseIm[k];
+			auto im = sweepRe[k] * inverseIm[k] + sweepIm[k] * inverseRe[k];
+			sum += std::sqrt(re * re + im * im);
+		}
+		auto gain = count > 0 && sum > 0.0 ? (float)(count / sum) : 1.0f;
+		for (size_t k = 0; k < numBins; ++k)
+		{
+			inverseRe[k] *= gain;
+			inverseIm[k] *= gain;
+		}
+	}
+
+	/// <summary>
+	/// Deconvolves one recorded channel
+	/// </summary>
+	/// <param name="response">responseLength recorded samples</param>
+	/// <param name="irLength">length of the returned impulse response</param>
+	/// <returns> the linear impulse response </returns>
+	vector<float> deconvolve(const float* response, size_t irLength) const
+	{
+		auto size = fft.getSize();
+		auto numBins = fft.getNumBins();
+		vector<float> buffer(size, 0.0f), re(numBins), im(numBins);
+		std::copy(response, response + responseLength, buffer.begin());
+
+		fft.performForward(buffer.data(), re.data(), im.data());
+		for (size_t k = 0; k < numBins; ++k)
+		{
+			auto r = re[k] * inverseRe[k] - im[k] * inverseIm[k];
+			auto i = re[k] * inverseIm[k] + im[k] * inverseRe[k];
+			re[k] = r;
+			im[k] = i;
+		}
+		fft.performInverse(re.data(), im.data(), buffer.data());
+
+		// the linear response starts after sweepLength - 1 samples
+		vector<float> ir(irLength, 0.0f);
+		for (size_t n = 0; n < irLength && sweepLength - 1 + n < size; ++n)
+			ir[n] = buffer[sweepLength - 1 + n];
+		return ir;
+	}
+
+private:
+	RealFFT fft;
+	size_t sweepLength = 0;
+	size_t responseLength = 0;
+	vector<float> inverseRe, inverseIm;
+};
+
+/// <summary>
+/// Recovers impulse responses from one period of the steady state response to a maximum length sequence.
+/// The circular cross correlation with the sequence is a permuted Hadamard transform :
+/// the response is scattered into a 2^order array, transformed by a fast Walsh-Hadamard transform and gathered back.
+/// The impulse response must be shorter than the sequence period, otherwise it folds back (time aliasing).
+/// </summary>
+class MLSDeconvolver
+{
+public:
+	/// <summary>
+	/// Builds the permutation tables from one period of the sequence (values +1 / -1)
+	/// </summary>
+	/// <param name="sequence">2^order - 1 samples, as created by createMaximumLengthSequence()</param>
+	void prepare(const vector<float>& sequence)
+	{
+		length = sequence.size();
+		order = getFFTOrder(length + 1);
+
+		// the bits of the linear recurrence, +1 -> 1, -1 -> 0
+		vector<unsigned char> bits(length);
+		for (size_t n = 0; n < length; ++n)
+			bits[n] = sequence[n] > 0.0f ? 1 : 0;
+
+		// every non zero order bits word appears once as a window of consecutive bits
+		auto window = [&](size_t k)
+		{
+			unsigned int w = 0;
+			for (unsigned int i = 0; i < order; ++i)
+				w |= (unsigned int)bits[(k + i) % length] << i;
+			return w;
+		};
+
+		// positions of the unit windows
+		vector<size_t> unitPosition(order, 0);
+		for (size_t k = 0; k < length; ++k)
+		{
+			auto w = window(k);
+			for (unsigned int i = 0; i < order; ++i)
+				if (w == (1u << i))
+					unitPosition[i] = k;
+		}
+
+		// input permutation : bit i of p[n] is the bit n samples after the unit window i
+		scatterIndex.resize(length);
+		for (size_t n = 0; n < length; ++n)
+		{
+			unsigned int p = 0;
+			for (unsigned int i = 0; i < order; ++i)
+				p |= (unsigned int)bits[(unitPosition[i] + n) % length] << i;
+			scatterIndex[n] = p;
+		}
+
+		// output permutation : window starting at -tau
+		gatherIndex.resize(length);
+		for (size_t tau = 0; tau < length; ++tau)
+			gatherIndex[tau] = window((length - tau) % length);
+	}
+
+	/// <summary>
+	/// Deconvolves one period of the recorded steady state response
+	/// </summary>
+	/// <param name="response">length recorded samples, the first period having been discarded</param>
+	/// <returns> length samples of impulse response </returns>
+	vector<float> deconvolve(const float* response) const
+	{
+		auto size = (size_t)1 << order;
+		vector<double> work(size, 0.0);
+		for (size_t n = 0; n < length; ++n)
+			work[scatterIndex[n]] = response[n];
+
+		// fast Walsh-Hadamard transform
+		for (size_t h = 1; h < size; h <<= 1)
+			for (size_t start = 0; start < size; start += 2 * h)
+				for (size_t k = start; k < start + h; ++k)
+				{
+					auto a = work[k], b = work[k + h];
+					work[k] = a + b;
+					work[k + h] = a - b;
+				}
+
+		// the transform correlates with (-1)^bit, which is minus the sequence
+		// the MLS autocorrelation is (L + 1) delta - 1, hence h = (R + sum(R)) / (L + 1)
+		vector<float> ir(length);
+		double sum = 0.0;
+		for (size_t tau = 0; tau < length; ++tau)
+			sum -= work[gatherIndex[tau]];
+		for (size_t tau = 0; tau < length; ++tau)
+			ir[tau] = (float)((-work[gatherIndex[tau]] + sum) / (length + 1));
+		return ir;
+	}
+
+	size_t getLength() const
+	{
+		return length;
+	}
+
+private:
+	size_t length = 0;
+	unsigned int order = 1;
+	vector<unsigned int> scatterIndex, gatherIndex;
+};
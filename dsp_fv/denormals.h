@@ -0,0 +1,26 @@
+#pragma once
+#include <cmath>
+
+// =============================================================================
+// Denormal protection
+// Decaying feedback structures (combs, allpasses, filter states) reach subnormal numbers once their input stops,
+// which slows x86 processors down by orders of magnitude. The plugins set flush to zero / denormals are zero
+// for their processBlock() (juce::ScopedNoDenormals) ; the primitives also flush their recursive states
+// themselves, for the architectures and threads where those flags are not set
+// =============================================================================
+
+/// <summary>
+/// Values below this magnitude are flushed to zero by the primitives (-300 dB, far above the
+/// subnormal ranges of float and double)
+/// </summary>
+constexpr double denormalThreshold = 1.0e-15;
+
+/// <summary>
+/// Returns 0 if x is below denormalThreshold, x otherwise. Branchless once compiled (compare and mask),
+/// to be applied to the values written back into a feedback path
+/// </summary>
+template <typename SampleType>
+inline SampleType flushDenormal(SampleType x)
+{
+	return std::abs(x) < SampleType(denormalThreshold) ? SampleType(0) : x;
+}
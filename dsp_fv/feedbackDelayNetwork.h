@@ -0,0 +1,283 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <cmath>
+#include "APFstructures.h"
+#include "silenceDetector.h"
+
+// =============================================================================
+// Feedback delay network
+// numLines delay lines fed back through a unitary matrix (Hadamard or Householder),
+// with a per line absorption filter setting the decay time and its high frequency
+// damping. J.-M. Jot, A. Chaigne, "Digital delay networks for designing artificial
+// reverberators" (AES 1991). The per line operations are loops over the lines, which
+// the compiler turns into SIMD instructions (as the batched filters, one line per lane).
+// =============================================================================
+
+enum class FDNMatrixType { hadamard, householder };
+
+/// <summary>
+/// Control parameters of the feedback delay network
+/// </summary>
+struct FDNParameters
+{
+	double mix = 1.0;
+	double decay_s = 2.0;			// RT60 at DC
+	double damping = 0.5;			// RT60 at Nyquist / RT60 at DC, (0, 1]
+	double size = 1.0;				// delay lengths scale, 0.25 to 2
+	double modulationRate_Hz = 0.5;
+	double modulationDepth_ms = 0.3;
+	FDNMatrixType matrix = FDNMatrixType::hadamard;
+};
+
+/// <summary>
+/// Feedback delay network reverb, 8 or 16 lines, stereo in and out.
+/// The lines are delayLine instances, read with a modulated fractional delay and cubic interpolation : the absorption
+/// filters assume a lossless read, the linear interpolation's lowpass shortened the decay (RT60 1.78 s for 2 s with
+/// flat damping and the default 0.3 ms depth, 1.90 s with the cubic, 2.01 s unmodulated). The delay lengths are
+/// primes spread exponentially between minDelay_ms and maxDelay_ms (times size).
+/// reset() allocates, setParameters() only recomputes the coefficients (size changes are applied at the next reset()).
+/// Lines, filters, oscillators and frames are in SampleType, see the FeedbackDelayNetwork alias
+/// </summary>
+template <int numLines, typename SampleType>
+class FeedbackDelayNetworkT
+{
+	static_assert(numLines == 8 || numLines == 16, "FeedbackDelayNetwork : 8 or 16 lines");
+
+public:
+	static constexpr double minDelay_ms = 21.0;
+	static constexpr double maxDelay_ms = 63.0;
+	static constexpr double maxSize = 2.0;
+
+	/// <summary>
+	/// Allocates the delay lines for the current size, clears the states
+	/// </summary>
+	void reset(double pSampleRate)
+	{
+		sampleRate = pSampleRate;
+		lengthSize = juce::jlimit(0.25, maxSize, parameters.size);
+
+		auto samplesPerMsec = sampleRate / 1000.0;
+		auto maxExcursion = maxModulationDepth_ms * samplesPerMsec;
+		for (int line = 0; line < numLines; ++line)
+		{
+			auto position = (double)line / (numLines - 1);
+			auto length_ms = lengthSize * minDelay_ms * std::pow(maxDelay_ms / minDelay_ms, position);
+			delayLengths[line] = (SampleType)nextPrime((unsigned int)(length_ms * samplesPerMsec));
+
+			// the buffer holds the longest modulated read
+			delayLineParameters lineParameters = { (delayLengths[line] + maxExcursion + 3.0) / samplesPerMsec, true };
+			lines[line].setParameters(lineParameters);
+			lines[line].createDelayBuffer(sampleRate);
+		}
+
+		filterStates.fill(0.0f);
+		// one quadrature oscillator per line, phases spread over the period
+		for (int line = 0; line < numLines; ++line)
+		{
+			auto phase = juce::MathConstants<double>::twoPi * line / numLines;
+			lfoSin[line] = (SampleType)std::sin(phase);
+			lfoCos[line] = (SampleType)std::cos(phase);
+		}
+		updateCoefficients();
+	}
+
+	/// <summary>
+	/// Sets the control parameters, recomputes the absorption filters and the modulation
+	/// </summary>
+	void setParameters(const FDNParameters& pParameters)
+	{
+		parameters = pParameters;
+		updateCoefficients();
+	}
+
+	/// <summary>
+	/// Processes one stereo frame (left, right) in place
+	/// </summary>
+	void processAudioFrame(SampleType* frame)
+	{
+		alignas(64) SampleType yn[numLines];
+		alignas(64) SampleType readDelay[numLines];
+
+		// modulated read positions, the oscillators are rotated by one sample
+		for (int line = 0; line < numLines; ++line)
+		{
+			auto s = lfoSin[line] * rotationCos[line] + lfoCos[line] * rotationSin[line];
+			auto c = lfoCos[line] * rotationCos[line] - lfoSin[line] * rotationSin[line];
+			lfoSin[line] = s;
+			lfoCos[line] = c;
+			readDelay[line] = delayLengths[line] + modulationDepth * s;
+		}
+		for (int line = 0; line < numLines; ++line)
+			yn[line] = lines[line].readDelayLineCubic(readDelay[line]);
+
+		// absorption : H(z) = g (1 - p) / (1 - p z^-1)
+		for (int line = 0; line < numLines; ++line)
+		{
+			yn[line] = flushDenormal(filterGains[line] * yn[line] + filterPoles[line] * filterStates[line]);
+			filterStates[line] = yn[line];
+		}
+
+		// outputs : even lines to the left, odd lines to the right, alternating signs
+		SampleType wetL = SampleType(0), wetR = SampleType(0);
+		for (int line = 0; line < numLines; line += 4)
+		{
+			wetL += yn[line] - yn[line + 2];
+			wetR += yn[line + 1] - yn[line + 3];
+		}
+
+		if (parameters.matrix == FDNMatrixType::householder)
+			householder(yn);
+		else
+			hadamard(yn);
+
+		// inputs : left to the even lines, right to the odd ones
+		auto inL = frame[0], inR = frame[1];
+		for (int line = 0; line < numLines; line += 2)
+		{
+			auto sign = (line & 2) ? SampleType(-1) : SampleType(1);
+			yn[line] += sign * inL;
+			yn[line + 1] += sign * inR;
+		}
+		for (int line = 0; line < numLines; ++line)
+			lines[line].writeDelayLine(yn[line]);
+
+		// periodic renormalization of the oscillators
+		if (++renormalizationCounter >= renormalizationPeriod)
+		{
+			renormalizationCounter = 0;
+			for (int line = 0; line < numLines; ++line)
+			{
+				auto gain = SampleType(1) / std::sqrt(lfoSin[line] * lfoSin[line] + lfoCos[line] * lfoCos[line]);
+				lfoSin[line] *= gain;
+				lfoCos[line] *= gain;
+			}
+		}
+
+		auto mix = (SampleType)parameters.mix;
+		frame[0] = (1 - mix) * inL + mix * outputGain * wetL;
+		frame[1] = (1 - mix) * inR + mix * outputGain * wetR;
+	}
+
+	/// <summary>
+	/// Tail length in seconds (decay by tailDecay_dB) : decay_s is the RT60 at DC, the other frequencies decay faster.
+	/// The longest line, and its modulation, is added
+	/// </summary>
+	double getTailLengthSeconds() const
+	{
+		auto longestLine_s = (delayLengths[numLines - 1] + modulationDepth) / sampleRate;
+		return limitTailLength(longestLine_s + juce::jmax(0.05, parameters.decay_s) * tailDecay_dB / 60.0);
+	}
+
+	/// <summary>
+	/// Delay length of a line in samples, without modulation
+	/// </summary>
+	SampleType getDelayLength(int line) const
+	{
+		return delayLengths[(size_t)line];
+	}
+
+private:
+	/// <summary>
+	/// Normalized Hadamard matrix, fast Walsh-Hadamard transform : log2(numLines) stages of butterflies
+	/// </summary>
+	static void hadamard(SampleType* x)
+	{
+		for (int half = 1; half < numLines; half *= 2)
+		{
+			for (int block = 0; block < numLines; block += 2 * half)
+			{
+				for (int i = block; i < block + half; ++i)
+				{
+					auto a = x[i];
+					auto b = x[i + half];
+					x[i] = a + b;
+					x[i + half] = a - b;
+				}
+			}
+		}
+		const auto scale = (SampleType)(1.0 / std::sqrt((double)numLines));
+		for (int line = 0; line < numLines; ++line)
+			x[line] *= scale;
+	}
+
+	/// <summary>
+	/// Householder reflection, I - 2/N 1 1^T
+	/// </summary>
+	static void householder(SampleType* x)
+	{
+		SampleType sum = SampleType(0);
+		for (int line = 0; line < numLines; ++line)
+			sum += x[line];
+		sum *= SampleType(2) / numLines;
+		for (int line = 0; line < numLines; ++line)
+			x[line] -= sum;
+	}
+
+	/// <summary>
+	/// Absorption filters (Jot) : g = 10^(-3 m / (fs RT60)), p = ln(10) / 4 log10(g) (1 - 1 / alpha^2),
+	/// alpha = RT60(Nyquist) / RT60(DC). Modulation oscillators rates and depth
+	/// </summary>
+	void updateCoefficients()
+	{
+		auto decay = juce::jmax(0.05, parameters.decay_s);
+		auto alpha = juce::jlimit(0.05, 1.0, parameters.damping);
+		for (int line = 0; line < numLines; ++line)
+		{
+			auto log10g = -3.0 * delayLengths[line] / (sampleRate * decay);
+			auto pole = std::log(10.0) / 4.0 * log10g * (1.0 - 1.0 / (alpha * alpha));
+			pole = juce::jlimit(0.0, 0.99, pole);
+			auto g = std::pow(10.0, log10g);
+			filterGains[line] = (SampleType)(g * (1.0 - pole));
+			filterPoles[line] = (SampleType)pole;
+
+			// rates spread by +-20 % around the set rate
+			auto rate = parameters.modulationRate_Hz * (0.8 + 0.4 * line / (numLines - 1));
+			auto w = juce::MathConstants<double>::twoPi * rate / sampleRate;
+			rotationSin[line] = (SampleType)std::sin(w);
+			rotationCos[line] = (SampleType)std::cos(w);
+		}
+		modulationDepth = (SampleType)(juce::jlimit(0.0, maxModulationDepth_ms, parameters.modulationDepth_ms) * sampleRate / 1000.0);
+		outputGain = (SampleType)(1.0 / std::sqrt((double)numLines / 2.0));
+	}
+
+	static unsigned int nextPrime(unsigned int n)
+	{
+		auto isPrime = [](unsigned int value)
+		{
+			if (value < 2)
+				return false;
+			for (unsigned int divisor = 2; divisor * divisor <= value; ++divisor)
+				if (value % divisor == 0)
+					return false;
+			return true;
+		};
+		while (!isPrime(n))
+			++n;
+		return n;
+	}
+
+	static constexpr double maxModulationDepth_ms = 2.0;
+	static constexpr int renormalizationPeriod = 4096;
+
+	double sampleRate = 44100.0;
+	double lengthSize = 1.0;
+	FDNParameters parameters;
+
+	std::array<delayLineT<SampleType>, numLines> lines;
+	alignas(64) std::array<SampleType, numLines> delayLengths {};
+	alignas(64) std::array<SampleType, numLines> filterGains {};
+	alignas(64) std::array<SampleType, numLines> filterPoles {};
+	alignas(64) std::array<SampleType, numLines> filterStates {};
+	alignas(64) std::array<SampleType, numLines> lfoSin {}, lfoCos {};
+	alignas(64) std::array<SampleType, numLines> rotationSin {}, rotationCos {};
+	SampleType modulationDepth = SampleType(0);
+	SampleType outputGain = SampleType(1);
+	int renormalizationCounter = 0;
+};
+
+/// <summary>
+/// Single precision network, as every default alias of dsp_fv
+/// </summary>
+template <int numLines>
+using FeedbackDelayNetwork = FeedbackDelayNetworkT<numLines, float>;
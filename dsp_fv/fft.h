@@ -0,0 +1,263 @@
+#pragma once
+#include <vector>
+#include <cmath>
+#include <utility>
+
+using std::vector;
+
+// ========================================================================
+// FFT classes
+// radix-2, iterative, split real / imaginary arrays
+// ========================================================================
+
+/// <summary>
+/// In place complex FFT of size 2^order, on split real and imaginary arrays.
+/// Tables are built by prepare(), perform() does not allocate and is const, so one instance
+/// can be shared by several threads working on their own buffers.
+/// </summary>
+class ComplexFFT
+{
+public:
+	ComplexFFT() {}
+	ComplexFFT(unsigned int pOrder)
+	{
+		prepare(pOrder);
+	}
+
+	/// <summary>
+	/// Builds the bit reversal and twiddle tables for a 2^pOrder points transform
+	/// </summary>
+	/// <param name="pOrder"></param>
+	void prepare(unsigned int pOrder)
+	{
+		order = pOrder;
+		size = 1u << order;
+
+		// bit reversal swaps
+		swaps.clear();
+		for (unsigned int i = 0; i < size; ++i)
+		{
+			unsigned int j = 0;
+			for (unsigned int b = 0; b < order; ++b)
+				j |= ((i >> b) & 1u) << (order - 1 - b);
+			if (j > i)
+				swaps.push_back({ i, j });
+		}
+
+		// twiddles W^k = exp(-2 pi i k / 2h), stored contiguously for each stage of half size h
+		twiddleRe.assign(size > 1 ? size - 1 : 1, 0.0f);
+		twiddleIm.assign(size > 1 ? size - 1 : 1, 0.0f);
+		for (unsigned int h = 1, offset = 0; h < size; offset += h, h <<= 1)
+		{
+			for (unsigned int k = 0; k < h; ++k)
+			{
+				auto w = -3.14159265358979323846 * k / h;
+				twiddleRe[offset + k] = (float)std::cos(w);
+				twiddleIm[offset + k] = (float)std::sin(w);
+			}
+		}
+	}
+
+	unsigned int getSize() const
+	{
+		return size;
+	}
+
+	unsigned int getOrder() const
+	{
+		return order;
+	}
+
+	/// <summary>
+	/// Performs the transform in place. The inverse transform is scaled by 1 / size.
+	/// </summary>
+	/// <param name="re">real part, size samples</param>
+	/// <param name="im">imaginary part, size samples</param>
+	/// <param name="inverse"></param>
+	void perform(float* re, float* im, bool inverse = false) const
+	{
+		// the inverse transform is the forward transform with real and imaginary parts exchanged
+		if (inverse)
+			std::swap(re, im);
+
+		for (auto& s : swaps)
+		{
+			std::swap(re[s.first], re[s.second]);
+			std::swap(im[s.first], im[s.second]);
+		}
+
+		for (unsigned int h = 1, offset = 0; h < size; offset += h, h <<= 1)
+		{
+			const float* wr = twiddleRe.data() + offset;
+			const float* wi = twiddleIm.data() + offset;
+			for (unsigned int start = 0; start < size; start += 2 * h)
+			{
+				float* r0 = re + start;
+				float* i0 = im + start;
+				float* r1 = r0 + h;
+				float* i1 = i0 + h;
+				// contiguous butterflies : this loop vectorises
+				for (unsigned int k = 0; k < h; ++k)
+				{
+					auto tr = r1[k] * wr[k] - i1[k] * wi[k];
+					auto ti = r1[k] * wi[k] + i1[k] * wr[k];
+					r1[k] = r0[k] - tr;
+					i1[k] = i0[k] - ti;
+					r0[k] += tr;
+					i0[k] += ti;
+				}
+			}
+		}
+
+		if (inverse)
+		{
+			auto scale = 1.0f / size;
+			for (unsigned int n = 0; n < size; ++n)
+			{
+				re[n] *= scale;
+				im[n] *= scale;
+			}
+		}
+	}
+
+private:
+	unsigned int order = 0;
+	unsigned int size = 1;
+	vector<std::pair<unsigned int, unsigned int>> swaps;
+	vector<float> twiddleRe, twiddleIm;
+};
+
+/// <summary>
+/// Real FFT of size 2^order, computed with a complex FFT of half size.
+/// The spectrum holds size / 2 + 1 bins, from DC to Nyquist. perform functions are const and do not allocate.
+/// </summary>
+class RealFFT
+{
+public:
+	RealFFT() {}
+	RealFFT(unsigned int pOrder)
+	{
+		prepare(pOrder);
+	}
+
+	/// <summary>
+	/// Prepares a 2^pOrder points real transform, pOrder >= 1
+	/// </summary>
+	/// <param name="pOrder"></param>
+	void prepare(unsigned int pOrder)
+	{
+		order = pOrder < 1 ? 1 : pOrder;
+		size = 1u << order;
+		halfFFT.prepare(order - 1);
+
+		auto half = size / 2;
+		splitRe.resize(half);
+		splitIm.resize(half);
+		for (unsigned int k = 0; k < half; ++k)
+		{
+			auto w = -2.0 * 3.14159265358979323846 * k / size;
+			splitRe[k] = (float)std::cos(w);
+			splitIm[k] = (float)std::sin(w);
+		}
+	}
+
+	unsigned int getSize() const
+	{
+		return size;
+	}
+
+	unsigned int getNumBins() const
+	{
+		return size / 2 + 1;
+	}
+
+	/// <summary>
+	/// Forward transform
+	/// </summary>
+	/// <param name="input">size real samples</param>
+	/// <param name="re">size / 2 + 1 bins</param>
+	/// <param name="im">size / 2 + 1 bins</param>
+	void performForward(const float* input, float* re, float* im) const
+	{
+		auto half = size / 2;
+
+		// even samples as real part, odd samples as imaginary part
+		for (unsigned int n = 0; n < half; ++n)
+		{
+			re[n] = input[2 * n];
+			im[n] = input[2 * n + 1];
+		}
+		halfFFT.perform(re, im);
+
+		// split the half size spectrum Z into the even and odd spectra, X[k] = E[k] + W^k O[k]
+		auto zr0 = re[0], zi0 = im[0];
+		re[0] = zr0 + zi0;
+		im[0] = 0.0f;
+		re[half] = zr0 - zi0;
+		im[half] = 0.0f;
+
+		for (unsigned int k = 1; k <= half / 2; ++k)
+		{
+			auto m = half - k;
+			auto ar = re[k], ai = im[k], br = re[m], bi = im[m];
+
+			auto er = 0.5f * (ar + br), ei = 0.5f * (ai - bi);
+			auto or_ = 0.5f * (ai + bi), oi = -0.5f * (ar - br);
+
+			auto tr = splitRe[k] * or_ - splitIm[k] * oi;
+			auto ti = splitRe[k] * oi + splitIm[k] * or_;
+			re[k] = er + tr;
+			im[k] = ei + ti;
+
+			// bin half - k : E and O are conjugate symmetric and W^(half - k) = -conj(W^k), so X[half - k] = conj(E[k] - W^k O[k])
+			re[m] = er - tr;
+			im[m] = ti - ei;
+		}
+	}
+
+	/// <summary>
+	/// Inverse transform, scaled by 1 / size. The spectrum arrays are used as scratch memory.
+	/// </summary>
+	/// <param name="re">size / 2 + 1 bins</param>
+	/// <param name="im">size / 2 + 1 bins</param>
+	/// <param name="output">size real samples</param>
+	void performInverse(float* re, float* im, float* output) const
+	{
+		auto half = size / 2;
+
+		// rebuild Z[k] = E[k] + i O[k]
+		auto x0 = re[0], xh = re[half];
+		re[0] = 0.5f * (x0 + xh);
+		im[0] = 0.5f * (x0 - xh);
+
+		for (unsigned int k = 1; k <= half / 2; ++k)
+		{
+			auto m = half - k;
+			auto ar = re[k], ai = im[k], br = re[m], bi = -im[m];
+
+			// E[k] = (X[k] + conj(X[half - k])) / 2, O[k] = (X[k] - conj(X[half - k])) / 2 * conj(W^k)
+			auto er = 0.5f * (ar + br), ei = 0.5f * (ai + bi);
+			auto dr = 0.5f * (ar - br), di = 0.5f * (ai - bi);
+			auto or_ = dr * splitRe[k] + di * splitIm[k];
+			auto oi = di * splitRe[k] - dr * splitIm[k];
+
+			re[k] = er - oi;
+			im[k] = ei + or_;
+			re[m] = er + oi;
+			im[m] = or_ - ei;
+		}
+		halfFFT.perform(re, im, true);
+
+		for (unsigned int n = 0; n < half; ++n)
+		{
+			output[2 * n] = re[n];
+			output[2 * n + 1] = im[n];
+		}
+	}
+
+private:
+	unsigned int order = 1;
+	unsigned int size = 2;
+	ComplexFFT halfFFT;
+	vector<float> splitRe, splitIm;
+};
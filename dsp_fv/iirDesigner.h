@@ -0,0 +1,286 @@
+#pragma once
+#include <JuceHeader.h>
+#include <vector>
+#include <complex>
+#include <cmath>
+
+using std::vector;
+
+// =============================================================================
+// IIR filter designer
+// Butterworth, Chebyshev I and II and elliptic (Cauer) filters, any order, designed
+// as an analog prototype and mapped by the bilinear transform (prewarped cutoff)
+// into a cascade of second order sections. Meant to be called at reset(), not per sample.
+// =============================================================================
+
+enum class IIRDesignType { butterworth, chebyshevI, chebyshevII, elliptic };
+enum class IIRResponseType { lowpass, highpass };
+
+/// <summary>
+/// IIR filter specification. cutoffFreq is the passband edge (-passbandRipple_dB for chebyshevI and elliptic, -3 dB for butterworth),
+/// except for chebyshevII where it is the stopband edge (-stopbandAttenuation_dB), as in scipy.signal
+/// </summary>
+struct IIRDesignParameters
+{
+	IIRDesignType type = IIRDesignType::butterworth;
+	IIRResponseType response = IIRResponseType::lowpass;
+	unsigned int order = 2;
+	double cutoffFreq = 1000.0;
+	double passbandRipple_dB = 1.0;			// chebyshevI, elliptic
+	double stopbandAttenuation_dB = 60.0;	// chebyshevII, elliptic
+};
+
+/// <summary>
+/// Cascade of second order sections, ClassicFilters convention : acoeff rows = numerators a0 a1 a2,
+/// bcoeff rows = denominators 1 b1 b2. Odd orders end with a first order section (a2 = b2 = 0)
+/// </summary>
+struct SOSCoefficients
+{
+	unsigned int N = 0; // filter order
+	vector<vector<double>> acoeff;
+	vector<vector<double>> bcoeff;
+};
+
+/// <summary>
+/// IIR filter designer. Every section has unity gain at DC (lowpass) or Nyquist (highpass),
+/// the even order Chebyshev I and elliptic ripple offset is applied to the first section.
+/// Elliptic functions : Landen transformations, after S. J. Orfanidis, "Lecture Notes on Elliptic Filter Design" (2006)
+/// </summary>
+class IIRDesigner
+{
+public:
+	static SOSCoefficients design(const IIRDesignParameters& parameters, double sampleRate)
+	{
+		auto order = juce::jmax(1u, parameters.order);
+		AnalogPrototype prototype;
+		switch (parameters.type)
+		{
+		case IIRDesignType::chebyshevI:	 prototype = chebyshevI(order, parameters.passbandRipple_dB); break;
+		case IIRDesignType::chebyshevII: prototype = chebyshevII(order, parameters.stopbandAttenuation_dB); break;
+		case IIRDesignType::elliptic:	 prototype = elliptic(order, parameters.passbandRipple_dB, parameters.stopbandAttenuation_dB); break;
+		default:						 prototype = butterworth(order); break;
+		}
+		return bilinearTransform(prototype, parameters.response, parameters.cutoffFreq, sampleRate);
+	}
+
+private:
+	using Complex = std::complex<double>;
+
+	/// <summary>
+	/// Analog section, edge frequency 1 rad/s : pole (upper half plane, or real for a first order section),
+	/// zero (upper half plane) or none (zero at infinity)
+	/// </summary>
+	struct AnalogSection
+	{
+		Complex pole;
+		Complex zero;
+		bool hasZero = false;
+		bool firstOrder = false;
+	};
+
+	struct AnalogPrototype
+	{
+		vector<AnalogSection> sections;
+		double gain = 1.0; // passband reference gain (DC of the lowpass)
+		unsigned int order = 0;
+	};
+
+	static constexpr double pi = juce::MathConstants<double>::pi;
+
+	static double getTheta(unsigned int i, unsigned int order)
+	{
+		return pi * (2.0 * i + 1.0) / (2.0 * order);
+	}
+
+	static AnalogPrototype butterworth(unsigned int order)
+	{
+		AnalogPrototype prototype;
+		prototype.order = order;
+		for (unsigned int i = 0; i < order / 2; ++i)
+		{
+			AnalogSection section;
+			section.pole = Complex(-std::sin(getTheta(i, order)), std::cos(getTheta(i, order)));
+			prototype.sections.push_back(section);
+		}
+		if (order % 2 == 1)
+			prototype.sections.push_back({ Complex(-1.0, 0.0), Complex(), false, true });
+		return prototype;
+	}
+
+	static AnalogPrototype chebyshevI(unsigned int order, double passbandRipple_dB)
+	{
+		auto ep = std::sqrt(std::pow(10.0, passbandRipple_dB / 10.0) - 1.0);
+		auto v0 = std::asinh(1.0 / ep) / order;
+
+		AnalogPrototype prototype;
+		prototype.order = order;
+		for (unsigned int i = 0; i < order / 2; ++i)
+		{
+			AnalogSection section;
+			section.pole = Complex(-std::sinh(v0) * std::sin(getTheta(i, order)), std::cosh(v0) * std::cos(getTheta(i, order)));
+			prototype.sections.push_back(section);
+		}
+		if (order % 2 == 1)
+			prototype.sections.push_back({ Complex(-std::sinh(v0), 0.0), Complex(), false, true });
+		else
+			prototype.gain = 1.0 / std::sqrt(1.0 + ep * ep);
+		return prototype;
+	}
+
+	static AnalogPrototype chebyshevII(unsigned int order, double stopbandAttenuation_dB)
+	{
+		auto es = std::sqrt(std::pow(10.0, stopbandAttenuation_dB / 10.0) - 1.0);
+		auto v0 = std::asinh(es) / order;
+
+		AnalogPrototype prototype;
+		prototype.order = order;
+		for (unsigned int i = 0; i < order / 2; ++i)
+		{
+			AnalogSection section;
+			section.pole = 1.0 / Complex(-std::sinh(v0) * std::sin(getTheta(i, order)), -std::cosh(v0) * std::cos(getTheta(i, order)));
+			section.zero = Complex(0.0, 1.0 / std::cos(getTheta(i, order)));
+			section.hasZero = true;
+			prototype.sections.push_back(section);
+		}
+		if (order % 2 == 1)
+			prototype.sections.push_back({ Complex(-1.0 / std::sinh(v0), 0.0), Complex(), false, true });
+		return prototype;
+	}
+
+	static AnalogPrototype elliptic(unsigned int order, double passbandRipple_dB, double stopbandAttenuation_dB)
+	{
+		auto ep = std::sqrt(std::pow(10.0, passbandRipple_dB / 10.0) - 1.0);
+		auto es = std::sqrt(std::pow(10.0, stopbandAttenuation_dB / 10.0) - 1.0);
+		auto k1 = ep / es;
+		auto k = ellipdeg(order, k1);
+		auto v0 = (Complex(0.0, -1.0) * asne(Complex(0.0, 1.0 / ep), k1) / (double)order).real();
+		const Complex j(0.0, 1.0);
+
+		AnalogPrototype prototype;
+		prototype.order = order;
+		for (unsigned int i = 0; i < order / 2; ++i)
+		{
+			auto ui = (2.0 * i + 1.0) / order;
+			AnalogSection section;
+			section.pole = j * cde(Complex(ui, -v0), k);
+			section.zero = j / (k * cde(Complex(ui, 0.0), k));
+			section.hasZero = true;
+			prototype.sections.push_back(section);
+		}
+		if (order % 2 == 1)
+			prototype.sections.push_back({ Complex((j * sne(Complex(0.0, v0), k)).real(), 0.0), Complex(), false, true });
+		else
+			prototype.gain = 1.0 / std::sqrt(1.0 + ep * ep);
+		return prototype;
+	}
+
+	/// <summary>
+	/// Descending Landen sequence of the modulus k
+	/// </summary>
+	static vector<double> landen(double k)
+	{
+		vector<double> moduli;
+		for (int n = 0; n < 20 && k > 1.0e-15; ++n)
+		{
+			k = std::pow(k / (1.0 + std::sqrt(1.0 - k * k)), 2.0);
+			moduli.push_back(k);
+		}
+		return moduli;
+	}
+
+	/// <summary>
+	/// Jacobi elliptic cd(u K, k), u normalized by the quarter period K
+	/// </summary>
+	static Complex cde(Complex u, double k)
+	{
+		auto moduli = landen(k);
+		auto w = std::cos(u * pi / 2.0);
+		for (auto n = (int)moduli.size() - 1; n >= 0; --n)
+			w = (1.0 + moduli[n]) * w / (1.0 + moduli[n] * w * w);
+		return w;
+	}
+
+	/// <summary>
+	/// Jacobi elliptic sn(u K, k), u normalized by the quarter period K
+	/// </summary>
+	static Complex sne(Complex u, double k)
+	{
+		auto moduli = landen(k);
+		auto w = std::sin(u * pi / 2.0);
+		for (auto n = (int)moduli.size() - 1; n >= 0; --n)
+			w = (1.0 + moduli[n]) * w / (1.0 + moduli[n] * w * w);
+		return w;
+	}
+
+	/// <summary>
+	/// Inverse of sne()
+	/// </summary>
+	static Complex asne(Complex w, double k)
+	{
+		auto moduli = landen(k);
+		auto previousModulus = k;
+		for (auto modulus : moduli)
+		{
+			w = w / (1.0 + std::sqrt(1.0 - w * w * previousModulus * previousModulus)) * 2.0 / (1.0 + modulus);
+			previousModulus = modulus;
+		}
+		return 1.0 - std::acos(w) * 2.0 / pi;
+	}
+
+	/// <summary>
+	/// Solves the degree equation : elliptic modulus k of an order N filter of discrimination k1 = ep / es
+	/// </summary>
+	static double ellipdeg(unsigned int order, double k1)
+	{
+		auto k1p = std::sqrt(1.0 - k1 * k1);
+		auto kp = std::pow(k1p, (double)order);
+		for (unsigned int i = 0; i < order / 2; ++i)
+			kp *= std::pow(sne(Complex((2.0 * i + 1.0) / order, 0.0), k1p).real(), 4.0);
+		return std::sqrt(1.0 - kp * kp);
+	}
+
+	/// <summary>
+	/// Scales the prototype to the prewarped cutoff (lowpass) or inverts it (highpass),
+	/// then maps every section to the z plane, z = (1 + s) / (1 - s)
+	/// </summary>
+	static SOSCoefficients bilinearTransform(const AnalogPrototype& prototype, IIRResponseType response, double cutoffFreq, double sampleRate)
+	{
+		auto warpedCutoff = std::tan(pi * juce::jlimit(1.0e-6, 0.499, cutoffFreq / sampleRate));
+		auto highpass = response == IIRResponseType::highpass;
+		auto toDigital = [](Complex s) { return (1.0 + s) / (1.0 - s); };
+		auto reference = highpass ? -1.0 : 1.0; // z^-1 at Nyquist or DC, where the sections have unity gain
+
+		SOSCoefficients sos;
+		sos.N = prototype.order;
+		for (const auto& section : prototype.sections)
+		{
+			auto pole = toDigital(highpass ? warpedCutoff / section.pole : warpedCutoff * section.pole);
+			// zeros at infinity map to Nyquist (lowpass), to DC once inverted (highpass)
+			auto zero = section.hasZero ? toDigital(highpass ? warpedCutoff / section.zero : warpedCutoff * section.zero) : Complex(-reference, 0.0);
+
+			vector<double> numerator, denominator;
+			if (section.firstOrder)
+			{
+				numerator = { 1.0, -zero.real(), 0.0 };
+				denominator = { 1.0, -pole.real(), 0.0 };
+			}
+			else
+			{
+				numerator = { 1.0, -2.0 * zero.real(), std::norm(zero) };
+				denominator = { 1.0, -2.0 * pole.real(), std::norm(pole) };
+			}
+
+			auto sectionGain = (numerator[0] + numerator[1] * reference + numerator[2] * reference * reference)
+				/ (denominator[0] + denominator[1] * reference + denominator[2] * reference * reference);
+			for (auto& coefficient : numerator)
+				coefficient /= sectionGain;
+
+			sos.acoeff.push_back(numerator);
+			sos.bcoeff.push_back(denominator);
+		}
+
+		for (auto& coefficient : sos.acoeff[0])
+			coefficient *= prototype.gain;
+		return sos;
+	}
+};
@@ -0,0 +1,349 @@
+#pragma once
+#include <JuceHeader.h>
+#include <vector>
+#include <complex>
+#include <cmath>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <memory>
+#include <algorithm>
+#include "classicFilters.h"
+#include "partitionedConvolution.h"
+
+using std::vector;
+
+// =============================================================================
+// Linear phase filter
+// FIR with the magnitude response of a ClassicFilters biquad and no phase distortion,
+// applied by uniformly partitioned overlap-save convolution. The FIR is designed by a
+// background worker shared by all the filters, and faded in by the convolvers when the settings change.
+// =============================================================================
+
+/// <summary>
+/// Response of the linear phase filter : ClassicFilters type and settings, wet gain as BiquadFilterBank::setFilterGain()
+/// </summary>
+struct LinearPhaseFilterParameters
+{
+	ClassicFilterType filterType = ClassicFilterType::LPF1;
+	double cornerFreq = 1000.0;
+	double qualityFactor = 0.707;
+	double boostCut_dB = 0.0;
+	double wetGain = 1.0;
+
+	bool operator==(const LinearPhaseFilterParameters& other) const
+	{
+		return filterType == other.filterType && cornerFreq == other.cornerFreq && qualityFactor == other.qualityFactor
+			&& boostCut_dB == other.boostCut_dB && wetGain == other.wetGain;
+	}
+
+	bool operator!=(const LinearPhaseFilterParameters& other) const
+	{
+		return !(*this == other);
+	}
+};
+
+class LinearPhaseFilter;
+
+/// <summary>
+/// Background thread designing the FIRs of the linear phase filters, one filter after the other.
+/// Filters are added and removed from the message thread, the audio thread only signals the worker's event :
+/// the worker sleeps on it while no filter has a pending request.
+/// A single worker is shared by all the filters of the process, see getSharedWorker()
+/// </summary>
+class LinearPhaseDesignWorker
+{
+public:
+	LinearPhaseDesignWorker()
+	{
+		thread = std::thread([this] { run(); });
+	}
+
+	~LinearPhaseDesignWorker()
+	{
+		shouldExit.store(true);
+		workAvailable.signal();
+		thread.join();
+	}
+
+	void addFilter(LinearPhaseFilter* filter)
+	{
+		const std::lock_guard<std::mutex> lock(filtersMutex);
+		filters.push_back(filter);
+	}
+
+	/// <summary>
+	/// Removes a filter and waits for a design of it in progress, the filter can then be prepared again or destroyed
+	/// </summary>
+	void removeFilter(LinearPhaseFilter* filter)
+	{
+		{
+			const std::lock_guard<std::mutex> lock(filtersMutex);
+			filters.erase(std::remove(filters.begin(), filters.end(), filter), filters.end());
+		}
+		// filters are picked under both locks, so no design of the filter can start or still run past this one
+		const std::lock_guard<std::mutex> lock(designMutex);
+	}
+
+	/// <summary>
+	/// Audio thread : a request was made, or the spectra were taken. The event stays signalled until the worker wakes up,
+	/// no notification is lost
+	/// </summary>
+	void notify()
+	{
+		workAvailable.signal();
+	}
+
+	/// <summary>
+	/// Process wide worker, created on first use
+	/// </summary>
+	static std::shared_ptr<LinearPhaseDesignWorker> getSharedWorker()
+	{
+		static std::mutex mutex;
+		static std::weak_ptr<LinearPhaseDesignWorker> sharedWorker;
+		const std::lock_guard<std::mutex> lock(mutex);
+		auto worker = sharedWorker.lock();
+		if (worker == nullptr)
+		{
+			worker = std::make_shared<LinearPhaseDesignWorker>();
+			sharedWorker = worker;
+		}
+		return worker;
+	}
+
+private:
+	void run();
+
+	std::thread thread;
+	std::mutex filtersMutex;
+	std::mutex designMutex;				// held while a filter is designed
+	juce::WaitableEvent workAvailable;	// auto reset
+	vector<LinearPhaseFilter*> filters;
+	std::atomic<bool> shouldExit{ false };
+};
+
+/// <summary>
+/// Linear phase version of the ClassicFilters responses, one convolver per channel.
+/// The FIR (1023 taps up to 48 kHz, scaled with the sample rate) is designed by frequency sampling of the biquad magnitude,
+/// zero phase, Blackman windowed. Latency : partitionSize + (numTaps - 1) / 2 samples, see getLatency().
+/// setParameters() and processBlock() are audio thread safe, prepare() allocates and registers the filter to the design worker.
+/// </summary>
+class LinearPhaseFilter
+{
+public:
+	static constexpr unsigned int partitionSize = 64;
+
+	~LinearPhaseFilter()
+	{
+		if (designWorker != nullptr)
+			designWorker->removeFilter(this);
+	}
+
+	/// <summary>
+	/// Designs the initial FIR and prepares the convolvers, clears the channel states
+	/// </summary>
+	void prepare(int pNumChannels, double pSampleRate, const LinearPhaseFilterParameters& pParameters)
+	{
+		if (designWorker != nullptr)
+			designWorker->removeFilter(this);
+		else
+			designWorker = LinearPhaseDesignWorker::getSharedWorker();
+
+		sampleRate = pSampleRate;
+		// 1023 taps up to 48 kHz, the frequency resolution is kept at higher sample rates
+		size_t length = 1024;
+		while ((double)length * 48000.0 < 1024.0 * sampleRate)
+			length *= 2;
+		numTaps = length - 1;
+
+		// frequency grid of 8 points per FIR bin
+		unsigned int order = 1;
+		while ((1u << order) < 8 * length)
+			++order;
+		designFFT.prepare(order);
+		designRe.assign(designFFT.getNumBins(), 0.0f);
+		designIm.assign(designFFT.getNumBins(), 0.0f);
+		impulse.assign(designFFT.getSize(), 0.0f);
+		taps.assign(numTaps, 0.0f);
+
+		designFIR(pParameters);
+		convolvers.resize((size_t)juce::jmax(1, pNumChannels));
+		for (auto& convolver : convolvers)
+			convolver.prepare(partitionSize, taps.data(), taps.size(), true);
+		convolvers[0].computePartitionSpectra(taps.data(), taps.size(), pendingRe, pendingIm);
+
+		requested = designed = lastRequested = pParameters;
+		spectraReady.store(false);
+		designWorker->addFilter(this);
+	}
+
+	/// <summary>
+	/// Clears the channel states, keeps the response
+	/// </summary>
+	void reset()
+	{
+		for (auto& convolver : convolvers)
+			convolver.reset();
+	}
+
+	/// <summary>
+	/// Requests a new response, designed by the background worker. Audio thread safe, unchanged settings cost a comparison
+	/// </summary>
+	void setParameters(const LinearPhaseFilterParameters& pParameters)
+	{
+		if (pParameters == lastRequested)
+			return;
+
+		// the worker holds the lock only to copy the request, a busy lock is retried on the next block
+		std::unique_lock<std::mutex> lock(requestMutex, std::try_to_lock);
+		if (!lock.owns_lock())
+			return;
+		requested = pParameters;
+		lastRequested = pParameters;
+		lock.unlock();
+		if (designWorker != nullptr)
+			designWorker->notify();
+	}
+
+	/// <summary>
+	/// Filters the first channels of the buffer (at most the prepared number of channels) in place
+	/// </summary>
+	void processBlock(juce::AudioBuffer<float>& buffer)
+	{
+		if (spectraReady.load(std::memory_order_acquire))
+		{
+			for (auto& convolver : convolvers)
+				convolver.setPartitionSpectra(pendingRe.data(), pendingIm.data());
+			spectraReady.store(false, std::memory_order_release);
+			// a request made meanwhile waited for the spectra to be taken
+			designWorker->notify();
+		}
+
+		auto channels = juce::jmin((int)convolvers.size(), buffer.getNumChannels());
+		for (int channel = 0; channel < channels; ++channel)
+		{
+			auto* data = buffer.getWritePointer(channel);
+			convolvers[(size_t)channel].process(data, data, buffer.getNumSamples());
+		}
+	}
+
+	/// <summary>
+	/// Latency in samples : the convolver block and the FIR group delay
+	/// </summary>
+	int getLatency() const
+	{
+		return (int)partitionSize + (int)(numTaps - 1) / 2;
+	}
+
+	size_t getNumTaps() const
+	{
+		return numTaps;
+	}
+
+private:
+	friend class LinearPhaseDesignWorker;
+
+	/// <summary>
+	/// Design worker : the latest request, if it is not designed yet and the previous spectra were taken by the audio thread
+	/// </summary>
+	bool getPendingRequest(LinearPhaseFilterParameters& target)
+	{
+		const std::lock_guard<std::mutex> lock(requestMutex);
+		if (requested == designed || spectraReady.load(std::memory_order_acquire))
+			return false;
+		target = requested;
+		return true;
+	}
+
+	/// <summary>
+	/// Design worker : designs the request and hands its spectra to the audio thread
+	/// </summary>
+	void designRequest(const LinearPhaseFilterParameters& target)
+	{
+		designFIR(target);
+		convolvers[0].computePartitionSpectra(taps.data(), taps.size(), pendingRe, pendingIm);
+		{
+			const std::lock_guard<std::mutex> lock(requestMutex);
+			designed = target;
+		}
+		spectraReady.store(true, std::memory_order_release);
+	}
+
+	/// <summary>
+	/// Frequency sampling : biquad magnitude on the design grid, zero phase, inverse transform,
+	/// centred on tap (numTaps - 1) / 2 and Blackman windowed
+	/// </summary>
+	void designFIR(const LinearPhaseFilterParameters& pParameters)
+	{
+		const auto pi = juce::MathConstants<double>::pi;
+		auto gridSize = designFFT.getSize();
+
+		BiquadCoefficients coefficients;
+		coefficients.update(pParameters.filterType, pParameters.cornerFreq, pParameters.qualityFactor, sampleRate, pParameters.boostCut_dB);
+		auto bypass = pParameters.filterType == ClassicFilterType::None;
+		for (size_t k = 0; k < designRe.size(); ++k)
+		{
+			auto z1 = std::polar(1.0, -2.0 * pi * (double)k / gridSize); // z^-1
+			auto numerator = coefficients.aCoeff[0] + z1 * (coefficients.aCoeff[1] + z1 * coefficients.aCoeff[2]);
+			auto denominator = 1.0 + z1 * (coefficients.bCoeff[1] + z1 * coefficients.bCoeff[2]);
+			auto response = pParameters.wetGain * numerator / denominator + (1.0 - pParameters.wetGain);
+			designRe[k] = bypass ? 1.0f : (float)std::abs(response);
+			designIm[k] = 0.0f;
+		}
+		designFFT.performInverse(designRe.data(), designIm.data(), impulse.data());
+
+		auto centre = (numTaps - 1) / 2;
+		for (size_t n = 0; n < numTaps; ++n)
+		{
+			auto phase = 2.0 * pi * (double)n / (double)(numTaps - 1);
+			auto window = 0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase);
+			taps[n] = (float)window * impulse[(n + gridSize - centre) % gridSize];
+		}
+	}
+
+	double sampleRate = 44100.0;
+	size_t numTaps = 1023;
+	vector<UniformPartitionedConvolver> convolvers;
+
+	// design worker
+	RealFFT designFFT;
+	vector<float> designRe, designIm;	// magnitude on the design grid
+	vector<float> impulse;				// zero phase impulse response, grid size
+	vector<float> taps;
+	vector<float> pendingRe, pendingIm;	// partition spectra, handed over when spectraReady
+
+	std::shared_ptr<LinearPhaseDesignWorker> designWorker;
+	std::mutex requestMutex;
+	LinearPhaseFilterParameters requested, designed;	// guarded by requestMutex
+	LinearPhaseFilterParameters lastRequested;			// audio thread
+	std::atomic<bool> spectraReady { false };
+};
+
+/// <summary>
+/// Designs the pending requests, the filters in turn, sleeps on the event when none is left
+/// </summary>
+inline void LinearPhaseDesignWorker::run()
+{
+	while (!shouldExit.load())
+	{
+		bool designed = false;
+		{
+			const std::lock_guard<std::mutex> designLock(designMutex);
+			std::unique_lock<std::mutex> lock(filtersMutex);
+			LinearPhaseFilterParameters target;
+			auto pending = std::find_if(filters.begin(), filters.end(),
+				[&target](LinearPhaseFilter* filter) { return filter->getPendingRequest(target); });
+			if (pending != filters.end())
+			{
+				auto* filter = *pending;
+				// the design runs without the filters lock, removeFilter() waits on the design lock
+				lock.unlock();
+				filter->designRequest(target);
+				designed = true;
+			}
+		}
+		// after a design, looks for the next pending request before sleeping
+		if (!designed)
+			workAvailable.wait();
+	}
+}
@@ -0,0 +1,531 @@
+#pragma once
+#include <JuceHeader.h>
+#include <vector>
+#include <complex>
+#include <cmath>
+
+using std::vector;
+
+// =============================================================================
+// Oversampling
+// 2x, 4x or 8x by cascaded half-band stages, each stage doubling the rate on the way up
+// and halving it on the way down. The stages are polyphase IIR half-bands (two allpass
+// branches, low latency, non linear phase) or linear phase FIR half-bands.
+// Any processor with reset(double sampleRate) and processAudioSample(float) runs at the
+// oversampled rate with OversampledProcessor, other engines with Oversampling::processBlock().
+// =============================================================================
+
+enum class OversamplingFilterType { polyphaseIIR, halfBandFIR };
+
+/// <summary>
+/// Polyphase IIR half-band filter, one channel, one direction : H(z) = (A0(z^2) + z^-1 A1(z^2)) / 2,
+/// A0 and A1 cascades of first order allpass sections. Each branch runs at the low rate.
+/// Coefficients after L. de Soras, HIIR (elliptic half-band, Valenzuela and Constantinides)
+/// </summary>
+class PolyphaseIIRHalfBand
+{
+public:
+	/// <summary>
+	/// Allpass coefficients, alternately of the A0 and A1 branches
+	/// </summary>
+	/// <param name="numCoefficients">filter order = 2 numCoefficients + 1</param>
+	/// <param name="transitionBandwidth">normalized to the high rate, centred on a quarter of it, ]0, 0.5[</param>
+	static vector<double> design(int numCoefficients, double transitionBandwidth)
+	{
+		const auto pi = juce::MathConstants<double>::pi;
+		auto order = 2 * numCoefficients + 1;
+
+		// elliptic modulus of the transition band and its nome
+		auto k = std::tan((1.0 - 2.0 * transitionBandwidth) * pi / 4.0);
+		k *= k;
+		auto kksqrt = std::pow(1.0 - k * k, 0.25);
+		auto e = 0.5 * (1.0 - kksqrt) / (1.0 + kksqrt);
+		auto e4 = e * e * e * e;
+		auto q = e * (1.0 + e4 * (2.0 + e4 * (15.0 + 150.0 * e4)));
+
+		vector<double> coefficients;
+		for (int index = 1; index <= numCoefficients; ++index)
+		{
+			// theta functions series
+			double numerator = 0.0, denominator = 0.0, term;
+			int i = 0;
+			do
+			{
+				term = std::pow(q, (double)(i * (i + 1))) * std::sin((2 * i + 1) * index * pi / order) * (i % 2 == 0 ? 1.0 : -1.0);
+				numerator += term;
+				++i;
+			} while (std::abs(term) > 1.0e-100 && i < 100);
+			i = 1;
+			do
+			{
+				term = std::pow(q, (double)(i * i)) * std::cos(2 * i * index * pi / order) * (i % 2 == 0 ? 1.0 : -1.0);
+				denominator += term;
+				++i;
+			} while (std::abs(term) > 1.0e-100 && i < 100);
+
+			auto ww = numerator * std::pow(q, 0.25) / (denominator + 0.5);
+			auto wwsq = ww * ww;
+			auto x = std::sqrt((1.0 - wwsq * k) * (1.0 - wwsq / k)) / (1.0 + wwsq);
+			coefficients.push_back((1.0 - x) / (1.0 + x));
+		}
+		return coefficients;
+	}
+
+	/// <summary>
+	/// Phase delay of H at low frequencies, in high rate samples
+	/// </summary>
+	static double getPhaseDelay(const vector<double>& coefficients)
+	{
+		const auto omega = 1.0e-3;
+		const std::complex<double> z1 = std::polar(1.0, -2.0 * omega); // z^-2 of the high rate
+		std::complex<double> a0 = 1.0, a1 = 1.0;
+		for (size_t i = 0; i < coefficients.size(); ++i)
+		{
+			auto section = (coefficients[i] + z1) / (1.0 + coefficients[i] * z1);
+			if (i % 2 == 0)
+				a0 *= section;
+			else
+				a1 *= section;
+		}
+		auto response = 0.5 * (a0 + std::polar(1.0, -omega) * a1);
+		return -std::arg(response) / omega;
+	}
+
+	void setCoefficients(const vector<double>& pCoefficients)
+	{
+		coefficients.assign(pCoefficients.begin(), pCoefficients.end());
+		x1.assign(coefficients.size(), 0.0f);
+		y1.assign(coefficients.size(), 0.0f);
+	}
+
+	void reset()
+	{
+		std::fill(x1.begin(), x1.end(), 0.0f);
+		std::fill(y1.begin(), y1.end(), 0.0f);
+	}
+
+	/// <summary>
+	/// numSamples low rate samples in, 2 numSamples out
+	/// </summary>
+	void upsample(const float* input, float* output, int numSamples)
+	{
+		for (int n = 0; n < numSamples; ++n)
+		{
+			output[2 * n] = processBranch(0, input[n]);
+			output[2 * n + 1] = processBranch(1, input[n]);
+		}
+	}
+
+	/// <summary>
+	/// 2 numSamples high rate samples in, numSamples out. input and output may be the same buffer
+	/// </summary>
+	void downsample(const float* input, float* output, int numSamples)
+	{
+		for (int n = 0; n < numSamples; ++n)
+		{
+			auto even = input[2 * n], odd = input[2 * n + 1];
+			output[n] = 0.5f * (processBranch(0, odd) + processBranch(1, even));
+		}
+	}
+
+private:
+	/// <summary>
+	/// Allpass sections of one branch, y(n) = c (x(n) - y(n-1)) + x(n-1) at the low rate
+	/// </summary>
+	float processBranch(size_t branch, float xn)
+	{
+		for (auto i = branch; i < coefficients.size(); i += 2)
+		{
+			auto yn = coefficients[i] * (xn - y1[i]) + x1[i];
+			x1[i] = xn;
+			y1[i] = yn;
+			xn = yn;
+		}
+		return xn;
+	}
+
+	vector<float> coefficients;
+	vector<float> x1, y1;
+};
+
+/// <summary>
+/// Linear phase FIR half-band filter, one channel, one direction. Kaiser windowed sinc, every other tap is zero
+/// but the centre one : the polyphase branch holding the centre is a pure delay, the other one a (numTaps + 1) / 2 taps FIR.
+/// Delay : (numTaps - 1) / 2 high rate samples
+/// </summary>
+class HalfBandFIR
+{
+public:
+	/// <summary>
+	/// Half-band taps, numTaps = 4 m + 3 so that the centre tap sits on an odd index
+	/// </summary>
+	/// <param name="transitionBandwidth">normalized to the high rate, centred on a quarter of it, ]0, 0.5[</param>
+	/// <param name="attenuation_dB">stopband attenuation</param>
+	static vector<float> design(double transitionBandwidth, double attenuation_dB = 90.0)
+	{
+		const auto pi = juce::MathConstants<double>::pi;
+		// Kaiser estimate of the length, rounded up to 4 m + 3
+		auto estimate = (attenuation_dB - 8.0) / (2.285 * 2.0 * pi * transitionBandwidth) + 1.0;
+		auto numTaps = 4 * (int)std::ceil((estimate - 3.0) / 4.0) + 3;
+		numTaps = juce::jmax(7, numTaps);
+		auto beta = attenuation_dB > 50.0 ? 0.1102 * (attenuation_dB - 8.7) : 0.5842 * std::pow(attenuation_dB - 21.0, 0.4) + 0.07886 * (attenuation_dB - 21.0);
+
+		vector<float> taps((size_t)numTaps, 0.0f);
+		auto centre = (numTaps - 1) / 2;
+		for (int n = 0; n < numTaps; ++n)
+		{
+			auto offset = n - centre;
+			if (offset == 0)
+				taps[(size_t)n] = 0.5f;
+			else if (offset % 2 != 0)
+			{
+				auto ratio = (double)offset / centre;
+				auto window = besselI0(beta * std::sqrt(1.0 - ratio * ratio)) / besselI0(beta);
+				taps[(size_t)n] = (float)(std::sin(pi * offset / 2.0) / (pi * offset) * window);
+			}
+		}
+		return taps;
+	}
+
+	/// <summary>
+	/// Keeps the non zero taps of the design() half-band, allocates the history for blocks of up to maxBlockSize low rate samples
+	/// (numSamples of upsample() and downsample())
+	/// </summary>
+	void setTaps(const vector<float>& taps, int maxBlockSize)
+	{
+		numTaps = (int)taps.size();
+		centre = (numTaps - 1) / 2;
+		// the centre index is odd : the even indexes hold the sinc taps
+		branchTaps.clear();
+		for (int n = 0; n < numTaps; n += 2)
+			branchTaps.push_back(taps[(size_t)n]);
+		historyLength = (int)branchTaps.size() - 1;
+		history.assign((size_t)(historyLength + juce::jmax(1, maxBlockSize)), 0.0f);
+		centreHistory.assign((size_t)((centre + 1) / 2 + juce::jmax(1, maxBlockSize)), 0.0f);
+	}
+
+	void reset()
+	{
+		std::fill(history.begin(), history.end(), 0.0f);
+		std::fill(centreHistory.begin(), centreHistory.end(), 0.0f);
+	}
+
+	/// <summary>
+	/// High rate samples of delay, per direction
+	/// </summary>
+	int getDelay() const
+	{
+		return centre;
+	}
+
+	/// <summary>
+	/// numSamples low rate samples in, 2 numSamples out : the even outputs are the sinc branch, the odd ones the delayed input
+	/// </summary>
+	void upsample(const float* input, float* output, int numSamples)
+	{
+		// low rate history : branch taps - 1 previous samples, then the block
+		std::copy(input, input + numSamples, history.begin() + historyLength);
+		auto numBranchTaps = (int)branchTaps.size();
+		auto centreDelay = (centre - 1) / 2; // low rate samples
+		for (int n = 0; n < numSamples; ++n)
+		{
+			auto* x = history.data() + n + historyLength;
+			float sum = 0.0f;
+			for (int p = 0; p < numBranchTaps; ++p)
+				sum += branchTaps[(size_t)p] * x[-p];
+			output[2 * n] = 2.0f * sum;
+			output[2 * n + 1] = x[-centreDelay];
+		}
+		std::copy(history.begin() + numSamples, history.begin() + numSamples + historyLength, history.begin());
+	}
+
+	/// <summary>
+	/// 2 numSamples high rate samples in, numSamples out. input and output may be the same buffer
+	/// </summary>
+	void downsample(const float* input, float* output, int numSamples)
+	{
+		// y(n) = 0.5 x(2n - centre) + sum of the sinc taps over the even samples
+		auto numBranchTaps = (int)branchTaps.size();
+		auto centreDelay = (centre + 1) / 2; // the centre tap reads the odd samples x(2m + 1), m = n - centreDelay
+		for (int n = 0; n < numSamples; ++n)
+		{
+			history[(size_t)(historyLength + n)] = input[2 * n];
+			centreHistory[(size_t)(centreDelay + n)] = input[2 * n + 1];
+		}
+		for (int n = 0; n < numSamples; ++n)
+		{
+			auto* x = history.data() + n + historyLength;
+			float sum = 0.0f;
+			for (int p = 0; p < numBranchTaps; ++p)
+				sum += branchTaps[(size_t)p] * x[-p];
+			output[n] = sum + 0.5f * centreHistory[(size_t)n];
+		}
+		std::copy(history.begin() + numSamples, history.begin() + numSamples + historyLength, history.begin());
+		std::copy(centreHistory.begin() + numSamples, centreHistory.begin() + numSamples + centreDelay, centreHistory.begin());
+	}
+
+private:
+	static double besselI0(double x)
+	{
+		double sum = 1.0, term = 1.0;
+		for (int k = 1; k < 50 && term > 1.0e-12 * sum; ++k)
+		{
+			term *= (x / (2.0 * k)) * (x / (2.0 * k));
+			sum += term;
+		}
+		return sum;
+	}
+
+	int numTaps = 0;
+	int centre = 0;
+	vector<float> branchTaps;		// taps 0, 2, 4 ... (centre excluded)
+	int historyLength = 0;
+	vector<float> history;			// low rate samples of the sinc branch
+	vector<float> centreHistory;	// delay line of the centre tap (downsampling)
+};
+
+/// <summary>
+/// Multichannel oversampling by 2, 4 or 8, one half-band stage per factor of 2 and per direction.
+/// The first stage has the narrow transition band (passband up to 0.45 fs), the next ones only reject images
+/// of the already band limited signal. prepare() allocates, processBlock() does not.
+/// </summary>
+class Oversampling
+{
+public:
+	/// <summary>
+	/// Allocates the stages and the oversampled buffers, clears the states
+	/// </summary>
+	/// <param name="factor">1, 2, 4 or 8 (rounded down to a power of 2)</param>
+	void prepare(int pNumChannels, int pMaxBlockSize, int factor, OversamplingFilterType pFilterType)
+	{
+		numChannels = juce::jmax(1, pNumChannels);
+		maxBlockSize = juce::jmax(1, pMaxBlockSize);
+		filterType = pFilterType;
+		numStages = 0;
+		while (numStages < 3 && (2 << numStages) <= factor)
+			++numStages;
+
+		iirUp.clear(); iirDown.clear();
+		firUp.clear(); firDown.clear();
+		stageBuffers.clear();
+		latency = 0.0;
+		for (int stage = 0; stage < numStages; ++stage)
+		{
+			auto transitionBandwidth = stage == 0 ? firstStageTransition : nextStagesTransition;
+			auto stageRate = (double)(2 << stage); // high rate of the stage, in base sample rates
+			auto lowRateBlock = maxBlockSize << stage;
+			if (filterType == OversamplingFilterType::polyphaseIIR)
+			{
+				auto coefficients = PolyphaseIIRHalfBand::design(stage == 0 ? firstStageIIRCoefficients : nextStagesIIRCoefficients, transitionBandwidth);
+				iirUp.emplace_back((size_t)numChannels);
+				iirDown.emplace_back((size_t)numChannels);
+				for (int channel = 0; channel < numChannels; ++channel)
+				{
+					iirUp.back()[(size_t)channel].setCoefficients(coefficients);
+					iirDown.back()[(size_t)channel].setCoefficients(coefficients);
+				}
+				// downsample() keeps the odd outputs of H : one high rate sample less than twice its delay
+				latency += (2.0 * PolyphaseIIRHalfBand::getPhaseDelay(coefficients) - 1.0) / stageRate;
+			}
+			else
+			{
+				auto taps = HalfBandFIR::design(transitionBandwidth);
+				firUp.emplace_back((size_t)numChannels);
+				firDown.emplace_back((size_t)numChannels);
+				for (int channel = 0; channel < numChannels; ++channel)
+				{
+					firUp.back()[(size_t)channel].setTaps(taps, lowRateBlock);
+					firDown.back()[(size_t)channel].setTaps(taps, lowRateBlock);
+				}
+				latency += 2.0 * firUp.back()[0].getDelay() / stageRate;
+			}
+			stageBuffers.emplace_back((size_t)numChannels * (size_t)(2 * lowRateBlock), 0.0f);
+		}
+		channelPointers.assign((size_t)numChannels, nullptr);
+	}
+
+	/// <summary>
+	/// Clears the filter states
+	/// </summary>
+	void reset()
+	{
+		for (auto* stages : { &iirUp, &iirDown })
+			for (auto& stage : *stages)
+				for (auto& filter : stage)
+					filter.reset();
+		for (auto* stages : { &firUp, &firDown })
+			for (auto& stage : *stages)
+				for (auto& filter : stage)
+					filter.reset();
+	}
+
+	int getFactor() const
+	{
+		return 1 << numStages;
+	}
+
+	/// <summary>
+	/// Latency of the up and down stages, in base rate samples. Exact for the FIR stages (fractional beyond 2x),
+	/// phase delay at low frequencies for the IIR ones
+	/// </summary>
+	double getLatency() const
+	{
+		return latency;
+	}
+
+	/// <summary>
+	/// Rounded latency, for AudioProcessor::setLatencySamples()
+	/// </summary>
+	int getLatencyInSamples() const
+	{
+		return (int)std::lround(latency);
+	}
+
+	/// <summary>
+	/// Upsamples the first channels of the buffer, calls processOversampled(float* const* channels, int numChannels, int numSamples)
+	/// on the oversampled block, and downsamples it back into the buffer
+	/// </summary>
+	template <typename Function>
+	void processBlock(juce::AudioBuffer<float>& buffer, Function&& processOversampled)
+	{
+		auto channels = juce::jmin(numChannels, buffer.getNumChannels());
+		for (int start = 0; start < buffer.getNumSamples(); start += maxBlockSize)
+		{
+			auto numSamples = juce::jmin(maxBlockSize, buffer.getNumSamples() - start);
+			for (int channel = 0; channel < channels; ++channel)
+				channelPointers[(size_t)channel] = buffer.getWritePointer(channel) + start;
+			if (numStages == 0)
+			{
+				processOversampled(channelPointers.data(), channels, numSamples);
+				continue;
+			}
+
+			for (int channel = 0; channel < channels; ++channel)
+			{
+				const float* input = channelPointers[(size_t)channel];
+				for (int stage = 0; stage < numStages; ++stage)
+				{
+					auto lowRateSamples = numSamples << stage;
+					auto* output = getStageChannel(stage, channel);
+					if (filterType == OversamplingFilterType::polyphaseIIR)
+						iirUp[(size_t)stage][(size_t)channel].upsample(input, output, lowRateSamples);
+					else
+						firUp[(size_t)stage][(size_t)channel].upsample(input, output, lowRateSamples);
+					input = output;
+				}
+			}
+
+			for (int channel = 0; channel < channels; ++channel)
+				channelPointers[(size_t)channel] = getStageChannel(numStages - 1, channel);
+			processOversampled(channelPointers.data(), channels, numSamples << numStages);
+
+			for (int channel = 0; channel < channels; ++channel)
+			{
+				for (int stage = numStages - 1; stage >= 0; --stage)
+				{
+					auto lowRateSamples = numSamples << stage;
+					auto* input = getStageChannel(stage, channel);
+					auto* output = stage > 0 ? getStageChannel(stage - 1, channel) : buffer.getWritePointer(channel) + start;
+					if (filterType == OversamplingFilterType::polyphaseIIR)
+						iirDown[(size_t)stage][(size_t)channel].downsample(input, output, lowRateSamples);
+					else
+						firDown[(size_t)stage][(size_t)channel].downsample(input, output, lowRateSamples);
+				}
+			}
+		}
+	}
+
+private:
+	float* getStageChannel(int stage, int channel)
+	{
+		auto& stageBuffer = stageBuffers[(size_t)stage];
+		return stageBuffer.data() + (size_t)channel * (stageBuffer.size() / (size_t)numChannels);
+	}
+
+	// stage 0 : passband up to 0.45 fs. Next stages : images of the band limited signal only
+	static constexpr double firstStageTransition = 0.05;
+	static constexpr double nextStagesTransition = 0.25;
+	static constexpr int firstStageIIRCoefficients = 12;
+	static constexpr int nextStagesIIRCoefficients = 4;
+
+	int numChannels = 1;
+	int maxBlockSize = 512;
+	int numStages = 0;
+	OversamplingFilterType filterType = OversamplingFilterType::polyphaseIIR;
+	double latency = 0.0;
+
+	vector<vector<PolyphaseIIRHalfBand>> iirUp, iirDown;	// [stage][channel]
+	vector<vector<HalfBandFIR>> firUp, firDown;
+	vector<vector<float>> stageBuffers;						// high rate samples of each stage, channel after channel
+	vector<float*> channelPointers;
+};
+
+/// <summary>
+/// Runs one Processor per channel at the oversampled rate. Processor : reset(double sampleRate), processAudioSample(float),
+/// reset() is called with the oversampled rate, by prepare() and reset(). Parameters are set on getProcessor(channel)
+/// </summary>
+template <typename Processor>
+class OversampledProcessor
+{
+public:
+	void prepare(int numChannels, double sampleRate, int maxBlockSize, int factor, OversamplingFilterType filterType)
+	{
+		oversampling.prepare(numChannels, maxBlockSize, factor, filterType);
+		oversampledRate = sampleRate * oversampling.getFactor();
+		processors.resize((size_t)juce::jmax(1, numChannels));
+		for (auto& processor : processors)
+			processor.reset(oversampledRate);
+	}
+
+	/// <summary>
+	/// Clears the oversampling filters and the processors' states
+	/// </summary>
+	void reset()
+	{
+		oversampling.reset();
+		for (auto& processor : processors)
+			processor.reset(oversampledRate);
+	}
+
+	Processor& getProcessor(int channel)
+	{
+		return processors[(size_t)channel];
+	}
+
+	int getNumChannels() const
+	{
+		return (int)processors.size();
+	}
+
+	/// <summary>
+	/// Processes the first channels of the buffer in place
+	/// </summary>
+	void processBlock(juce::AudioBuffer<float>& buffer)
+	{
+		oversampling.processBlock(buffer, [this](float* const* channels, int numChannels, int numSamples)
+			{
+				for (int channel = 0; channel < numChannels; ++channel)
+				{
+					auto& processor = processors[(size_t)channel];
+					auto* data = channels[channel];
+					for (int sample = 0; sample < numSamples; ++sample)
+						data[sample] = (float)processor.processAudioSample(data[sample]);
+				}
+			});
+	}
+
+	const Oversampling& getOversampling() const
+	{
+		return oversampling;
+	}
+
+	int getLatencyInSamples() const
+	{
+		return oversampling.getLatencyInSamples();
+	}
+
+private:
+	Oversampling oversampling;
+	vector<Processor> processors;
+	double oversampledRate = 44100.0;
+};
@@ -0,0 +1,985 @@
+#pragma once
+#include <JuceHeader.h>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <cstdint>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include "fft.h"
+
+using std::vector;
+
+// =============================================================================
+// Partitioned convolution
+// Uniformly partitioned overlap-save convolution, with a frequency-domain delay line,
+// and a zero latency non-uniform scheme whose long partitions run on worker threads
+// =============================================================================
+
+/// <summary>
+/// Complex multiply accumulate on split arrays : acc += a * b.
+/// The arrays do not alias, so the loop vectorises (SSE / AVX / NEON)
+/// </summary>
+inline void complexMultiplyAccumulate(float* __restrict accRe, float* __restrict accIm,
+	const float* __restrict aRe, const float* __restrict aIm,
+	const float* __restrict bRe, const float* __restrict bIm, size_t numBins)
+{
+	for (size_t k = 0; k < numBins; ++k)
+	{
+		accRe[k] += aRe[k] * bRe[k] - aIm[k] * bIm[k];
+		accIm[k] += aRe[k] * bIm[k] + aIm[k] * bRe[k];
+	}
+}
+
+/// <summary>
+/// Mono uniformly partitioned convolver (overlap-save).
+/// The impulse response is cut into P partitions of B samples, each transformed with a 2B points FFT.
+/// Every B input samples, the input spectrum is pushed into a frequency-domain delay line (FDL)
+/// and the output spectrum is the sum over p of FDL[p] * H[p] : one FFT, one inverse FFT and P complex MACs per block.
+/// The latency is B samples. prepare() allocates, process() does not.
+/// </summary>
+class UniformPartitionedConvolver
+{
+public:
+	/// <summary>
+	/// Partitions and transforms the impulse response
+	/// </summary>
+	/// <param name="pPartitionSize">B, a power of 2</param>
+	/// <param name="ir">impulse response</param>
+	/// <param name="irLength">impulse response length</param>
+	/// <param name="allowSpectraUpdates">allocates the crossfade spectra used by setPartitionSpectra()</param>
+	void prepare(unsigned int pPartitionSize, const float* ir, size_t irLength, bool allowSpectraUpdates = false)
+	{
+		partitionSize = pPartitionSize;
+		fft.prepare(getOrder(2 * partitionSize));
+		numBins = fft.getNumBins();
+		numPartitions = juce::jmax((size_t)1, (irLength + partitionSize - 1) / partitionSize);
+		computePartitionSpectra(ir, irLength, irRe, irIm);
+
+		previousIrRe.assign(allowSpectraUpdates ? irRe.size() : 0, 0.0f);
+		previousIrIm.assign(allowSpectraUpdates ? irIm.size() : 0, 0.0f);
+		crossfadePending = false;
+
+		fdlRe.assign(numPartitions * numBins, 0.0f);
+		fdlIm.assign(numPartitions * numBins, 0.0f);
+		inputBuffer.assign(2 * partitionSize, 0.0f);
+		outputBuffer.assign(partitionSize, 0.0f);
+		timeBuffer.assign(2 * partitionSize, 0.0f);
+		accRe.assign(numBins, 0.0f);
+		accIm.assign(numBins, 0.0f);
+		reset();
+	}
+
+	/// <summary>
+	/// Partition spectra of an impulse response, for setPartitionSpectra(). Allocates, does not touch the convolver state :
+	/// can run on another thread while process() runs. The response is truncated to the prepared number of partitions
+	/// </summary>
+	void computePartitionSpectra(const float* ir, size_t irLength, vector<float>& re, vector<float>& im) const
+	{
+		re.assign(numPartitions * numBins, 0.0f);
+		im.assign(numPartitions * numBins, 0.0f);
+		vector<float> padded(2 * partitionSize);
+		for (size_t p = 0; p < numPartitions; ++p)
+		{
+			// zero padded to 2B
+			std::fill(padded.begin(), padded.end(), 0.0f);
+			auto start = p * partitionSize;
+			auto count = juce::jmin((size_t)partitionSize, irLength - juce::jmin(irLength, start));
+			std::copy(ir + start, ir + start + count, padded.begin());
+			fft.performForward(padded.data(), &re[p * numBins], &im[p * numBins]);
+		}
+	}
+
+	/// <summary>
+	/// Replaces the impulse response by the spectra of computePartitionSpectra(), without allocation and keeping the input history.
+	/// The next partition crossfades from the previous response to the new one. Requires prepare(..., true)
+	/// </summary>
+	void setPartitionSpectra(const float* re, const float* im)
+	{
+		jassert(previousIrRe.size() == irRe.size());
+		// a response replaced before it was heard is not faded from
+		if (!crossfadePending)
+		{
+			std::copy(irRe.begin(), irRe.end(), previousIrRe.begin());
+			std::copy(irIm.begin(), irIm.end(), previousIrIm.begin());
+		}
+		std::copy(re, re + irRe.size(), irRe.begin());
+		std::copy(im, im + irIm.size(), irIm.begin());
+		crossfadePending = true;
+	}
+
+	/// <summary>
+	/// Clears the delay line and the buffers, keeps the impulse response
+	/// </summary>
+	void reset()
+	{
+		std::fill(fdlRe.begin(), fdlRe.end(), 0.0f);
+		std::fill(fdlIm.begin(), fdlIm.end(), 0.0f);
+		std::fill(inputBuffer.begin(), inputBuffer.end(), 0.0f);
+		std::fill(outputBuffer.begin(), outputBuffer.end(), 0.0f);
+		fdlIndex = 0;
+		fifoPosition = 0;
+	}
+
+	/// <summary>
+	/// Processes a block of any size, input and output may be the same buffer
+	/// </summary>
+	void process(const float* input, float* output, int numSamples)
+	{
+		int n = 0;
+		while (n < numSamples)
+		{
+			auto count = juce::jmin(numSamples - n, (int)(partitionSize - fifoPosition));
+			std::copy(input + n, input + n + count, inputBuffer.begin() + partitionSize + fifoPosition);
+			std::copy(outputBuffer.begin() + fifoPosition, outputBuffer.begin() + fifoPosition + count, output + n);
+			fifoPosition += count;
+			n += count;
+
+			if (fifoPosition == partitionSize)
+			{
+				processPartition();
+				fifoPosition = 0;
+			}
+		}
+	}
+
+	/// <summary>
+	/// Processes one sample
+	/// </summary>
+	float processAudioSample(float xn)
+	{
+		float yn;
+		process(&xn, &yn, 1);
+		return yn;
+	}
+
+	/// <summary>
+	/// Processes exactly B samples without the FIFO : the output is the convolution of the block just passed in.
+	/// Used by the non-uniform convolver, which schedules the blocks itself
+	/// </summary>
+	void processPartition(const float* input, float* output)
+	{
+		std::copy(input, input + partitionSize, inputBuffer.begin() + partitionSize);
+		processPartition();
+		std::copy(outputBuffer.begin(), outputBuffer.end(), output);
+	}
+
+	int getLatency() const
+	{
+		return (int)partitionSize;
+	}
+
+	unsigned int getPartitionSize() const
+	{
+		return partitionSize;
+	}
+
+	size_t getNumPartitions() const
+	{
+		return numPartitions;
+	}
+
+private:
+	static unsigned int getOrder(unsigned int size)
+	{
+		unsigned int order = 1;
+		while ((1u << order) < size)
+			++order;
+		return order;
+	}
+
+	/// <summary>
+	/// Runs once every B samples : input spectrum into the FDL, MACs, inverse transform
+	/// </summary>
+	void processPartition()
+	{
+		// the newest input spectrum goes in the FDL slot fdlIndex
+		fft.performForward(inputBuffer.data(), &fdlRe[fdlIndex * numBins], &fdlIm[fdlIndex * numBins]);
+
+		if (crossfadePending)
+		{
+			// output of the previous response, faded out over the partition while the new one fades in
+			convolve(previousIrRe.data(), previousIrIm.data());
+			std::copy(timeBuffer.begin() + partitionSize, timeBuffer.end(), outputBuffer.begin());
+			convolve(irRe.data(), irIm.data());
+			for (unsigned int n = 0; n < partitionSize; ++n)
+			{
+				auto fade = (float)(n + 1) / (float)partitionSize;
+				outputBuffer[n] += fade * (timeBuffer[partitionSize + n] - outputBuffer[n]);
+			}
+			crossfadePending = false;
+		}
+		else
+		{
+			convolve(irRe.data(), irIm.data());
+			// overlap-save : the last B samples of the inverse transform are valid
+			std::copy(timeBuffer.begin() + partitionSize, timeBuffer.end(), outputBuffer.begin());
+		}
+
+		// slide the input window
+		std::copy(inputBuffer.begin() + partitionSize, inputBuffer.end(), inputBuffer.begin());
+		fdlIndex = (fdlIndex + 1) % numPartitions;
+	}
+
+	/// <summary>
+	/// Sum of FDL[p] * H[p], FDL[p] being the input spectrum p blocks ago, inverse transformed into timeBuffer
+	/// </summary>
+	void convolve(const float* hRe, const float* hIm)
+	{
+		std::fill(accRe.begin(), accRe.end(), 0.0f);
+		std::fill(accIm.begin(), accIm.end(), 0.0f);
+		for (size_t p = 0; p < numPartitions; ++p)
+		{
+			auto slot = (fdlIndex + numPartitions - p) % numPartitions;
+			complexMultiplyAccumulate(accRe.data(), accIm.data(),
+				&fdlRe[slot * numBins], &fdlIm[slot * numBins],
+				hRe + p * numBins, hIm + p * numBins, numBins);
+		}
+		fft.performInverse(accRe.data(), accIm.data(), timeBuffer.data());
+	}
+
+	RealFFT fft;
+	unsigned int partitionSize = 512;
+	size_t numBins = 0;
+	size_t numPartitions = 0;
+
+	vector<float> irRe, irIm;		// P partition spectra
+	vector<float> previousIrRe, previousIrIm;	// faded out by the next partition, see setPartitionSpectra()
+	bool crossfadePending = false;
+	vector<float> fdlRe, fdlIm;		// P input spectra, circular
+	size_t fdlIndex = 0;
+
+	vector<float> inputBuffer;		// 2B : previous block and current block
+	vector<float> outputBuffer;		// B output samples of the last processed block
+	vector<float> timeBuffer;		// 2B
+	vector<float> accRe, accIm;		// output spectrum
+	unsigned int fifoPosition = 0;
+};
+
+class ConvolutionWorkerPool;
+
+/// <summary>
+/// One stage of the non-uniform convolver, computed away from the audio thread.
+/// The stage convolves the input with the IR segment starting at offset O, with partitions of B samples, O >= 2B :
+/// the block j of input is complete at (j + 1)B and its output is only needed at jB + O, which leaves at least B samples
+/// to a worker thread to compute it. Input and output blocks are kept in rings of slots, the audio thread publishes the
+/// complete input blocks (and their deadlines), the workers publish the computed output blocks. If a block is still
+/// missing at its deadline and no worker has started it (no worker, or workers late), the audio thread computes it
+/// itself. The audio thread never waits : a block a worker is still computing at its deadline is left out of the output,
+/// except when rendering offline (setNonRealtime()), where the output must be exact whatever the processing speed.
+/// </summary>
+class BackgroundConvolutionStage
+{
+public:
+	/// <summary>
+	/// Partitions the IR segment, allocates the rings
+	/// </summary>
+	/// <param name="pPartitionSize">B, a power of 2</param>
+	/// <param name="pOffset">O, position of the segment in the IR, at least 2B</param>
+	/// <param name="irSegment">the IR, from the offset</param>
+	/// <param name="segmentLength">segment length</param>
+	/// <param name="sampleRate">used to convert the deadlines to time</param>
+	void prepare(unsigned int pPartitionSize, size_t pOffset, const float* irSegment, size_t segmentLength, double sampleRate)
+	{
+		jassert(pOffset >= 2 * (size_t)pPartitionSize);
+		partitionSize = pPartitionSize;
+		offset = pOffset;
+		convolver.prepare(partitionSize, irSegment, segmentLength);
+
+		// blocks alive at once : the one being read, the ones waiting for the worker, the one being filled
+		numSlots = offset / partitionSize + 3;
+		inputSlots.assign(numSlots * partitionSize, 0.0f);
+		outputSlots.assign(numSlots * partitionSize, 0.0f);
+		deadlines.reset(new std::atomic<double>[numSlots]);
+		for (size_t slot = 0; slot < numSlots; ++slot)
+			deadlines[slot].store(0.0, std::memory_order_relaxed);
+		slack_s = (double)(offset - partitionSize) / sampleRate;
+		reset();
+	}
+
+	/// <summary>
+	/// Offline rendering : the audio thread waits for the blocks the workers are computing instead of leaving them out.
+	/// Not to be called while the stage is processed
+	/// </summary>
+	void setNonRealtime(bool pNonRealtime)
+	{
+		nonRealtime = pNonRealtime;
+	}
+
+	/// <summary>
+	/// Clears the stage, not to be called while the stage is processed
+	/// </summary>
+	void reset()
+	{
+		convolver.reset();
+		std::fill(outputSlots.begin(), outputSlots.end(), 0.0f);
+		inputTime = 0;
+		outputTime = 0;
+		publishedBlocks.store(0);
+		completedBlocks.store(0);
+		lateBlocks.store(0);
+	}
+
+	/// <summary>
+	/// Audio thread : writes the input, publishes every complete block
+	/// </summary>
+	/// <returns> true if a block was published </returns>
+	bool pushInput(const float* input, int numSamples)
+	{
+		bool published = false;
+		int n = 0;
+		while (n < numSamples)
+		{
+			auto block = inputTime / partitionSize;
+			auto position = (unsigned int)(inputTime % partitionSize);
+			auto count = juce::jmin(numSamples - n, (int)(partitionSize - position));
+			std::copy(input + n, input + n + count, &inputSlots[(block % numSlots) * partitionSize + position]);
+			inputTime += (uint64_t)count;
+			n += count;
+
+			if (position + count == partitionSize)
+			{
+				deadlines[block % numSlots].store(getTime() + slack_s, std::memory_order_relaxed);
+				// publishes the input block and its deadline
+				publishedBlocks.store(block + 1, std::memory_order_release);
+				published = true;
+			}
+		}
+		return published;
+	}
+
+	/// <summary>
+	/// Audio thread : adds the stage output to the buffer, computes the blocks not ready yet if no worker is on them.
+	/// A block a worker is still computing is left out, the audio thread does not wait for it
+	/// </summary>
+	void addOutput(float* output, int numSamples)
+	{
+		int n = 0;
+		while (n < numSamples)
+		{
+			if (outputTime < offset)
+			{
+				// the segment has not started yet
+				auto count = (int)juce::jmin((uint64_t)(numSamples - n), (uint64_t)offset - outputTime);
+				outputTime += (uint64_t)count;
+				n += count;
+				continue;
+			}
+
+			auto block = (outputTime - offset) / partitionSize;
+			auto position = (unsigned int)((outputTime - offset) % partitionSize);
+			auto count = juce::jmin(numSamples - n, (int)(partitionSize - position));
+			if (isBlockReady(block))
+			{
+				auto slot = &outputSlots[(block % numSlots) * partitionSize + position];
+				for (int i = 0; i < count; ++i)
+					output[n + i] += slot[i];
+			}
+			else
+				lateBlocks.fetch_add(1, std::memory_order_relaxed);
+			outputTime += (uint64_t)count;
+			n += count;
+		}
+	}
+
+	/// <summary>
+	/// Worker thread : claims the stage if it has blocks to compute
+	/// </summary>
+	/// <returns> true if the stage was claimed, runClaimed() must follow </returns>
+	bool tryClaim()
+	{
+		return hasPendingWork() && !busy.exchange(true, std::memory_order_acquire);
+	}
+
+	/// <summary>
+	/// Worker thread : computes the published blocks, then releases the stage
+	/// </summary>
+	void runClaimed()
+	{
+		runPendingBlocks();
+		busy.store(false, std::memory_order_release);
+	}
+
+	bool hasPendingWork() const
+	{
+		return completedBlocks.load(std::memory_order_relaxed) < publishedBlocks.load(std::memory_order_acquire);
+	}
+
+	bool isBusy() const
+	{
+		return busy.load(std::memory_order_acquire);
+	}
+
+	/// <summary>
+	/// Time (s) at which the next block to compute is needed by the audio thread, when hasPendingWork()
+	/// </summary>
+	double getDeadline() const
+	{
+		return deadlines[completedBlocks.load(std::memory_order_relaxed) % numSlots].load(std::memory_order_relaxed);
+	}
+
+	/// <summary>
+	/// Output chunks left out because their block was still being computed at its deadline, since prepare()
+	/// </summary>
+	uint64_t getNumLateBlocks() const
+	{
+		return lateBlocks.load(std::memory_order_relaxed);
+	}
+
+	static double getTime()
+	{
+		return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+private:
+	/// <summary>
+	/// Blocks are computed in order, by whoever holds the busy flag
+	/// </summary>
+	void runPendingBlocks()
+	{
+		auto block = completedBlocks.load(std::memory_order_relaxed);
+		while (block < publishedBlocks.load(std::memory_order_acquire))
+		{
+			auto slot = (block % numSlots) * partitionSize;
+			convolver.processPartition(&inputSlots[slot], &outputSlots[slot]);
+			completedBlocks.store(++block, std::memory_order_release);
+		}
+	}
+
+	/// <summary>
+	/// Output block deadline : computes the block on the audio thread if no worker has started it.
+	/// Returns false if a worker is still computing it, waits for the worker when rendering offline
+	/// </summary>
+	bool isBlockReady(uint64_t block)
+	{
+		while (completedBlocks.load(std::memory_order_acquire) <= block)
+		{
+			if (!busy.exchange(true, std::memory_order_acquire))
+				runClaimed();
+			else if (!nonRealtime)
+				return false;
+			else
+				std::this_thread::yield();
+		}
+		return true;
+	}
+
+	UniformPartitionedConvolver convolver;
+	unsigned int partitionSize = 1024;
+	size_t offset = 2048;
+	size_t numSlots = 0;
+	double slack_s = 0.0;
+	bool nonRealtime = false;
+
+	vector<float> inputSlots, outputSlots;	// numSlots blocks of B samples
+	std::unique_ptr<std::atomic<double>[]> deadlines;	// per input slot, published with publishedBlocks
+	uint64_t inputTime = 0, outputTime = 0;	// audio thread clocks, in samples
+
+	std::atomic<uint64_t> publishedBlocks{ 0 };
+	std::atomic<uint64_t> completedBlocks{ 0 };
+	std::atomic<uint64_t> lateBlocks{ 0 };
+	std::atomic<bool> busy{ false };
+};
+
+/// <summary>
+/// Worker threads computing the background convolution stages, earliest deadline first.
+/// Stages are added and removed from the message thread, the audio thread only signals the workers' event.
+/// The workers sleep on the event while no stage has published blocks.
+/// A single pool is shared by all the convolvers of the process, see getSharedPool()
+/// </summary>
+class ConvolutionWorkerPool
+{
+public:
+	explicit ConvolutionWorkerPool(int numThreads)
+	{
+		for (int i = 0; i < juce::jmax(1, numThreads); ++i)
+			threads.emplace_back([this] { run(); });
+	}
+
+	~ConvolutionWorkerPool()
+	{
+		// each worker passes the signal on as it exits
+		shouldExit.store(true);
+		workAvailable.signal();
+		for (auto& thread : threads)
+			thread.join();
+	}
+
+	void addStage(BackgroundConvolutionStage* stage)
+	{
+		const std::lock_guard<std::mutex> lock(stagesMutex);
+		stages.push_back(stage);
+	}
+
+	/// <summary>
+	/// Removes a stage and waits for a worker still computing it, the stage can then be destroyed
+	/// </summary>
+	void removeStage(BackgroundConvolutionStage* stage)
+	{
+		{
+			const std::lock_guard<std::mutex> lock(stagesMutex);
+			stages.erase(std::remove(stages.begin(), stages.end(), stage), stages.end());
+		}
+		// claims are only made under the lock, so no worker can pick the stage up from here
+		while (stage->isBusy())
+			std::this_thread::yield();
+	}
+
+	/// <summary>
+	/// Audio thread : a block was published. The event stays signalled until a worker wakes up, no notification is lost
+	/// </summary>
+	void notify()
+	{
+		workAvailable.signal();
+	}
+
+	/// <summary>
+	/// Process wide pool, created on first use with half of the cores
+	/// </summary>
+	static std::shared_ptr<ConvolutionWorkerPool> getSharedPool()
+	{
+		static std::mutex mutex;
+		static std::weak_ptr<ConvolutionWorkerPool> sharedPool;
+		const std::lock_guard<std::mutex> lock(mutex);
+		auto pool = sharedPool.lock();
+		if (pool == nullptr)
+		{
+			pool = std::make_shared<ConvolutionWorkerPool>(juce::jmax(1, (int)std::thread::hardware_concurrency() / 2));
+			sharedPool = pool;
+		}
+		return pool;
+	}
+
+private:
+	void run()
+	{
+		while (!shouldExit.load())
+		{
+			BackgroundConvolutionStage* claimed = nullptr;
+			bool morePendingWork = false;
+			{
+				const std::lock_guard<std::mutex> lock(stagesMutex);
+				// earliest deadline first among the stages with published blocks
+				BackgroundConvolutionStage* next = nullptr;
+				for (auto* stage : stages)
+					if (stage->hasPendingWork() && !stage->isBusy() && (next == nullptr || stage->getDeadline() < next->getDeadline()))
+						next = stage;
+
+				if (next != nullptr && next->tryClaim())
+				{
+					claimed = next;
+					for (auto* stage : stages)
+						morePendingWork |= stage != claimed && stage->hasPendingWork() && !stage->isBusy();
+				}
+			}
+
+			if (claimed == nullptr)
+			{
+				// nothing to do, or the audio thread took the stage over : sleep until the next published block
+				workAvailable.wait();
+				continue;
+			}
+
+			// the event wakes a single worker, the other stages go to the next one
+			if (morePendingWork)
+				workAvailable.signal();
+			claimed->runClaimed();
+		}
+		workAvailable.signal();
+	}
+
+	std::vector<std::thread> threads;
+	std::mutex stagesMutex;
+	juce::WaitableEvent workAvailable;	// auto reset : wakes one worker per signal
+	vector<BackgroundConvolutionStage*> stages;
+	std::atomic<bool> shouldExit{ false };
+};
+
+/// <summary>
+/// Mono zero latency convolver, non-uniformly partitioned (Gardner) :
+/// - the first H samples of the IR are a direct form FIR, computed sample by sample
+/// - the segment [H, 8H) is a uniform convolver with B = H on the audio thread, its latency H is the segment offset
+/// - the rest of the IR is cut into background stages of growing partitions (4x each time, up to maxPartitionSize),
+///   stage k starting at offset 2Bk, computed by the worker pool.
+/// With H = 128 and 8192 samples partitions a 10 s IR costs the audio thread a 128 taps FIR and a few 256 points FFTs,
+/// whatever the host block size.
+/// </summary>
+class NonUniformPartitionedConvolver
+{
+public:
+	~NonUniformPartitionedConvolver()
+	{
+		releaseStages();
+	}
+
+	/// <summary>
+	/// Partitions the impulse response, registers the background stages to the pool. Not to be called while processing
+	/// </summary>
+	/// <param name="ir">impulse response</param>
+	/// <param name="irLength">impulse response length</param>
+	/// <param name="pHeadSize">H, direct form FIR length, a power of 2</param>
+	/// <param name="maxPartitionSize">largest background partition, a power of 2</param>
+	/// <param name="sampleRate"></param>
+	/// <param name="pool">worker pool, if nullptr the background stages are computed on the audio thread, at their deadline</param>
+	/// <param name="nonRealtime">offline rendering, see BackgroundConvolutionStage::setNonRealtime()</param>
+	void prepare(const float* ir, size_t irLength, unsigned int pHeadSize, unsigned int maxPartitionSize, double sampleRate,
+		std::shared_ptr<ConvolutionWorkerPool> pool, bool nonRealtime = false)
+	{
+		releaseStages();
+		headSize = pHeadSize;
+		workerPool = pool;
+
+		// direct form head, reversed so that the dot product runs forward on the history
+		headIR.assign(headSize, 0.0f);
+		for (size_t i = 0; i < juce::jmin((size_t)headSize, irLength); ++i)
+			headIR[headSize - 1 - i] = ir[i];
+		history.assign(2 * headSize, 0.0f);
+		historyIndex = 0;
+
+		// audio thread uniform stage
+		auto partitionSize = headSize;
+		auto stageStart = (size_t)headSize;
+		auto stageEnd = juce::jmin(irLength, (size_t)(8 * headSize));
+		hasSyncStage = irLength > stageStart;
+		if (hasSyncStage)
+			syncStage.prepare(partitionSize, ir + stageStart, stageEnd - stageStart);
+
+		// background stages
+		while (irLength > stageEnd)
+		{
+			partitionSize = juce::jmax(partitionSize, juce::jmin(4 * partitionSize, maxPartitionSize));
+			stageStart = stageEnd;
+			// the next stage starts at twice its partition size, the last one takes the rest of the IR
+			auto nextPartitionSize = juce::jmin(4 * partitionSize, maxPartitionSize);
+			stageEnd = nextPartitionSize > partitionSize ? juce::jmin(irLength, (size_t)(2 * nextPartitionSize)) : irLength;
+
+			auto stage = std::make_unique<BackgroundConvolutionStage>();
+			stage->prepare(partitionSize, stageStart, ir + stageStart, stageEnd - stageStart, sampleRate);
+			stage->setNonRealtime(nonRealtime);
+			stages.push_back(std::move(stage));
+		}
+
+		scratch.assign(headSize, 0.0f);
+		if (workerPool != nullptr)
+			for (auto& stage : stages)
+				workerPool->addStage(stage.get());
+	}
+
+	/// <summary>
+	/// Processes a block of any size, input and output may be the same buffer. No latency
+	/// </summary>
+	void process(const float* input, float* output, int numSamples)
+	{
+		int n = 0;
+		while (n < numSamples)
+		{
+			auto count = juce::jmin(numSamples - n, (int)headSize);
+
+			// inputs first : every background output needed by this chunk was published earlier, as O >= 2B
+			bool published = false;
+			for (auto& stage : stages)
+				published |= stage->pushInput(input + n, count);
+			if (published && workerPool != nullptr)
+				workerPool->notify();
+
+			if (hasSyncStage)
+				syncStage.process(input + n, scratch.data(), count);
+			else
+				std::fill(scratch.begin(), scratch.begin() + count, 0.0f);
+
+			for (int i = 0; i < count; ++i)
+				scratch[i] += processHead(input[n + i]);
+
+			for (auto& stage : stages)
+				stage->addOutput(scratch.data(), count);
+
+			std::copy(scratch.begin(), scratch.begin() + count, output + n);
+			n += count;
+		}
+	}
+
+	int getLatency() const
+	{
+		return 0;
+	}
+
+	size_t getNumBackgroundStages() const
+	{
+		return stages.size();
+	}
+
+private:
+	/// <summary>
+	/// Direct form FIR on a doubled history, so that the last H samples are always contiguous
+	/// </summary>
+	float processHead(float xn)
+	{
+		history[historyIndex] = xn;
+		history[historyIndex + headSize] = xn;
+		auto window = &history[historyIndex + 1];
+		float yn = 0.0f;
+		for (unsigned int i = 0; i < headSize; ++i)
+			yn += window[i] * headIR[i];
+		historyIndex = (historyIndex + 1) % headSize;
+		return yn;
+	}
+
+	void releaseStages()
+	{
+		if (workerPool != nullptr)
+			for (auto& stage : stages)
+				workerPool->removeStage(stage.get());
+		stages.clear();
+	}
+
+	unsigned int headSize = 128;
+	vector<float> headIR;		// H taps, reversed
+	vector<float> history;		// 2H, doubled
+	unsigned int historyIndex = 0;
+
+	UniformPartitionedConvolver syncStage;
+	bool hasSyncStage = false;
+
+	vector<std::unique_ptr<BackgroundConvolutionStage>> stages;
+	std::shared_ptr<ConvolutionWorkerPool> workerPool;
+	vector<float> scratch;		// H
+};
+
+/// <summary>
+/// Convolution reverb parameters
+/// </summary>
+struct ConvolutionReverbParameters
+{
+	double mix = 1.0;
+	double gain_dB = 0.0;
+};
+
+/// <summary>
+/// Stereo convolution reverb : a mono IR is applied to both channels, a stereo IR channel by channel.
+/// The impulse response is loaded and partitioned on the message thread, then swapped in under a spin lock :
+/// the audio thread only tries the lock and passes the dry signal through while a new IR is being swapped.
+/// In the uniform mode the latency is the partition size, the dry signal is delayed by as much to stay aligned with the wet one
+/// (with or without an IR, so that the reported latency holds).
+/// In zero latency mode the convolvers are non-uniform, their long partitions computed by the shared worker pool.
+/// </summary>
+class ConvolutionReverb
+{
+public:
+	/// <summary>
+	/// Resets the sample rate and the partition size, prepares the current IR again
+	/// </summary>
+	/// <param name="pSampleRate"></param>
+	/// <param name="pPartitionSize">a power of 2, it is also the latency. In zero latency mode, the direct form head length</param>
+	/// <param name="pZeroLatency">non-uniform partitions, no latency</param>
+	void reset(double pSampleRate, unsigned int pPartitionSize = 512, bool pZeroLatency = false)
+	{
+		sampleRate = pSampleRate;
+		partitionSize = pPartitionSize;
+		zeroLatency = pZeroLatency;
+		if (zeroLatency && workerPool == nullptr)
+			workerPool = ConvolutionWorkerPool::getSharedPool();
+		dryDelayL.assign((size_t)getLatencySamples(), 0.0f);
+		dryDelayR.assign((size_t)getLatencySamples(), 0.0f);
+		dryDelayIndex = 0;
+		prepareConvolvers();
+	}
+
+	void setParameters(ConvolutionReverbParameters pParameters)
+	{
+		parameters = pParameters;
+	}
+
+	/// <summary>
+	/// Offline rendering (AudioProcessor::isNonRealtime()) : in zero latency mode the audio thread waits for the late
+	/// background partitions instead of leaving them out. Applied by the next reset() or impulse response
+	/// </summary>
+	void setNonRealtime(bool pNonRealtime)
+	{
+		nonRealtime = pNonRealtime;
+	}
+
+	/// <summary>
+	/// Loads an impulse response from an audio file (WAV, AIFF...), call from the message thread
+	/// </summary>
+	/// <returns> false if the file could not be read </returns>
+	bool loadImpulseResponse(const juce::File& file)
+	{
+		juce::AudioFormatManager formatManager;
+		formatManager.registerBasicFormats();
+		std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+		if (reader == nullptr)
+			return false;
+
+		auto length = (int)juce::jmin(reader->lengthInSamples, (juce::int64)(maxLength_s * reader->sampleRate));
+		juce::AudioBuffer<float> ir((int)juce::jmin(2u, reader->numChannels), length);
+		reader->read(&ir, 0, length, 0, true, ir.getNumChannels() > 1);
+		setImpulseResponse(ir, reader->sampleRate);
+		return true;
+	}
+
+	/// <summary>
+	/// Sets the impulse response, resampled to the current sample rate. Call from the message thread
+	/// </summary>
+	void setImpulseResponse(const juce::AudioBuffer<float>& ir, double irSampleRate)
+	{
+		impulseResponse.makeCopyOf(ir);
+		impulseResponseSampleRate = irSampleRate;
+		prepareConvolvers();
+	}
+
+	bool hasImpulseResponse() const
+	{
+		return impulseResponse.getNumSamples() > 0;
+	}
+
+	int getLatencySamples() const
+	{
+		return zeroLatency ? 0 : (int)partitionSize;
+	}
+
+	/// <summary>
+	/// Processes a stereo block in place
+	/// </summary>
+	void processBlock(float* left, float* right, int numSamples)
+	{
+		const juce::SpinLock::ScopedTryLockType lock(convolverLock);
+		if (!lock.isLocked() || convolvers == nullptr)
+		{
+			delayDry(left, right, numSamples);
+			return;
+		}
+
+		auto& c = *convolvers;
+		auto wet = (float)(parameters.mix * juce::Decibels::decibelsToGain(parameters.gain_dB));
+		auto dry = (float)(1.0 - parameters.mix);
+
+		int n = 0;
+		while (n < numSamples)
+		{
+			auto count = juce::jmin(numSamples - n, (int)c.scratchL.size());
+			if (c.zeroLatency)
+			{
+				c.zeroLatencyLeft.process(left + n, c.scratchL.data(), count);
+				c.zeroLatencyRight.process(right + n, c.scratchR.data(), count);
+			}
+			else
+			{
+				c.left.process(left + n, c.scratchL.data(), count);
+				c.right.process(right + n, c.scratchR.data(), count);
+			}
+			delayDry(left + n, right + n, count);
+			for (int i = 0; i < count; ++i)
+			{
+				left[n + i] = dry * left[n + i] + wet * c.scratchL[i];
+				right[n + i] = dry * right[n + i] + wet * c.scratchR[i];
+			}
+			n += count;
+		}
+	}
+
+	/// <summary>
+	/// Processes one stereo sample, same interface as the algorithmic reverbs
+	/// </summary>
+	vector<float> processAudioSample(vector<float> inputXn)
+	{
+		processBlock(&inputXn[0], &inputXn[1], 1);
+		return inputXn;
+	}
+
+private:
+	/// <summary>
+	/// Delays the dry signal in place by the latency (the partition size in the uniform mode, nothing in zero latency mode)
+	/// </summary>
+	void delayDry(float* left, float* right, int numSamples)
+	{
+		auto length = dryDelayL.size();
+		if (length == 0)
+			return;
+		for (int i = 0; i < numSamples; ++i)
+		{
+			std::swap(left[i], dryDelayL[dryDelayIndex]);
+			std::swap(right[i], dryDelayR[dryDelayIndex]);
+			if (++dryDelayIndex == length)
+				dryDelayIndex = 0;
+		}
+	}
+
+	/// <summary>
+	/// Both channels convolvers, swapped as a whole. Only the pair of the selected mode is prepared
+	/// </summary>
+	struct Convolvers
+	{
+		bool zeroLatency = false;
+		UniformPartitionedConvolver left, right;
+		NonUniformPartitionedConvolver zeroLatencyLeft, zeroLatencyRight;
+		vector<float> scratchL, scratchR;
+	};
+
+	/// <summary>
+	/// Resamples the IR and builds new convolvers, then swaps them in
+	/// </summary>
+	void prepareConvolvers()
+	{
+		std::unique_ptr<Convolvers> newConvolvers;
+		if (hasImpulseResponse())
+		{
+			// resample to the processing sample rate
+			auto ratio = impulseResponseSampleRate / sampleRate;
+			auto length = (int)(impulseResponse.getNumSamples() / ratio);
+			juce::AudioBuffer<float> resampled(impulseResponse.getNumChannels(), length);
+			for (int ch = 0; ch < impulseResponse.getNumChannels(); ++ch)
+			{
+				if (ratio == 1.0)
+					resampled.copyFrom(ch, 0, impulseResponse, ch, 0, length);
+				else
+				{
+					juce::LagrangeInterpolator interpolator;
+					interpolator.process(ratio, impulseResponse.getReadPointer(ch), resampled.getWritePointer(ch), length);
+				}
+			}
+
+			newConvolvers = std::make_unique<Convolvers>();
+			newConvolvers->zeroLatency = zeroLatency;
+			auto irLeft = resampled.getReadPointer(0);
+			auto irRight = resampled.getReadPointer(juce::jmin(1, resampled.getNumChannels() - 1));
+			if (zeroLatency)
+			{
+				newConvolvers->zeroLatencyLeft.prepare(irLeft, (size_t)length, partitionSize, maxPartitionSize, sampleRate, workerPool, nonRealtime);
+				newConvolvers->zeroLatencyRight.prepare(irRight, (size_t)length, partitionSize, maxPartitionSize, sampleRate, workerPool, nonRealtime);
+			}
+			else
+			{
+				newConvolvers->left.prepare(partitionSize, irLeft, (size_t)length);
+				newConvolvers->right.prepare(partitionSize, irRight, (size_t)length);
+			}
+			newConvolvers->scratchL.assign(partitionSize, 0.0f);
+			newConvolvers->scratchR.assign(partitionSize, 0.0f);
+		}
+
+		{
+			const juce::SpinLock::ScopedLockType lock(convolverLock);
+			std::swap(convolvers, newConvolvers);
+		}
+		// the previous convolvers are released here, outside of the lock : their background stages leave the pool
+	}
+
+	double sampleRate = 44100.0;
+	unsigned int partitionSize = 512;
+	bool zeroLatency = false;
+	bool nonRealtime = false;
+	const unsigned int maxPartitionSize = 8192;
+	const double maxLength_s = 20.0;
+	ConvolutionReverbParameters parameters;
+
+	juce::AudioBuffer<float> impulseResponse;
+	double impulseResponseSampleRate = 44100.0;
+
+	std::shared_ptr<ConvolutionWorkerPool> workerPool;
+	juce::SpinLock convolverLock;
+	std::unique_ptr<Convolvers> convolvers;
+
+	vector<float> dryDelayL, dryDelayR;	// latency samples, audio thread
+	size_t dryDelayIndex = 0;
+};
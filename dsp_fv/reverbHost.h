@@ -0,0 +1,358 @@
+#pragma once
+#include <JuceHeader.h>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <atomic>
+#include <cmath>
+#include "silenceDetector.h"
+
+using std::vector;
+
+// =============================================================================
+// Reverb host
+// Several reverb algorithms behind one interface, only the selected one allocated and running
+// =============================================================================
+
+/// <summary>
+/// Interface of an algorithm run by the ReverbHost
+/// </summary>
+class HostedReverb
+{
+public:
+	virtual ~HostedReverb() = default;
+
+	/// <summary>
+	/// Allocates the delay memory, clears the states. Called on the preparation thread (or in prepareToPlay)
+	/// </summary>
+	virtual void reset(double sampleRate) = 0;
+
+	/// <summary>
+	/// Audio thread, once per block : reads the control parameters
+	/// </summary>
+	virtual void updateParameters() = 0;
+
+	/// <summary>
+	/// Audio thread : processes a stereo block, fully wet
+	/// </summary>
+	virtual void processBlock(const float* inL, const float* inR, float* wetL, float* wetR, int numSamples) = 0;
+
+	/// <summary>
+	/// Audio thread : tail length with the current parameters, in seconds
+	/// </summary>
+	virtual double getTailLengthSeconds() const = 0;
+};
+
+/// <summary>
+/// Runs one reverb algorithm out of several, chosen by its index.
+/// - algorithms are created by their factory only when selected : an unselected algorithm holds no memory and costs no CPU
+/// - message thread : update() is called periodically with the selected algorithm. On a change, a new instance is
+///   created and reset (its delay lines allocated) by a background thread, then handed to the audio thread
+/// - audio thread : processBlock() runs the active algorithm. When a new one is handed over, both run during an equal
+///   power crossfade (the outputs are uncorrelated), then the old one is handed back to the message thread, which deletes it.
+/// The audio thread neither allocates nor frees, and only tries the lock it shares with the message thread.
+/// Out of a crossfade, the active algorithm is skipped while its input is silent and its tail has rung out (SilenceDetector).
+/// The mix is applied here, the algorithms are fully wet.
+/// </summary>
+class ReverbHost
+{
+public:
+	using Factory = std::function<std::unique_ptr<HostedReverb>()>;
+
+	/// <summary>
+	/// One factory per algorithm, the index is the algorithm number. Not to be called while processing
+	/// </summary>
+	void setFactories(vector<Factory> pFactories)
+	{
+		factories = std::move(pFactories);
+	}
+
+	/// <summary>
+	/// Crossfade length, applied at the next reset()
+	/// </summary>
+	void setCrossfadeTime(double pCrossfade_ms)
+	{
+		crossfade_ms = pCrossfade_ms;
+	}
+
+	/// <summary>
+	/// Allocates the buffers, creates and resets the given algorithm right away : the host starts with it,
+	/// without crossfade. Preparations in progress are dropped. Not to be called while processing
+	/// </summary>
+	/// <param name="allocationSetting">setting only applied when an instance is reset (e.g. a size), see update()</param>
+	void reset(double pSampleRate, int pMaxBlockSize, int algorithm, double allocationSetting = 0.0)
+	{
+		preparationThread.removeAllJobs(true, -1);
+		{
+			const juce::ScopedLock lock(preparationLock);
+			finishedPreparations.clear();
+		}
+		preparationPending.store(false, std::memory_order_release);
+
+		sampleRate = pSampleRate;
+		maxBlockSize = juce::jmax(1, pMaxBlockSize);
+		for (auto* buffer : { &dryL, &dryR, &wetL, &wetR, &tempL, &tempR })
+			buffer->assign((size_t)maxBlockSize, 0.0f);
+		silenceDetector.reset(sampleRate);
+
+		// equal power crossfade, fadeIn[i] = sin(pi/2 i/N), fade out read backwards
+		auto crossfadeLength = juce::jmax(1, (int)(crossfade_ms * 0.001 * sampleRate));
+		fadeIn.resize((size_t)crossfadeLength + 1);
+		for (int i = 0; i <= crossfadeLength; ++i)
+			fadeIn[(size_t)i] = (float)std::sin(juce::MathConstants<double>::halfPi * i / crossfadeLength);
+
+		auto engine = createEngine(algorithm, sampleRate);
+		const juce::SpinLock::ScopedLockType lock(stateLock);
+		active = std::move(engine);
+		fadingOut.reset();
+		incoming.reset();
+		retired.reset();
+		fadePosition = 0;
+		installedAlgorithm = active != nullptr ? algorithm : -1;
+		installedSetting = allocationSetting;
+		activeAlgorithm.store(installedAlgorithm, std::memory_order_release);
+		tailLength_s.store(active != nullptr ? active->getTailLengthSeconds() : 0.0);
+	}
+
+	/// <summary>
+	/// Message thread, periodically : starts the preparation of the selected algorithm, hands the prepared
+	/// instances to the audio thread, deletes the ones it has retired
+	/// </summary>
+	/// <param name="algorithm">selected algorithm</param>
+	/// <param name="allocationSetting">a change prepares a new instance of the current algorithm</param>
+	void update(int algorithm, double allocationSetting = 0.0)
+	{
+		std::unique_ptr<HostedReverb> toDelete;
+		{
+			const juce::SpinLock::ScopedLockType lock(stateLock);
+			toDelete = std::move(retired);
+		}
+		toDelete.reset();
+
+		collectFinishedPreparations();
+
+		if (preparationPending.load(std::memory_order_acquire) || sampleRate <= 0.0 || algorithm < 0 || algorithm >= (int)factories.size())
+			return;
+		if (algorithm != installedAlgorithm || allocationSetting != installedSetting)
+			startPreparation(algorithm, allocationSetting);
+	}
+
+	/// <summary>
+	/// Audio thread : processes a stereo block in place
+	/// </summary>
+	/// <param name="mix">dry / wet</param>
+	void processBlock(float* left, float* right, int numSamples, double mix)
+	{
+		takeIncoming();
+
+		auto wet = (float)mix;
+		auto dry = 1.0f - wet;
+		int n = 0;
+		while (n < numSamples)
+		{
+			auto count = juce::jmin(numSamples - n, maxBlockSize);
+			std::copy(left + n, left + n + count, dryL.begin());
+			std::copy(right + n, right + n + count, dryR.begin());
+			std::fill(wetL.begin(), wetL.begin() + count, 0.0f);
+			std::fill(wetR.begin(), wetR.begin() + count, 0.0f);
+
+			// the crossfades always run, they restart the idle detection
+			auto tail_s = active != nullptr ? active->getTailLengthSeconds() : 0.0;
+			if (fadingOut != nullptr)
+				tail_s = juce::jmax(tail_s, fadingOut->getTailLengthSeconds());
+			tailLength_s.store(tail_s);
+			silenceDetector.setTailLength(tail_s);
+			auto run = silenceDetector.processInput(dryL.data(), dryR.data(), count) || fadingOut != nullptr;
+
+			if (active != nullptr && run)
+			{
+				active->updateParameters();
+				active->processBlock(dryL.data(), dryR.data(), wetL.data(), wetR.data(), count);
+			}
+
+			if (fadingOut != nullptr)
+			{
+				fadingOut->updateParameters();
+				fadingOut->processBlock(dryL.data(), dryR.data(), tempL.data(), tempR.data(), count);
+
+				auto crossfadeLength = (int)fadeIn.size() - 1;
+				for (int i = 0; i < count; ++i)
+				{
+					auto position = juce::jmin(fadePosition + i, crossfadeLength);
+					auto gainIn = fadeIn[(size_t)position];
+					auto gainOut = fadeIn[(size_t)(crossfadeLength - position)];
+					wetL[i] = gainIn * wetL[i] + gainOut * tempL[i];
+					wetR[i] = gainIn * wetR[i] + gainOut * tempR[i];
+				}
+				fadePosition += count;
+				if (fadePosition >= crossfadeLength)
+					retireFadingOut();
+			}
+			if (run)
+				silenceDetector.processOutput(wetL.data(), wetR.data(), count);
+
+			for (int i = 0; i < count; ++i)
+			{
+				left[n + i] = dry * dryL[i] + wet * wetL[i];
+				right[n + i] = dry * dryR[i] + wet * wetR[i];
+			}
+			n += count;
+		}
+	}
+
+	/// <summary>
+	/// Algorithm the audio thread is running (or fading in), -1 if none
+	/// </summary>
+	int getActiveAlgorithm() const
+	{
+		return activeAlgorithm.load(std::memory_order_acquire);
+	}
+
+	/// <summary>
+	/// Tail length of the running algorithm(s), for the host
+	/// </summary>
+	double getTailLengthSeconds() const
+	{
+		return tailLength_s.load();
+	}
+
+	/// <summary>
+	/// Message thread : true while an algorithm is prepared or crossfaded in
+	/// </summary>
+	bool isSwitching() const
+	{
+		return preparationPending.load(std::memory_order_acquire) || switching.load(std::memory_order_acquire);
+	}
+
+private:
+	std::unique_ptr<HostedReverb> createEngine(int algorithm, double fs) const
+	{
+		if (algorithm < 0 || algorithm >= (int)factories.size() || factories[(size_t)algorithm] == nullptr)
+			return nullptr;
+		auto engine = factories[(size_t)algorithm]();
+		if (engine != nullptr)
+			engine->reset(fs);
+		return engine;
+	}
+
+	void startPreparation(int algorithm, double allocationSetting)
+	{
+		preparationPending.store(true, std::memory_order_release);
+		switching.store(true, std::memory_order_release);
+		auto fs = sampleRate;
+		preparationThread.addJob([this, algorithm, allocationSetting, fs]
+			{
+				auto engine = createEngine(algorithm, fs);
+				const juce::ScopedLock lock(preparationLock);
+				finishedPreparations.push_back({ algorithm, allocationSetting, fs, std::move(engine) });
+			});
+	}
+
+	struct Preparation
+	{
+		int algorithm;
+		double allocationSetting;
+		double sampleRate;
+		std::unique_ptr<HostedReverb> engine;
+	};
+
+	/// <summary>
+	/// Message thread : hands the prepared instance to the audio thread, once the previous one has been taken
+	/// </summary>
+	void collectFinishedPreparations()
+	{
+		const juce::ScopedLock lock(preparationLock);
+		if (finishedPreparations.empty())
+			return;
+
+		// stale sample rate : dropped, update() prepares the algorithm again. No instance : the algorithm is skipped
+		auto& preparation = finishedPreparations.front();
+		const juce::SpinLock::ScopedLockType stateScope(stateLock);
+		if (preparation.sampleRate != sampleRate || preparation.engine == nullptr)
+		{
+			if (preparation.sampleRate == sampleRate)
+			{
+				installedAlgorithm = preparation.algorithm;
+				installedSetting = preparation.allocationSetting;
+			}
+			finishedPreparations.clear();
+			preparationPending.store(false, std::memory_order_release);
+			switching.store(false, std::memory_order_release);
+			return;
+		}
+
+		// the audio thread takes it once its crossfade in progress has ended
+		if (incoming != nullptr)
+			return;
+		incoming = std::move(preparation.engine);
+		installedAlgorithm = preparation.algorithm;
+		installedSetting = preparation.allocationSetting;
+		finishedPreparations.clear();
+		preparationPending.store(false, std::memory_order_release);
+	}
+
+	/// <summary>
+	/// Audio thread : starts the crossfade to the handed over instance
+	/// </summary>
+	void takeIncoming()
+	{
+		const juce::SpinLock::ScopedTryLockType lock(stateLock);
+		if (!lock.isLocked())
+			return;
+
+		if (fadingOut == nullptr && pendingRetire != nullptr && retired == nullptr)
+			retired = std::move(pendingRetire);
+
+		if (incoming == nullptr || fadingOut != nullptr || pendingRetire != nullptr)
+			return;
+		fadingOut = std::move(active);
+		active = std::move(incoming);
+		fadePosition = 0;
+		activeAlgorithm.store(installedAlgorithm, std::memory_order_release);
+		if (fadingOut == nullptr)
+			switching.store(false, std::memory_order_release);
+	}
+
+	/// <summary>
+	/// Audio thread : end of the crossfade, the old instance waits to be handed back to the message thread
+	/// </summary>
+	void retireFadingOut()
+	{
+		pendingRetire = std::move(fadingOut);
+		fadePosition = 0;
+		switching.store(false, std::memory_order_release);
+	}
+
+	double sampleRate = 0.0;
+	int maxBlockSize = 512;
+	double crossfade_ms = 50.0;
+	vector<Factory> factories;
+
+	// message thread
+	double installedSetting = 0.0;
+	// written by reset() from prepareToPlay and by update() on the message thread
+	std::atomic<bool> preparationPending{ false };
+
+	// shared with the audio thread, written under the state lock
+	juce::SpinLock stateLock;
+	int installedAlgorithm = -1;			// algorithm of the newest instance handed to the audio thread
+	std::unique_ptr<HostedReverb> incoming;
+	std::unique_ptr<HostedReverb> retired;
+	std::atomic<int> activeAlgorithm{ -1 };
+	std::atomic<bool> switching{ false };
+	std::atomic<double> tailLength_s{ 0.0 };
+
+	// audio thread
+	std::unique_ptr<HostedReverb> active;
+	std::unique_ptr<HostedReverb> fadingOut;
+	std::unique_ptr<HostedReverb> pendingRetire;
+	int fadePosition = 0;
+	SilenceDetector silenceDetector;
+	vector<float> dryL, dryR, wetL, wetR, tempL, tempR;
+	vector<float> fadeIn;
+
+	// preparation thread
+	juce::CriticalSection preparationLock;
+	vector<Preparation> finishedPreparations;
+	juce::ThreadPool preparationThread{ 1 };		// last member : destroyed first, waits for a preparation in progress
+};
@@ -0,0 +1,317 @@
+#pragma once
+#include "reverbTopology.h"
+
+// =============================================================================
+// Reverb topologies
+// The plate and Schroeder reverbs of the repository, re-expressed as ReverbTopology descriptions.
+// Structure values are the ones of the engines' ReverbStructureParameters, controls are the plugins'
+// parameters with their default values.
+// =============================================================================
+
+struct ReverbTopologies
+{
+	/// <summary>
+	/// Jon Dattorro plate (DattorroPlateReverb) : predelay, bandwidth, 4 input diffusers, two tanks crossed through
+	/// one sample of feedback. The tanks APFs are modulated, depth 0.536 ms times the modulation control.
+	/// Same output as DattorroPlateReverb (modulation off) for predelays of one sample or more only : below one sample,
+	/// the engine's delayLine reads 0 samples back after its write, which wraps to its whole buffer (~32768 samples),
+	/// while the predelay node here has no delay
+	/// </summary>
+	static ReverbTopology dattorroPlate()
+	{
+		ReverbTopology topology;
+		topology.name = "dattorro";
+		topology.controls = { { "mix", 0.0 }, { "predelay", 0.0 }, { "inputDiffusion1", 0.75 }, { "inputDiffusion2", 0.625 },
+			{ "decayDiffusion1", 0.7 }, { "decayDiffusion2", 0.5 }, { "decay", 0.5 }, { "damping", 10.0 }, { "bandwidth", 20000.0 },
+			{ "modulation", 1.0 } };
+
+		addNode(topology, input("input"));
+		auto predelay = delay("predelay", TopologyValue::control("predelay"));
+		predelay.maxDelay_ms = 500.0;
+		addNode(topology, predelay, { { "input" } });
+		addNode(topology, tptLowpass("bandwidth", TopologyValue::control("bandwidth")), { { "predelay" } });
+		addNode(topology, allPass("inputDiffuser1", TopologyNodeType::latticeAllPass, 4.93, TopologyValue::control("inputDiffusion1", -1.0)), { { "bandwidth" } });
+		addNode(topology, allPass("inputDiffuser2", TopologyNodeType::latticeAllPass, 3.6, TopologyValue::control("inputDiffusion1", -1.0)), { { "inputDiffuser1" } });
+		addNode(topology, allPass("inputDiffuser3", TopologyNodeType::latticeAllPass, 12.7, TopologyValue::control("inputDiffusion2", -1.0)), { { "inputDiffuser2" } });
+		addNode(topology, allPass("inputDiffuser4", TopologyNodeType::latticeAllPass, 9.3, TopologyValue::control("inputDiffusion2", -1.0)), { { "inputDiffuser3" } });
+
+		// tanks : modulated APF, delay, damping, APF, delay. Each tank input reads the other tank output of the previous sample
+		const double modulatedAPF_ms[2] = { 22.55, 30.46 };
+		const double delayLine_ms[4] = { 149.4, 124.8, 141.5, 105.2 };
+		const double alternateAPF_ms[2] = { 60.4, 89.12 };
+		for (int tank = 0; tank < 2; ++tank)
+		{
+			auto n = juce::String(tank + 1);
+			auto otherTankOutput = "delayLine" + juce::String(tank == 0 ? 4 : 2);
+			addNode(topology, sum("tank" + n), { { "inputDiffuser4" }, { otherTankOutput, TopologyValue::control("decay"), true } });
+
+			addNode(topology, lfo("lfo" + n, generatorWaveform::kSin, 1.0));
+			auto modulatedAPF = allPass("modulatedAPF" + n, TopologyNodeType::latticeAllPass, modulatedAPF_ms[tank], TopologyValue::control("decayDiffusion1"));
+			modulatedAPF.modulator = "lfo" + n;
+			modulatedAPF.modulationDepth_ms = TopologyValue::control("modulation", 0.536);
+			modulatedAPF.maxDelay_ms = modulatedAPF_ms[tank] + 0.536;
+			addNode(topology, modulatedAPF, { { "tank" + n } });
+
+			addNode(topology, delay("delayLine" + juce::String(2 * tank + 1), delayLine_ms[2 * tank]), { { "modulatedAPF" + n } });
+			addNode(topology, tptLowpass("damping" + n, TopologyValue::control("damping")), { { "delayLine" + juce::String(2 * tank + 1) } });
+			addNode(topology, allPass("alternateAPF" + juce::String(tank + 5), TopologyNodeType::latticeAllPass, alternateAPF_ms[tank], TopologyValue::control("decayDiffusion2")), { { "damping" + n } });
+			addNode(topology, delay("delayLine" + juce::String(2 * tank + 2), delayLine_ms[2 * tank + 1]), { { "alternateAPF" + juce::String(tank + 5) } });
+		}
+
+		// output taps, sample counts of the paper at its 29761 Hz rate (dattorroOutputTaps), scaled to the sample rate
+		const double paperRate = 29761.0;
+		topology.taps = {
+			{ "delayLine1", 266, 1.0, 0, paperRate }, { "delayLine1", 2974, 1.0, 0, paperRate }, { "alternateAPF5", 1913, -1.0, 0, paperRate },
+			{ "delayLine2", 1996, 1.0, 0, paperRate }, { "delayLine3", 1990, -1.0, 0, paperRate }, { "alternateAPF6", 187, -1.0, 0, paperRate },
+			{ "delayLine4", 1066, -1.0, 0, paperRate },
+			{ "delayLine3", 353, 1.0, 1, paperRate }, { "delayLine3", 3627, 1.0, 1, paperRate }, { "alternateAPF6", 1228, -1.0, 1, paperRate },
+			{ "delayLine4", 2673, 1.0, 1, paperRate }, { "delayLine1", 2111, -1.0, 1, paperRate }, { "alternateAPF5", 335, -1.0, 1, paperRate },
+			{ "delayLine2", 121, -1.0, 1, paperRate } };
+		return topology;
+	}
+
+	/// <summary>
+	/// AbyssalPlateReverb : early reflections (ring of 4 absorption filters and APFs, 2 lowpass combs) crossfaded
+	/// with the input, into a ring of 4 branches (APF, vibrato on the first two, APF, damping, delay).
+	/// Matches AbyssalPlateReverb within 1e-6 without modulation, 3e-5 with it (1e-4 of the output peak) : the vibrato
+	/// delays are computed in SampleType here, in double in the engine. At full modulation depth the vibrato reaches
+	/// 0 ms, where the engine's read wraps to its whole buffer, while the vibrato node is limited to 1 sample
+	/// </summary>
+	static ReverbTopology abyssalPlate()
+	{
+		ReverbTopology topology;
+		topology.name = "abyssal";
+		topology.controls = { { "mix", 0.0 }, { "absorption", 20000.0 }, { "earlyReflexions", 0.0 }, { "decay", 0.0 },
+			{ "damping", 0.5 }, { "modRate", 1.0 }, { "modDepth", 0.0 } };
+
+		addNode(topology, input("input"));
+
+		// early reflections, each branch reads the previous one (the first one, the last one of the previous sample).
+		// The APFs delays are truncated to whole ms by allPassFilter::createDelayBuffer() : 5.647, 6.38, 15.67, 16.75 ms
+		const double earlyReflexAPF_ms[4] = { 5.0, 6.0, 15.0, 16.0 };
+		const double earlyReflexAPF_gain[4] = { -0.53, -0.53, 0.45, 0.45 };
+		for (int branch = 0; branch < 4; ++branch)
+		{
+			auto n = juce::String(branch + 1);
+			auto previous = "earlyReflexAPF" + juce::String(branch == 0 ? 4 : branch);
+			auto absorption = biquad("absorption" + n, ClassicFilterType::LPF1, TopologyValue::control("absorption"), 1.0);
+			addNode(topology, absorption, { { "input" }, { previous, 0.25, branch == 0 } });
+			addNode(topology, allPass("earlyReflexAPF" + n, TopologyNodeType::latticeAllPass, earlyReflexAPF_ms[branch], earlyReflexAPF_gain[branch]), { { "absorption" + n } });
+		}
+		addNode(topology, sum("earlyReflexBranches"), { { "earlyReflexAPF1" }, { "earlyReflexAPF2" }, { "earlyReflexAPF3" }, { "earlyReflexAPF4" } });
+
+		// FCombFilter : the delay is truncated to whole ms, the loop pole is sqrt(delay / 250 ms) of the exact delay
+		addNode(topology, lowpassComb("earlyReflexFcomb1", 61.0, 0.35, std::sqrt(61.54 / 250.0)), { { "earlyReflexBranches" } });
+		addNode(topology, lowpassComb("earlyReflexFcomb2", 74.0, 0.35, std::sqrt(74.69 / 250.0)), { { "earlyReflexBranches" } });
+		addNode(topology, sum("earlyReflexions"), { { "earlyReflexFcomb1", 0.15 }, { "earlyReflexFcomb2", 0.15 }, { "earlyReflexBranches" } });
+		addNode(topology, sum("reverbInput"), { { "earlyReflexions", TopologyValue::control("earlyReflexions") },
+			{ "input", TopologyValue::control("earlyReflexions", -1.0, 1.0) } });
+
+		// reverberator ring. The plugin's modulated APFs never apply their LFO : they are plain lattice APFs here
+		addNode(topology, lfo("vibratoLFO", generatorWaveform::kTriangle, TopologyValue::control("modRate")));
+		const double reverbModulatedAPF_ms[4] = { 31.17, 8.87, 32.37, 9.45 };
+		const double reverbModulatedAPF_gain[4] = { 0.65, 0.65, 0.75, 0.75 };
+		const double reverbAPF_ms[4] = { 78.0, 43.0, 64.0, 56.0 };
+		const double reverbAPF_gain[4] = { 0.4, 0.4, 0.53, 0.53 };
+		const double reverbDelayLine_ms[4] = { 86.0, 79.0, 76.0, 81.0 };
+		for (int branch = 0; branch < 4; ++branch)
+		{
+			auto n = juce::String(branch + 1);
+			auto previous = "delayLine" + juce::String(branch == 0 ? 4 : branch);
+			addNode(topology, allPass("modulatedAPF" + n, TopologyNodeType::latticeAllPass, reverbModulatedAPF_ms[branch], reverbModulatedAPF_gain[branch]),
+				{ { "reverbInput" }, { previous, TopologyValue::control("decay"), branch == 0 } });
+			auto apfInput = "modulatedAPF" + n;
+
+			// Vibrato : 0 to 7 ms, around 3.5 ms
+			if (branch < 2)
+			{
+				auto vibrato = delay("vibrato" + n, 3.5);
+				vibrato.modulator = "vibratoLFO";
+				vibrato.modulationDepth_ms = TopologyValue::control("modDepth", 3.5);
+				vibrato.maxDelay_ms = 7.0;
+				addNode(topology, vibrato, { { apfInput } });
+				apfInput = "vibrato" + n;
+			}
+			addNode(topology, allPass("reverbAPF" + n, TopologyNodeType::latticeAllPass, reverbAPF_ms[branch], reverbAPF_gain[branch]), { { apfInput } });
+
+			TopologyNode damping;
+			damping.name = "damping" + n;
+			damping.type = TopologyNodeType::onePole;
+			damping.pole = TopologyValue::control("damping");
+			addNode(topology, damping, { { "reverbAPF" + n, TopologyValue::control("damping", -1.0, 1.0) } });
+			addNode(topology, delay("delayLine" + n, reverbDelayLine_ms[branch]), { { "damping" + n } });
+		}
+
+		topology.taps = {
+			{ "delayLine1", 825, 0.16, 0 }, { "delayLine2", 2112, 0.16, 0 }, { "delayLine3", 1630, -0.16, 0 }, { "delayLine4", 3215, -0.16, 0 },
+			{ "delayLine3", 825, 0.16, 1 }, { "delayLine4", 2069, 0.16, 1 }, { "delayLine2", 1679, -0.16, 1 }, { "delayLine3", 2641, -0.16, 1 } };
+		return topology;
+	}
+
+	/// <summary>
+	/// SchroederReverb (1962) : 4 parallel combs into 2 series APFs, mono output to both channels.
+	/// CombFilter and allPassFilter truncate their delay to whole ms, the comb adds one sample
+	/// </summary>
+	static ReverbTopology schroeder()
+	{
+		ReverbTopology topology;
+		topology.name = "schroeder";
+		topology.controls = { { "mix", 0.0 } };
+
+		addNode(topology, input("input"));
+		const double comb_ms[4] = { 45.0, 38.0, 33.0, 30.0 };
+		const double comb_gain[4] = { 0.85, 0.87, 0.89, 0.9 };
+		vector<Input> combs;
+		for (int comb = 0; comb < 4; ++comb)
+		{
+			TopologyNode node;
+			node.name = "comb" + juce::String(comb + 1);
+			node.type = TopologyNodeType::comb;
+			node.delay_ms = comb_ms[comb];
+			node.delayOffset_samples = 1.0;
+			node.gain = comb_gain[comb];
+			addNode(topology, node, { { "input" } });
+			combs.push_back(Input(node.name));
+		}
+		addNode(topology, sum("combs"), combs);
+		addNode(topology, allPass("APF1", TopologyNodeType::allPass, 1.0, 0.63), { { "combs" } });
+		addNode(topology, allPass("APF2", TopologyNodeType::allPass, 5.0, 0.63), { { "APF1" } });
+		topology.taps = { { "APF2", 0, 1.0, 0 }, { "APF2", 0, 1.0, 1 } };
+		return topology;
+	}
+
+	/// <summary>
+	/// SchroederReverbSeries (1961) : 5 series APFs, mono output to both channels. allPassFilter truncates
+	/// its delay to whole ms : 19.7 ms and 5.85 ms are 19 ms and 5 ms
+	/// </summary>
+	static ReverbTopology schroederSeries()
+	{
+		ReverbTopology topology;
+		topology.name = "schroederSeries";
+		topology.controls = { { "mix", 0.0 } };
+
+		addNode(topology, input("input"));
+		const double apf_ms[5] = { 100.0, 68.0, 60.0, 19.0, 5.0 };
+		const double apf_gain[5] = { 0.7, -0.7, 0.7, 0.7, 0.7 };
+		juce::String previous = "input";
+		for (int apf = 0; apf < 5; ++apf)
+		{
+			auto name = "APF" + juce::String(apf + 1);
+			addNode(topology, allPass(name, TopologyNodeType::allPass, apf_ms[apf], apf_gain[apf]), { { previous } });
+			previous = name;
+		}
+		topology.taps = { { "APF5", 0, 1.0, 0 }, { "APF5", 0, 1.0, 1 } };
+		return topology;
+	}
+
+	/// <summary>
+	/// Names accepted by get()
+	/// </summary>
+	static juce::StringArray getNames()
+	{
+		return { "dattorro", "abyssal", "schroeder", "schroederSeries" };
+	}
+
+	static ReverbTopology get(const juce::String& name)
+	{
+		if (name == "abyssal") return abyssalPlate();
+		if (name == "schroeder") return schroeder();
+		if (name == "schroederSeries") return schroederSeries();
+		return dattorroPlate();
+	}
+
+private:
+	/// <summary>
+	/// Edge to a node being added : source, gain, feedback
+	/// </summary>
+	struct Input
+	{
+		Input(const juce::String& pSource, TopologyValue pGain = 1.0, bool pFeedback = false) : source(pSource), gain(pGain), feedback(pFeedback) {}
+		juce::String source;
+		TopologyValue gain;
+		bool feedback;
+	};
+
+	static void addNode(ReverbTopology& topology, const TopologyNode& node, vector<Input> inputs = {})
+	{
+		topology.nodes.push_back(node);
+		for (auto& edge : inputs)
+			topology.edges.push_back({ edge.source, node.name, edge.gain, edge.feedback });
+	}
+
+	static TopologyNode input(const juce::String& name)
+	{
+		TopologyNode node;
+		node.name = name;
+		node.type = TopologyNodeType::input;
+		return node;
+	}
+
+	static TopologyNode sum(const juce::String& name)
+	{
+		TopologyNode node;
+		node.name = name;
+		node.type = TopologyNodeType::sum;
+		return node;
+	}
+
+	static TopologyNode delay(const juce::String& name, TopologyValue delay_ms)
+	{
+		TopologyNode node;
+		node.name = name;
+		node.type = TopologyNodeType::delay;
+		node.delay_ms = delay_ms;
+		return node;
+	}
+
+	static TopologyNode allPass(const juce::String& name, TopologyNodeType type, double delay_ms, TopologyValue gain)
+	{
+		TopologyNode node;
+		node.name = name;
+		node.type = type;
+		node.delay_ms = delay_ms;
+		node.gain = gain;
+		return node;
+	}
+
+	static TopologyNode lowpassComb(const juce::String& name, double delay_ms, double gain, double pole)
+	{
+		TopologyNode node;
+		node.name = name;
+		node.type = TopologyNodeType::lowpassComb;
+		node.delay_ms = delay_ms;
+		node.gain = gain;
+		node.pole = pole;
+		return node;
+	}
+
+	static TopologyNode tptLowpass(const juce::String& name, TopologyValue frequency)
+	{
+		TopologyNode node;
+		node.name = name;
+		node.type = TopologyNodeType::tptLowpass;
+		node.frequency = frequency;
+		return node;
+	}
+
+	static TopologyNode biquad(const juce::String& name, ClassicFilterType filterType, TopologyValue frequency, TopologyValue q)
+	{
+		TopologyNode node;
+		node.name = name;
+		node.type = TopologyNodeType::biquad;
+		node.filterType = filterType;
+		node.frequency = frequency;
+		node.q = q;
+		return node;
+	}
+
+	static TopologyNode lfo(const juce::String& name, generatorWaveform waveform, TopologyValue frequency)
+	{
+		TopologyNode node;
+		node.name = name;
+		node.type = TopologyNodeType::lfo;
+		node.waveform = waveform;
+		node.frequency = frequency;
+		return node;
+	}
+};
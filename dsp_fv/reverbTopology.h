@@ -0,0 +1,735 @@
+#pragma once
+#include <JuceHeader.h>
+#include <vector>
+#include <cmath>
+#include "lfo.h"
+#include "classicFilters.h"
+#include "stateVariableFilter.h"
+
+using std::vector;
+
+// =============================================================================
+// Reverb topology
+// A reverb network described as data (nodes, edges, output taps) instead of objects wired
+// by hand. reset() compiles the description into a flat schedule : the nodes in dependency
+// order, one instruction each, their signals and delay memories laid out in that order in
+// two contiguous arrays. processAudioFrame() runs the schedule with a switch interpreter.
+// The node arithmetic is the one of the APFstructures classes, so a network re-expressed
+// here (reverbTopologies.h) renders as its hand-wired version.
+// =============================================================================
+
+/// <summary>
+/// Node types. x is the weighted sum of the node inputs, D the delay in samples, g the gain, p the pole
+/// </summary>
+enum class TopologyNodeType
+{
+	input,			// mono input, 0.5 (L + R), no inputs
+	sum,			// x
+	delay,			// delayLine : x written, then read D back (1 is the sample just written), interpolated when modulated
+	allPass,		// allPassFilter : yD read D back, x + g yD written, (1 - g^2) yD - g x
+	latticeAllPass,	// alternateAllPassFilter : yD read D back, t = x + g yD written, yD - g t
+	comb,			// CombFilter : yD read D back, x + g yD written, yD
+	lowpassComb,	// FCombFilter : yD read D back, lowpassed by p, x + (1 - p) g lp written, lp
+	onePole,		// x + p y(n-1)
+	tptLowpass,		// TPTOnePoleFilter lowpass, cutoff frequency
+	biquad,			// ClassicFilters, filterType at frequency and q, canonical form
+	lfo				// LFO normal output, waveform at frequency, no inputs
+};
+
+/// <summary>
+/// A constant, or a control of the topology : scale * control + offset
+/// </summary>
+struct TopologyValue
+{
+	TopologyValue(double pValue = 0.0) : value(pValue) {}
+
+	static TopologyValue control(const juce::String& pName, double pScale = 1.0, double pOffset = 0.0)
+	{
+		TopologyValue bound;
+		bound.controlName = pName;
+		bound.scale = pScale;
+		bound.offset = pOffset;
+		return bound;
+	}
+
+	bool isBound() const
+	{
+		return controlName.isNotEmpty();
+	}
+
+	double get(const vector<double>& controls) const
+	{
+		return controlIndex < 0 ? value : scale * controls[(size_t)controlIndex] + offset;
+	}
+
+	double value = 0.0;
+	juce::String controlName;
+	double scale = 1.0;
+	double offset = 0.0;
+	int controlIndex = -1; // resolved by the compiler
+};
+
+struct TopologyNode
+{
+	juce::String name;
+	TopologyNodeType type = TopologyNodeType::sum;
+
+	// delay, allPass, latticeAllPass, comb, lowpassComb : D = delay_ms * fs / 1000 + delayOffset_samples
+	TopologyValue delay_ms;
+	double delayOffset_samples = 0.0;
+	double maxDelay_ms = 0.0;			// buffer length when the delay or the modulation depth is bound to a control
+	juce::String modulator;				// lfo node moving the read position by modulationDepth_ms
+	TopologyValue modulationDepth_ms;
+
+	TopologyValue gain;					// allPass, latticeAllPass, comb, lowpassComb
+	TopologyValue pole;					// lowpassComb, onePole
+	TopologyValue frequency;			// tptLowpass, biquad, lfo
+	TopologyValue q = 0.707;			// biquad
+	ClassicFilterType filterType = ClassicFilterType::LPF1;
+	generatorWaveform waveform = generatorWaveform::kSin;
+};
+
+/// <summary>
+/// Connection, the gain applied to the source signal. A feedback edge reads the source output of the previous sample
+/// </summary>
+struct TopologyEdge
+{
+	juce::String source;
+	juce::String destination;
+	TopologyValue gain = 1.0;
+	bool feedback = false;
+};
+
+/// <summary>
+/// Output tap : the delay memory of the node read distance_samples back after the node ran (as readDelayLine(),
+/// 1 is the sample just written), or the node output when distance_samples is 0. channel 0 left, 1 right.
+/// With a referenceRate, distance_samples is given at that sample rate and scaled to the compiled one
+/// </summary>
+struct TopologyTap
+{
+	juce::String node;
+	unsigned int distance_samples = 0;
+	TopologyValue gain = 1.0;
+	int channel = 0;
+	double referenceRate = 0.0;
+};
+
+struct TopologyControl
+{
+	juce::String name;
+	double defaultValue = 0.0;
+};
+
+/// <summary>
+/// Reverb network : stereo in (mono input nodes), stereo out (taps), linear dry/wet mix on mixControl
+/// </summary>
+struct ReverbTopology
+{
+	juce::String name;
+	vector<TopologyControl> controls;
+	vector<TopologyNode> nodes;
+	vector<TopologyEdge> edges;
+	vector<TopologyTap> taps;
+	juce::String mixControl = "mix";
+};
+
+/// <summary>
+/// A ReverbTopology compiled into a flat schedule, processed in SampleType, see the CompiledReverb alias.
+/// reset() compiles and allocates, setControl() + updateParameters() recompute the coefficients only,
+/// processAudioFrame() runs the instructions. A topology that does not compile leaves the engine silent
+/// (dry signal through the mix) and getError() tells why.
+/// </summary>
+template <typename SampleType>
+class CompiledReverbT
+{
+public:
+	void setTopology(const ReverbTopology& pTopology)
+	{
+		topology = pTopology;
+		controls.clear();
+		for (auto& control : topology.controls)
+			controls.push_back(control.defaultValue);
+		compiled = false;
+	}
+
+	/// <summary>
+	/// Compiles the topology for the sample rate, clears every state
+	/// </summary>
+	/// <returns> false if the topology does not compile </returns>
+	bool reset(double pSampleRate)
+	{
+		sampleRate = pSampleRate;
+		samplesPerMsec = sampleRate / 1000.0;
+		error.clear();
+		compiled = compile();
+		if (!compiled)
+		{
+			instructions.clear();
+			taps.clear();
+			feedbackCopies.clear();
+		}
+		return compiled;
+	}
+
+	/// <summary>
+	/// Sets a control value, applied by the next updateParameters()
+	/// </summary>
+	void setControl(const juce::String& pName, double pValue)
+	{
+		auto index = getControlIndex(pName);
+		if (index >= 0)
+			controls[(size_t)index] = pValue;
+	}
+
+	/// <summary>
+	/// Recomputes the gains, delays and filter coefficients from the controls
+	/// </summary>
+	void updateParameters()
+	{
+		if (!compiled)
+			return;
+
+		for (size_t i = 0; i < inputGains.size(); ++i)
+			inputGains[i] = (SampleType)inputGainValues[i].get(controls);
+
+		for (size_t i = 0; i < instructions.size(); ++i)
+		{
+			auto& instruction = instructions[i];
+			auto& node = topology.nodes[(size_t)schedule[i]];
+			switch (instruction.type)
+			{
+			case TopologyNodeType::delay:
+			case TopologyNodeType::allPass:
+			case TopologyNodeType::latticeAllPass:
+			case TopologyNodeType::comb:
+			case TopologyNodeType::lowpassComb:
+			{
+				// reads stay inside the buffer, one sample is kept for the interpolation
+				auto maxDelay = (double)(instruction.mask - 1);
+				instruction.delay = juce::jlimit(1.0, maxDelay, node.delay_ms.get(controls) * samplesPerMsec + node.delayOffset_samples);
+				auto depth = std::abs(node.modulationDepth_ms.get(controls)) * samplesPerMsec;
+				instruction.modulationDepth = (SampleType)juce::jmin(depth, instruction.delay - 1.0, maxDelay - instruction.delay);
+				instruction.coefficients[0] = (SampleType)node.gain.get(controls);
+				auto p = node.pole.get(controls);
+				instruction.coefficients[1] = (SampleType)p;
+				if (instruction.type == TopologyNodeType::lowpassComb)
+					instruction.coefficients[0] = (SampleType)((1 - p) * node.gain.get(controls));
+				break;
+			}
+			case TopologyNodeType::onePole:
+				instruction.coefficients[1] = (SampleType)node.pole.get(controls);
+				break;
+			case TopologyNodeType::tptLowpass:
+			{
+				auto g = TPTGain::compute(node.frequency.get(controls), sampleRate);
+				instruction.coefficients[0] = (SampleType)(g / (1.0 + g));
+				break;
+			}
+			case TopologyNodeType::biquad:
+			{
+				auto& coefficients = biquadCoefficients[(size_t)instruction.state / 2];
+				coefficients.update(node.filterType, node.frequency.get(controls), node.q.get(controls), sampleRate);
+				instruction.coefficients[0] = (SampleType)coefficients.aCoeff[0];
+				instruction.coefficients[1] = (SampleType)coefficients.aCoeff[1];
+				instruction.coefficients[2] = (SampleType)coefficients.aCoeff[2];
+				instruction.coefficients[3] = (SampleType)coefficients.bCoeff[1];
+				instruction.coefficients[4] = (SampleType)coefficients.bCoeff[2];
+				break;
+			}
+			case TopologyNodeType::lfo:
+				lfos[(size_t)instruction.state].setParameters({ node.waveform, node.frequency.get(controls) });
+				break;
+			default:
+				break;
+			}
+		}
+
+		for (auto& tap : taps)
+			tap.gain = (SampleType)tap.gainValue.get(controls);
+		mix = mixIndex < 0 ? SampleType(1) : (SampleType)controls[(size_t)mixIndex];
+	}
+
+	/// <summary>
+	/// Processes one stereo frame (left, right) in place
+	/// </summary>
+	void processAudioFrame(SampleType* frame)
+	{
+		auto inL = frame[0], inR = frame[1];
+		SampleType wet[2] = { SampleType(0), SampleType(0) };
+
+		if (compiled)
+		{
+			SampleType* signal = signals.data();
+			SampleType* state = states.data();
+			const int* inputSlot = inputSlots.data();
+			const SampleType* inputGain = inputGains.data();
+
+			for (int i = 0; i < (int)instructions.size(); ++i)
+			{
+				const auto& instruction = instructions[(size_t)i];
+				SampleType x = SampleType(0);
+				for (int input = instruction.firstInput; input < instruction.firstInput + instruction.numInputs; ++input)
+					x += inputGain[input] * signal[inputSlot[input]];
+
+				SampleType* buffer = delayPool.data() + instruction.buffer;
+				auto mask = instruction.mask;
+				const auto* c = instruction.coefficients;
+				SampleType yn;
+
+				switch (instruction.type)
+				{
+				case TopologyNodeType::input:
+					yn = SampleType(0.5) * (inL + inR);
+					break;
+				case TopologyNodeType::delay:
+					buffer[writeIndex & mask] = x;
+					if (instruction.modulator < 0)
+						yn = buffer[(writeIndex + 1 - (unsigned int)instruction.delay) & mask];
+					else
+						yn = readFractional(buffer, mask, writeIndex + 1, getDelay(instruction));
+					break;
+				case TopologyNodeType::allPass:
+				{
+					auto g = c[0];
+					auto ynD = readFractional(buffer, mask, writeIndex, getDelay(instruction));
+					buffer[writeIndex & mask] = flushDenormal(x + ynD * g);
+					yn = (1 - g * g) * ynD + x * (-g);
+					break;
+				}
+				case TopologyNodeType::latticeAllPass:
+				{
+					auto g = c[0];
+					auto ynD = readFractional(buffer, mask, writeIndex, getDelay(instruction));
+					auto temp = flushDenormal(x + ynD * g);
+					buffer[writeIndex & mask] = temp;
+					yn = -g * temp + ynD;
+					break;
+				}
+				case TopologyNodeType::comb:
+				{
+					auto ynD = readFractional(buffer, mask, writeIndex, getDelay(instruction));
+					buffer[writeIndex & mask] = flushDenormal(x + c[0] * ynD);
+					yn = ynD;
+					break;
+				}
+				case TopologyNodeType::lowpassComb:
+				{
+					auto ynD = readFractional(buffer, mask, writeIndex, getDelay(instruction));
+					auto& y1 = state[instruction.state];
+					yn = flushDenormal(ynD + c[1] * y1);
+					y1 = yn;
+					buffer[writeIndex & mask] = flushDenormal(x + c[0] * yn);
+					break;
+				}
+				case TopologyNodeType::onePole:
+				{
+					auto& y1 = state[instruction.state];
+					yn = flushDenormal(x + c[1] * y1);
+					y1 = yn;
+					break;
+				}
+				case TopologyNodeType::tptLowpass:
+				{
+					auto& s = state[instruction.state];
+					auto v = (x - s) * c[0];
+					yn = v + s;
+					s = flushDenormal(yn + v);
+					break;
+				}
+				case TopologyNodeType::biquad:
+				{
+					auto* w = state + instruction.state;
+					auto wn = flushDenormal(x - c[3] * w[0] - c[4] * w[1]);
+					yn = c[0] * wn + c[1] * w[0] + c[2] * w[1];
+					w[1] = w[0];
+					w[0] = wn;
+					break;
+				}
+				case TopologyNodeType::lfo:
+					yn = (SampleType)lfos[(size_t)instruction.state].renderAudioOuput().normalOutput;
+					break;
+				default:
+					yn = x;
+					break;
+				}
+				signal[i] = yn;
+			}
+
+			for (const auto& tap : taps)
+			{
+				auto value = tap.mask == 0 ? signal[tap.slot] : delayPool[(size_t)tap.buffer + ((writeIndex + 1 - tap.distance) & tap.mask)];
+				wet[tap.channel] += tap.gain * value;
+			}
+
+			// previous sample values read by the feedback edges
+			for (const auto& copy : feedbackCopies)
+				signal[copy.second] = signal[copy.first];
+			++writeIndex;
+		}
+
+		frame[0] = (1 - mix) * inL + (mix) * wet[0];
+		frame[1] = (1 - mix) * inR + (mix) * wet[1];
+	}
+
+	const juce::String& getError() const
+	{
+		return error;
+	}
+
+	const ReverbTopology& getTopology() const
+	{
+		return topology;
+	}
+
+	/// <summary>
+	/// Node names in schedule order
+	/// </summary>
+	juce::StringArray getSchedule() const
+	{
+		juce::StringArray names;
+		for (auto node : schedule)
+			names.add(topology.nodes[(size_t)node].name);
+		return names;
+	}
+
+	/// <summary>
+	/// Samples of delay memory of the compiled topology
+	/// </summary>
+	size_t getDelayMemorySize() const
+	{
+		return delayPool.size();
+	}
+
+private:
+	/// <summary>
+	/// One node of the schedule. Its output goes to the signal slot of its schedule position
+	/// </summary>
+	struct Instruction
+	{
+		TopologyNodeType type = TopologyNodeType::sum;
+		int firstInput = 0, numInputs = 0;	// in inputSlots / inputGains
+		int buffer = 0;						// offset of the delay memory in the delay pool
+		unsigned int mask = 0;
+		int modulator = -1;					// signal slot of the modulating lfo
+		int state = 0;						// offset in the filter states, lfo index for the lfo nodes
+		double delay = 1.0;					// samples
+		SampleType modulationDepth = SampleType(0);		// samples
+		SampleType coefficients[5] = {};			// g, p, tpt G, or biquad a0 a1 a2 b1 b2
+	};
+
+	struct Tap
+	{
+		int slot = 0;
+		int buffer = 0;
+		unsigned int mask = 0;				// 0 : the node output
+		unsigned int distance = 0;
+		int channel = 0;
+		SampleType gain = SampleType(1);
+		TopologyValue gainValue;
+	};
+
+	static bool hasDelayMemory(TopologyNodeType type)
+	{
+		return type == TopologyNodeType::delay || type == TopologyNodeType::allPass || type == TopologyNodeType::latticeAllPass
+			|| type == TopologyNodeType::comb || type == TopologyNodeType::lowpassComb;
+	}
+
+	/// <summary>
+	/// Read distance of a tap at the compiled sample rate
+	/// </summary>
+	unsigned int getTapDistance(const TopologyTap& tap) const
+	{
+		if (tap.referenceRate <= 0.0 || tap.distance_samples == 0)
+			return tap.distance_samples;
+		return juce::jmax(1u, (unsigned int)std::round(tap.distance_samples * sampleRate / tap.referenceRate));
+	}
+
+	double getDelay(const Instruction& instruction) const
+	{
+		if (instruction.modulator < 0)
+			return instruction.delay;
+		return instruction.delay + instruction.modulationDepth * signals[(size_t)instruction.modulator];
+	}
+
+	/// <summary>
+	/// CircularBuffer::readBuffer(double) : delay samples back from position, linear interpolation
+	/// </summary>
+	static SampleType readFractional(const SampleType* buffer, unsigned int mask, unsigned int position, double delay)
+	{
+		auto whole = (unsigned int)delay;
+		auto y1 = buffer[(position - whole) & mask];
+		auto y2 = buffer[(position - whole - 1) & mask];
+		auto fraction = (SampleType)(delay - (int)delay);
+		if (fraction >= SampleType(1))
+			return y2;
+		return y1 + fraction * (y2 - y1);
+	}
+
+	int getControlIndex(const juce::String& pName) const
+	{
+		for (size_t i = 0; i < topology.controls.size(); ++i)
+			if (topology.controls[i].name == pName)
+				return (int)i;
+		return -1;
+	}
+
+	bool resolve(TopologyValue& value, const juce::String& where)
+	{
+		if (!value.isBound())
+			return true;
+		value.controlIndex = getControlIndex(value.controlName);
+		if (value.controlIndex < 0)
+			error = where + " : unknown control " + value.controlName;
+		return value.controlIndex >= 0;
+	}
+
+	/// <summary>
+	/// Orders the nodes (Kahn's algorithm, declaration order among the ready nodes, feedback edges ignored),
+	/// lays out the signals, the delay memory and the filter states in that order, builds the instructions
+	/// </summary>
+	bool compile()
+	{
+		auto numNodes = (int)topology.nodes.size();
+		auto findNode = [this, numNodes](const juce::String& name)
+		{
+			for (int i = 0; i < numNodes; ++i)
+				if (topology.nodes[(size_t)i].name == name)
+					return i;
+			return -1;
+		};
+
+		// names, controls
+		for (int i = 0; i < numNodes; ++i)
+		{
+			auto& node = topology.nodes[(size_t)i];
+			if (node.name.isEmpty() || findNode(node.name) != i)
+			{
+				error = "node " + juce::String(i) + " : empty or duplicated name";
+				return false;
+			}
+			for (auto* value : { &node.delay_ms, &node.modulationDepth_ms, &node.gain, &node.pole, &node.frequency, &node.q })
+				if (!resolve(*value, node.name))
+					return false;
+		}
+		mixIndex = getControlIndex(topology.mixControl);
+
+		// dependencies : non feedback edges and modulators
+		vector<vector<int>> dependents((size_t)numNodes);
+		vector<int> numDependencies((size_t)numNodes, 0);
+		vector<int> edgeSource, edgeDestination;
+		for (auto& edge : topology.edges)
+		{
+			auto source = findNode(edge.source), destination = findNode(edge.destination);
+			if (source < 0 || destination < 0)
+			{
+				error = "edge " + edge.source + " -> " + edge.destination + " : unknown node";
+				return false;
+			}
+			if (!resolve(edge.gain, edge.source + " -> " + edge.destination))
+				return false;
+			edgeSource.push_back(source);
+			edgeDestination.push_back(destination);
+			if (!edge.feedback)
+			{
+				dependents[(size_t)source].push_back(destination);
+				++numDependencies[(size_t)destination];
+			}
+		}
+		vector<int> modulators((size_t)numNodes, -1);
+		for (int i = 0; i < numNodes; ++i)
+		{
+			auto& node = topology.nodes[(size_t)i];
+			if (node.modulator.isEmpty())
+				continue;
+			auto modulator = findNode(node.modulator);
+			if (modulator < 0 || topology.nodes[(size_t)modulator].type != TopologyNodeType::lfo || !hasDelayMemory(node.type))
+			{
+				error = node.name + " : the modulator must be an lfo node, modulating a delay memory";
+				return false;
+			}
+			modulators[(size_t)i] = modulator;
+			dependents[(size_t)modulator].push_back(i);
+			++numDependencies[(size_t)i];
+		}
+
+		schedule.clear();
+		vector<bool> scheduled((size_t)numNodes, false);
+		while ((int)schedule.size() < numNodes)
+		{
+			auto next = -1;
+			for (int i = 0; i < numNodes && next < 0; ++i)
+				if (!scheduled[(size_t)i] && numDependencies[(size_t)i] == 0)
+					next = i;
+			if (next < 0)
+			{
+				for (int i = 0; i < numNodes; ++i)
+					if (!scheduled[(size_t)i])
+					{
+						error = "cycle through " + topology.nodes[(size_t)i].name + " without a feedback edge";
+						break;
+					}
+				return false;
+			}
+			scheduled[(size_t)next] = true;
+			schedule.push_back(next);
+			for (auto dependent : dependents[(size_t)next])
+				--numDependencies[(size_t)dependent];
+		}
+		vector<int> slotOf((size_t)numNodes);
+		for (int i = 0; i < numNodes; ++i)
+			slotOf[(size_t)schedule[(size_t)i]] = i;
+
+		// feedback edges read a copy of their source, made at the end of the sample
+		feedbackCopies.clear();
+		vector<int> feedbackSlot((size_t)numNodes, -1);
+		for (size_t e = 0; e < topology.edges.size(); ++e)
+		{
+			auto source = edgeSource[e];
+			if (topology.edges[e].feedback && feedbackSlot[(size_t)source] < 0)
+			{
+				feedbackSlot[(size_t)source] = numNodes + (int)feedbackCopies.size();
+				feedbackCopies.push_back({ slotOf[(size_t)source], feedbackSlot[(size_t)source] });
+			}
+		}
+		signals.assign((size_t)numNodes + feedbackCopies.size(), SampleType(0));
+
+		// read distances of the taps, per node
+		vector<unsigned int> longestTap((size_t)numNodes, 0);
+		for (auto& tap : topology.taps)
+		{
+			auto node = findNode(tap.node);
+			if (node < 0 || tap.channel < 0 || tap.channel > 1)
+			{
+				error = "tap " + tap.node + " : unknown node or channel";
+				return false;
+			}
+			if (tap.distance_samples > 0 && !hasDelayMemory(topology.nodes[(size_t)node].type))
+			{
+				error = "tap " + tap.node + " : the node has no delay memory";
+				return false;
+			}
+			longestTap[(size_t)node] = juce::jmax(longestTap[(size_t)node], getTapDistance(tap));
+		}
+
+		// instructions, inputs grouped per instruction, memories in schedule order
+		instructions.assign((size_t)numNodes, Instruction());
+		inputSlots.clear();
+		inputGainValues.clear();
+		lfos.clear();
+		biquadCoefficients.clear();
+		size_t poolSize = 0, numStates = 0;
+		vector<int> bufferOf((size_t)numNodes, 0);
+		vector<unsigned int> maskOf((size_t)numNodes, 0);
+		for (int i = 0; i < numNodes; ++i)
+		{
+			auto nodeIndex = schedule[(size_t)i];
+			auto& node = topology.nodes[(size_t)nodeIndex];
+			auto& instruction = instructions[(size_t)i];
+			instruction.type = node.type;
+			instruction.firstInput = (int)inputSlots.size();
+			for (size_t e = 0; e < topology.edges.size(); ++e)
+			{
+				if (edgeDestination[e] != nodeIndex)
+					continue;
+				auto source = edgeSource[e];
+				inputSlots.push_back(topology.edges[e].feedback ? feedbackSlot[(size_t)source] : slotOf[(size_t)source]);
+				inputGainValues.push_back(topology.edges[e].gain);
+			}
+			instruction.numInputs = (int)inputSlots.size() - instruction.firstInput;
+			instruction.modulator = modulators[(size_t)nodeIndex] < 0 ? -1 : slotOf[(size_t)modulators[(size_t)nodeIndex]];
+
+			if (hasDelayMemory(node.type))
+			{
+				if ((node.delay_ms.isBound() || node.modulationDepth_ms.isBound()) && node.maxDelay_ms <= 0.0)
+				{
+					error = node.name + " : a delay bound to a control needs maxDelay_ms";
+					return false;
+				}
+				auto longest = node.maxDelay_ms > 0.0 ? node.maxDelay_ms : node.delay_ms.value + std::abs(node.modulationDepth_ms.value);
+				auto longestRead = juce::jmax(longest * samplesPerMsec + node.delayOffset_samples + 2.0, (double)longestTap[(size_t)nodeIndex] + 1.0);
+				unsigned int length = 1;
+				while (length < (unsigned int)longestRead + 1)
+					length *= 2;
+				instruction.buffer = (int)poolSize;
+				instruction.mask = length - 1;
+				bufferOf[(size_t)nodeIndex] = instruction.buffer;
+				maskOf[(size_t)nodeIndex] = instruction.mask;
+				poolSize += length;
+			}
+			if (node.type == TopologyNodeType::lowpassComb || node.type == TopologyNodeType::onePole || node.type == TopologyNodeType::tptLowpass)
+				instruction.state = (int)numStates++;
+			else if (node.type == TopologyNodeType::biquad)
+			{
+				// even offsets : biquadCoefficients[state / 2]
+				numStates += numStates % 2;
+				instruction.state = (int)numStates;
+				numStates += 2;
+				biquadCoefficients.resize(numStates / 2);
+			}
+			else if (node.type == TopologyNodeType::lfo)
+			{
+				instruction.state = (int)lfos.size();
+				lfos.emplace_back();
+				lfos.back().reset(sampleRate);
+			}
+		}
+		delayPool.assign(poolSize, SampleType(0));
+		states.assign(numStates, SampleType(0));
+		inputGains.assign(inputSlots.size(), SampleType(0));
+		writeIndex = 0;
+
+		taps.clear();
+		for (auto& topologyTap : topology.taps)
+		{
+			auto node = findNode(topologyTap.node);
+			Tap tap;
+			tap.slot = slotOf[(size_t)node];
+			tap.channel = topologyTap.channel;
+			tap.gainValue = topologyTap.gain;
+			if (!resolve(tap.gainValue, "tap " + topologyTap.node))
+				return false;
+			if (topologyTap.distance_samples > 0)
+			{
+				tap.buffer = bufferOf[(size_t)node];
+				tap.mask = maskOf[(size_t)node];
+				tap.distance = getTapDistance(topologyTap);
+			}
+			taps.push_back(tap);
+		}
+
+		compiled = true;
+		updateParameters();
+		return true;
+	}
+
+	ReverbTopology topology;
+	vector<double> controls;
+	double sampleRate = 44100.0;
+	double samplesPerMsec = 44.1;
+	bool compiled = false;
+	juce::String error;
+
+	// compiled schedule
+	vector<int> schedule;							// node index of each instruction
+	vector<Instruction> instructions;
+	vector<int> inputSlots;
+	vector<SampleType> inputGains;
+	vector<TopologyValue> inputGainValues;
+	vector<std::pair<int, int>> feedbackCopies;		// source slot, feedback slot
+	vector<Tap> taps;
+	int mixIndex = -1;
+	SampleType mix = SampleType(1);
+
+	// memories, in schedule order
+	vector<SampleType> signals;
+	vector<SampleType> delayPool;
+	vector<SampleType> states;
+	vector<LFO> lfos;
+	vector<BiquadCoefficients> biquadCoefficients;
+	unsigned int writeIndex = 0;
+};
+
+/// <summary>
+/// Single precision engine, as the plugins
+/// </summary>
+using CompiledReverb = CompiledReverbT<float>;
@@ -0,0 +1,431 @@
+#pragma once
+#include <JuceHeader.h>
+#include <vector>
+#include <cmath>
+#include <memory>
+#include <atomic>
+
+using std::vector;
+
+// =============================================================================
+// Test signal generators
+// Exponential sine sweeps, maximum length sequences, impulses, multitones and
+// a sine tone, rendered by blocks. Everything that can be precomputed is held
+// in tables built off the audio thread : rendering a block is then a copy.
+// =============================================================================
+
+/// Enumerates the test signals of the SignalGenerator class
+enum class testSignalType { kSine, kExponentialSweep, kMLS, kImpulse, kMultitone };
+
+/// <summary>
+/// Parameters of the SignalGenerator
+/// </summary>
+struct SignalGeneratorParameters
+{
+	testSignalType signalType = testSignalType::kSine;
+	double frequency_Hz = 1000.0;		// sine frequency
+	double sweepStart_Hz = 20.0;		// exponential sweep start frequency
+	double sweepEnd_Hz = 20000.0;		// exponential sweep end frequency
+	double sweepLength_s = 5.0;			// exponential sweep duration
+	unsigned int mlsOrder = 16;			// MLS period is 2^order - 1 samples
+	double impulsePeriod_s = 0.0;		// 0.0 : a single impulse, otherwise an impulse train
+	unsigned int numberOfTones = 16;	// multitone : log spaced tones between sweepStart_Hz and sweepEnd_Hz
+	bool loop = false;					// loops the sweep, otherwise the sweep is a one shot
+};
+
+/// <summary>
+/// Maximal length LFSR taps (Xilinx XAPP052), for orders 2 to 24
+/// </summary>
+static const vector<vector<unsigned int>> mlsTaps = {
+	{}, {}, { 2, 1 }, { 3, 2 }, { 4, 3 }, { 5, 3 }, { 6, 5 }, { 7, 6 }, { 8, 6, 5, 4 }, { 9, 5 }, { 10, 7 }, { 11, 9 },
+	{ 12, 6, 4, 1 }, { 13, 4, 3, 1 }, { 14, 5, 3, 1 }, { 15, 14 }, { 16, 15, 13, 4 }, { 17, 14 }, { 18, 11 },
+	{ 19, 6, 2, 1 }, { 20, 17 }, { 21, 19 }, { 22, 21 }, { 23, 18 }, { 24, 23, 22, 17 } };
+
+/// <summary>
+/// Creates one period of a maximum length sequence, values are +1 / -1
+/// </summary>
+/// <param name="order">The order of the LFSR, between 2 and 24.</param>
+/// <returns>2^order - 1 samples</returns>
+inline vector<float> createMaximumLengthSequence(unsigned int order)
+{
+	order = juce::jlimit(2u, 24u, order);
+	unsigned int feedbackMask = 0;
+	for (auto tap : mlsTaps[order])
+		feedbackMask |= 1u << (tap - 1);
+
+	auto length = (1u << order) - 1;
+	vector<float> sequence(length);
+
+	// Galois LFSR, any non zero seed goes through all 2^order - 1 states
+	unsigned int state = 1;
+	for (unsigned int n = 0; n < length; ++n)
+	{
+		auto bit = state & 1u;
+		sequence[n] = bit ? 1.0f : -1.0f;
+		state >>= 1;
+		if (bit)
+			state ^= feedbackMask;
+	}
+	return sequence;
+}
+
+/// <summary>
+/// Creates an exponential (logarithmic) sine sweep, as described by A. Farina (2000)
+/// x(t) = sin(K * (exp(t / L) - 1)) with L = T / ln(f2 / f1) and K = 2 pi f1 L.
+/// Short half-Hann fades avoid clicks at both ends.
+/// </summary>
+inline vector<float> createExponentialSweep(double pSampleRate, double f1, double f2, double lengthSeconds)
+{
+	f2 = juce::jmin(f2, 0.5 * pSampleRate);
+	f1 = juce::jlimit(1.0, f2, f1);
+	auto length = juce::jmax(1, (int)(lengthSeconds * pSampleRate));
+	vector<float> sweep(length);
+
+	auto T = length / pSampleRate;
+	auto L = T / std::log(f2 / f1);
+	auto K = juce::MathConstants<double>::twoPi * f1 * L;
+
+	for (int n = 0; n < length; ++n)
+		sweep[n] = (float)std::sin(K * (std::exp(n / pSampleRate / L) - 1.0));
+
+	// fades : 5 ms in, 1 ms out
+	auto fadeIn = juce::jmin(length / 2, (int)(0.005 * pSampleRate));
+	auto fadeOut = juce::jmin(length / 2, (int)(0.001 * pSampleRate));
+	for (int n = 0; n < fadeIn; ++n)
+		sweep[n] *= (float)(0.5 - 0.5 * std::cos(juce::MathConstants<double>::pi * n / fadeIn));
+	for (int n = 0; n < fadeOut; ++n)
+		sweep[length - 1 - n] *= (float)(0.5 - 0.5 * std::cos(juce::MathConstants<double>::pi * n / fadeOut));
+
+	return sweep;
+}
+
+/// <summary>
+/// Creates one period of a multitone signal. Tone frequencies are log spaced and snapped
+/// to multiples of sampleRate / period, so the table loops seamlessly. Schroeder phases keep the crest factor low.
+/// </summary>
+inline vector<float> createMultitone(double pSampleRate, double f1, double f2, unsigned int numberOfTones, unsigned int period)
+{
+	vector<float> table(period, 0.0f);
+	auto binWidth = pSampleRate / period;
+	f2 = juce::jmin(f2, 0.45 * pSampleRate);
+	f1 = juce::jlimit(binWidth, f2, f1);
+	numberOfTones = juce::jmax(1u, numberOfTones);
+
+	// log spaced bins, duplicates are skipped
+	vector<unsigned int> bins;
+	for (unsigned int k = 0; k < numberOfTones; ++k)
+	{
+		auto f = numberOfTones > 1 ? f1 * std::pow(f2 / f1, (double)k / (numberOfTones - 1)) : f1;
+		auto bin = (unsigned int) juce::jmax(1.0, std::round(f / binWidth));
+		if (bins.empty() || bin != bins.back())
+			bins.push_back(bin);
+	}
+
+	vector<double> sum(period, 0.0);
+	auto N = (double) bins.size();
+	for (size_t k = 0; k < bins.size(); ++k)
+	{
+		auto phase = -juce::MathConstants<double>::pi * (k + 1) * k / N;
+		auto w = juce::MathConstants<double>::twoPi * bins[k] / period;
+		for (unsigned int n = 0; n < period; ++n)
+			sum[n] += std::cos(w * n + phase);
+	}
+
+	// normalise the peak to 1
+	double peak = 1e-12;
+	for (auto s : sum)
+		peak = juce::jmax(peak, std::abs(s));
+	for (unsigned int n = 0; n < period; ++n)
+		table[n] = (float)(sum[n] / peak);
+
+	return table;
+}
+
+/// <summary>
+/// Test signal generator : sine (recursive oscillator), exponential sweep, MLS, impulse and multitone (tables).
+/// setParameters() builds the tables and should not be called from the audio thread,
+/// start(), stop() and renderBlock() are real-time safe. Starts and stops take effect on the next rendered sample,
+/// hence splitting the block at the event position gives sample accurate starts and stops.
+/// The settings reach the audio thread through a triple buffer : neither thread ever waits for the other.
+/// </summary>
+class SignalGenerator
+{
+public:
+	/// <summary>
+	/// Resets the generator to a new sample rate and rebuilds the tables
+	/// </summary>
+	/// <param name="pSampleRate"></param>
+	void reset(double pSampleRate)
+	{
+		sampleRate = pSampleRate;
+		tablesValid = false;
+		setParameters(parameters);
+	}
+
+	/// <summary>
+	/// Sets the generator parameters, tables are rebuilt only when their parameters changed.
+	/// Allocates : call from the message thread or from prepareToPlay()
+	/// </summary>
+	/// <param name="pParameters"></param>
+	void setParameters(SignalGeneratorParameters pParameters)
+	{
+		if (!tablesValid || tableParametersChanged(pParameters))
+		{
+			vector<float> newTable;
+			switch (pParameters.signalType)
+			{
+			case testSignalType::kExponentialSweep:
+				newTable = createExponentialSweep(sampleRate, pParameters.sweepStart_Hz, pParameters.sweepEnd_Hz, pParameters.sweepLength_s);
+				break;
+			case testSignalType::kMLS:
+				newTable = createMaximumLengthSequence(pParameters.mlsOrder);
+				break;
+			case testSignalType::kMultitone:
+				newTable = createMultitone(sampleRate, pParameters.sweepStart_Hz, pParameters.sweepEnd_Hz, pParameters.numberOfTones,
+					sampleRate > 50000.0 ? 1u << 17 : 1u << 16);
+				break;
+			default:
+				break;
+			}
+			latestTable = std::make_shared<const vector<float>>(std::move(newTable));
+			tablesValid = true;
+		}
+		parameters = pParameters;
+
+		// the state no thread reads : the table is shared, a table no state holds anymore is released on this thread
+		auto& state = states[writeState];
+		state.parameters = parameters;
+		state.table = latestTable;
+		// sine : rotation coefficients of the recursive oscillator
+		auto w = juce::MathConstants<double>::twoPi * juce::jlimit(0.0, 0.5 * sampleRate, parameters.frequency_Hz) / sampleRate;
+		state.cosW = std::cos(w);
+		state.sinW = std::sin(w);
+		state.impulsePeriod = (unsigned int)(parameters.impulsePeriod_s * sampleRate);
+
+		// published for the next renderBlock(), the previously published one (if not picked up) is written next time
+		writeState = readyState.exchange(writeState | newStateFlag, std::memory_order_acq_rel) & stateIndexMask;
+	}
+
+	/// <summary>
+	/// Starts the signal from its beginning, from any thread
+	/// </summary>
+	void start()
+	{
+		pendingCommand.store(Command::start, std::memory_order_release);
+	}
+
+	/// <summary>
+	/// Stops the signal, the generator outputs silence until the next start(). From any thread
+	/// </summary>
+	void stop()
+	{
+		pendingCommand.store(Command::stop, std::memory_order_release);
+	}
+
+	bool isActive() const
+	{
+		return active.load(std::memory_order_relaxed);
+	}
+
+	/// <summary>
+	/// Returns the current table (sweep, MLS period or multitone period), used by the deconvolution tools.
+	/// Message thread
+	/// </summary>
+	const vector<float>& getTable() const
+	{
+		return *latestTable;
+	}
+
+	/// <summary>
+	/// Renders numSamples samples of the selected test signal
+	/// </summary>
+	/// <param name="output"></param>
+	/// <param name="numSamples"></param>
+	void renderBlock(float* output, int numSamples)
+	{
+		acquireState();
+		applyCommand();
+		if (!active.load(std::memory_order_relaxed))
+		{
+			std::fill(output, output + numSamples, 0.0f);
+			return;
+		}
+
+		const auto& state = states[readState];
+		switch (state.parameters.signalType)
+		{
+		case testSignalType::kSine:
+			renderSine(state, output, numSamples);
+			break;
+		case testSignalType::kImpulse:
+			renderImpulse(state, output, numSamples);
+			break;
+		case testSignalType::kExponentialSweep:
+			renderTable(*state.table, output, numSamples, state.parameters.loop);
+			break;
+		case testSignalType::kMLS:
+		case testSignalType::kMultitone:
+			renderTable(*state.table, output, numSamples, true);
+			break;
+		}
+	}
+
+private:
+	/// <summary>
+	/// Everything the rendering reads from the parameters, built by setParameters()
+	/// </summary>
+	struct GeneratorState
+	{
+		SignalGeneratorParameters parameters;
+		std::shared_ptr<const vector<float>> table = std::make_shared<const vector<float>>();
+		double cosW = 1.0, sinW = 0.0;
+		unsigned int impulsePeriod = 0;
+	};
+
+	enum class Command { none, start, stop };
+
+	/// <summary>
+	/// Audio thread : takes the last published state, if any. The table restarts when it changed
+	/// </summary>
+	void acquireState()
+	{
+		if ((readyState.load(std::memory_order_relaxed) & newStateFlag) == 0)
+			return;
+		auto previousTable = states[readState].table.get();
+		readState = readyState.exchange(readState, std::memory_order_acq_rel) & stateIndexMask;
+		if (states[readState].table.get() != previousTable)
+			tableIndex = 0;
+	}
+
+	/// <summary>
+	/// Audio thread : applies the last start() or stop()
+	/// </summary>
+	void applyCommand()
+	{
+		auto command = pendingCommand.exchange(Command::none, std::memory_order_acquire);
+		if (command == Command::stop)
+			active.store(false, std::memory_order_relaxed);
+		else if (command == Command::start)
+		{
+			tableIndex = 0;
+			impulseCounter = 0;
+			oscX = 1.0;
+			oscY = 0.0;
+			active.store(true, std::memory_order_relaxed);
+		}
+	}
+
+	/// <summary>
+	/// Recursive quadrature oscillator (rotation of the (x, y) vector), renormalised once per block
+	/// </summary>
+	void renderSine(const GeneratorState& state, float* output, int numSamples)
+	{
+		auto cosW = state.cosW, sinW = state.sinW;
+		auto x = oscX, y = oscY;
+		for (int n = 0; n < numSamples; ++n)
+		{
+			output[n] = (float) y;
+			auto xn = cosW * x - sinW * y;
+			y = sinW * x + cosW * y;
+			x = xn;
+		}
+		// first order correction of the amplitude drift
+		auto g = 1.5 - 0.5 * (x * x + y * y);
+		oscX = g * x;
+		oscY = g * y;
+	}
+
+	/// <summary>
+	/// A single impulse at start, or an impulse train when impulsePeriod_s > 0
+	/// </summary>
+	void renderImpulse(const GeneratorState& state, float* output, int numSamples)
+	{
+		std::fill(output, output + numSamples, 0.0f);
+		for (int n = 0; n < numSamples; ++n)
+		{
+			if (impulseCounter == 0)
+				output[n] = 1.0f;
+			++impulseCounter;
+			if (state.impulsePeriod == 0)
+			{
+				// single impulse : nothing left to render
+				active.store(false, std::memory_order_relaxed);
+				return;
+			}
+			if (impulseCounter >= state.impulsePeriod)
+				impulseCounter = 0;
+		}
+	}
+
+	/// <summary>
+	/// Copies the table to the output, by contiguous segments
+	/// </summary>
+	void renderTable(const vector<float>& table, float* output, int numSamples, bool wrap)
+	{
+		auto length = table.size();
+		int n = 0;
+		while (n < numSamples && length > 0)
+		{
+			auto count = (size_t) juce::jmin((size_t)(numSamples - n), length - tableIndex);
+			std::copy(table.begin() + tableIndex, table.begin() + tableIndex + count, output + n);
+			n += (int) count;
+			tableIndex += count;
+			if (tableIndex >= length)
+			{
+				tableIndex = 0;
+				if (!wrap)
+				{
+					active.store(false, std::memory_order_relaxed);
+					break;
+				}
+			}
+		}
+		std::fill(output + n, output + numSamples, 0.0f);
+	}
+
+	/// <summary>
+	/// Checks whether the table needs to be rebuilt for the new parameters
+	/// </summary>
+	bool tableParametersChanged(const SignalGeneratorParameters& p) const
+	{
+		if (p.signalType != parameters.signalType)
+			return true;
+		switch (p.signalType)
+		{
+		case testSignalType::kExponentialSweep:
+			return p.sweepStart_Hz != parameters.sweepStart_Hz || p.sweepEnd_Hz != parameters.sweepEnd_Hz
+				|| p.sweepLength_s != parameters.sweepLength_s;
+		case testSignalType::kMLS:
+			return p.mlsOrder != parameters.mlsOrder;
+		case testSignalType::kMultitone:
+			return p.sweepStart_Hz != parameters.sweepStart_Hz || p.sweepEnd_Hz != parameters.sweepEnd_Hz
+				|| p.numberOfTones != parameters.numberOfTones;
+		default:
+			return false;
+		}
+	}
+
+	static constexpr int stateIndexMask = 3;
+	static constexpr int newStateFlag = 4;
+
+	double sampleRate = 44100.0;
+
+	// message thread
+	SignalGeneratorParameters parameters;
+	std::shared_ptr<const vector<float>> latestTable = std::make_shared<const vector<float>>();
+	bool tablesValid = false;
+
+	// triple buffer : one state written by setParameters(), one read by renderBlock(), the last published one between
+	GeneratorState states[3];
+	int writeState = 0;								// message thread
+	int readState = 1;								// audio thread
+	std::atomic<int> readyState{ 2 };				// index, with newStateFlag until renderBlock() takes it
+
+	// audio thread
+	size_t tableIndex = 0;
+	double oscX = 1.0, oscY = 0.0;					// recursive oscillator state
+	unsigned int impulseCounter = 0;
+
+	std::atomic<Command> pendingCommand{ Command::none };
+	std::atomic<bool> active{ false };
+};
@@ -0,0 +1,138 @@
+#pragma once
+#include <JuceHeader.h>
+#include <cmath>
+#include <limits>
+
+// =============================================================================
+// Silence detection
+// Tail lengths of recursive structures, and an idle state skipping an engine once its input is silent and its tail has rung out
+// =============================================================================
+
+/// <summary>
+/// Range over which a tail is measured : a full scale input decays to the silence threshold
+/// </summary>
+constexpr double tailDecay_dB = 100.0;
+
+/// <summary>
+/// Tails longer than this are reported as infinite
+/// </summary>
+constexpr double maxTailLength_s = 600.0;
+
+/// <summary>
+/// Time for a feedback loop to decay by decay_dB : the signal is multiplied by loopGain every loopDelay_s,
+/// t = loopDelay_s * decay_dB / (-20 log10 |loopGain|). Infinite if |loopGain| >= 1.
+/// Also the ringing time of a comb or an allpass filter (loopGain : feedback gain, loopDelay_s : delay time)
+/// </summary>
+inline double getFeedbackDecayTime(double loopGain, double loopDelay_s, double decay_dB = tailDecay_dB)
+{
+	auto gain = std::abs(loopGain);
+	if (gain >= 1.0)
+		return std::numeric_limits<double>::infinity();
+	if (gain <= 1.0e-9 || loopDelay_s <= 0.0)
+		return 0.0;
+	return loopDelay_s * decay_dB / (-20.0 * std::log10(gain));
+}
+
+/// <summary>
+/// Clamps a tail length for the host : infinity beyond maxTailLength_s
+/// </summary>
+inline double limitTailLength(double tail_s)
+{
+	if (!(tail_s < maxTailLength_s))
+		return std::numeric_limits<double>::infinity();
+	return juce::jmax(0.0, tail_s);
+}
+
+/// <summary>
+/// Silence detection settings
+/// </summary>
+struct SilenceDetectorParameters
+{
+	double threshold_dB = -tailDecay_dB;		// input and output peaks below this level are silence
+};
+
+/// <summary>
+/// Decides, block by block, whether a recursive engine has to be processed.
+/// The engine becomes idle once its input has been silent for its whole tail length and its last output
+/// block is silent too (the computed tail is an estimate, the output check catches what it misses).
+/// While idle the engine is not run and its output is zero ; any input above the threshold wakes it up.
+/// Audio thread only, no allocation.
+/// </summary>
+class SilenceDetector
+{
+public:
+	void setParameters(SilenceDetectorParameters pParameters)
+	{
+		parameters = pParameters;
+		threshold = juce::Decibels::decibelsToGain((float)parameters.threshold_dB, -200.0f);
+	}
+
+	/// <summary>
+	/// The engine is active after a reset
+	/// </summary>
+	void reset(double pSampleRate)
+	{
+		sampleRate = pSampleRate;
+		threshold = juce::Decibels::decibelsToGain((float)parameters.threshold_dB, -200.0f);
+		silentSamples = 0;
+		idle = false;
+	}
+
+	/// <summary>
+	/// Tail length of the engine with its current settings, infinite : never idle
+	/// </summary>
+	void setTailLength(double tail_s)
+	{
+		tailSamples = std::isfinite(tail_s) ? (int64_t)std::ceil(juce::jmax(0.0, tail_s) * sampleRate)
+			: std::numeric_limits<int64_t>::max();
+	}
+
+	/// <summary>
+	/// Before the engine : checks the input block
+	/// </summary>
+	/// <returns> true if the engine has to process the block, false if it is idle (its output is to be zeroed) </returns>
+	bool processInput(const float* left, const float* right, int numSamples)
+	{
+		if (getPeak(left, right, numSamples) > threshold)
+		{
+			silentSamples = 0;
+			idle = false;
+			return true;
+		}
+		if (idle)
+			return false;
+		if (silentSamples < tailSamples)
+			silentSamples += numSamples;
+		return true;
+	}
+
+	/// <summary>
+	/// After the engine : checks its output block, the engine goes idle if its tail has rung out
+	/// </summary>
+	void processOutput(const float* left, const float* right, int numSamples)
+	{
+		if (silentSamples >= tailSamples && getPeak(left, right, numSamples) <= threshold)
+			idle = true;
+	}
+
+	bool isIdle() const
+	{
+		return idle;
+	}
+
+private:
+	static float getPeak(const float* left, const float* right, int numSamples)
+	{
+		float peak = 0.0f;
+		for (int i = 0; i < numSamples; ++i)
+			peak = juce::jmax(peak, std::abs(left[i]), std::abs(right[i]));
+		return peak;
+	}
+
+	SilenceDetectorParameters parameters;
+	double sampleRate = 44100.0;
+	float threshold = 1.0e-5f;
+	int64_t tailSamples = 0;
+	int64_t silentSamples = 0;
+	bool idle = false;
+};
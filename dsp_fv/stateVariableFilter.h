@@ -0,0 +1,256 @@
+#pragma once
+#include <JuceHeader.h>
+#include <cmath>
+#include "denormals.h"
+
+// =============================================================================
+// Topology preserving transform (TPT, zero delay feedback) filters
+// trapezoidal integrators : the cutoff can change every sample, the filters stay stable
+// =============================================================================
+
+/// <summary>
+/// Prewarped integrator gain of the TPT filters, g = tan(pi * fc / fs)
+/// </summary>
+struct TPTGain
+{
+	/// <summary>
+	/// Exact gain, the cutoff is limited to [0, 0.49 fs]
+	/// </summary>
+	static double compute(double cornerFreq, double sampleRate)
+	{
+		return std::tan(getAngle(cornerFreq, sampleRate));
+	}
+
+	/// <summary>
+	/// Fast gain, safe to compute every sample : [7/6] Pade approximant of tan, relative error below 1e-7 up to 0.49 fs
+	/// </summary>
+	static double computeFast(double cornerFreq, double sampleRate)
+	{
+		auto x = getAngle(cornerFreq, sampleRate);
+		auto x2 = x * x;
+		return x * (135135.0 - x2 * (17325.0 - x2 * (378.0 - x2))) / (135135.0 - x2 * (62370.0 - x2 * (3150.0 - 28.0 * x2)));
+	}
+
+private:
+	static double getAngle(double cornerFreq, double sampleRate)
+	{
+		return juce::MathConstants<double>::pi * juce::jlimit(0.0, 0.49, cornerFreq / sampleRate);
+	}
+};
+
+/// <summary>
+/// The four outputs of the state variable filter, computed together
+/// </summary>
+template <typename SampleType>
+struct SVFOutputsT
+{
+	SampleType lowpass = SampleType(0);
+	SampleType highpass = SampleType(0);
+	SampleType bandpass = SampleType(0);
+	SampleType notch = SampleType(0);
+};
+
+enum class SVFOutputType { lowpass, highpass, bandpass, notch };
+
+/// <summary>
+/// Second order TPT state variable filter (Zavalishin, Simper).
+/// Lowpass, highpass, bandpass and notch outputs are computed together, for one channel.
+/// setCutoffFrequencyFast() updates the cutoff with a tan approximation, cheap enough to run every sample.
+/// The gain is designed in double, the coefficients, the states and the arithmetic are in SampleType,
+/// see the TPTStateVariableFilter alias
+/// </summary>
+template <typename SampleType>
+class TPTStateVariableFilterT
+{
+public:
+	/// <summary>
+	/// Sets the sample rate and clears the filter state
+	/// </summary>
+	void reset(double pSampleRate)
+	{
+		sampleRate = pSampleRate;
+		ic1eq = ic2eq = SampleType(0);
+		updateCoefficients(TPTGain::compute(cornerFreq, sampleRate));
+	}
+
+	/// <summary>
+	/// Sets the cutoff frequency and the quality factor, exact tan
+	/// </summary>
+	void setParameters(double pCornerFreq, double pQualityFactor)
+	{
+		cornerFreq = pCornerFreq;
+		damping = 1.0 / juce::jmax(0.01, pQualityFactor);
+		k = (SampleType)damping;
+		updateCoefficients(TPTGain::compute(cornerFreq, sampleRate));
+	}
+
+	/// <summary>
+	/// Sets the cutoff frequency only, with the tan approximation : for per sample modulation
+	/// </summary>
+	void setCutoffFrequencyFast(double pCornerFreq)
+	{
+		cornerFreq = pCornerFreq;
+		updateCoefficients(TPTGain::computeFast(cornerFreq, sampleRate));
+	}
+
+	/// <summary>
+	/// Output returned by processAudioSample() and processBlock()
+	/// </summary>
+	void setOutputType(SVFOutputType type)
+	{
+		outputType = type;
+	}
+
+	/// <summary>
+	/// Processes one sample, returns the four outputs
+	/// </summary>
+	SVFOutputsT<SampleType> processAllOutputs(SampleType xn)
+	{
+		auto v3 = xn - ic2eq;
+		auto v1 = a1 * ic1eq + a2 * v3;
+		auto v2 = ic2eq + a2 * ic1eq + a3 * v3;
+		ic1eq = flushDenormal(SampleType(2) * v1 - ic1eq);
+		ic2eq = flushDenormal(SampleType(2) * v2 - ic2eq);
+
+		SVFOutputsT<SampleType> outputs;
+		outputs.lowpass = v2;
+		outputs.bandpass = v1;
+		outputs.highpass = xn - k * v1 - v2;
+		outputs.notch = xn - k * v1;
+		return outputs;
+	}
+
+	/// <summary>
+	/// Processes one sample, returns the selected output (setOutputType())
+	/// </summary>
+	SampleType processAudioSample(SampleType xn)
+	{
+		auto outputs = processAllOutputs(xn);
+		switch (outputType)
+		{
+		case SVFOutputType::highpass: return outputs.highpass;
+		case SVFOutputType::bandpass: return outputs.bandpass;
+		case SVFOutputType::notch: return outputs.notch;
+		default: return outputs.lowpass;
+		}
+	}
+
+	/// <summary>
+	/// Processes a block, selected output. input and output may be the same buffer
+	/// </summary>
+	void processBlock(const SampleType* input, SampleType* output, int numSamples)
+	{
+		for (int sample = 0; sample < numSamples; ++sample)
+			output[sample] = processAudioSample(input[sample]);
+	}
+
+	/// <summary>
+	/// Processes a block with a cutoff frequency per sample (fast coefficient updates)
+	/// </summary>
+	void processBlock(const SampleType* input, SampleType* output, const float* cutoffFrequencies, int numSamples)
+	{
+		for (int sample = 0; sample < numSamples; ++sample)
+		{
+			setCutoffFrequencyFast(cutoffFrequencies[sample]);
+			output[sample] = processAudioSample(input[sample]);
+		}
+	}
+
+private:
+	void updateCoefficients(double g)
+	{
+		auto h = 1.0 / (1.0 + g * (g + damping));
+		a1 = (SampleType)h;
+		a2 = (SampleType)(g * h);
+		a3 = (SampleType)(g * g * h);
+	}
+
+	double sampleRate = 44100.0;
+	double cornerFreq = 1000.0;
+	double damping = 1.41421356237; // 1 / Q, Q = 0.707, the design value of k
+	SampleType k = SampleType(1.41421356237);
+	SampleType a1 = SampleType(1), a2 = SampleType(0), a3 = SampleType(0);
+	SampleType ic1eq = SampleType(0), ic2eq = SampleType(0); // integrators states
+	SVFOutputType outputType = SVFOutputType::lowpass;
+};
+
+/// <summary>
+/// First order TPT filter, lowpass and highpass outputs.
+/// Same response as the ClassicFilters LPF1 and HPF1 (bilinear transform, prewarped), but modulation safe.
+/// The gain is designed in double, the state and the arithmetic are in SampleType, see the TPTOnePoleFilter alias.
+/// The gain design and the lowpass step are also static, for filters stored as arrays of gains and states
+/// (one per SIMD lane)
+/// </summary>
+template <typename SampleType>
+class TPTOnePoleFilterT
+{
+public:
+	void reset(double pSampleRate)
+	{
+		sampleRate = pSampleRate;
+		state = SampleType(0);
+		setCutoffFrequency(cornerFreq);
+	}
+
+	/// <summary>
+	/// Sets the cutoff frequency, exact tan
+	/// </summary>
+	void setCutoffFrequency(double pCornerFreq)
+	{
+		cornerFreq = pCornerFreq;
+		G = computeGain(cornerFreq, sampleRate);
+	}
+
+	/// <summary>
+	/// Sets the cutoff frequency with the tan approximation : for per sample modulation
+	/// </summary>
+	void setCutoffFrequencyFast(double pCornerFreq)
+	{
+		cornerFreq = pCornerFreq;
+		auto g = TPTGain::computeFast(cornerFreq, sampleRate);
+		G = (SampleType)(g / (1.0 + g));
+	}
+
+	SampleType processLowpass(SampleType xn)
+	{
+		return processLowpass(xn, G, state);
+	}
+
+	SampleType processHighpass(SampleType xn)
+	{
+		return xn - processLowpass(xn);
+	}
+
+	/// <summary>
+	/// Gain G = g / (1 + g) of the cutoff frequency, exact tan
+	/// </summary>
+	static SampleType computeGain(double pCornerFreq, double pSampleRate)
+	{
+		auto g = TPTGain::compute(pCornerFreq, pSampleRate);
+		return (SampleType)(g / (1.0 + g));
+	}
+
+	/// <summary>
+	/// One lowpass step of a filter given by its gain and state, the state is updated
+	/// </summary>
+	static SampleType processLowpass(SampleType xn, SampleType gain, SampleType& pState)
+	{
+		auto v = (xn - pState) * gain;
+		auto lowpass = v + pState;
+		pState = flushDenormal(lowpass + v);
+		return lowpass;
+	}
+
+private:
+	double sampleRate = 44100.0;
+	double cornerFreq = 1000.0;
+	SampleType G = SampleType(0);
+	SampleType state = SampleType(0);
+};
+
+/// <summary>
+/// Single precision filters, as every default alias of dsp_fv. The double precision ones are the T<double> instantiations
+/// </summary>
+using SVFOutputs = SVFOutputsT<float>;
+using TPTStateVariableFilter = TPTStateVariableFilterT<float>;
+using TPTOnePoleFilter = TPTOnePoleFilterT<float>;
@@ -34,19 +34,24 @@ struct vibratoParameters
 	bool enableVibrato; // enables or disables the Vibrator effect 
 };
 
-class Vibrato 
+/// <summary>
+/// Vibrato : a delay line modulated by a triangle LFO. The delay buffer and the samples are in SampleType,
+/// the LFO and the delay time in double, see the Vibrato alias
+/// </summary>
+template <typename SampleType>
+class VibratoT 
 {
 public:
 	// Default constructor
-	Vibrato(double  pBufferLength_ms, double pSampleRate, double pSamplesPerMsec ) : bufferLength(pBufferLength_ms), currentSampleRate(pSampleRate), samplesPerMsec(pSamplesPerMsec)
+	VibratoT(double  pBufferLength_ms, double pSampleRate, double pSamplesPerMsec ) : bufferLength(pBufferLength_ms), currentSampleRate(pSampleRate), samplesPerMsec(pSamplesPerMsec)
 	{	}
 	
 	// Delegating constructors
 	// Specified bufferLength in ms
-	Vibrato(double  pBufferLength_ms) : Vibrato(pBufferLength_ms, 0.0, 0.0){ }
+	VibratoT(double  pBufferLength_ms) : VibratoT(pBufferLength_ms, 0.0, 0.0){ }
 
 	// unspecified bufferLength, default value is set to 100.0 ms 
-	Vibrato() : Vibrato(100.0, 0.0, 0.0) { }
+	VibratoT() : VibratoT(100.0, 0.0, 0.0) { }
 
 	/// <summary>
 	/// Sets the delay time in ms and enables/ disables  the comb filter 
@@ -106,7 +111,7 @@ public:
 	/// </summary>
 	/// <param name="inputXn">The input audio sample to process.</param>
 	/// <returns>The processed audio sample.</returns>
-	float processAudioSample(float inputXn)
+	SampleType processAudioSample(SampleType inputXn)
 	{
 		if (parameters.enableVibrato == true)
 		{
@@ -131,7 +136,12 @@ private:
 	double bufferLength;
 	double currentSampleRate;
 	double samplesPerMsec;
-	CircularBuffer<float> delayBuffer;
+	CircularBuffer<SampleType> delayBuffer;
 	vibratoParameters parameters;
 	LFO osc; // Low-frequency oscillator for modulation
 };
+
+/// <summary>
+/// Single precision vibrato, as every default alias of dsp_fv
+/// </summary>
+using Vibrato = VibratoT<float>;